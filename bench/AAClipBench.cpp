@@ -11,6 +11,7 @@
 #include "SkRegion.h"
 #include "SkString.h"
 #include "SkCanvas.h"
+#include "SkGraphics.h"
 #include "SkRandom.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -87,6 +88,66 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// This bench clips every "layer" to the same complex polygon, as a map tile
+// does with a coastline, with and without the clip mask cache.
+class RepeatedAAClipBench : public SkBenchmark {
+    SkString fName;
+    SkPath   fClipPath;
+    SkRect   fDrawRect;
+    bool     fUseCache;
+
+    enum {
+        N = SkBENCHLOOP(200),
+        kPointCount = 500,
+    };
+
+public:
+    RepeatedAAClipBench(void* param, bool useCache)
+        : INHERITED(param)
+        , fUseCache(useCache) {
+
+        fName.printf("aaclip_repeated_path_%s", useCache ? "cached" : "uncached");
+
+        SkRandom rand;
+        const SkScalar cx = SkIntToScalar(320);
+        const SkScalar cy = SkIntToScalar(240);
+        for (int i = 0; i < kPointCount; ++i) {
+            SkScalar angle = SkIntToScalar(i) * 2 * SK_ScalarPI / kPointCount;
+            SkScalar radius = SkIntToScalar(150) + rand.nextUScalar1() * 60;
+            SkPoint pt = SkPoint::Make(cx + SkScalarMul(radius, SkScalarCos(angle)),
+                                       cy + SkScalarMul(radius, SkScalarSin(angle)));
+            if (0 == i) {
+                fClipPath.moveTo(pt);
+            } else {
+                fClipPath.lineTo(pt);
+            }
+        }
+        fClipPath.close();
+        fDrawRect.set(0, 0, SkIntToScalar(640), SkIntToScalar(480));
+    }
+
+protected:
+    virtual const char* onGetName() { return fName.c_str(); }
+    virtual void onDraw(SkCanvas* canvas) {
+        size_t prevLimit = SkGraphics::SetClipMaskCacheLimit(fUseCache ? 4 * 1024 * 1024 : 0);
+
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        for (int i = 0; i < N; ++i) {
+            canvas->save();
+            canvas->clipPath(fClipPath, SkRegion::kIntersect_Op, true);
+            canvas->drawRect(fDrawRect, paint);
+            canvas->restore();
+        }
+
+        SkGraphics::SetClipMaskCacheLimit(prevLimit);
+    }
+private:
+    typedef SkBenchmark INHERITED;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // This bench tests out nested clip stacks. It is intended to simulate
 // how WebKit nests clips.
@@ -288,3 +349,9 @@ static SkBenchmark* Fact005(void* p) { return SkNEW_ARGS(NestedAAClipBench, (p,
 
 static BenchRegistry gReg004(Fact004);
 static BenchRegistry gReg005(Fact005);
+
+static SkBenchmark* Fact006(void* p) { return SkNEW_ARGS(RepeatedAAClipBench, (p, false)); }
+static SkBenchmark* Fact007(void* p) { return SkNEW_ARGS(RepeatedAAClipBench, (p, true)); }
+
+static BenchRegistry gReg006(Fact006);
+static BenchRegistry gReg007(Fact007);
@@ -188,15 +188,18 @@ class FilterBitmapBench : public BitmapBench {
     bool        fScale;
     bool        fRotate;
     bool        fFilter;
+    U8CPU       fAlpha;
     SkString    fFullName;
     enum { N = SkBENCHLOOP(300) };
 public:
     FilterBitmapBench(void* param, bool isOpaque, SkBitmap::Config c,
                 bool forceUpdate = false, bool bitmapVolatile = false,
                 int tx = -1, int ty = -1, bool addScale = false,
-                bool addRotate = false, bool addFilter = false)
+                bool addRotate = false, bool addFilter = false,
+                U8CPU alpha = 0xFF)
         : INHERITED(param, isOpaque, c, forceUpdate, bitmapVolatile, tx, ty)
-        , fScale(addScale), fRotate(addRotate), fFilter(addFilter) {
+        , fScale(addScale), fRotate(addRotate), fFilter(addFilter)
+        , fAlpha(alpha) {
 
     }
 
@@ -209,6 +212,8 @@ protected:
             fFullName.append("_rotate");
         if (fFilter)
             fFullName.append("_filter");
+        if (fAlpha != 0xFF)
+            fFullName.append("_alpha");
 
         return fFullName.c_str();
     }
@@ -237,6 +242,11 @@ protected:
         INHERITED::onDraw(canvas);
     }
 
+    virtual void setupPaint(SkPaint* paint) {
+        INHERITED::setupPaint(paint);
+        paint->setAlpha(fAlpha);
+    }
+
 private:
     typedef BitmapBench INHERITED;
 };
@@ -263,6 +273,23 @@ static SkBenchmark* Fact14(void* p) { return new FilterBitmapBench(p, true, SkBi
 static SkBenchmark* Fact15(void* p) { return new FilterBitmapBench(p, true, SkBitmap::kARGB_8888_Config, true, true, -1, -1, true, true, true); }
 static SkBenchmark* Fact16(void* p) { return new FilterBitmapBench(p, true, SkBitmap::kARGB_8888_Config, true, false, -1, -1, true, true, true); }
 
+// scale filter -> S16_{opaque,alpha}_D32_filter_DX_SSE2
+static SkBenchmark* Fact17(void* p) { return new FilterBitmapBench(p, true, SkBitmap::kRGB_565_Config, false, false, -1, -1, true, false, true); }
+static SkBenchmark* Fact18(void* p) { return new FilterBitmapBench(p, true, SkBitmap::kRGB_565_Config, false, false, -1, -1, true, false, true, 0x80); }
+
+// scale rotate filter -> S16_{opaque,alpha}_D32_filter_DXDY_SSE2
+static SkBenchmark* Fact19(void* p) { return new FilterBitmapBench(p, true, SkBitmap::kRGB_565_Config, false, false, -1, -1, true, true, true); }
+static SkBenchmark* Fact20(void* p) { return new FilterBitmapBench(p, true, SkBitmap::kRGB_565_Config, false, false, -1, -1, true, true, true, 0x80); }
+
+// scale -> S16_{opaque,alpha}_D32_nofilter_DX_SSE2
+static SkBenchmark* Fact21(void* p) { return new FilterBitmapBench(p, true, SkBitmap::kRGB_565_Config, false, false, -1, -1, true, false, false); }
+static SkBenchmark* Fact22(void* p) { return new FilterBitmapBench(p, true, SkBitmap::kRGB_565_Config, false, false, -1, -1, true, false, false, 0x80); }
+
+// A8 -> SA8_alpha_D32_{filter_DX,filter_DXDY,nofilter_DX}_SSE2
+static SkBenchmark* Fact23(void* p) { return new FilterBitmapBench(p, false, SkBitmap::kA8_Config, false, false, -1, -1, true, false, true, 0x80); }
+static SkBenchmark* Fact24(void* p) { return new FilterBitmapBench(p, false, SkBitmap::kA8_Config, false, false, -1, -1, true, true, true, 0x80); }
+static SkBenchmark* Fact25(void* p) { return new FilterBitmapBench(p, false, SkBitmap::kA8_Config, false, false, -1, -1, true, false, false, 0x80); }
+
 static BenchRegistry gReg0(Fact0);
 static BenchRegistry gReg1(Fact1);
 static BenchRegistry gReg2(Fact2);
@@ -283,3 +310,13 @@ static BenchRegistry gReg14(Fact14);
 static BenchRegistry gReg15(Fact15);
 static BenchRegistry gReg16(Fact16);
 
+static BenchRegistry gReg17(Fact17);
+static BenchRegistry gReg18(Fact18);
+static BenchRegistry gReg19(Fact19);
+static BenchRegistry gReg20(Fact20);
+static BenchRegistry gReg21(Fact21);
+static BenchRegistry gReg22(Fact22);
+
+static BenchRegistry gReg23(Fact23);
+static BenchRegistry gReg24(Fact24);
+static BenchRegistry gReg25(Fact25);
@@ -74,6 +74,49 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+// Many small masks, the size of a map label, as for text halos and shadows.
+class BlurHaloBench : public SkBenchmark {
+    SkScalar    fRadius;
+    uint32_t    fFlags;
+    SkString    fName;
+
+public:
+    BlurHaloBench(void* param, int rad, uint32_t flags = 0) : INHERITED(param) {
+        fRadius = SkIntToScalar(rad);
+        fFlags = flags;
+        const char* quality = flags & SkBlurMaskFilter::kHighQuality_BlurFlag ? "high_quality" : "low_quality";
+        fName.printf("blur_halo_%d_%s", rad, quality);
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        paint.setAntiAlias(true);
+        SkMaskFilter* mf = SkBlurMaskFilter::Create(fRadius,
+                                                    SkBlurMaskFilter::kNormal_BlurStyle,
+                                                    fFlags);
+        paint.setMaskFilter(mf)->unref();
+
+        SkRandom rand;
+        for (int i = 0; i < SkBENCHLOOP(100); i++) {
+            SkRect r = SkRect::MakeXYWH(rand.nextUScalar1() * 400,
+                                        rand.nextUScalar1() * 400,
+                                        SkIntToScalar(24) + rand.nextUScalar1() * 64,
+                                        SkIntToScalar(10) + rand.nextUScalar1() * 6);
+            canvas->drawRoundRect(r, SkIntToScalar(3), SkIntToScalar(3), paint);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
 DEF_BENCH(return new BlurBench(p, SMALL, SkBlurMaskFilter::kNormal_BlurStyle);)
 DEF_BENCH(return new BlurBench(p, SMALL, SkBlurMaskFilter::kSolid_BlurStyle);)
 DEF_BENCH(return new BlurBench(p, SMALL, SkBlurMaskFilter::kOuter_BlurStyle);)
@@ -104,3 +147,11 @@ DEF_BENCH(return new BlurBench(p, REAL, SkBlurMaskFilter::kNormal_BlurStyle, SkB
 
 DEF_BENCH(return new BlurBench(p, 0, SkBlurMaskFilter::kNormal_BlurStyle);)
 
+DEF_BENCH(return new BlurHaloBench(p, 1);)
+DEF_BENCH(return new BlurHaloBench(p, 2);)
+DEF_BENCH(return new BlurHaloBench(p, 3);)
+DEF_BENCH(return new BlurHaloBench(p, 4);)
+DEF_BENCH(return new BlurHaloBench(p, 6);)
+DEF_BENCH(return new BlurHaloBench(p, 8);)
+DEF_BENCH(return new BlurHaloBench(p, 4, SkBlurMaskFilter::kHighQuality_BlurFlag);)
+DEF_BENCH(return new BlurHaloBench(p, 8, SkBlurMaskFilter::kHighQuality_BlurFlag);)
@@ -311,6 +311,57 @@ protected:
 private:
     typedef SkBenchmark INHERITED;
 };
+/*
+ *  Long polylines (e.g. map routes or plotted data) take the dasher's fast
+ *  path, which emits the stroked dashes without measuring or stroking an
+ *  intermediate path.
+ */
+class PolylineDashBench : public SkBenchmark {
+    SkString fName;
+    SkPath   fPath;
+    SkScalar fStrokeWidth;
+    SkAutoTUnref<SkPathEffect> fPE;
+
+    enum {
+        kSegments = 10000,
+        N = SkBENCHLOOP(4)
+    };
+
+public:
+    PolylineDashBench(void* param, SkScalar width) : INHERITED(param) {
+        fName.printf("dashpolyline_%g", SkScalarToFloat(width));
+        fStrokeWidth = width;
+
+        SkRandom rand;
+        fPath.moveTo(SkIntToScalar(320), SkIntToScalar(240));
+        for (int i = 0; i < kSegments; ++i) {
+            fPath.lineTo(rand.nextUScalar1() * 640, rand.nextUScalar1() * 480);
+        }
+
+        SkScalar vals[] = { SkIntToScalar(10), SkIntToScalar(4) };
+        fPE.reset(new SkDashPathEffect(vals, 2, 0));
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(fStrokeWidth);
+        paint.setPathEffect(fPE);
+        for (int i = 0; i < N; ++i) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const SkScalar gDots[] = { SK_Scalar1, SK_Scalar1 };
@@ -338,6 +389,9 @@ static SkBenchmark* gF11(void* p) { return new DrawPointsDashingBench(p, 3, 1, t
 static SkBenchmark* gF12(void* p) { return new DrawPointsDashingBench(p, 5, 5, false); }
 static SkBenchmark* gF13(void* p) { return new DrawPointsDashingBench(p, 5, 5, true); }
 
+static SkBenchmark* gF14(void* p) { return new PolylineDashBench(p, 0); }
+static SkBenchmark* gF15(void* p) { return new PolylineDashBench(p, SkIntToScalar(3)); }
+
 static BenchRegistry gR0(gF0);
 static BenchRegistry gR1(gF1);
 static BenchRegistry gR2(gF2);
@@ -358,3 +412,6 @@ static BenchRegistry gR10(gF10);
 static BenchRegistry gR11(gF11);
 static BenchRegistry gR12(gF12);
 static BenchRegistry gR13(gF13);
+
+static BenchRegistry gR14(gF14);
+static BenchRegistry gR15(gF15);
@@ -11,6 +11,7 @@
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
+#include "SkThreadUtils.h"
 
 extern bool gSkSuppressFontCachePurgeSpew;
 
@@ -51,6 +52,100 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+/**
+ *  Like FontScalerBench, but splits the sizes between threadCount threads,
+ *  each drawing into its own bitmap, to see how well glyph generation for new
+ *  strikes scales across threads (see SK_FONTHOST_FREETYPE_SLOT_COUNT).
+ */
+class FontScalerThreadsBench : public SkBenchmark {
+    enum {
+        kMaxThreads = 8,
+        kMinSize = 9,
+        kMaxSize = 40
+    };
+
+    struct Worker {
+        FontScalerThreadsBench* fBench;
+        SkBitmap                fBitmap;
+        SkPaint                 fPaint;
+        int                     fFirstSize;
+    };
+
+    SkString fName;
+    SkString fText;
+    Worker   fWorkers[kMaxThreads];
+    int      fThreadCount;
+public:
+    FontScalerThreadsBench(void* param, int threadCount) : INHERITED(param) {
+        SkASSERT(threadCount > 0 && threadCount <= kMaxThreads);
+        fName.printf("fontscaler_aa_threads_%d", threadCount);
+        fText.set("abcdefghijklmnopqrstuvwxyz01234567890");
+        fThreadCount = threadCount;
+        for (int i = 0; i < threadCount; ++i) {
+            fWorkers[i].fBench = this;
+            fWorkers[i].fFirstSize = kMinSize + i;
+            fWorkers[i].fBitmap.setConfig(SkBitmap::kARGB_8888_Config,
+                                          1024, 64);
+        }
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() { return fName.c_str(); }
+
+    virtual void onPreDraw() {
+        for (int i = 0; i < fThreadCount; ++i) {
+            fWorkers[i].fBitmap.allocPixels();
+            this->setupPaint(&fWorkers[i].fPaint);
+        }
+    }
+
+    virtual void onDraw(SkCanvas*) {
+        bool prev = gSkSuppressFontCachePurgeSpew;
+        gSkSuppressFontCachePurgeSpew = true;
+
+        // as above, time the creation of the strikes
+        SkGraphics::PurgeFontCache();
+
+        SkThread* threads[kMaxThreads];
+        for (int i = 0; i < fThreadCount; ++i) {
+            threads[i] = SkNEW_ARGS(SkThread, (Draw, &fWorkers[i]));
+            if (!threads[i]->start()) {
+                Draw(&fWorkers[i]);
+            }
+        }
+        for (int i = 0; i < fThreadCount; ++i) {
+            threads[i]->join();
+            SkDELETE(threads[i]);
+        }
+
+        gSkSuppressFontCachePurgeSpew = prev;
+    }
+
+    virtual void onPostDraw() {
+        for (int i = 0; i < fThreadCount; ++i) {
+            fWorkers[i].fBitmap.setPixels(NULL);
+        }
+    }
+
+private:
+    static void Draw(void* data) {
+        Worker* worker = static_cast<Worker*>(data);
+        const SkString& text = worker->fBench->fText;
+        int step = worker->fBench->fThreadCount;
+
+        SkCanvas canvas(worker->fBitmap);
+        SkPaint paint(worker->fPaint);
+        for (int ps = worker->fFirstSize; ps <= kMaxSize; ps += step) {
+            paint.setTextSize(SkIntToScalar(ps));
+            canvas.drawText(text.c_str(), text.size(),
+                            0, SkIntToScalar(48), paint);
+        }
+    }
+
+    typedef SkBenchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static SkBenchmark* Fact0(void* p) { return SkNEW_ARGS(FontScalerBench, (p, false)); }
@@ -58,3 +153,9 @@ static SkBenchmark* Fact1(void* p) { return SkNEW_ARGS(FontScalerBench, (p, true
 
 static BenchRegistry gReg0(Fact0);
 static BenchRegistry gReg1(Fact1);
+
+static SkBenchmark* Fact2(void* p) { return SkNEW_ARGS(FontScalerThreadsBench, (p, 1)); }
+static SkBenchmark* Fact3(void* p) { return SkNEW_ARGS(FontScalerThreadsBench, (p, 4)); }
+
+static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
@@ -15,6 +15,8 @@
 #define SMALL   SkIntToScalar(2)
 #define REAL    SkFloatToScalar(1.5f)
 #define BIG     SkIntToScalar(10)
+#define LARGE   SkIntToScalar(32)
+#define XLARGE  SkIntToScalar(100)
 
 namespace {
 
@@ -96,6 +98,12 @@ static SkBenchmark* Fact11(void* p) { return new MorphologyBench(p, BIG, kDilate
 static SkBenchmark* Fact20(void* p) { return new MorphologyBench(p, REAL, kErode_MT); }
 static SkBenchmark* Fact21(void* p) { return new MorphologyBench(p, REAL, kDilate_MT); }
 
+static SkBenchmark* Fact30(void* p) { return new MorphologyBench(p, LARGE, kErode_MT); }
+static SkBenchmark* Fact31(void* p) { return new MorphologyBench(p, LARGE, kDilate_MT); }
+
+static SkBenchmark* Fact40(void* p) { return new MorphologyBench(p, XLARGE, kErode_MT); }
+static SkBenchmark* Fact41(void* p) { return new MorphologyBench(p, XLARGE, kDilate_MT); }
+
 static SkBenchmark* FactNone(void* p) { return new MorphologyBench(p, 0, kErode_MT); }
 
 // Fixed point can be 100x slower than float on these tests, causing
@@ -111,6 +119,12 @@ static BenchRegistry gReg11(Fact11);
 static BenchRegistry gReg20(Fact20);
 static BenchRegistry gReg21(Fact21);
 
+static BenchRegistry gReg30(Fact30);
+static BenchRegistry gReg31(Fact31);
+
+static BenchRegistry gReg40(Fact40);
+static BenchRegistry gReg41(Fact41);
+
 static BenchRegistry gRegNone(FactNone);
 
 #endif
@@ -0,0 +1,145 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkBenchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkImageEncoder.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTemplates.h"
+#include "SkThreadPool.h"
+
+enum {
+    kMetatileSize = 2048,
+    kThreadCount = 4
+};
+
+// Something like a rendered map: flat fills of land and water, parks and
+// buildings, crossed by antialiased roads of a few widths and colors.
+static void draw_map(SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, kMetatileSize, kMetatileSize);
+    bm->allocPixels();
+    bm->setIsOpaque(true);
+    SkCanvas canvas(*bm);
+    canvas.drawColor(0xFFF1EEE8);
+
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    static const SkColor gAreaColors[] = {
+        0xFFB5D0D0,     // water
+        0xFFCDEBB0,     // park
+        0xFFD9D0C9,     // building
+    };
+    for (int i = 0; i < 400; i++) {
+        SkPath path;
+        SkScalar x = rand.nextUScalar1() * kMetatileSize;
+        SkScalar y = rand.nextUScalar1() * kMetatileSize;
+        SkScalar size = SkIntToScalar(20) + rand.nextUScalar1() * 200;
+        path.moveTo(x, y);
+        for (int j = 0; j < 5; j++) {
+            path.lineTo(x + rand.nextSScalar1() * size,
+                        y + rand.nextSScalar1() * size);
+        }
+        path.close();
+        paint.setColor(gAreaColors[i % SK_ARRAY_COUNT(gAreaColors)]);
+        canvas.drawPath(path, paint);
+    }
+
+    static const struct {
+        SkColor fColor;
+        int     fWidth;
+        int     fCount;
+    } gRoads[] = {
+        { 0xFFFFFFFF,   4,  300 },  // streets
+        { 0xFFF7FABF,   8,  60 },   // main roads
+        { 0xFFE892A2,   12, 12 },   // motorways
+    };
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeCap(SkPaint::kRound_Cap);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gRoads); i++) {
+        paint.setColor(gRoads[i].fColor);
+        paint.setStrokeWidth(SkIntToScalar(gRoads[i].fWidth));
+        for (int j = 0; j < gRoads[i].fCount; j++) {
+            SkPath path;
+            path.moveTo(rand.nextUScalar1() * kMetatileSize,
+                        rand.nextUScalar1() * kMetatileSize);
+            path.quadTo(rand.nextUScalar1() * kMetatileSize,
+                        rand.nextUScalar1() * kMetatileSize,
+                        rand.nextUScalar1() * kMetatileSize,
+                        rand.nextUScalar1() * kMetatileSize);
+            canvas.drawPath(path, paint);
+        }
+    }
+}
+
+/**
+ *  Encodes a map metatile with libpng's encoder (threaded == false), or with
+ *  the parallel encoder on a pool of kThreadCount threads at the given zlib
+ *  level.
+ */
+class PNGEncodeBench : public SkBenchmark {
+    SkString        fName;
+    bool            fThreaded;
+    int             fZLibLevel;
+    SkBitmap        fBitmap;
+    SkThreadPool*   fPool;
+    enum { N = SkBENCHLOOP(2) };
+public:
+    PNGEncodeBench(void* param, bool threaded, int zlibLevel = -1)
+        : INHERITED(param)
+        , fThreaded(threaded)
+        , fZLibLevel(zlibLevel)
+        , fPool(NULL) {
+        if (threaded) {
+            fName.printf("png_encode_parallel_%d", zlibLevel);
+        } else {
+            fName.set("png_encode_libpng");
+        }
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() {
+        draw_map(&fBitmap);
+        if (fThreaded) {
+            fPool = SkNEW_ARGS(SkThreadPool, (kThreadCount));
+        }
+    }
+
+    virtual void onDraw(SkCanvas*) {
+        SkAutoTDelete<SkImageEncoder> encoder(fThreaded ?
+                CreateParallelPNGImageEncoder(fPool, fZLibLevel) :
+                CreatePNGImageEncoder());
+        for (int i = 0; i < N; i++) {
+            SkDynamicMemoryWStream stream;
+            encoder->encodeStream(&stream, fBitmap, 100);
+        }
+    }
+
+    virtual void onPostDraw() {
+        SkDELETE(fPool);
+        fPool = NULL;
+        fBitmap.reset();
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+DEF_BENCH(return new PNGEncodeBench(p, false))
+DEF_BENCH(return new PNGEncodeBench(p, true, 1))
+DEF_BENCH(return new PNGEncodeBench(p, true, 6))
+DEF_BENCH(return new PNGEncodeBench(p, true, 9))
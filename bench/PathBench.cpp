@@ -9,6 +9,7 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
+#include "SkGraphics.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
@@ -17,14 +18,17 @@
 
 
 enum Flags {
-    kStroke_Flag = 1 << 0,
-    kBig_Flag    = 1 << 1
+    kStroke_Flag    = 1 << 0,
+    kBig_Flag       = 1 << 1,
+    kAnalytic_Flag  = 1 << 2    // antialias with analytic coverage
 };
 
 #define FLAGS00  Flags(0)
 #define FLAGS01  Flags(kStroke_Flag)
 #define FLAGS10  Flags(kBig_Flag)
 #define FLAGS11  Flags(kStroke_Flag | kBig_Flag)
+#define FLAGS_A00  Flags(kAnalytic_Flag)
+#define FLAGS_A10  Flags(kAnalytic_Flag | kBig_Flag)
 
 class PathBench : public SkBenchmark {
     SkPaint     fPaint;
@@ -48,6 +52,9 @@ protected:
         fName.printf("path_%s_%s_",
                      fFlags & kStroke_Flag ? "stroke" : "fill",
                      fFlags & kBig_Flag ? "big" : "small");
+        if (fFlags & kAnalytic_Flag) {
+            fName.append("analytic_");
+        }
         this->appendName(&fName);
         return fName.c_str();
     }
@@ -70,9 +77,15 @@ protected:
         }
         count >>= (3 * complexity());
 
+        if (fFlags & kAnalytic_Flag) {
+            SkGraphics::SetFlags("analytic-aa=1");
+        }
         for (int i = 0; i < count; i++) {
             canvas->drawPath(path, paint);
         }
+        if (fFlags & kAnalytic_Flag) {
+            SkGraphics::SetFlags("analytic-aa=0");
+        }
     }
 
 private:
@@ -930,6 +943,26 @@ static BenchRegistry gRegLC01(FactLC01);
 static BenchRegistry gRegLL00(FactLL00);
 static BenchRegistry gRegLL01(FactLL01);
 
+static SkBenchmark* FactAT00(void* p) { return new TrianglePathBench(p, FLAGS_A00); }
+static SkBenchmark* FactAT10(void* p) { return new TrianglePathBench(p, FLAGS_A10); }
+static SkBenchmark* FactAO00(void* p) { return new OvalPathBench(p, FLAGS_A00); }
+static SkBenchmark* FactAO10(void* p) { return new OvalPathBench(p, FLAGS_A10); }
+static SkBenchmark* FactAC00(void* p) { return new CirclePathBench(p, FLAGS_A00); }
+static SkBenchmark* FactAC10(void* p) { return new CirclePathBench(p, FLAGS_A10); }
+static SkBenchmark* FactAS00(void* p) { return new SawToothPathBench(p, FLAGS_A00); }
+static SkBenchmark* FactALC00(void* p) {
+    return new LongCurvedPathBench(p, FLAGS_A00);
+}
+
+static BenchRegistry gRegAT00(FactAT00);
+static BenchRegistry gRegAT10(FactAT10);
+static BenchRegistry gRegAO00(FactAO00);
+static BenchRegistry gRegAO10(FactAO10);
+static BenchRegistry gRegAC00(FactAC00);
+static BenchRegistry gRegAC10(FactAC10);
+static BenchRegistry gRegAS00(FactAS00);
+static BenchRegistry gRegALC00(FactALC00);
+
 static SkBenchmark* FactCreate(void* p) { return new PathCreateBench(p); }
 static BenchRegistry gRegCreate(FactCreate);
 
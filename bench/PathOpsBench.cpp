@@ -0,0 +1,160 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkBenchmark.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTemplates.h"
+
+// The kinds of work a map renderer hands to the path ops: merging the
+// parcels of a land use layer into one area, cleaning up a coastline that
+// crosses itself, and cutting a coastline down to a tile.
+
+// A count x count grid of four sided parcels. The grid lines are jittered,
+// so that the parcels are not rectangles, and the parcels are split
+// between two paths like the squares of a checkerboard.
+static void make_parcels(int count, SkPath* even, SkPath* odd) {
+    SkRandom rand;
+    const int stride = count + 1;
+    SkAutoTMalloc<SkPoint> corners(stride * stride);
+    for (int y = 0; y <= count; ++y) {
+        for (int x = 0; x <= count; ++x) {
+            SkScalar dx = 0, dy = 0;
+            if (x > 0 && x < count) {
+                dx = rand.nextRangeScalar(-SkIntToScalar(2), SkIntToScalar(2));
+            }
+            if (y > 0 && y < count) {
+                dy = rand.nextRangeScalar(-SkIntToScalar(2), SkIntToScalar(2));
+            }
+            corners[y * stride + x].set(SkIntToScalar(x * 10) + dx,
+                                        SkIntToScalar(y * 10) + dy);
+        }
+    }
+    for (int y = 0; y < count; ++y) {
+        for (int x = 0; x < count; ++x) {
+            SkPath* path = (x + y) & 1 ? odd : even;
+            const SkPoint* corner = &corners[y * stride + x];
+            path->moveTo(corner[0]);
+            path->lineTo(corner[1]);
+            path->lineTo(corner[stride + 1]);
+            path->lineTo(corner[stride]);
+            path->close();
+        }
+    }
+}
+
+// A ring of count points whose distance from the center wanders, so that
+// neighboring stretches of the shore cross each other now and then.
+static void make_coastline(int count, SkPath* path) {
+    SkRandom rand;
+    const SkScalar radius = SkIntToScalar(1000);
+    const SkScalar jitter = SkIntToScalar(20);
+    for (int i = 0; i < count; ++i) {
+        SkScalar angle = SkScalarDiv(SkIntToScalar(i) * 2 * SK_ScalarPI,
+                                     SkIntToScalar(count));
+        SkScalar cos;
+        SkScalar sin = SkScalarSinCos(angle, &cos);
+        SkScalar r = radius + SkScalarMul(rand.nextUScalar1(), jitter);
+        SkPoint pt = SkPoint::Make(SkScalarMul(r, cos), SkScalarMul(r, sin));
+        if (0 == i) {
+            path->moveTo(pt);
+        } else {
+            path->lineTo(pt);
+        }
+    }
+    path->close();
+}
+
+class ParcelsUnionBench : public SkBenchmark {
+    enum {
+        N = SkBENCHLOOP(2)
+    };
+    SkPath      fEven;
+    SkPath      fOdd;
+    SkString    fName;
+
+public:
+    ParcelsUnionBench(void* param, int count) : INHERITED(param) {
+        make_parcels(count, &fEven, &fOdd);
+        fName.printf("pathops_parcels_union_%d", count * count);
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas*) {
+        SkPath result;
+        for (int i = 0; i < N; ++i) {
+            Op(fEven, fOdd, kUnion_PathOp, &result);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+class CoastlineBench : public SkBenchmark {
+    enum {
+        N = SkBENCHLOOP(2)
+    };
+    SkPath      fCoastline;
+    SkPath      fTile;
+    SkString    fName;
+
+public:
+    // With no tile, the coastline is simplified. Otherwise it is intersected
+    // with a square that covers a stretch of it.
+    CoastlineBench(void* param, int count, bool tile) : INHERITED(param) {
+        make_coastline(count, &fCoastline);
+        if (tile) {
+            fTile.addRect(SkIntToScalar(700), SkIntToScalar(-150),
+                          SkIntToScalar(1100), SkIntToScalar(250));
+            fName.printf("pathops_coastline_tile_%d", count);
+        } else {
+            fName.printf("pathops_coastline_simplify_%d", count);
+        }
+        fIsRendering = false;
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas*) {
+        SkPath result;
+        for (int i = 0; i < N; ++i) {
+            if (fTile.isEmpty()) {
+                Simplify(fCoastline, &result);
+            } else {
+                Op(fCoastline, fTile, kIntersect_PathOp, &result);
+            }
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkBenchmark* Fact0(void* p) { return new ParcelsUnionBench(p, 16); }
+static SkBenchmark* Fact1(void* p) { return new ParcelsUnionBench(p, 64); }
+static SkBenchmark* Fact2(void* p) { return new CoastlineBench(p, 1000, false); }
+static SkBenchmark* Fact3(void* p) { return new CoastlineBench(p, 20000, false); }
+static SkBenchmark* Fact4(void* p) { return new CoastlineBench(p, 20000, true); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
+static BenchRegistry gReg4(Fact4);
@@ -182,12 +182,45 @@ private:
     typedef PictureRecordBench INHERITED;
 };
 
+/*
+ *  Populates the SkPaint and SkMatrix dictionaries with a very large number of
+ *  unique objects, so that insertion into the dictionaries dominates.
+ */
+class LargeUniquePaintDictionaryRecordBench : public PictureRecordBench {
+public:
+    LargeUniquePaintDictionaryRecordBench(void* param)
+        : INHERITED(param, "large_unique_paint_dictionary") { }
+
+    enum {
+        M = SkBENCHLOOP(50000),   // number of unique paint and matrix objects
+    };
+protected:
+    virtual float innerLoopScale() const SK_OVERRIDE { return 0.04f; }
+    virtual void recordCanvas(SkCanvas* canvas) {
+        SkRandom rand;
+        for (int i = 0; i < M; i++) {
+            SkPaint paint;
+            paint.setColor(rand.nextU());
+            paint.setStrokeWidth(SkIntToScalar(i));
+            SkMatrix matrix;
+            matrix.setTranslate(SkIntToScalar(i), 0);
+            canvas->setMatrix(matrix);
+            canvas->drawPaint(paint);
+        }
+    }
+
+private:
+    typedef PictureRecordBench INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static SkBenchmark* Fact0(void* p) { return new DictionaryRecordBench(p); }
 static SkBenchmark* Fact1(void* p) { return new UniquePaintDictionaryRecordBench(p); }
 static SkBenchmark* Fact2(void* p) { return new RecurringPaintDictionaryRecordBench(p); }
+static SkBenchmark* Fact3(void* p) { return new LargeUniquePaintDictionaryRecordBench(p); }
 
 static BenchRegistry gReg0(Fact0);
 static BenchRegistry gReg1(Fact1);
 static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
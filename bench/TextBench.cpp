@@ -8,6 +8,7 @@
 #include "SkBenchmark.h"
 #include "SkCanvas.h"
 #include "SkFontHost.h"
+#include "SkMeasuredPath.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
@@ -129,6 +130,142 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/*  Draws a label repeatedly along one long polyline, as a map does for a
+    street name, either measuring the path on every draw or once up front.
+ */
+class TextOnPathBench : public SkBenchmark {
+    SkString    fName;
+    SkPath      fPath;
+    bool        fMeasured;
+
+    enum {
+        kSegments = 100,
+        kLabels = 50,
+        N = SkBENCHLOOP(10)
+    };
+public:
+    TextOnPathBench(void* param, bool measured) : INHERITED(param) {
+        fMeasured = measured;
+        fName.printf("text_on_path_%s", measured ? "measured" : "plain");
+
+        SkRandom rand;
+        fPath.moveTo(0, SkIntToScalar(240));
+        for (int i = 1; i <= kSegments; ++i) {
+            fPath.lineTo(SkIntToScalar(i * 6),
+                         SkIntToScalar(220) + rand.nextUScalar1() * 40);
+        }
+    }
+
+protected:
+    virtual const char* onGetName() { return fName.c_str(); }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        static const char gLabel[] = "Main Street";
+
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setTextSize(SkIntToScalar(12));
+
+        for (int n = 0; n < N; ++n) {
+            // each draw builds its measurements, as a renderer that does not
+            // keep them between frames would
+            SkMeasuredPath* measured = NULL;
+            if (fMeasured) {
+                measured = SkNEW_ARGS(SkMeasuredPath, (fPath));
+            }
+            for (int i = 0; i < kLabels; ++i) {
+                SkScalar hOffset = SkIntToScalar(i * 12);
+                if (measured) {
+                    canvas->drawTextOnMeasuredPathHV(gLabel, sizeof(gLabel) - 1,
+                                                     *measured, hOffset, 0,
+                                                     paint);
+                } else {
+                    canvas->drawTextOnPathHV(gLabel, sizeof(gLabel) - 1, fPath,
+                                             hOffset, 0, paint);
+                }
+            }
+            SkSafeUnref(measured);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+/*  Many short labels sharing one font, in a few colors, as on a map tile:
+    one drawPosText per label, or all of them in a single drawPosTextRuns.
+ */
+class PosTextRunsBench : public SkBenchmark {
+    SkString    fName;
+    bool        fBatched;
+
+    enum {
+        kLabels = 500,
+        kGlyphsPerLabel = 8,
+        N = SkBENCHLOOP(10)
+    };
+
+    uint16_t                    fGlyphs[kLabels * kGlyphsPerLabel];
+    SkPoint                     fPos[kLabels * kGlyphsPerLabel];
+    SkCanvas::PosTextRun        fRuns[kLabels];
+
+public:
+    PosTextRunsBench(void* param, bool batched) : INHERITED(param) {
+        fBatched = batched;
+        fName.printf("pos_text_runs_%s", batched ? "batched" : "separate");
+
+        static const SkColor gColors[] = {
+            SK_ColorBLACK, 0xFF0000C0, 0xFF606060
+        };
+
+        SkPaint paint;
+        paint.setTextSize(SkIntToScalar(12));
+        SkRandom rand;
+        for (int i = 0; i < kLabels; ++i) {
+            uint16_t* glyphs = fGlyphs + i * kGlyphsPerLabel;
+            SkPoint* pos = fPos + i * kGlyphsPerLabel;
+            paint.textToGlyphs("Main St.", kGlyphsPerLabel, glyphs);
+            SkScalar x = rand.nextUScalar1() * 560;
+            SkScalar y = rand.nextUScalar1() * 460 + 12;
+            for (int j = 0; j < kGlyphsPerLabel; ++j) {
+                pos[j].set(x + SkIntToScalar(j * 7), y);
+            }
+            fRuns[i].fGlyphs = glyphs;
+            fRuns[i].fPos = pos;
+            fRuns[i].fCount = kGlyphsPerLabel;
+            fRuns[i].fColor = gColors[i * SK_ARRAY_COUNT(gColors) / kLabels];
+        }
+    }
+
+protected:
+    virtual const char* onGetName() { return fName.c_str(); }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setTextSize(SkIntToScalar(12));
+        paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+        for (int n = 0; n < N; ++n) {
+            if (fBatched) {
+                canvas->drawPosTextRuns(fRuns, kLabels, paint);
+            } else {
+                for (int i = 0; i < kLabels; ++i) {
+                    paint.setColor(fRuns[i].fColor);
+                    canvas->drawPosText(fRuns[i].fGlyphs,
+                                        fRuns[i].fCount * sizeof(uint16_t),
+                                        fRuns[i].fPos, paint);
+                }
+            }
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 #define STR     "Hamburgefons"
 
 static SkBenchmark* Fact01(void* p) { return new TextBench(p, STR, 16, 0xFF000000, kBW); }
@@ -158,3 +295,15 @@ static BenchRegistry gReg22(Fact22);
 static BenchRegistry gReg23(Fact23);
 
 static BenchRegistry gReg111(Fact111);
+
+static SkBenchmark* FactTOP0(void* p) { return new TextOnPathBench(p, false); }
+static SkBenchmark* FactTOP1(void* p) { return new TextOnPathBench(p, true); }
+
+static BenchRegistry gRegTOP0(FactTOP0);
+static BenchRegistry gRegTOP1(FactTOP1);
+
+static SkBenchmark* FactPTR0(void* p) { return new PosTextRunsBench(p, false); }
+static SkBenchmark* FactPTR1(void* p) { return new PosTextRunsBench(p, true); }
+
+static BenchRegistry gRegPTR0(FactPTR0);
+static BenchRegistry gRegPTR1(FactPTR1);
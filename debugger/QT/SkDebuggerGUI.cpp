@@ -268,7 +268,7 @@ public:
             return;
         }
 
-        if (stream->readBool()) {
+        if (stream->readU32()) {
             bool isValid = false;
             fPlayback = SkNEW_ARGS(SkTimedPicturePlayback,
                                    (stream, info, &isValid, decoder, offsets, deletedCommands));
@@ -934,7 +934,7 @@ public:
             return;
         }
 
-        if (stream->readBool()) {
+        if (stream->readU32()) {
             bool isValid = false;
             fPlayback = SkNEW_ARGS(SkOffsetPicturePlayback, (stream, info, &isValid, decoder));
             if (!isValid) {
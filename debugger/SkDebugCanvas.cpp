@@ -11,6 +11,7 @@
 #include "SkDrawCommand.h"
 #include "SkDevice.h"
 #include "SkImageWidget.h"
+#include "SkMeasuredPath.h"
 
 #ifdef SK_BUILD_FOR_WIN
     // iostream includes xlocale which generates warning 4530 because we're compiling without
@@ -336,6 +337,11 @@ void SkDebugCanvas::drawPosTextH(const void* text, size_t byteLength,
     addDrawCommand(new DrawPosTextH(text, byteLength, xpos, constY, paint));
 }
 
+void SkDebugCanvas::drawPosTextRuns(const PosTextRun runs[], int runCount,
+        const SkPaint& paint) {
+    addDrawCommand(new DrawPosTextRuns(runs, runCount, paint));
+}
+
 void SkDebugCanvas::drawRect(const SkRect& rect, const SkPaint& paint) {
     // NOTE(chudy): Messing up when renamed to DrawRect... Why?
     addDrawCommand(new DrawRectC(rect, paint));
@@ -361,6 +367,11 @@ void SkDebugCanvas::drawTextOnPath(const void* text, size_t byteLength,
     addDrawCommand(new DrawTextOnPath(text, byteLength, path, matrix, paint));
 }
 
+void SkDebugCanvas::drawTextOnMeasuredPath(const void* text, size_t byteLength,
+        const SkMeasuredPath& path, const SkMatrix* matrix, const SkPaint& paint) {
+    this->drawTextOnPath(text, byteLength, path.getPath(), matrix, paint);
+}
+
 void SkDebugCanvas::drawVertices(VertexMode vmode, int vertexCount,
         const SkPoint vertices[], const SkPoint texs[], const SkColor colors[],
         SkXfermode*, const uint16_t indices[], int indexCount,
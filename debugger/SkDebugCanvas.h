@@ -164,6 +164,9 @@ public:
                               const SkScalar xpos[], SkScalar constY,
                               const SkPaint&) SK_OVERRIDE;
 
+    virtual void drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                 const SkPaint&) SK_OVERRIDE;
+
     virtual void drawRect(const SkRect& rect, const SkPaint&) SK_OVERRIDE;
 
     virtual void drawRRect(const SkRRect& rrect, const SkPaint& paint) SK_OVERRIDE;
@@ -177,6 +180,10 @@ public:
     virtual void drawTextOnPath(const void* text, size_t byteLength,
                                 const SkPath& path, const SkMatrix* matrix,
                                 const SkPaint&) SK_OVERRIDE;
+    virtual void drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                        const SkMeasuredPath& path,
+                                        const SkMatrix* matrix,
+                                        const SkPaint&) SK_OVERRIDE;
 
     virtual void drawVertices(VertexMode, int vertexCount,
                               const SkPoint vertices[], const SkPoint texs[],
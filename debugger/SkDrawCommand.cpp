@@ -41,6 +41,7 @@ const char* SkDrawCommand::GetCommandString(DrawType type) {
         case DRAW_POINTS: return "Draw Points";
         case DRAW_POS_TEXT: return "Draw Pos Text";
         case DRAW_POS_TEXT_H: return "Draw Pos Text H";
+        case DRAW_POS_TEXT_RUNS: return "Draw Pos Text Runs";
         case DRAW_RECT: return "Draw Rect";
         case DRAW_RRECT: return "Draw RRect";
         case DRAW_SPRITE: return "Draw Sprite";
@@ -362,6 +363,21 @@ void DrawPosTextH::execute(SkCanvas* canvas) {
             *this->fPaint);
 }
 
+DrawPosTextRuns::DrawPosTextRuns(const SkCanvas::PosTextRun runs[],
+        int runCount, const SkPaint& paint) {
+    this->fRuns.append(runCount, runs);
+    this->fPaint = &paint;
+    this->fDrawType = DRAW_POS_TEXT_RUNS;
+
+    this->fInfo.push(SkObjectParser::IntToString(runCount, "Run count: "));
+    this->fInfo.push(SkObjectParser::PaintToString(paint));
+}
+
+void DrawPosTextRuns::execute(SkCanvas* canvas) {
+    canvas->drawPosTextRuns(this->fRuns.begin(), this->fRuns.count(),
+            *this->fPaint);
+}
+
 DrawRectC::DrawRectC(const SkRect& rect, const SkPaint& paint) {
     this->fRect = &rect;
     this->fPaint = &paint;
@@ -283,6 +283,16 @@ private:
     const SkPaint* fPaint;
 };
 
+class DrawPosTextRuns : public SkDrawCommand {
+public:
+    DrawPosTextRuns(const SkCanvas::PosTextRun runs[], int runCount,
+            const SkPaint& paint);
+    virtual void execute(SkCanvas* canvas) SK_OVERRIDE;
+private:
+    SkTDArray<SkCanvas::PosTextRun> fRuns;
+    const SkPaint* fPaint;
+};
+
 class DrawRectC : public SkDrawCommand {
 public:
     DrawRectC(const SkRect& rect, const SkPaint& paint);
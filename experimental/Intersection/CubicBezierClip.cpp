@@ -74,13 +74,13 @@ bool bezier_clip(const Cubic& cubic1, const Cubic& cubic2, double& minT, double&
     char to_0[2];
     char to_3[2];
     bool do_1_2_edge = convex_x_hull(distance2y, to_0, to_3);
-    x_at(distance2y[0], distance2y[to_0[0]], top, bottom, flags, minT, maxT);
+    x_at(distance2y[0], distance2y[(int)to_0[0]], top, bottom, flags, minT, maxT);
     if (to_0[0] != to_0[1]) {
-        x_at(distance2y[0], distance2y[to_0[1]], top, bottom, flags, minT, maxT);
+        x_at(distance2y[0], distance2y[(int)to_0[1]], top, bottom, flags, minT, maxT);
     }
-    x_at(distance2y[to_3[0]], distance2y[3], top, bottom, flags, minT, maxT);
+    x_at(distance2y[(int)to_3[0]], distance2y[3], top, bottom, flags, minT, maxT);
     if (to_3[0] != to_3[1]) {
-        x_at(distance2y[to_3[1]], distance2y[3], top, bottom, flags, minT, maxT);
+        x_at(distance2y[(int)to_3[1]], distance2y[3], top, bottom, flags, minT, maxT);
     }
     if (do_1_2_edge) {
         x_at(distance2y[1], distance2y[2], top, bottom, flags, minT, maxT);
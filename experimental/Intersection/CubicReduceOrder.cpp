@@ -129,16 +129,16 @@ static int check_linear(const Cubic& cubic, Cubic& reduction,
         // sameSide > 0 means mid is smaller than either [0] or [3], so replace smaller
         int replace;
         if (useX) {
-            if (extrema.x < cubic[0].x ^ extrema.x < cubic[3].x) {
+            if ((extrema.x < cubic[0].x) ^ (extrema.x < cubic[3].x)) {
                 continue;
             }
-            replace = (extrema.x < cubic[0].x | extrema.x < cubic[3].x)
+            replace = ((extrema.x < cubic[0].x) | (extrema.x < cubic[3].x))
                     ^ (cubic[0].x < cubic[3].x);
         } else {
-            if (extrema.y < cubic[0].y ^ extrema.y < cubic[3].y) {
+            if ((extrema.y < cubic[0].y) ^ (extrema.y < cubic[3].y)) {
                 continue;
             }
-            replace = (extrema.y < cubic[0].y | extrema.y < cubic[3].y)
+            replace = ((extrema.y < cubic[0].y) | (extrema.y < cubic[3].y))
                     ^ (cubic[0].y < cubic[3].y);
         }
         reduction[replace] = extrema;
@@ -165,10 +165,6 @@ void xy_at_t(const Cubic& cubic, double t, double& x, double& y) {
     double t2 = t * t;
     double c = 3 * one_t * t2;
     double d = t2 * t;
-    if (&x) {
-        x = a * cubic[0].x + b * cubic[1].x + c * cubic[2].x + d * cubic[3].x;
-    }
-    if (&y) {
-        y = a * cubic[0].y + b * cubic[1].y + c * cubic[2].y + d * cubic[3].y;
-    }
+    x = a * cubic[0].x + b * cubic[1].x + c * cubic[2].x + d * cubic[3].x;
+    y = a * cubic[0].y + b * cubic[1].y + c * cubic[2].y + d * cubic[3].y;
 }
@@ -147,23 +147,23 @@ static void CubicXYAtT(const SkPoint a[4], double t, SkPoint* out) {
 
 static SkScalar LineYAtT(const SkPoint a[2], double t) {
     const _Line aLine = {{a[0].fX, a[0].fY}, {a[1].fX, a[1].fY}};
-    double y;
-    xy_at_t(aLine, t, *(double*) 0, y);
+    double x, y;
+    xy_at_t(aLine, t, x, y);
     return SkDoubleToScalar(y);
 }
 
 static SkScalar QuadYAtT(const SkPoint a[3], double t) {
     const Quadratic quad = {{a[0].fX, a[0].fY}, {a[1].fX, a[1].fY}, {a[2].fX, a[2].fY}};
-    double y;
-    xy_at_t(quad, t, *(double*) 0, y);
+    double x, y;
+    xy_at_t(quad, t, x, y);
     return SkDoubleToScalar(y);
 }
 
 static SkScalar CubicYAtT(const SkPoint a[4], double t) {
     const Cubic cubic = {{a[0].fX, a[0].fY}, {a[1].fX, a[1].fY}, {a[2].fX, a[2].fY},
             {a[3].fX, a[3].fY}};
-    double y;
-    xy_at_t(cubic, t, *(double*) 0, y);
+    double x, y;
+    xy_at_t(cubic, t, x, y);
     return SkDoubleToScalar(y);
 }
 
@@ -33,7 +33,7 @@ given that:
    (0, 1) ^ 3 -> (3, 2)  (0, 2) ^ 3 -> (3, 1)  (1, 3) ^ 3 -> (2, 0)  (2, 3) ^ 3 -> (1, 0)
 */
 inline int other_two(int one, int two) {
-    return 1 >> 3 - (one ^ two) ^ 3;
+    return (1 >> (3 - (one ^ two))) ^ 3;
 }
 
 /* Returns -1 if negative, 0 if zero, 1 if positive
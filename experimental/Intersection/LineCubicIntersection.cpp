@@ -125,9 +125,9 @@ int horizontalIntersect(double axisIntercept, double left, double right, bool fl
     double rootVals[3];
     int roots = horizontalIntersect(axisIntercept, rootVals);
     for (int index = 0; index < roots; ++index) {
-        double x;
+        double x, y;
         double cubicT = rootVals[index];
-        xy_at_t(cubic, cubicT, x, *(double*) NULL);
+        xy_at_t(cubic, cubicT, x, y);
         double lineT = (x - left) / (right - left);
         if (pinTs(cubicT, lineT)) {
             intersections.insert(cubicT, lineT);
@@ -151,9 +151,9 @@ int verticalIntersect(double axisIntercept, double top, double bottom, bool flip
     double rootVals[3];
     int roots = verticalIntersect(axisIntercept, rootVals);
     for (int index = 0; index < roots; ++index) {
-        double y;
+        double x, y;
         double cubicT = rootVals[index];
-        xy_at_t(cubic, cubicT, *(double*) NULL, y);
+        xy_at_t(cubic, cubicT, x, y);
         double lineT = (y - top) / (bottom - top);
         if (pinTs(cubicT, lineT)) {
             intersections.insert(cubicT, lineT);
@@ -156,9 +156,9 @@ int horizontalIntersect(double axisIntercept, double left, double right, bool fl
     double rootVals[2];
     int roots = horizontalIntersect(axisIntercept, rootVals);
     for (int index = 0; index < roots; ++index) {
-        double x;
+        double x, y;
         double quadT = rootVals[index];
-        xy_at_t(quad, quadT, x, *(double*) NULL);
+        xy_at_t(quad, quadT, x, y);
         double lineT = (x - left) / (right - left);
         if (pinTs(quadT, lineT)) {
             intersections.insert(quadT, lineT);
@@ -185,9 +185,9 @@ int verticalIntersect(double axisIntercept, double top, double bottom, bool flip
     double rootVals[2];
     int roots = verticalIntersect(axisIntercept, rootVals);
     for (int index = 0; index < roots; ++index) {
-        double y;
+        double x, y;
         double quadT = rootVals[index];
-        xy_at_t(quad, quadT, *(double*) NULL, y);
+        xy_at_t(quad, quadT, x, y);
         double lineT = (y - top) / (bottom - top);
         if (pinTs(quadT, lineT)) {
             intersections.insert(quadT, lineT);
@@ -295,9 +295,9 @@ static double horizontalIntersect(const Quadratic& quad, const _Point& pt) {
     double rootVals[2];
     int roots = q.horizontalIntersect(pt.y, rootVals);
     for (int index = 0; index < roots; ++index) {
-        double x;
+        double x, y;
         double t = rootVals[index];
-        xy_at_t(quad, t, x, *(double*) 0);
+        xy_at_t(quad, t, x, y);
         if (AlmostEqualUlps(x, pt.x)) {
             return t;
         }
@@ -310,9 +310,9 @@ static double verticalIntersect(const Quadratic& quad, const _Point& pt) {
     double rootVals[2];
     int roots = q.verticalIntersect(pt.x, rootVals);
     for (int index = 0; index < roots; ++index) {
-        double y;
+        double x, y;
         double t = rootVals[index];
-        xy_at_t(quad, t, *(double*) 0, y);
+        xy_at_t(quad, t, x, y);
         if (AlmostEqualUlps(y, pt.y)) {
             return t;
         }
@@ -96,16 +96,16 @@ static int check_linear(const Quadratic& quad, Quadratic& reduction,
         // sameSide > 0 means mid is smaller than either [0] or [2], so replace smaller
         int replace;
         if (useX) {
-            if (extrema.x < quad[0].x ^ extrema.x < quad[2].x) {
+            if ((extrema.x < quad[0].x) ^ (extrema.x < quad[2].x)) {
                 return 2;
             }
-            replace = (extrema.x < quad[0].x | extrema.x < quad[2].x)
+            replace = ((extrema.x < quad[0].x) | (extrema.x < quad[2].x))
                     ^ (quad[0].x < quad[2].x);
         } else {
-            if (extrema.y < quad[0].y ^ extrema.y < quad[2].y) {
+            if ((extrema.y < quad[0].y) ^ (extrema.y < quad[2].y)) {
                 return 2;
             }
-            replace = (extrema.y < quad[0].y | extrema.y < quad[2].y)
+            replace = ((extrema.y < quad[0].y) | (extrema.y < quad[2].y))
                     ^ (quad[0].y < quad[2].y);
         }
         reduction[replace] = extrema;
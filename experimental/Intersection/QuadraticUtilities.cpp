@@ -92,10 +92,6 @@ void xy_at_t(const Quadratic& quad, double t, double& x, double& y) {
     double a = one_t * one_t;
     double b = 2 * one_t * t;
     double c = t * t;
-    if (&x) {
-        x = a * quad[0].x + b * quad[1].x + c * quad[2].x;
-    }
-    if (&y) {
-        y = a * quad[0].y + b * quad[1].y + c * quad[2].y;
-    }
+    x = a * quad[0].x + b * quad[1].x + c * quad[2].x;
+    y = a * quad[0].y + b * quad[1].y + c * quad[2].y;
 }
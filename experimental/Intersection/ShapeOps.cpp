@@ -17,7 +17,7 @@ namespace Op {
 // other code that walks winding in angles
 // OPTIMIZATION: Probably, the walked winding should be rolled into the angle structure
 // so it isn't duplicated by walkers like this one
-static Segment* findChaseOp(SkTDArray<Span*>& chase, int& nextStart, int& nextEnd) {
+static Segment* findChaseOp(Chase& chase, int& nextStart, int& nextEnd) {
     while (chase.count()) {
         Span* span;
         chase.pop(&span);
@@ -31,7 +31,7 @@ static Segment* findChaseOp(SkTDArray<Span*>& chase, int& nextStart, int& nextEn
             nextStart = last->start();
             nextEnd = last->end();
    #if TRY_ROTATE
-            *chase.insert(0) = span;
+            *chase.prepend() = span;
    #else
             *chase.append() = span;
    #endif
@@ -91,7 +91,7 @@ static Segment* findChaseOp(SkTDArray<Span*>& chase, int& nextStart, int& nextEn
         } while (++nextIndex != lastIndex);
         if (first) {
        #if TRY_ROTATE
-            *chase.insert(0) = span;
+            *chase.prepend() = span;
        #else
             *chase.append() = span;
        #endif
@@ -129,13 +129,15 @@ static bool windingIsActive(int winding, int oppWinding, int spanWinding, int op
 }
 */
 
+// returns false if the walk reached an edge it had already consumed, or could
+// not sort the edges at a junction; then no result can be trusted
 static bool bridgeOp(SkTDArray<Contour*>& contourList, const ShapeOp op,
-        const int xorMask, const int xorOpMask, PathWrapper& simple) {
+        const int xorMask, const int xorOpMask, PathWrapper& simple, bool& closable) {
     bool firstContour = true;
     bool unsortable = false;
     bool topUnsortable = false;
     bool firstRetry = false;
-    bool closable = true;
+    closable = true;
     SkPoint topLeft = {SK_ScalarMin, SK_ScalarMin};
     do {
         int index, endIndex;
@@ -144,15 +146,17 @@ static bool bridgeOp(SkTDArray<Contour*>& contourList, const ShapeOp op,
                 topUnsortable, done, true);
         if (!current) {
             if (topUnsortable || !done) {
+                if (firstRetry) {
+                    return false;
+                }
                 topUnsortable = false;
-                SkASSERT(!firstRetry);
                 firstRetry = true;
                 topLeft.fX = topLeft.fY = SK_ScalarMin;
                 continue;
             }
             break;
         }
-        SkTDArray<Span*> chaseArray;
+        Chase chaseArray;
         do {
             if (current->activeOp(index, endIndex, xorMask, xorOpMask, op)) {
                 bool active = true;
@@ -162,14 +166,18 @@ static bool bridgeOp(SkTDArray<Contour*>& contourList, const ShapeOp op,
                         debugShowActiveSpans(contourList);
                     }
             #endif
-                    SkASSERT(unsortable || !current->done());
+                    if (!unsortable && current->done()) {
+                        return false;
+                    }
                     int nextStart = index;
                     int nextEnd = endIndex;
                     Segment* next = current->findNextOp(chaseArray, nextStart, nextEnd,
                             unsortable, op, xorMask, xorOpMask);
                     if (!next) {
-                        SkASSERT(!unsortable);
-                        if (!unsortable && simple.hasMove()
+                        if (unsortable) {
+                            return false;
+                        }
+                        if (simple.hasMove()
                                 && current->verb() != SkPath::kLine_Verb
                                 && !simple.isClosed()) {
                             current->addCurveTo(index, endIndex, simple, true);
@@ -184,7 +192,9 @@ static bool bridgeOp(SkTDArray<Contour*>& contourList, const ShapeOp op,
                     endIndex = nextEnd;
                 } while (!simple.isClosed() && ((!unsortable) || !current->done()));
                 if (active && !simple.isClosed()) {
-                    SkASSERT(unsortable);
+                    if (!unsortable) {
+                        return false;
+                    }
                     int min = SkMin32(index, endIndex);
                     if (!current->done(min)) {
                         current->addCurveTo(index, endIndex, simple, true);
@@ -208,13 +218,13 @@ static bool bridgeOp(SkTDArray<Contour*>& contourList, const ShapeOp op,
             }
         } while (true);
     } while (true);
-    return closable;
+    return true;
 }
 
 } // end of Op namespace
 
 
-void operate(const SkPath& one, const SkPath& two, ShapeOp op, SkPath& result) {
+bool operate(const SkPath& one, const SkPath& two, ShapeOp op, SkPath& result) {
     result.reset();
     result.setFillType(SkPath::kEvenOdd_FillType);
     // turn path into list of segments
@@ -228,20 +238,10 @@ void operate(const SkPath& one, const SkPath& two, ShapeOp op, SkPath& result) {
     SkTDArray<Op::Contour*> contourList;
     makeContourList(contours, contourList, xorMask == kEvenOdd_Mask,
             xorOpMask == kEvenOdd_Mask);
-    Op::Contour** currentPtr = contourList.begin();
-    if (!currentPtr) {
-        return;
+    if (!contourList.count()) {
+        return true;
     }
-    Op::Contour** listEnd = contourList.end();
-    // find all intersections between segments
-    do {
-        Op::Contour** nextPtr = currentPtr;
-        Op::Contour* current = *currentPtr++;
-        Op::Contour* next;
-        do {
-            next = *nextPtr++;
-        } while (addIntersectTs(current, next) && nextPtr != listEnd);
-    } while (currentPtr != listEnd);
+    addIntersectTs(contourList);
     // eat through coincident edges
 
     int total = 0;
@@ -263,5 +263,16 @@ void operate(const SkPath& one, const SkPath& two, ShapeOp op, SkPath& result) {
 #endif
     // construct closed contours
     Op::PathWrapper wrapper(result);
-    bridgeOp(contourList, op, xorMask, xorOpMask, wrapper);
+    bool closable;
+    if (!bridgeOp(contourList, op, xorMask, xorOpMask, wrapper, closable)) {
+        return false;
+    }
+    if (!closable) { // if some edges could not be resolved, assemble remaining fragments
+        SkPath temp;
+        temp.setFillType(SkPath::kEvenOdd_FillType);
+        Op::PathWrapper assembled(temp);
+        assemble(wrapper, assembled);
+        result = *assembled.nativePath();
+    }
+    return true;
 }
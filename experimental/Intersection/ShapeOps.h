@@ -29,8 +29,9 @@ enum ShapeOpMask {
 };
 #endif
 
-void operate(const SkPath& one, const SkPath& two, ShapeOp op, SkPath& result);
-void simplifyx(const SkPath& path, SkPath& simple);
+// return false if the edges are too degenerate for the walker to resolve
+bool operate(const SkPath& one, const SkPath& two, ShapeOp op, SkPath& result);
+bool simplifyx(const SkPath& path, SkPath& simple);
 
 // FIXME: remove this section once debugging is complete
 extern const bool gRunTestsInOneThread;
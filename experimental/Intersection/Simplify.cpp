@@ -6,8 +6,13 @@
  */
 #include "Simplify.h"
 
+// The edge test harness defines SK_DEBUG_PATH_OPS, which traces the algorithm
+// and makes every assert fatal, even in release builds. Without it, as in the
+// pathops library, asserts are the usual debug-only ones and nothing is traced.
+#ifdef SK_DEBUG_PATH_OPS
 #undef SkASSERT
 #define SkASSERT(cond) while (!(cond)) { sk_throw(); }
+#endif
 
 // Terminology:
 // A Path contains one of more Contours
@@ -33,7 +38,7 @@ int gDebugMaxWindValue = SK_MaxS32;
 #define DEBUG_UNUSED 0 // set to expose unused functions
 #define FORCE_RELEASE 0  // set force release to 1 for multiple thread -- no debugging
 
-#if FORCE_RELEASE || defined SK_RELEASE
+#if FORCE_RELEASE || defined SK_RELEASE || !defined SK_DEBUG_PATH_OPS
 
 const bool gRunTestsInOneThread = false;
 
@@ -245,22 +250,22 @@ static void (* const SegmentXYAtT[])(const SkPoint [], double , SkPoint* ) = {
 
 static SkScalar LineXAtT(const SkPoint a[2], double t) {
     MAKE_CONST_LINE(aLine, a);
-    double x;
-    xy_at_t(aLine, t, x, *(double*) 0);
+    double x, y;
+    xy_at_t(aLine, t, x, y);
     return SkDoubleToScalar(x);
 }
 
 static SkScalar QuadXAtT(const SkPoint a[3], double t) {
     MAKE_CONST_QUAD(quad, a);
-    double x;
-    xy_at_t(quad, t, x, *(double*) 0);
+    double x, y;
+    xy_at_t(quad, t, x, y);
     return SkDoubleToScalar(x);
 }
 
 static SkScalar CubicXAtT(const SkPoint a[4], double t) {
     MAKE_CONST_CUBIC(cubic, a);
-    double x;
-    xy_at_t(cubic, t, x, *(double*) 0);
+    double x, y;
+    xy_at_t(cubic, t, x, y);
     return SkDoubleToScalar(x);
 }
 
@@ -273,22 +278,22 @@ static SkScalar (* const SegmentXAtT[])(const SkPoint [], double ) = {
 
 static SkScalar LineYAtT(const SkPoint a[2], double t) {
     MAKE_CONST_LINE(aLine, a);
-    double y;
-    xy_at_t(aLine, t, *(double*) 0, y);
+    double x, y;
+    xy_at_t(aLine, t, x, y);
     return SkDoubleToScalar(y);
 }
 
 static SkScalar QuadYAtT(const SkPoint a[3], double t) {
     MAKE_CONST_QUAD(quad, a);
-    double y;
-    xy_at_t(quad, t, *(double*) 0, y);
+    double x, y;
+    xy_at_t(quad, t, x, y);
     return SkDoubleToScalar(y);
 }
 
 static SkScalar CubicYAtT(const SkPoint a[4], double t) {
     MAKE_CONST_CUBIC(cubic, a);
-    double y;
-    xy_at_t(cubic, t, *(double*) 0, y);
+    double x, y;
+    xy_at_t(cubic, t, x, y);
     return SkDoubleToScalar(y);
 }
 
@@ -488,9 +493,9 @@ static bool CubicIsLinear(const SkPoint a[4]) {
 
 static SkScalar LineLeftMost(const SkPoint a[2], double startT, double endT) {
     MAKE_CONST_LINE(aLine, a);
-    double x[2];
-    xy_at_t(aLine, startT, x[0], *(double*) 0);
-    xy_at_t(aLine, endT, x[1], *(double*) 0);
+    double x[2], y;
+    xy_at_t(aLine, startT, x[0], y);
+    xy_at_t(aLine, endT, x[1], y);
     return SkMinScalar((float) x[0], (float) x[1]);
 }
 
@@ -528,9 +533,9 @@ static int QuadRayIntersect(const SkPoint a[3], const _Line& bLine,
 
 static bool LineVertical(const SkPoint a[2], double startT, double endT) {
     MAKE_CONST_LINE(aLine, a);
-    double x[2];
-    xy_at_t(aLine, startT, x[0], *(double*) 0);
-    xy_at_t(aLine, endT, x[1], *(double*) 0);
+    double x[2], y;
+    xy_at_t(aLine, startT, x[0], y);
+    xy_at_t(aLine, endT, x[1], y);
     return AlmostEqualUlps((float) x[0], (float) x[1]);
 }
 
@@ -566,12 +571,53 @@ struct Span {
     int fOppSum; // for binary operators: the opposite winding sum
     int fWindValue; // 0 == canceled; 1 == normal; >1 == coincident
     int fOppValue; // normally 0 -- when binary coincident edges combine, opp value goes here
+                   // (negative if the other operand's edge runs the opposite way)
     bool fDone; // if set, this span to next higher T has been processed
     bool fUnsortableStart; // set when start is part of an unsortable pair
     bool fUnsortableEnd; // set when end is part of an unsortable pair
     bool fTiny; // if set, span may still be considered once for edge following
 };
 
+// The spans left to chase. They are taken from the back, and with TRY_ROTATE,
+// put back at the front to be tried again after the rest. There may be as many
+// as there are segments, so room is kept at the front to put them back without
+// moving all the others each time.
+class Chase {
+public:
+    Chase()
+        : fFirst(0) {
+    }
+
+    Span** append() {
+        return fSpans.append();
+    }
+
+    int count() const {
+        return fSpans.count() - fFirst;
+    }
+
+    void pop(Span** span) {
+        SkASSERT(count() > 0);
+        fSpans.pop(span);
+        if (fSpans.count() == fFirst) {
+            fSpans.rewind();
+            fFirst = 0;
+        }
+    }
+
+    Span** prepend() {
+        if (!fFirst) {
+            fFirst = SkMax32(fSpans.count(), 8);
+            fSpans.insert(0, fFirst);
+        }
+        return &fSpans[--fFirst];
+    }
+
+private:
+    SkTDArray<Span*> fSpans; // the first fFirst entries are unused
+    int fFirst;
+};
+
 // sorting angles
 // given angles of {dx dy ddx ddy dddx dddy} sort them
 class Angle {
@@ -656,6 +702,12 @@ public:
             rh.fUnsortable = true;
             return this < &rh; // even with no solution, return a stable sort
         }
+        if (fVerb == SkPath::kLine_Verb || rh.fVerb == SkPath::kLine_Verb) {
+            // a line coincident with another edge that was not merged with it
+            fUnsortable = true;
+            rh.fUnsortable = true;
+            return this < &rh; // even with no solution, return a stable sort
+        }
         SkASSERT(fVerb == SkPath::kQuad_Verb); // worry about cubics later
         SkASSERT(rh.fVerb == SkPath::kQuad_Verb);
         // FIXME: until I can think of something better, project a ray from the
@@ -961,16 +1013,16 @@ static bool useInnerWinding(int outerWinding, int innerWinding) {
     return result;
 }
 
-#define F (false)      // discard the edge
-#define T (true)       // keep the edge
+#define F (0)          // discard the edge
+#define T (1)          // keep the edge
 
-static const bool gUnaryActiveEdge[2][2] = {
+static const int gUnaryActiveEdge[2][2] = {
 //  from=0  from=1
 //  to=0,1  to=0,1
     {F, T}, {T, F},
 };
 
-static const bool gActiveEdge[kShapeOp_Count][2][2][2][2] = {
+static const int gActiveEdge[kShapeOp_Count][2][2][2][2] = {
 //                 miFrom=0                              miFrom=1
 //         miTo=0            miTo=1              miTo=0             miTo=1
 //    suFrom=0    1     suFrom=0     1      suFrom=0    1      suFrom=0    1
@@ -1265,9 +1317,9 @@ public:
             suFrom = (oppMaxWinding & xorSuMask) != 0;
             suTo = (oppSumWinding & xorSuMask) != 0;
         }
-        bool result = gActiveEdge[op][miFrom][miTo][suFrom][suTo];
+        int result = gActiveEdge[op][miFrom][miTo][suFrom][suTo];
         SkASSERT(result != -1);
-        return result;
+        return result != 0;
     }
 
     bool activeWinding(int index, int endIndex) {
@@ -1280,9 +1332,9 @@ public:
         setUpWinding(index, endIndex, maxWinding, sumWinding);
         bool from = maxWinding != 0;
         bool to = sumWinding  != 0;
-        bool result = gUnaryActiveEdge[from][to];
+        int result = gUnaryActiveEdge[from][to];
         SkASSERT(result != -1);
-        return result;
+        return result != 0;
     }
 
     void addAngle(SkTDArray<Angle>& angles, int start, int end) const {
@@ -1595,6 +1647,9 @@ public:
 
     // set spans from start to end to decrement by one
     // note this walks other backwards
+    // if the segments belong to different operands, the larger winding keeps
+    // the edge and records the other operand running against it as a
+    // negative opp value
     // FIMXE: there's probably an edge case that can be constructed where
     // two span in one segment are separated by float epsilon on one span but
     // not the other, if one segment is very small. For this
@@ -1620,14 +1675,19 @@ public:
         SkTDArray<double> outsideTs;
         SkTDArray<double> oOutsideTs;
         do {
-            bool decrement = test->fWindValue && oTest->fWindValue && !binary;
+            bool decrement = test->fWindValue && oTest->fWindValue;
             bool track = test->fWindValue || oTest->fWindValue;
+            bool bigger = test->fWindValue >= oTest->fWindValue;
             double testT = test->fT;
             double oTestT = oTest->fT;
             Span* span = test;
             do {
                 if (decrement) {
-                    decrementSpan(span);
+                    if (binary && bigger) {
+                        span->fOppValue--;
+                    } else {
+                        decrementSpan(span);
+                    }
                 } else if (track && span->fT < 1 && oTestT < 1) {
                     TrackOutside(outsideTs, span->fT, oTestT);
                 }
@@ -1643,7 +1703,11 @@ public:
                 SkASSERT(originalWindValue == oSpan->fWindValue);
         #endif
                 if (decrement) {
-                    other.decrementSpan(oSpan);
+                    if (binary && !bigger) {
+                        oSpan->fOppValue--;
+                    } else {
+                        other.decrementSpan(oSpan);
+                    }
                 } else if (track && oSpan->fT < 1 && testT < 1) {
                     TrackOutside(oOutsideTs, oSpan->fT, testT);
                 }
@@ -1778,6 +1842,35 @@ public:
         }
     }
 
+    // a junction found on one of two coincident lines is on both; pair each
+    // T inside the overlap with the matching T on the other line, so that the
+    // edges meeting there are found from either line
+    void addCoincidentTs(double startT, double endT, Segment& other,
+            double oStartT, double oEndT, bool cancelers) {
+        if (fVerb != SkPath::kLine_Verb || other.fVerb != SkPath::kLine_Verb) {
+            return;
+        }
+        SkTDArray<double> innerTs;
+        int tCount = fTs.count();
+        for (int index = 0; index < tCount; ++index) {
+            double t = fTs[index].fT;
+            if (approximately_negative(t - startT) || approximately_negative(endT - t)) {
+                continue;
+            }
+            if (innerTs.count() && approximately_equal(innerTs.end()[-1], t)) {
+                continue;
+            }
+            *innerTs.append() = t;
+        }
+        double tRatio = (oEndT - oStartT) / (endT - startT);
+        for (int index = 0; index < innerTs.count(); ++index) {
+            double t = innerTs[index];
+            double otherT = cancelers ? oEndT - (t - startT) * tRatio
+                    : oStartT + (t - startT) * tRatio;
+            addTPair(t, other, otherT, true);
+        }
+    }
+
     // FIXME: this doesn't prevent the same span from being added twice
     // fix in caller, assert here?
     void addTPair(double t, Segment& other, double otherT, bool borrowWind) {
@@ -1811,14 +1904,14 @@ public:
     void addTwoAngles(int start, int end, SkTDArray<Angle>& angles) const {
         // add edge leading into junction
         int min = SkMin32(end, start);
-        if (fTs[min].fWindValue > 0 || fTs[min].fOppValue > 0) {
+        if (fTs[min].fWindValue > 0 || fTs[min].fOppValue != 0) {
             addAngle(angles, end, start);
         }
         // add edge leading away from junction
         int step = SkSign32(end - start);
         int tIndex = nextExactSpan(end, step);
         min = SkMin32(end, tIndex);
-        if (tIndex >= 0 && (fTs[min].fWindValue > 0 || fTs[min].fOppValue > 0)) {
+        if (tIndex >= 0 && (fTs[min].fWindValue > 0 || fTs[min].fOppValue != 0)) {
             addAngle(angles, end, tIndex);
         }
     }
@@ -2093,7 +2186,6 @@ public:
         span->fWindValue += windDelta;
         SkASSERT(span->fWindValue >= 0);
         span->fOppValue += oppDelta;
-        SkASSERT(span->fOppValue >= 0);
         if (fXor) {
             span->fWindValue &= 1;
         }
@@ -2152,7 +2244,7 @@ public:
      Opposite values result from combining coincident spans.
      */
 
-    Segment* findNextOp(SkTDArray<Span*>& chase, int& nextStart, int& nextEnd,
+    Segment* findNextOp(Chase& chase, int& nextStart, int& nextEnd,
             bool& unsortable, ShapeOp op, const int xorMiMask, const int xorSuMask) {
         const int startIndex = nextStart;
         const int endIndex = nextEnd;
@@ -2179,11 +2271,17 @@ public:
             nextStart = endSpan->fOtherIndex;
             double startT = other->fTs[nextStart].fT;
             nextEnd = nextStart;
+            int otherCount = other->fTs.count();
             do {
                 nextEnd += step;
+                if (step < 0 ? nextEnd < 0 : nextEnd >= otherCount) {
+                    // the other edge ends here; it was merged with a
+                    // coincident edge and cannot be followed
+                    unsortable = true;
+                    return NULL;
+                }
             }
             while (precisely_zero(startT - other->fTs[nextEnd].fT));
-            SkASSERT(step < 0 ? nextEnd >= 0 : nextEnd < other->fTs.count());
             return other;
         }
         // more than one viable candidate -- measure angles to find best
@@ -2196,7 +2294,10 @@ public:
         bool sortable = SortAngles(angles, sorted);
         int angleCount = angles.count();
         int firstIndex = findStartingEdge(sorted, startIndex, end);
-        SkASSERT(firstIndex >= 0);
+        if (firstIndex < 0) { // the edge arriving here was merged away
+            unsortable = true;
+            return NULL;
+        }
     #if DEBUG_SORT
         debugShowSort(__FUNCTION__, sorted, firstIndex);
     #endif
@@ -2266,7 +2367,7 @@ public:
         return nextSegment;
     }
 
-    Segment* findNextWinding(SkTDArray<Span*>& chase, int& nextStart, int& nextEnd,
+    Segment* findNextWinding(Chase& chase, int& nextStart, int& nextEnd,
             bool& unsortable) {
         const int startIndex = nextStart;
         const int endIndex = nextEnd;
@@ -2293,11 +2394,17 @@ public:
             nextStart = endSpan->fOtherIndex;
             double startT = other->fTs[nextStart].fT;
             nextEnd = nextStart;
+            int otherCount = other->fTs.count();
             do {
                 nextEnd += step;
+                if (step < 0 ? nextEnd < 0 : nextEnd >= otherCount) {
+                    // the other edge ends here; it was merged with a
+                    // coincident edge and cannot be followed
+                    unsortable = true;
+                    return NULL;
+                }
             }
             while (precisely_zero(startT - other->fTs[nextEnd].fT));
-            SkASSERT(step < 0 ? nextEnd >= 0 : nextEnd < other->fTs.count());
             return other;
         }
         // more than one viable candidate -- measure angles to find best
@@ -2310,7 +2417,10 @@ public:
         bool sortable = SortAngles(angles, sorted);
         int angleCount = angles.count();
         int firstIndex = findStartingEdge(sorted, startIndex, end);
-        SkASSERT(firstIndex >= 0);
+        if (firstIndex < 0) { // the edge arriving here was merged away
+            unsortable = true;
+            return NULL;
+        }
     #if DEBUG_SORT
         debugShowSort(__FUNCTION__, sorted, firstIndex);
     #endif
@@ -2449,7 +2559,10 @@ public:
         }
         int angleCount = angles.count();
         int firstIndex = findStartingEdge(sorted, startIndex, end);
-        SkASSERT(firstIndex >= 0);
+        if (firstIndex < 0) { // the edge arriving here was merged away
+            unsortable = true;
+            return NULL;
+        }
     #if DEBUG_SORT
         debugShowSort(__FUNCTION__, sorted, firstIndex, 0, 0);
     #endif
@@ -2580,7 +2693,10 @@ public:
                         moStart = -1;
                         break;
                     }
-                    SkASSERT(moEnd == -1);
+                    if (moEnd >= 0) { // the lines are coincident, and already merged
+                        moStart = -1;
+                        break;
+                    }
                     moEnd = moIndex;
                     moEndT = moSpan.fT;
                 }
@@ -2612,7 +2728,10 @@ public:
                         moStart = -1;
                         break;
                     }
-                    SkASSERT(toEnd == -1);
+                    if (toEnd >= 0) { // the lines are coincident, and already merged
+                        toStart = -1;
+                        break;
+                    }
                     toEnd = toIndex;
                     toEndT = toSpan.fT;
                 }
@@ -2675,7 +2794,10 @@ public:
             lastDone = span.fDone;
             lastUnsortable = span.fUnsortableEnd;
         }
-        SkASSERT(firstT >= 0);
+        if (firstT < 0) { // every remaining span ends in an unsortable junction
+            unsortable = true;
+            return NULL;
+        }
         // sort the edges to find the leftmost
         int step = 1;
         int end = nextSpan(firstT, step);
@@ -2703,7 +2825,11 @@ public:
         firstT = -1;
         Segment* leftSegment;
         do {
-            const Angle* angle = sorted[++firstT];
+            if (++firstT >= sorted.count()) {
+                unsortable = true;
+                return NULL;
+            }
+            const Angle* angle = sorted[firstT];
             SkASSERT(!onlySortable || !angle->unsortable());
             leftSegment = angle->segment();
             tIndex = angle->end();
@@ -2797,10 +2923,15 @@ the same winding is shared by both.
         int oppLocal = oppSign(start, end);
         SkASSERT(hitOppDx || !oppWind || !oppLocal);
         int oppWindVal = oppValue(SkMin32(start, end));
+        SkScalar oppDx = dx;
+        if (oppWindVal < 0) { // the other operand's edge runs the opposite way
+            oppWindVal = -oppWindVal;
+            oppDx = -oppDx;
+        }
         if (!oppWind) {
-            oppWind = dx < 0 ? oppWindVal : -oppWindVal;
-        } else if (hitOppDx * dx >= 0) {
-            int oppSideWind = oppWind + (dx < 0 ? oppWindVal : -oppWindVal);
+            oppWind = oppDx < 0 ? oppWindVal : -oppWindVal;
+        } else if (hitOppDx * oppDx >= 0) {
+            int oppSideWind = oppWind + (oppDx < 0 ? oppWindVal : -oppWindVal);
             if (abs(oppWind) < abs(oppSideWind)) {
                 oppWind = oppSideWind;
             }
@@ -2961,7 +3092,7 @@ the same winding is shared by both.
         Segment* other = this;
         while ((other = other->nextChase(index, step, min, last))) {
             if (other->fTs[min].fWindSum != SK_MinS32) {
-                SkASSERT(other->fTs[min].fWindSum == winding);
+                SkASSERT(other->windSumMatches(other->fTs[min].fWindSum, winding));
                 return NULL;
             }
             other->markWinding(min, winding);
@@ -2977,7 +3108,7 @@ the same winding is shared by both.
         Segment* other = this;
         while ((other = other->nextChase(index, step, min, last))) {
             if (other->fTs[min].fWindSum != SK_MinS32) {
-                SkASSERT(other->fTs[min].fWindSum == winding);
+                SkASSERT(other->windSumMatches(other->fTs[min].fWindSum, winding));
                 return NULL;
             }
             other->markWinding(min, winding, oppWinding);
@@ -3142,7 +3273,7 @@ the same winding is shared by both.
     #if DEBUG_MARK_DONE
         debugShowNewWinding(funName, span, winding);
     #endif
-        SkASSERT(span.fWindSum == SK_MinS32 || span.fWindSum == winding);
+        SkASSERT(span.fWindSum == SK_MinS32 || windSumMatches(span.fWindSum, winding));
    #ifdef SK_DEBUG
         SkASSERT(abs(winding) <= gDebugMaxWindSum);
    #endif
@@ -3158,12 +3289,12 @@ the same winding is shared by both.
     #if DEBUG_MARK_DONE
         debugShowNewWinding(funName, span, winding, oppWinding);
     #endif
-        SkASSERT(span.fWindSum == SK_MinS32 || span.fWindSum == winding);
+        SkASSERT(span.fWindSum == SK_MinS32 || windSumMatches(span.fWindSum, winding));
    #ifdef SK_DEBUG
         SkASSERT(abs(winding) <= gDebugMaxWindSum);
    #endif
         span.fWindSum = winding;
-        SkASSERT(span.fOppSum == SK_MinS32 || span.fOppSum == oppWinding);
+        SkASSERT(span.fOppSum == SK_MinS32 || oppSumMatches(span.fOppSum, oppWinding));
    #ifdef SK_DEBUG
         SkASSERT(abs(oppWinding) <= gDebugMaxWindSum);
    #endif
@@ -3334,6 +3465,11 @@ the same winding is shared by both.
         Segment* other = endSpan.fOther;
         index = endSpan.fOtherIndex;
         int otherEnd = other->nextExactSpan(index, step);
+        if (otherEnd < 0) {
+            // the chase ran off the end of a coincident edge that was dropped
+            last = NULL;
+            return NULL;
+        }
         min = SkMin32(index, otherEnd);
         return other;
     }
@@ -3405,6 +3541,10 @@ the same winding is shared by both.
         return fTs[lesser].fOppSum;
     }
 
+    bool oppSumMatches(int oppSum, int oppWinding) const {
+        return fOppXor || oppSum == oppWinding;
+    }
+
     int oppValue(int tIndex) const {
         return fTs[tIndex].fOppValue;
     }
@@ -3431,7 +3571,7 @@ the same winding is shared by both.
     void setUpWinding(int index, int endIndex, int& maxWinding, int& sumWinding) {
         int deltaSum = spanSign(index, endIndex);
         maxWinding = sumWinding;
-        sumWinding = sumWinding -= deltaSum;
+        sumWinding -= deltaSum;
     }
 
     void setUpWindings(int index, int endIndex, int& sumMiWinding, int& sumSuWinding,
@@ -3621,6 +3761,10 @@ the same winding is shared by both.
     #endif
             return SK_MinS32;
         }
+        if (windVal < 0) { // the other operand's edge runs the opposite way
+            windVal = -windVal;
+            dx = -dx;
+        }
         if (winding * dx > 0) { // if same signs, result is negative
             winding += dx > 0 ? -windVal : windVal;
         }
@@ -3652,6 +3796,12 @@ the same winding is shared by both.
         return windValue(index);
     }
 
+    // with even-odd fill, coincident edges that cancel are dropped, so the
+    // sums reached by walking around them on either side may disagree
+    bool windSumMatches(int windSum, int winding) const {
+        return fXor || windSum == winding;
+    }
+
     int windValueAt(double t) const {
         int count = fTs.count();
         for (int index = 0; index < count; ++index) {
@@ -3724,7 +3874,7 @@ the same winding is shared by both.
     }
 
     void zeroSpan(Span* span) {
-        SkASSERT(span->fWindValue > 0 || span->fOppValue > 0);
+        SkASSERT(span->fWindValue > 0 || span->fOppValue != 0);
         span->fWindValue = 0;
         span->fOppValue = 0;
         SkASSERT(!span->fDone);
@@ -4275,8 +4425,7 @@ public:
                 cancelers ^= true;
             }
             SkASSERT(!approximately_negative(oEndT - oStartT));
-            bool opp = fOperand ^ otherContour->fOperand;
-            if (cancelers && !opp) {
+            if (cancelers) {
                 // make sure startT and endT have t entries
                 if (startT > 0 || oEndT < 1
                         || thisOne.isMissing(startT) || other.isMissing(oEndT)) {
@@ -4346,8 +4495,7 @@ public:
                 cancelers ^= true;
             }
             SkASSERT(!approximately_negative(oEndT - oStartT));
-            bool opp = fOperand ^ otherContour->fOperand;
-            if (cancelers && !opp) {
+            if (cancelers) {
                 // make sure startT and endT have t entries
                 if (startT > 0 || oEndT < 1
                         || thisOne.isMissing(startT) || other.isMissing(oEndT)) {
@@ -4372,9 +4520,33 @@ public:
             other.debugShowTs();
         #endif
         }
+        for (int index = 0; index < count; ++index) {
+            Coincidence& coincidence = fCoincidences[index];
+            Segment& thisOne = fSegments[coincidence.fSegments[0]];
+            Contour* otherContour = coincidence.fContours[1];
+            Segment& other = otherContour->fSegments[coincidence.fSegments[1]];
+            if (thisOne.done() || other.done()) {
+                continue;
+            }
+            double startT = coincidence.fTs[0][0];
+            double endT = coincidence.fTs[0][1];
+            double oStartT = coincidence.fTs[1][0];
+            double oEndT = coincidence.fTs[1][1];
+            bool cancelers = (startT > endT) ^ (oStartT > oEndT);
+            if (startT > endT) {
+                SkTSwap<double>(startT, endT);
+            }
+            if (oStartT > oEndT) {
+                SkTSwap<double>(oStartT, oEndT);
+            }
+            thisOne.addCoincidentTs(startT, endT, other, oStartT, oEndT, cancelers);
+            other.addCoincidentTs(oStartT, oEndT, thisOne, startT, endT, cancelers);
+        }
     }
 
-    void calcCoincidentWinding() {
+    // edges of the same operand are merged first, so that the edges of the
+    // other operand see the winding left after any cancellation
+    void calcCoincidentWinding(bool binary) {
         int count = fCoincidences.count();
         for (int index = 0; index < count; ++index) {
             Coincidence& coincidence = fCoincidences[index];
@@ -4385,6 +4557,9 @@ public:
                 continue;
             }
             Contour* otherContour = coincidence.fContours[1];
+            if ((fOperand != otherContour->fOperand) != binary) {
+                continue;
+            }
             int otherIndex = coincidence.fSegments[1];
             Segment& other = otherContour->fSegments[otherIndex];
             if (other.done()) {
@@ -4404,8 +4579,7 @@ public:
                 cancelers ^= true;
             }
             SkASSERT(!approximately_negative(oEndT - oStartT));
-            bool opp = fOperand ^ otherContour->fOperand;
-            if (cancelers && !opp) {
+            if (cancelers) {
                 // make sure startT and endT have t entries
                 if (!thisOne.done() && !other.done()) {
                     thisOne.addTCancel(startT, endT, other, oStartT, oEndT);
@@ -4736,6 +4910,9 @@ void walk() {
     const SkPoint* finalCurveStart = NULL;
     const SkPoint* finalCurveEnd = NULL;
     SkPath::Verb verb;
+    if (verbPtr == endOfFirstHalf) { // the first path is empty
+        fOperand = true;
+    }
     while ((verb = (SkPath::Verb) *verbPtr++) != SkPath::kDone_Verb) {
         switch (verb) {
             case SkPath::kMove_Verb:
@@ -4932,9 +5109,8 @@ public:
         return kLine_Segment;
     }
 
-    bool startAfter(const Work& after) {
-        fIndex = after.fIndex;
-        return advance();
+    void setIndex(int index) {
+        fIndex = index;
     }
 
     SkScalar top() const {
@@ -5192,29 +5368,139 @@ static void debugShowCubicIntersection(int , const Work& ,
 #endif
 #endif
 
-static bool addIntersectTs(Contour* test, Contour* next) {
+// A pair of segments whose bounds intersect. Contours are numbered by their
+// place in the contour list. The test segment is the one in the earlier
+// contour, or the earlier segment when both are in the same contour.
+struct Overlap {
+    int fTestContour;
+    int fTestSegment;
+    int fNextContour;
+    int fNextSegment;
 
-    if (test != next) {
-        if (test->bounds().fBottom < next->bounds().fTop) {
-            return false;
+    // by pair of contours, then by test segment, then by next segment; the
+    // order in which every pair of segments used to be visited
+    bool operator<(const Overlap& rh) const {
+        if (fTestContour != rh.fTestContour) {
+            return fTestContour < rh.fTestContour;
         }
-        if (!Bounds::Intersects(test->bounds(), next->bounds())) {
-            return true;
+        if (fNextContour != rh.fNextContour) {
+            return fNextContour < rh.fNextContour;
+        }
+        if (fTestSegment != rh.fTestSegment) {
+            return fTestSegment < rh.fTestSegment;
         }
+        return fNextSegment < rh.fNextSegment;
     }
+
+    bool sameContours(const Overlap& rh) const {
+        return fTestContour == rh.fTestContour
+                && fNextContour == rh.fNextContour;
+    }
+};
+
+struct SweepSegment {
+    const Bounds* fBounds;
+    int fContour;
+    int fSegment;
+
+    bool operator<(const SweepSegment& rh) const {
+        return fBounds->fTop < rh.fBounds->fTop;
+    }
+};
+
+static int stripIndex(SkScalar x, SkScalar left, SkScalar scale, int count) {
+    return SkPin32(SkScalarFloorToInt((x - left) * scale), 0, count - 1);
+}
+
+// Find every pair of segments in the contours whose bounds intersect. The
+// segments are swept from top to bottom, and each is only compared with the
+// earlier segments that reach down to its top. Those are kept in vertical
+// strips, so that a segment is only compared with those to either side of it
+// that share one of its strips. The work grows with the number of segments
+// near each other, not with the square of the segment count, which matters
+// for large polygons.
+static void findOverlaps(Contour* const* contours, int contourCount,
+        SkTDArray<Overlap>& overlaps) {
+    SkTDArray<SweepSegment> sweep;
+    for (int cIndex = 0; cIndex < contourCount; ++cIndex) {
+        const SkTArray<Segment>& segments = contours[cIndex]->segments();
+        for (int sIndex = 0; sIndex < segments.count(); ++sIndex) {
+            SweepSegment* entry = sweep.append();
+            entry->fBounds = &segments[sIndex].bounds();
+            entry->fContour = cIndex;
+            entry->fSegment = sIndex;
+        }
+    }
+    if (sweep.count() < 2) {
+        return;
+    }
+    Bounds bounds = *sweep[0].fBounds;
+    for (int index = 1; index < sweep.count(); ++index) {
+        bounds.add(*sweep[index].fBounds);
+    }
+    SkTHeapSort(sweep.begin(), sweep.count());
+    // about as many strips as segments in each
+    const int stripCount = SkMin32(SkMax32(SkScalarRound(SkScalarSqrt(
+            SkIntToScalar(sweep.count()))), 1), 1024);
+    const SkScalar width = bounds.width();
+    const SkScalar stripScale = width > 0 ? stripCount / width : 0;
+    SkTArray<SkTDArray<const SweepSegment*> > active;
+    active.push_back_n(stripCount);
+    for (int index = 0; index < sweep.count(); ++index) {
+        const SweepSegment& entry = sweep[index];
+        const int firstStrip = stripIndex(entry.fBounds->fLeft, bounds.fLeft,
+                stripScale, stripCount);
+        const int lastStrip = stripIndex(entry.fBounds->fRight, bounds.fLeft,
+                stripScale, stripCount);
+        for (int strip = firstStrip; strip <= lastStrip; ++strip) {
+            SkTDArray<const SweepSegment*>& stripActive = active[strip];
+            int kept = 0;
+            for (int aIndex = 0; aIndex < stripActive.count(); ++aIndex) {
+                const SweepSegment* above = stripActive[aIndex];
+                if (above->fBounds->fBottom < entry.fBounds->fTop) {
+                    continue; // nothing later in the sweep can reach it either
+                }
+                stripActive[kept++] = above;
+                if (!Bounds::Intersects(*above->fBounds, *entry.fBounds)) {
+                    continue;
+                }
+                // record the pair in only the first strip the two share
+                if (strip != SkMax32(firstStrip, stripIndex(
+                        above->fBounds->fLeft, bounds.fLeft, stripScale,
+                        stripCount))) {
+                    continue;
+                }
+                bool aboveIsTest = above->fContour != entry.fContour
+                        ? above->fContour < entry.fContour
+                        : above->fSegment < entry.fSegment;
+                const SweepSegment& test = aboveIsTest ? *above : entry;
+                const SweepSegment& next = aboveIsTest ? entry : *above;
+                Overlap* overlap = overlaps.append();
+                overlap->fTestContour = test.fContour;
+                overlap->fTestSegment = test.fSegment;
+                overlap->fNextContour = next.fContour;
+                overlap->fNextSegment = next.fSegment;
+            }
+            stripActive.setCount(kept);
+            *stripActive.append() = &entry;
+        }
+    }
+    SkTQSort(overlaps.begin(), overlaps.end() - 1);
+}
+
+// intersect the pairs of segments in [overlap, end), which all come from test
+// and next
+static void addIntersectTs(Contour* test, Contour* next, const Overlap* overlap,
+        const Overlap* end) {
     Work wt;
     wt.init(test);
+    Work wn;
+    wn.init(next);
     bool foundCommonContour = test == next;
     do {
-        Work wn;
-        wn.init(next);
-        if (test == next && !wn.startAfter(wt)) {
-            continue;
-        }
+        wt.setIndex(overlap->fTestSegment);
         do {
-            if (!Bounds::Intersects(wt.bounds(), wn.bounds())) {
-                continue;
-            }
+            wn.setIndex(overlap->fNextSegment);
             int pts;
             Intersections ts;
             bool swap = false;
@@ -5430,8 +5716,55 @@ static bool addIntersectTs(Contour* test, Contour* next) {
                 wt.addOtherT(testTAt, ts.fT[!swap][pt ^ ts.fFlip], nextTAt);
                 wn.addOtherT(nextTAt, ts.fT[swap][pt ^ ts.fFlip], testTAt);
             }
-        } while (wn.advance());
-    } while (wt.advance());
+        } while (++overlap != end && overlap->fTestSegment == wt.segmentIndex());
+    } while (overlap != end);
+}
+
+// find all intersections between segments
+static void addIntersectTs(SkTDArray<Contour*>& contourList) {
+    SkTDArray<Overlap> overlaps;
+    findOverlaps(contourList.begin(), contourList.count(), overlaps);
+    const Overlap* overlap = overlaps.begin();
+    const Overlap* end = overlaps.end();
+    while (overlap != end) {
+        const Overlap* pairEnd = overlap;
+        while (++pairEnd != end && pairEnd->sameContours(*overlap))
+            ;
+        addIntersectTs(contourList[overlap->fTestContour],
+                contourList[overlap->fNextContour], overlap, pairEnd);
+        overlap = pairEnd;
+    }
+}
+
+// find the intersections within one contour, or between two; returns false
+// if next, and any contour sorted after it, is entirely below test
+static bool addIntersectTs(Contour* test, Contour* next) {
+    if (test != next) {
+        if (test->bounds().fBottom < next->bounds().fTop) {
+            return false;
+        }
+        if (!Bounds::Intersects(test->bounds(), next->bounds())) {
+            return true;
+        }
+    }
+    Contour* contours[] = { test, next };
+    SkTDArray<Overlap> overlaps;
+    findOverlaps(contours, test == next ? 1 : 2, overlaps);
+    // skip the pairs within each contour
+    const Overlap* overlap = overlaps.begin();
+    const Overlap* end = overlaps.end();
+    const int nextContour = test == next ? 0 : 1;
+    while (overlap != end && overlap->fNextContour != nextContour) {
+        ++overlap;
+    }
+    const Overlap* pairEnd = overlap;
+    while (pairEnd != end && pairEnd->fTestContour == 0
+            && pairEnd->fNextContour == nextContour) {
+        ++pairEnd;
+    }
+    if (overlap != pairEnd) {
+        addIntersectTs(test, next, overlap, pairEnd);
+    }
     return true;
 }
 
@@ -5451,7 +5784,11 @@ static void coincidenceCheck(SkTDArray<Contour*>& contourList, int total) {
     }
     for (int cIndex = 0; cIndex < contourCount; ++cIndex) {
         Contour* contour = contourList[cIndex];
-        contour->calcCoincidentWinding();
+        contour->calcCoincidentWinding(false);
+    }
+    for (int cIndex = 0; cIndex < contourCount; ++cIndex) {
+        Contour* contour = contourList[cIndex];
+        contour->calcCoincidentWinding(true);
     }
 #endif
     for (int cIndex = 0; cIndex < contourCount; ++cIndex) {
@@ -5560,7 +5897,7 @@ static Segment* findUndone(SkTDArray<Contour*>& contourList, int& start, int& en
 
 #define OLD_FIND_CHASE 1
 
-static Segment* findChase(SkTDArray<Span*>& chase, int& tIndex, int& endIndex) {
+static Segment* findChase(Chase& chase, int& tIndex, int& endIndex) {
     while (chase.count()) {
         Span* span;
         chase.pop(&span);
@@ -5574,7 +5911,7 @@ static Segment* findChase(SkTDArray<Span*>& chase, int& tIndex, int& endIndex) {
             tIndex = last->start();
             endIndex = last->end();
    #if TRY_ROTATE
-            *chase.insert(0) = span;
+            *chase.prepend() = span;
    #else
             *chase.append() = span;
    #endif
@@ -5682,7 +6019,7 @@ static Segment* findChase(SkTDArray<Span*>& chase, int& tIndex, int& endIndex) {
 #endif
         } while (++nextIndex != lastIndex);
    #if TRY_ROTATE
-        *chase.insert(0) = span;
+        *chase.prepend() = span;
    #else
         *chase.append() = span;
    #endif
@@ -5827,7 +6164,9 @@ static Segment* findSortableTop(SkTDArray<Contour*>& contourList, bool& firstCon
 }
 
 // rewrite that abandons keeping local track of winding
-static bool bridgeWinding(SkTDArray<Contour*>& contourList, PathWrapper& simple) {
+// returns false if the walk reached an edge it had already consumed
+static bool bridgeWinding(SkTDArray<Contour*>& contourList, PathWrapper& simple,
+        bool& closable) {
     bool firstContour = true;
     bool unsortable = false;
     bool topUnsortable = false;
@@ -5839,14 +6178,16 @@ static bool bridgeWinding(SkTDArray<Contour*>& contourList, PathWrapper& simple)
                 topUnsortable, topDone, false);
         if (!current) {
             if (topUnsortable || !topDone) {
+                if (topLeft.fX == SK_ScalarMin && topLeft.fY == SK_ScalarMin) {
+                    return false;
+                }
                 topUnsortable = false;
-                SkASSERT(topLeft.fX != SK_ScalarMin && topLeft.fY != SK_ScalarMin);
                 topLeft.fX = topLeft.fY = SK_ScalarMin;
                 continue;
             }
             break;
         }
-        SkTDArray<Span*> chaseArray;
+        Chase chaseArray;
         do {
             if (current->activeWinding(index, endIndex)) {
                 do {
@@ -5855,7 +6196,9 @@ static bool bridgeWinding(SkTDArray<Contour*>& contourList, PathWrapper& simple)
                         debugShowActiveSpans(contourList);
                     }
             #endif
-                    SkASSERT(unsortable || !current->done());
+                    if (!unsortable && current->done()) {
+                        return false;
+                    }
                     int nextStart = index;
                     int nextEnd = endIndex;
                     Segment* next = current->findNextWinding(chaseArray, nextStart, nextEnd,
@@ -5881,7 +6224,9 @@ static bool bridgeWinding(SkTDArray<Contour*>& contourList, PathWrapper& simple)
                 } while (!simple.isClosed() && (!unsortable
                         || !current->done(SkMin32(index, endIndex))));
                 if (current->activeWinding(index, endIndex) && !simple.isClosed()) {
-                    SkASSERT(unsortable);
+                    if (!unsortable) {
+                        return false;
+                    }
                     int min = SkMin32(index, endIndex);
                     if (!current->done(min)) {
                         current->addCurveTo(index, endIndex, simple, true);
@@ -5904,15 +6249,17 @@ static bool bridgeWinding(SkTDArray<Contour*>& contourList, PathWrapper& simple)
             }
         } while (true);
     } while (true);
-    return simple.someAssemblyRequired();
+    closable = !simple.someAssemblyRequired();
+    return true;
 }
 
-// returns true if all edges were processed
-static bool bridgeXor(SkTDArray<Contour*>& contourList, PathWrapper& simple) {
+// returns false if the walk reached an edge it had already consumed
+static bool bridgeXor(SkTDArray<Contour*>& contourList, PathWrapper& simple,
+        bool& closable) {
     Segment* current;
     int start, end;
     bool unsortable = false;
-    bool closable = true;
+    closable = true;
     while ((current = findUndone(contourList, start, end))) {
         do {
     #if DEBUG_ACTIVE_SPANS
@@ -5920,7 +6267,9 @@ static bool bridgeXor(SkTDArray<Contour*>& contourList, PathWrapper& simple) {
                 debugShowActiveSpans(contourList);
             }
     #endif
-            SkASSERT(unsortable || !current->done());
+            if (!unsortable && current->done()) {
+                return false;
+            }
             int nextStart = start;
             int nextEnd = end;
             Segment* next = current->findNextXor(nextStart, nextEnd, unsortable);
@@ -5944,7 +6293,9 @@ static bool bridgeXor(SkTDArray<Contour*>& contourList, PathWrapper& simple) {
             end = nextEnd;
         } while (!simple.isClosed() && (!unsortable || !current->done(SkMin32(start, end))));
         if (!simple.isClosed()) {
-            SkASSERT(unsortable);
+            if (!unsortable) {
+                return false;
+            }
             int min = SkMin32(start, end);
             if (!current->done(min)) {
                 current->addCurveTo(start, end, simple, true);
@@ -5957,7 +6308,7 @@ static bool bridgeXor(SkTDArray<Contour*>& contourList, PathWrapper& simple) {
         debugShowActiveSpans(contourList);
     #endif
     }
-    return closable;
+    return true;
 }
 
 static void fixOtherTIndex(SkTDArray<Contour*>& contourList) {
@@ -6193,7 +6544,7 @@ static void assemble(const PathWrapper& path, PathWrapper& simple) {
 #endif
 }
 
-void simplifyx(const SkPath& path, SkPath& result) {
+bool simplifyx(const SkPath& path, SkPath& result) {
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     result.reset();
     result.setFillType(SkPath::kEvenOdd_FillType);
@@ -6206,20 +6557,10 @@ void simplifyx(const SkPath& path, SkPath& result) {
     builder.finish();
     SkTDArray<Contour*> contourList;
     makeContourList(contours, contourList, false, false);
-    Contour** currentPtr = contourList.begin();
-    if (!currentPtr) {
-        return;
+    if (!contourList.count()) {
+        return true;
     }
-    Contour** listEnd = contourList.end();
-    // find all intersections between segments
-    do {
-        Contour** nextPtr = currentPtr;
-        Contour* current = *currentPtr++;
-        Contour* next;
-        do {
-            next = *nextPtr++;
-        } while (addIntersectTs(current, next) && nextPtr != listEnd);
-    } while (currentPtr != listEnd);
+    addIntersectTs(contourList);
     // eat through coincident edges
     coincidenceCheck(contourList, 0);
     fixOtherTIndex(contourList);
@@ -6228,13 +6569,17 @@ void simplifyx(const SkPath& path, SkPath& result) {
     debugShowActiveSpans(contourList);
 #endif
     // construct closed contours
-    if (builder.xorMask() == kWinding_Mask ? bridgeWinding(contourList, simple)
-                : !bridgeXor(contourList, simple))
-    { // if some edges could not be resolved, assemble remaining fragments
+    bool closable;
+    if (builder.xorMask() == kWinding_Mask ? !bridgeWinding(contourList, simple, closable)
+                : !bridgeXor(contourList, simple, closable)) {
+        return false;
+    }
+    if (!closable) { // if some edges could not be resolved, assemble remaining fragments
         SkPath temp;
         temp.setFillType(SkPath::kEvenOdd_FillType);
         PathWrapper assembled(temp);
         assemble(simple, assembled);
         result = *assembled.nativePath();
     }
+    return true;
 }
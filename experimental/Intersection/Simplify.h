@@ -13,6 +13,7 @@
 #include "SkRect.h"
 #include "SkTArray.h"
 #include "SkTDArray.h"
+#include "SkTSort.h"
 #include "ShapeOps.h"
 #include "TSearch.h"
 #include <algorithm> // used for std::min
@@ -34,7 +34,7 @@ static const SimplifyFindNextTest::Segment* testCommon(
     pts[0] = segment.xyAtT(&segment.span(endIndex));
     int nextStart = startIndex;
     int nextEnd = endIndex;
-    SkTDArray<SimplifyFindNextTest::Span*> chaseArray;
+    SimplifyFindNextTest::Chase chaseArray;
     bool unsortable = false;
     SimplifyFindNextTest::Segment* next = segment.findNextWinding(chaseArray,
             nextStart, nextEnd, unsortable);
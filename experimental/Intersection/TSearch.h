@@ -34,7 +34,7 @@ void QSort(T* left, T* right)
     if (left >= right) {
         return;
     }
-    T* pivot = left + (right - left >> 1);
+    T* pivot = left + ((right - left) >> 1);
     pivot = QSort_Partition(left, right, pivot);
     QSort(left, pivot - 1);
     QSort(pivot + 1, right);
@@ -63,7 +63,7 @@ void QSort(T** left, T** right)
     if (left >= right) {
         return;
     }
-    T** pivot = left + (right - left >> 1);
+    T** pivot = left + ((right - left) >> 1);
     pivot = QSort_Partition(left, right, pivot);
     QSort(left, pivot - 1);
     QSort(pivot + 1, right);
@@ -94,7 +94,7 @@ void QSort(S& context, T* left, T* right,
     if (left >= right) {
         return;
     }
-    T* pivot = left + (right - left >> 1);
+    T* pivot = left + ((right - left) >> 1);
     pivot = QSort_Partition(context, left, right, pivot, lessThan);
     QSort(context, left, pivot - 1, lessThan);
     QSort(context, pivot + 1, right, lessThan);
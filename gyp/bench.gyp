@@ -11,6 +11,7 @@
       'include_dirs' : [
         '../src/core',
         '../src/effects',
+        '../src/utils',
       ],
       'includes': [
         'bench.gypi'
@@ -19,6 +20,7 @@
         'skia_base_libs.gyp:skia_base_libs',
         'effects.gyp:effects',
         'images.gyp:images',
+        'pathops.gyp:pathops',
         'bench_timer',
       ],
       'conditions': [
@@ -16,9 +16,11 @@
         '../include/config',
         '../include/core',
         '../include/images',
+        '../src/core',
       ],
       'sources': [
         '../include/images/SkBitmapFactory.h',
+        '../include/images/SkImageCache.h',
         '../include/images/SkImageDecoder.h',
         '../include/images/SkImageEncoder.h',
         '../include/images/SkImageRef.h',
@@ -31,6 +33,7 @@
         '../src/images/bmpdecoderhelper.h',
         '../src/images/SkBitmapFactory.cpp',
         '../src/images/SkFDStream.cpp',
+        '../src/images/SkImageCache.cpp',
         '../src/images/SkImageDecoder.cpp',
         '../src/images/SkImageDecoder_Factory.cpp',
         '../src/images/SkImageDecoder_libjpeg.cpp',
@@ -42,8 +45,6 @@
         '../src/images/SkImageEncoder.cpp',
         '../src/images/SkImageEncoder_Factory.cpp',
         '../src/images/SkImageRef.cpp',
-        '../src/images/SkImageRefPool.cpp',
-        '../src/images/SkImageRefPool.h',
         '../src/images/SkImageRef_GlobalPool.cpp',
         '../src/images/SkImages.cpp',
         '../src/images/SkJpegUtility.cpp',
@@ -104,6 +105,7 @@
             ],
             'libraries': [
               '-lpng',
+              '-lz',
             ],
           },
           # end libpng stuff
@@ -48,6 +48,9 @@
             '../src/opts/SkBitmapProcState_opts_SSE2.cpp',
             '../src/opts/SkBlitRow_opts_SSE2.cpp',
             '../src/opts/SkBlitRect_opts_SSE2.cpp',
+            '../src/opts/SkBoxBlur_opts_SSE2.cpp',
+            '../src/opts/SkMorphology_opts_SSE2.cpp',
+            '../src/opts/SkSampleRow_opts_SSE2.cpp',
             '../src/opts/SkUtils_opts_SSE2.cpp',
           ],
         }],
@@ -93,6 +96,9 @@
           'sources': [
             '../src/opts/SkBitmapProcState_opts_none.cpp',
             '../src/opts/SkBlitRow_opts_none.cpp',
+            '../src/opts/SkBoxBlur_opts_none.cpp',
+            '../src/opts/SkMorphology_opts_none.cpp',
+            '../src/opts/SkSampleRow_opts_none.cpp',
             '../src/opts/SkUtils_opts_none.cpp',
           ],
         }],
@@ -166,6 +172,9 @@
         '../src/opts/SkBitmapProcState_matrix_clamp_neon.h',
         '../src/opts/SkBitmapProcState_matrix_repeat_neon.h',
         '../src/opts/SkBlitRow_opts_arm_neon.cpp',
+        '../src/opts/SkBoxBlur_opts_neon.cpp',
+        '../src/opts/SkMorphology_opts_neon.cpp',
+        '../src/opts/SkSampleRow_opts_neon.cpp',
       ],
     },
   ],
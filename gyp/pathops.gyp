@@ -0,0 +1,73 @@
+# GYP file to build the path boolean operations library.
+{
+  'targets': [
+    {
+      'target_name': 'pathops',
+      'product_name': 'skia_pathops',
+      'type': 'static_library',
+      'standalone_static_library': 1,
+      'dependencies': [
+        'skia_base_libs.gyp:skia_base_libs',
+      ],
+      'include_dirs': [
+        '../include/config',
+        '../include/core',
+        '../include/pathops',
+        '../src/core', # needed to get SkTSort.h
+        '../experimental/Intersection',
+      ],
+      'sources': [
+        '../include/pathops/SkPathOps.h',
+
+        '../src/pathops/SkPathOps.cpp',
+
+        # The edge walker is still developed in experimental/Intersection,
+        # next to its test harness (shapeops_edge.gyp). These are the parts
+        # of it that the ops are built on.
+        '../experimental/Intersection/ConvexHull.cpp',
+        '../experimental/Intersection/CubeRoot.cpp',
+        '../experimental/Intersection/CubicBezierClip.cpp',
+        '../experimental/Intersection/CubicBounds.cpp',
+        '../experimental/Intersection/CubicIntersection.cpp',
+        '../experimental/Intersection/CubicLineSegments.cpp',
+        '../experimental/Intersection/CubicParameterization.cpp',
+        '../experimental/Intersection/CubicReduceOrder.cpp',
+        '../experimental/Intersection/CubicSubDivide.cpp',
+        '../experimental/Intersection/CubicToQuadratics.cpp',
+        '../experimental/Intersection/CubicUtilities.cpp',
+        '../experimental/Intersection/DataTypes.cpp',
+        '../experimental/Intersection/Extrema.cpp',
+        '../experimental/Intersection/IntersectionUtilities.cpp',
+        '../experimental/Intersection/Intersections.cpp',
+        '../experimental/Intersection/LineCubicIntersection.cpp',
+        '../experimental/Intersection/LineIntersection.cpp',
+        '../experimental/Intersection/LineParameterization.cpp',
+        '../experimental/Intersection/LineQuadraticIntersection.cpp',
+        '../experimental/Intersection/LineUtilities.cpp',
+        '../experimental/Intersection/QuadraticBezierClip.cpp',
+        '../experimental/Intersection/QuadraticBounds.cpp',
+        '../experimental/Intersection/QuadraticImplicit.cpp',
+        '../experimental/Intersection/QuadraticIntersection.cpp',
+        '../experimental/Intersection/QuadraticLineSegments.cpp',
+        '../experimental/Intersection/QuadraticParameterization.cpp',
+        '../experimental/Intersection/QuadraticReduceOrder.cpp',
+        '../experimental/Intersection/QuadraticSubDivide.cpp',
+        '../experimental/Intersection/QuadraticUtilities.cpp',
+        '../experimental/Intersection/QuarticRoot.cpp',
+        '../experimental/Intersection/ShapeOps.cpp',
+        '../experimental/Intersection/Simplify.cpp',
+      ],
+      'direct_dependent_settings': {
+        'include_dirs': [
+          '../include/pathops',
+        ],
+      },
+    },
+  ],
+}
+
+# Local Variables:
+# tab-width:2
+# indent-tabs-mode:nil
+# End:
+# vim: set expandtab tabstop=2 shiftwidth=2:
@@ -13,6 +13,7 @@
         '../include/config',
         '../include/core',
         '../include/pdf',
+        '../include/utils', # needed to get SkThreadPool.h
         '../src/core', # needed to get SkGlyphCache.h and SkTextFormatParams.h
         '../src/utils', # needed to get SkBitSet.h
       ],
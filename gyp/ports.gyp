@@ -52,6 +52,8 @@
             ],
           },
           'sources': [
+            '../src/ports/SkFontCatalog.cpp',
+            '../src/ports/SkFontCatalog.h',
             '../src/ports/SkFontHost_FreeType.cpp',
             '../src/ports/SkFontHost_FreeType_common.cpp',
             '../src/ports/SkFontHost_linux.cpp',
@@ -73,6 +75,8 @@
             'SK_FONTHOST_FREETYPE_RUNTIME_VERSION=0x020400',\
           ],
           'sources': [
+            '../src/ports/SkFontCatalog.cpp',
+            '../src/ports/SkFontCatalog.h',
             '../src/ports/SkFontHost_FreeType.cpp',
             '../src/ports/SkFontHost_FreeType_common.cpp',
             '../src/ports/SkFontHost_linux.cpp',
@@ -10,6 +10,10 @@
       'mac_bundle' : 1,
       'include_dirs' : [
         '../experimental/SimpleCocoaApp', # needed to get SimpleApp.h
+        '../src/core', # needed to get SkTSort.h
+      ],
+      'defines': [
+        'SK_DEBUG_PATH_OPS',
       ],
       'sources': [
         '../experimental/Intersection/ConvexHull.cpp',
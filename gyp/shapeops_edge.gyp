@@ -11,6 +11,9 @@
       'include_dirs' : [
         '../src/core',
       ],
+      'defines': [
+        'SK_DEBUG_PATH_OPS',
+      ],
       'sources': [
         '../experimental/Intersection/ActiveEdge_Test.cpp',
         '../experimental/Intersection/ConvexHull.cpp',
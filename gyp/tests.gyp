@@ -10,6 +10,7 @@
       'include_dirs' : [
         '../src/core',
         '../src/effects',
+        '../src/images',
         '../src/pdf',
         '../src/pipe/utils',
         '../src/utils',
@@ -17,6 +18,7 @@
       ],
       'sources': [
         '../tests/AAClipTest.cpp',
+        '../tests/AnalyticAATest.cpp',
         '../tests/AnnotationTest.cpp',
         '../tests/AtomicTest.cpp',
         '../tests/BitmapCopyTest.cpp',
@@ -49,6 +51,7 @@
         '../tests/FontHostStreamTest.cpp',
         '../tests/FontHostTest.cpp',
         '../tests/GeometryTest.cpp',
+        '../tests/GlyphCacheTest.cpp',
         '../tests/GLInterfaceValidation.cpp',
         '../tests/GLProgramsTest.cpp',
         '../tests/GpuBitmapCopyTest.cpp',
@@ -56,23 +59,30 @@
         '../tests/GradientTest.cpp',
         '../tests/GrMemoryPoolTest.cpp',
         '../tests/HashCacheTest.cpp',
+        '../tests/ImageCacheTest.cpp',
+        '../tests/ImageDecodeRegionTest.cpp',
+        '../tests/ImageFilterTest.cpp',
         '../tests/InfRectTest.cpp',
         '../tests/LListTest.cpp',
         '../tests/MathTest.cpp',
         '../tests/MatrixTest.cpp',
         '../tests/Matrix44Test.cpp',
+        '../tests/MeasuredPathTest.cpp',
         '../tests/MemsetTest.cpp',
         '../tests/MetaDataTest.cpp',
+        '../tests/MorphologyTest.cpp',
         '../tests/PackBitsTest.cpp',
         '../tests/PaintTest.cpp',
         '../tests/ParsePathTest.cpp',
         '../tests/PathCoverageTest.cpp',
         '../tests/PathMeasureTest.cpp',
+        '../tests/PathOpsTest.cpp',
         '../tests/PathTest.cpp',
         '../tests/PDFPrimitivesTest.cpp',
         '../tests/PictureTest.cpp',
         '../tests/PictureUtilsTest.cpp',
         '../tests/PipeTest.cpp',
+        '../tests/PNGEncodeTest.cpp',
         '../tests/PointTest.cpp',
         '../tests/PremulAlphaRoundTripTest.cpp',
         '../tests/QuickRejectTest.cpp',
@@ -85,6 +95,7 @@
         '../tests/RoundRectTest.cpp',
         '../tests/RTreeTest.cpp',
         '../tests/ScalarTest.cpp',
+        '../tests/ScaledBitmapSamplerTest.cpp',
         '../tests/ShaderOpacityTest.cpp',
         '../tests/Sk64Test.cpp',
         '../tests/skia_test.cpp',
@@ -92,10 +103,13 @@
         '../tests/SrcOverTest.cpp',
         '../tests/StreamTest.cpp',
         '../tests/StringTest.cpp',
+        '../tests/StrokeCacheTest.cpp',
         '../tests/StrokeTest.cpp',
         '../tests/Test.cpp',
         '../tests/Test.h',
+        '../tests/TestUtils.h',
         '../tests/TestSize.cpp',
+        '../tests/ThreadPoolTest.cpp',
         '../tests/TileGridTest.cpp',
         '../tests/TLSTest.cpp',
         '../tests/ToUnicode.cpp',
@@ -114,6 +128,7 @@
         'effects.gyp:effects',
         'experimental.gyp:experimental',
         'images.gyp:images',
+        'pathops.gyp:pathops',
         'pdf.gyp:pdf',
         'tools.gyp:picture_utils',
         'utils.gyp:utils',
@@ -124,6 +139,22 @@
             '../src/gpu',
           ],
         }],
+        [ 'skia_os in ["linux", "freebsd", "openbsd", "solaris"]', {
+          'include_dirs': [
+            '../src/ports',
+          ],
+          'sources': [
+            '../tests/FontCatalogTest.cpp',
+          ],
+        }],
+        [ 'skia_arch_type == "x86" and skia_os != "ios"', {
+          'include_dirs': [
+            '../src/opts',
+          ],
+          'sources': [
+            '../tests/BitmapProcOptsTest.cpp',
+          ],
+        }],
       ],
     },
   ],
@@ -18,6 +18,7 @@
         '../include/utils/unix',
         '../include/utils/win',
         '../include/xml',
+        '../src/core',
         '../src/utils',
       ],
       'sources': [
@@ -43,12 +44,14 @@
         '../include/utils/SkNinePatch.h',
         '../include/utils/SkNWayCanvas.h',
         '../include/utils/SkNullCanvas.h',
+        '../include/utils/SkParallelRaster.h',
         '../include/utils/SkParse.h',
         '../include/utils/SkParsePaint.h',
         '../include/utils/SkParsePath.h',
         '../include/utils/SkPictureUtils.h',
         '../include/utils/SkRTConf.h',
         '../include/utils/SkProxyCanvas.h',
+        '../include/utils/SkThreadedPipeController.h',
         '../include/utils/SkUnitMappers.h',
         '../include/utils/SkWGL.h',
 
@@ -76,6 +79,7 @@
         '../src/utils/SkNinePatch.cpp',
         '../src/utils/SkNWayCanvas.cpp',
         '../src/utils/SkNullCanvas.cpp',
+        '../src/utils/SkParallelRaster.cpp',
         '../src/utils/SkOSFile.cpp',
         '../src/utils/SkParse.cpp',
         '../src/utils/SkParseColor.cpp',
@@ -83,6 +87,7 @@
         '../src/utils/SkPictureUtils.cpp',
         '../src/utils/SkProxyCanvas.cpp',
         '../src/utils/SkRTConf.cpp',
+        '../src/utils/SkThreadedPipeController.cpp',
         '../src/utils/SkThreadUtils.h',
         '../src/utils/SkThreadUtils_pthread.cpp',
         '../src/utils/SkThreadUtils_pthread.h',
@@ -122,6 +122,14 @@
  */
 //#define SK_DEFAULT_FONT_CACHE_LIMIT   (1024 * 1024)
 
+/*
+ *  To let the FreeType font host generate glyphs on several threads at once,
+ *  define this to the number of FreeType libraries (each with its own lock
+ *  and its own copy of every face in use) to spread scaler contexts over.
+ *  If this is undefined, all of them share one library and one lock.
+ */
+//#define SK_FONTHOST_FREETYPE_SLOT_COUNT   4
+
 /* If defined, use CoreText instead of ATSUI on OS X.
 */
 //#define SK_USE_MAC_CORE_TEXT
@@ -25,6 +25,7 @@ class SkBounder;
 class SkDevice;
 class SkDraw;
 class SkDrawFilter;
+class SkMeasuredPath;
 class SkMetaData;
 class SkPicture;
 class SkRRect;
@@ -756,6 +757,30 @@ public:
                               const SkScalar xpos[], SkScalar constY,
                               const SkPaint& paint);
 
+    /** A run of glyphs for drawPosTextRuns(), each glyph drawn with its
+        origin at its own position, in the run's color.
+    */
+    struct PosTextRun {
+        const uint16_t* fGlyphs;    //!< fCount glyph IDs
+        const SkPoint*  fPos;       //!< fCount positions, one per glyph
+        int             fCount;
+        SkColor         fColor;     //!< replaces the paint's color
+    };
+
+    /** Draw many runs of positioned glyphs that share everything in the paint
+        but its color, e.g. all of the labels of a map tile in one font. This
+        is equivalent to calling drawPosText() for each run, in order, with
+        the run's glyph IDs and its color set on the paint, but the typeface,
+        size and clip are resolved once for the whole batch rather than once
+        per run. The paint's text encoding is ignored.
+        @param runs     Array of runs to draw
+        @param runCount The number of runs in the array
+        @param paint    The paint used for the text (e.g. typeface, size,
+                        style), whose color is replaced by each run's color
+        */
+    virtual void drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                 const SkPaint& paint);
+
     /** Draw the text, with origin at (x,y), using the specified paint, along
         the specified path. The paint's Align setting determins where along the
         path to start the text.
@@ -786,6 +811,56 @@ public:
                                 const SkPath& path, const SkMatrix* matrix,
                                 const SkPaint& paint);
 
+    /** Draw the text along the path held by the specified SkMeasuredPath,
+        exactly as drawTextOnPath() would, but reusing the measurements of
+        the path rather than computing them again for each draw.
+        @param text The text to be drawn
+        @param byteLength   The number of bytes to read from the text parameter
+        @param path         The measured path the text should follow for its
+                            baseline
+        @param matrix       (may be null) Applied to the text before it is
+                            mapped onto the path
+        @param paint        The paint used for the text
+        */
+    virtual void drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                        const SkMeasuredPath& path,
+                                        const SkMatrix* matrix,
+                                        const SkPaint& paint);
+
+    /** Draw the text along the measured path, as drawTextOnPathHV() would.
+        @param text The text to be drawn
+        @param byteLength   The number of bytes to read from the text parameter
+        @param path         The measured path the text should follow for its
+                            baseline
+        @param hOffset      The distance along the path to add to the text's
+                            starting position
+        @param vOffset      The distance above(-) or below(+) the path to
+                            position the text
+        @param paint        The paint used for the text
+    */
+    void drawTextOnMeasuredPathHV(const void* text, size_t byteLength,
+                                  const SkMeasuredPath& path, SkScalar hOffset,
+                                  SkScalar vOffset, const SkPaint& paint);
+
+    /** Draw count strings along the same measured path, e.g. a label
+        repeated along a street. This is equivalent to calling
+        drawTextOnMeasuredPathHV() for each string.
+        @param count        The number of strings to draw
+        @param texts        The strings to be drawn
+        @param byteLengths  The number of bytes to read from each string
+        @param offsets      For each string, the distance along the path to
+                            add to its starting position (fX), and the distance
+                            above(-) or below(+) the path to position it (fY)
+        @param path         The measured path the text should follow for its
+                            baseline
+        @param paint        The paint used for the text
+    */
+    void drawTextsOnMeasuredPath(int count, const void* const texts[],
+                                 const size_t byteLengths[],
+                                 const SkPoint offsets[],
+                                 const SkMeasuredPath& path,
+                                 const SkPaint& paint);
+
 #ifdef SK_BUILD_FOR_ANDROID
     /** Draw the text on path, with each character/glyph origin specified by the pos[]
         array. The origin is interpreted by the Align setting in the paint.
@@ -978,6 +1053,11 @@ protected:
     // is not released or deleted by the caller.
     virtual SkCanvas* canvasForDrawIter();
 
+    // draws each run with drawPosText(), for subclasses that have no better
+    // way to implement drawPosTextRuns()
+    void drawPosTextRunsAsPosText(const PosTextRun runs[], int runCount,
+                                  const SkPaint& paint);
+
     // all of the drawBitmap variants call this guy
     void commonDrawBitmap(const SkBitmap&, const SkIRect*, const SkMatrix&,
                           const SkPaint& paint);
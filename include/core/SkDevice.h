@@ -264,6 +264,18 @@ protected:
     virtual void drawPosText(const SkDraw&, const void* text, size_t len,
                              const SkScalar pos[], SkScalar constY,
                              int scalarsPerPos, const SkPaint& paint);
+    /**
+     *  Draw each run as drawPosText() would, with the run's glyph IDs and its
+     *  color set on the paint. The default impl. draws all of the runs with
+     *  one glyph cache. Devices that override drawPosText() should override
+     *  this too, if only to call drawPosTextRunsAsPosText().
+     */
+    virtual void drawPosTextRuns(const SkDraw&,
+                                 const SkCanvas::PosTextRun runs[],
+                                 int runCount, const SkPaint& paint);
+    void drawPosTextRunsAsPosText(const SkDraw&,
+                                  const SkCanvas::PosTextRun runs[],
+                                  int runCount, const SkPaint& paint);
     virtual void drawTextOnPath(const SkDraw&, const void* text, size_t len,
                                 const SkPath& path, const SkMatrix* matrix,
                                 const SkPaint& paint);
@@ -18,9 +18,12 @@
 #include "SkRect.h"
 #include "SkAutoKern.h"
 
+class SkBlitter;
 class SkBounder;
 class SkClipStack;
 class SkDevice;
+class SkGlyphCache;
+class SkMeasuredPath;
 class SkPath;
 class SkRegion;
 class SkRasterClip;
@@ -53,6 +56,13 @@ public:
     void    drawPosText(const char text[], size_t byteLength,
                         const SkScalar pos[], SkScalar constY,
                         int scalarsPerPosition, const SkPaint& paint) const;
+    /**
+     *  Same as calling drawPosText() on each run's glyph IDs, with the paint's
+     *  color set to the run's color, but sharing the glyph cache between all
+     *  of the runs, and the blitter between runs of the same color.
+     */
+    void    drawPosTextRuns(const SkCanvas::PosTextRun runs[], int runCount,
+                            const SkPaint& paint) const;
     void    drawTextOnPath(const char text[], size_t byteLength,
                         const SkPath&, const SkMatrix*, const SkPaint&) const;
 #ifdef SK_BUILD_FOR_ANDROID
@@ -101,8 +111,15 @@ public:
 private:
     void    drawText_asPaths(const char text[], size_t byteLength,
                              SkScalar x, SkScalar y, const SkPaint&) const;
+    void    drawPosGlyphs(const char text[], size_t byteLength,
+                          const SkScalar pos[], SkScalar constY,
+                          int scalarsPerPosition, const SkPaint&,
+                          SkGlyphCache*, SkBlitter*) const;
     void    drawDevMask(const SkMask& mask, const SkPaint&) const;
     void    drawBitmapAsMask(const SkBitmap&, const SkPaint&) const;
+    void    drawTextOnMeasuredPath(const char text[], size_t byteLength,
+                                   const SkMeasuredPath&, const SkMatrix*,
+                                   const SkPaint&) const;
 
 public:
     const SkBitmap* fBitmap;        // required
@@ -114,6 +131,8 @@ public:
     SkDevice*       fDevice;        // optional
     SkBounder*      fBounder;       // optional
     SkDrawProcs*    fProcs;         // optional
+    // optional: if set, drawTextOnPath uses it when asked to follow its path
+    const SkMeasuredPath* fMeasuredPath;
 
 #ifdef SK_DEBUG
     void validate() const;
@@ -60,11 +60,90 @@ public:
      */
     static void PurgeFontCache();
 
+    /**
+     *  Return the max number of bytes that should be used by the stroke cache,
+     *  which keeps the outlines of stroked (or path-effected) paths so that
+     *  drawing the same path with the same paint again can reuse them. 0, the
+     *  default, means the cache is off.
+     */
+    static size_t GetStrokeCacheLimit();
+
+    /**
+     *  Specify the max number of bytes that should be used by the stroke
+     *  cache, purging the least recently used outlines as needed. 0 turns the
+     *  cache off.
+     *
+     *  This function returns the previous setting, as if GetStrokeCacheLimit()
+     *  had be called before the new limit was set.
+     */
+    static size_t SetStrokeCacheLimit(size_t bytes);
+
+    /**
+     *  Return the number of bytes currently used by the stroke cache.
+     */
+    static size_t GetStrokeCacheUsed();
+
+    /**
+     *  Return the number of stroked path draws that found their outline in
+     *  the stroke cache (hits), and that had to compute it (misses), since
+     *  the cache was last purged. Either parameter may be null.
+     */
+    static void GetStrokeCacheStats(int32_t* hits, int32_t* misses);
+
+    /**
+     *  Empty the stroke cache and zero its statistics. This does not change
+     *  the limit.
+     */
+    static void PurgeStrokeCache();
+
+    /**
+     *  Return the max number of bytes that should be used by the clip mask
+     *  cache, which keeps the antialiased clips built by clipPath() so that
+     *  clipping to the same path with the same matrix again (on any canvas)
+     *  can reuse them. 0, the default, means the cache is off.
+     */
+    static size_t GetClipMaskCacheLimit();
+
+    /**
+     *  Specify the max number of bytes that should be used by the clip mask
+     *  cache, purging the least recently used clips as needed. 0 turns the
+     *  cache off.
+     *
+     *  This function returns the previous setting.
+     */
+    static size_t SetClipMaskCacheLimit(size_t bytes);
+
+    /**
+     *  Return the number of bytes currently used by the clip mask cache.
+     */
+    static size_t GetClipMaskCacheUsed();
+
+    /**
+     *  Return the number of antialiased path clips that found their mask in
+     *  the clip mask cache (hits), and that had to build it (misses), since
+     *  the cache was last purged. Either parameter may be null.
+     */
+    static void GetClipMaskCacheStats(int32_t* hits, int32_t* misses);
+
+    /**
+     *  Empty the clip mask cache and zero its statistics. This does not change
+     *  the limit.
+     */
+    static void PurgeClipMaskCache();
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
      *  font-cache-limit=12345678
      *
+     *  stroke-cache-limit=12345678 turns on the stroke cache with that limit.
+     *  clip-mask-cache-limit=12345678 turns on the clip mask cache with that
+     *  limit.
+     *
+     *  analytic-aa=1 makes antialiased path fills compute each pixel's exact
+     *  coverage instead of supersampling it (analytic-aa=0 restores the
+     *  default).
+     *
      *  The flags format is name=value[;name=value...] with no spaces.
      *  This format is subject to change.
      */
@@ -90,6 +169,28 @@ public:
      */
     static void SetTLSFontCacheLimit(size_t bytes);
 
+    /**
+     *  Return the number of recently used strikes each thread may keep in a
+     *  private front cache, ahead of the shared font cache. 0 means the front
+     *  cache is disabled (the default).
+     */
+    static int GetFontCachePerThreadStrikeCount();
+
+    /**
+     *  Specify the number of recently used strikes each thread may keep in a
+     *  private front cache. Lookups that hit there take no lock, which helps
+     *  when many threads draw text at once. Those strikes still count against
+     *  the shared font cache limit. Threads using a thread-local font cache
+     *  (see SetTLSFontCacheLimit) ignore this setting.
+     *
+     *  Lowering the count (e.g. to 0) returns the extra strikes to the shared
+     *  cache: the calling thread's right away, and every other thread's the
+     *  next time it looks up a strike.
+     *
+     *  This function returns the previous setting.
+     */
+    static int SetFontCachePerThreadStrikeCount(int count);
+
 private:
     /** This is automatically called by SkGraphics::Init(), and must be
         implemented by the host OS. This allows the host OS to register a callback
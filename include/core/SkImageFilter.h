@@ -9,14 +9,13 @@
 #define SkImageFilter_DEFINED
 
 #include "SkFlattenable.h"
+#include "SkMatrix.h"
+#include "SkRect.h"
 
 class SkBitmap;
 class SkColorFilter;
 class SkDevice;
-class SkMatrix;
 struct SkIPoint;
-struct SkIRect;
-struct SkRect;
 class GrEffectRef;
 class GrTexture;
 
@@ -49,6 +48,11 @@ public:
     public:
         virtual ~Proxy() {};
 
+        /**
+         *  Return a new, cleared device for an intermediate result. A proxy
+         *  may hand out a device again once nothing else refers to it or to
+         *  its pixels, so callers must not hold on to one they have released.
+         */
         virtual SkDevice* createDevice(int width, int height) = 0;
         // returns true if the proxy can handle this filter natively
         virtual bool canHandleImageFilter(SkImageFilter*) = 0;
@@ -59,6 +63,25 @@ public:
                                  SkBitmap* result, SkIPoint* offset) = 0;
     };
 
+    /**
+     *  The state a graph of filters is evaluated in. clipBounds is in the same
+     *  space as the offsets passed to filterImage(), and is the only part of
+     *  the result that the caller is going to look at, so filters may leave
+     *  out anything outside of it.
+     */
+    class Context {
+    public:
+        Context(const SkMatrix& ctm, const SkIRect& clipBounds)
+            : fCTM(ctm), fClipBounds(clipBounds) {}
+
+        const SkMatrix& ctm() const { return fCTM; }
+        const SkIRect& clipBounds() const { return fClipBounds; }
+
+    private:
+        SkMatrix    fCTM;
+        SkIRect     fClipBounds;
+    };
+
     /**
      *  Request a new (result) image to be created from the src image.
      *  If the src has no pixels (isNull()) then the request just wants to
@@ -71,6 +94,15 @@ public:
      *
      *  If the result image cannot be created, return false, in which case both
      *  the result and offset parameters will be ignored by the caller.
+     *
+     *  Only the part of the result within the context's clipBounds is
+     *  computed, and the result may be cropped to it.
+     */
+    bool filterImage(Proxy*, const SkBitmap& src, const Context&,
+                     SkBitmap* result, SkIPoint* offset);
+
+    /**
+     *  Same as above, but the whole result is wanted.
      */
     bool filterImage(Proxy*, const SkBitmap& src, const SkMatrix& ctm,
                      SkBitmap* result, SkIPoint* offset);
@@ -81,6 +113,14 @@ public:
      */
     bool filterBounds(const SkIRect& src, const SkMatrix& ctm, SkIRect* dst);
 
+    /**
+     *  Given the bounds of the part of the result that is wanted, this returns
+     *  the bounds of the src image that the filter and its inputs need to
+     *  read to compute it. Returns false if that is not known, in which case
+     *  all of the src may be needed.
+     */
+    bool sourceBounds(const SkIRect& dst, const SkMatrix& ctm, SkIRect* src);
+
     /**
      *  Returns true if the filter can be expressed a single-pass
      *  GrEffect, used to process this filter on the GPU, or false if
@@ -149,14 +189,20 @@ protected:
     virtual void flatten(SkFlattenableWriteBuffer& wb) const SK_OVERRIDE;
 
     // Default impl returns false
-    virtual bool onFilterImage(Proxy*, const SkBitmap& src, const SkMatrix&,
+    virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* offset);
     // Default impl copies src into dst and returns true
     virtual bool onFilterBounds(const SkIRect&, const SkMatrix&, SkIRect*);
+    // Return in src the bounds of the inputs' results that this filter reads
+    // to compute dst. Default impl returns false, meaning all of them.
+    virtual bool onSourceBounds(const SkIRect& dst, const SkMatrix&,
+                                SkIRect* src);
 
     // Return the result of processing the given input, or the source bitmap
-    // if we have no connected input at that index.
-    SkBitmap getInputResult(int index, Proxy*, const SkBitmap& src, const SkMatrix&,
+    // if we have no connected input at that index. Only the part of it that
+    // onSourceBounds() says is needed for the context's clipBounds is
+    // computed, and the result may be cropped to that.
+    SkBitmap getInputResult(int index, Proxy*, const SkBitmap& src, const Context&,
                             SkIPoint*);
 
 private:
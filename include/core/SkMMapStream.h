@@ -12,18 +12,18 @@
 
 #include "SkStream.h"
 
+/** \class SkMMAPStream
+
+    A stream over a memory-mapped file. The mapping is owned by the stream's
+    SkData, so copyToData() can hand it to something that outlives the stream
+    (e.g. a picture loaded in place), and the file stays mapped until the last
+    ref to that data goes away.
+*/
 class SkMMAPStream : public SkMemoryStream {
 public:
     SkMMAPStream(const char filename[]);
-    virtual ~SkMMAPStream();
 
-    virtual void setMemory(const void* data, size_t length, bool);
 private:
-    void*   fAddr;
-    size_t  fSize;
-
-    void closeMMap();
-
     typedef SkMemoryStream INHERITED;
 };
 
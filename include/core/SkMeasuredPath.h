@@ -0,0 +1,62 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#ifndef SkMeasuredPath_DEFINED
+#define SkMeasuredPath_DEFINED
+
+#include "SkPath.h"
+#include "SkPathMeasure.h"
+#include "SkRefCnt.h"
+
+/** \class SkMeasuredPath
+
+    SkMeasuredPath holds a copy of a path together with the measurements of
+    its first contour, which is what text is laid out along by
+    SkCanvas::drawTextOnPath. Measuring a path means flattening its curves
+    into a table of segments; when many strings are drawn along the same
+    path (e.g. repeated labels along a long street) build one SkMeasuredPath
+    and pass it to SkCanvas::drawTextOnMeasuredPath, so that the table is
+    computed once instead of on every draw.
+
+    The measurements are computed in the constructor, after which the object
+    is immutable and may be shared between canvases and threads.
+*/
+class SK_API SkMeasuredPath : public SkRefCnt {
+public:
+    SK_DECLARE_INST_COUNT(SkMeasuredPath)
+
+    explicit SkMeasuredPath(const SkPath& path);
+    virtual ~SkMeasuredPath();
+
+    /** Return the path that was measured.
+    */
+    const SkPath& getPath() const { return fPath; }
+
+    /** Return the length of the path's first contour.
+    */
+    SkScalar getLength() const { return fLength; }
+
+    /** Pins distance to 0 <= distance <= getLength(), and then computes
+        the corresponding position and tangent.
+        Returns false if the contour has zero length, in which case position
+        and tangent are unchanged.
+    */
+    bool SK_WARN_UNUSED_RESULT getPosTan(SkScalar distance, SkPoint* position,
+                                         SkVector* tangent) const;
+
+private:
+    SkPath                  fPath;
+    // Only ever queried after being built, which does not modify it.
+    mutable SkPathMeasure   fMeasure;
+    SkScalar                fLength;
+
+    typedef SkRefCnt INHERITED;
+};
+
+#endif
@@ -989,6 +989,10 @@ private:
 
     inline bool hasOnlyMoveTos() const;
 
+    // Returns an ID for the points and verbs, shared by copies of this path
+    // until one of them is edited.
+    uint32_t getPathRefGenID() const;
+
     Convexity internalGetConvexity() const;
 
     bool isRectContour(bool allowPartial, int* currVerb, const SkPoint** pts,
@@ -998,6 +1002,8 @@ private:
     friend class SkAutoDisableOvalCheck;
     friend class SkAutoDisableDirectionCheck;
     friend class SkBench_AddPathTest; // perf test pathTo/reversePathTo
+    friend class SkAAClipCache; // getPathRefGenID
+    friend class SkStrokeCache; // getPathRefGenID
 };
 
 #endif
@@ -16,8 +16,11 @@
 class SkBBoxHierarchy;
 class SkBitmap;
 class SkCanvas;
+class SkData;
+struct SkRect;
 class SkPicturePlayback;
 class SkPictureRecord;
+class SkPictureSegments;
 class SkStream;
 class SkWStream;
 
@@ -46,6 +49,16 @@ public:
      */
     explicit SkPicture(SkStream*, bool* success = NULL,
                        SkSerializationHelpers::DecodeBitmap decoder = NULL);
+    /**
+     *  Recreate a picture that was serialized into data, e.g. the contents of
+     *  an SkMMAPStream (see SkMemoryStream::copyToData()). Rather than copying
+     *  everything up front, the picture refs data and reads from it in place:
+     *  the drawing commands are never copied, and each bitmap, paint and path
+     *  is read from data the first time a draw uses it. *success and decoder
+     *  are as for the stream constructor.
+     */
+    explicit SkPicture(SkData* data, bool* success = NULL,
+                       SkSerializationHelpers::DecodeBitmap decoder = NULL);
     virtual ~SkPicture();
 
     /**
@@ -116,6 +129,52 @@ public:
     */
     void endRecording();
 
+    /** Begin recording a segment: a named part of the picture that can be
+        recorded again on its own later, without re-recording the rest of the
+        picture.
+
+        While the picture is recording, this inserts a new segment at the
+        current point of the recording canvas, as if the segment were a
+        picture passed to drawPicture() there. The segment is drawn with the
+        matrix and clip that the recording canvas has at that point, and its
+        own drawing starts from them.
+
+        Once the segment exists, beginning it again records new contents for
+        it, which replace the old ones when endRecordingSegment() is called
+        (whether or not the picture is still recording). The rest of the
+        picture's drawing is kept as is, and the area of the picture covered
+        by the old and new contents is added to getDirtyBounds().
+
+        Only one segment may record at a time, and the picture must not be
+        drawn or copied while a segment is recording. Copies of the picture
+        keep the contents that its segments had when they were made, and do
+        not have segments of their own. Neither does a picture read from a
+        stream: segments are serialized as plain subpictures.
+
+        @param segmentID identifies the segment to the caller.
+        @return the canvas to record the segment's drawing into, or NULL if
+                the segment does not exist and the picture is not recording.
+    */
+    SkCanvas* beginRecordingSegment(uint32_t segmentID);
+
+    /** Finish recording the segment begun by beginRecordingSegment(), and
+        install its new contents.
+    */
+    void endRecordingSegment();
+
+    /** Return in bounds the area of the picture (in the coordinates of its
+        recording canvas, before any of its matrix) where re-recording
+        segments has changed what the picture draws, since the picture was
+        recorded or since the last call to clearDirtyBounds(). A caller that
+        keeps the picture rendered somewhere only needs to repaint this area.
+        Returns false if nothing has changed.
+    */
+    bool getDirtyBounds(SkRect* bounds) const;
+
+    /** Empty the area returned by getDirtyBounds().
+    */
+    void clearDirtyBounds();
+
     /** Replays the drawing commands on the specified canvas. This internally
         calls endRecording() if that has not already been called.
         @param surface the canvas receiving the drawing commands.
@@ -159,7 +218,10 @@ protected:
     // V9 : Allow the reader and writer of an SKP disagree on whether to support
     //      SK_SUPPORT_HINTING_SCALE_FACTOR
     // V10: add drawRRect, drawOval, clipRRect
-    static const uint32_t PICTURE_VERSION = 10;
+    // V11: keep the contents 4-byte aligned, and record the offsets of the
+    //      flattened bitmaps, paints and paths, so that they can be read in place
+    // V12: add drawPosTextRuns
+    static const uint32_t PICTURE_VERSION = 12;
 
     // fPlayback, fRecord, fWidth & fHeight are protected to allow derived classes to
     // install their own SkPicturePlayback-derived players,SkPictureRecord-derived
@@ -173,6 +235,13 @@ protected:
     virtual SkBBoxHierarchy* createBBoxHierarchy() const;
 
 private:
+    // The segments recorded by beginRecordingSegment(), created as needed.
+    SkPictureSegments* fSegments;
+
+    // Reads a serialized picture from stream. If data is not NULL, stream
+    // reads from data, and the picture is loaded in place.
+    void initFromStream(SkStream*, SkData* data, bool* success,
+                        SkSerializationHelpers::DecodeBitmap decoder);
 
     friend class SkFlatPicture;
     friend class SkPicturePlayback;
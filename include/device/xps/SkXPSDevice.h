@@ -117,6 +117,13 @@ protected:
         const SkScalar pos[], SkScalar constY, int scalarsPerPos,
         const SkPaint& paint) SK_OVERRIDE;
 
+    virtual void drawPosTextRuns(
+        const SkDraw& draw,
+        const SkCanvas::PosTextRun runs[], int runCount,
+        const SkPaint& paint) SK_OVERRIDE {
+        this->drawPosTextRunsAsPosText(draw, runs, runCount, paint);
+    }
+
     virtual void drawTextOnPath(
         const SkDraw&,
         const void* text, size_t len,
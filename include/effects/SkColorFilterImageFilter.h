@@ -23,8 +23,9 @@ protected:
     SkColorFilterImageFilter(SkFlattenableReadBuffer& buffer);
     virtual void flatten(SkFlattenableWriteBuffer&) const SK_OVERRIDE;
 
-    virtual bool onFilterImage(Proxy*, const SkBitmap& src, const SkMatrix&,
+    virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* loc) SK_OVERRIDE;
+    virtual bool onSourceBounds(const SkIRect&, const SkMatrix&, SkIRect*) SK_OVERRIDE;
 
     virtual SkColorFilter* asColorFilter() const SK_OVERRIDE;
 
@@ -19,6 +19,7 @@ public:
 protected:
     SkMorphologyImageFilter(SkFlattenableReadBuffer& buffer);
     virtual void flatten(SkFlattenableWriteBuffer&) const SK_OVERRIDE;
+    virtual bool onSourceBounds(const SkIRect&, const SkMatrix&, SkIRect*) SK_OVERRIDE;
 #if SK_SUPPORT_GPU
     virtual bool canFilterImageGPU() const SK_OVERRIDE { return true; }
 #endif
@@ -35,7 +36,7 @@ public:
     SkDilateImageFilter(int radiusX, int radiusY, SkImageFilter* input = NULL)
     : INHERITED(radiusX, radiusY, input) {}
 
-    virtual bool onFilterImage(Proxy*, const SkBitmap& src, const SkMatrix&,
+    virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* offset) SK_OVERRIDE;
 #if SK_SUPPORT_GPU
     virtual GrTexture* filterImageGPU(Proxy* proxy, GrTexture* src,
@@ -56,7 +57,7 @@ public:
     SkErodeImageFilter(int radiusX, int radiusY, SkImageFilter* input = NULL)
     : INHERITED(radiusX, radiusY, input) {}
 
-    virtual bool onFilterImage(Proxy*, const SkBitmap& src, const SkMatrix&,
+    virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* offset) SK_OVERRIDE;
 #if SK_SUPPORT_GPU
     virtual GrTexture* filterImageGPU(Proxy* proxy, GrTexture* src,
@@ -26,7 +26,7 @@ protected:
 
     // Recurses on input (if non-NULL), and returns the processed result,
     // otherwise returns src.
-    SkBitmap getInputResult(Proxy*, const SkBitmap& src, const SkMatrix&,
+    SkBitmap getInputResult(Proxy*, const SkBitmap& src, const Context&,
                             SkIPoint* offset);
 
 #if SK_SUPPORT_GPU
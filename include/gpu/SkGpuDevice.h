@@ -80,6 +80,12 @@ public:
     virtual void drawPosText(const SkDraw&, const void* text, size_t len,
                              const SkScalar pos[], SkScalar constY,
                              int scalarsPerPos, const SkPaint&) SK_OVERRIDE;
+    virtual void drawPosTextRuns(const SkDraw& draw,
+                                 const SkCanvas::PosTextRun runs[],
+                                 int runCount,
+                                 const SkPaint& paint) SK_OVERRIDE {
+        this->drawPosTextRunsAsPosText(draw, runs, runCount, paint);
+    }
     virtual void drawTextOnPath(const SkDraw&, const void* text, size_t len,
                                 const SkPath& path, const SkMatrix* matrix,
                                 const SkPaint&) SK_OVERRIDE;
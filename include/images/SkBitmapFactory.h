@@ -8,8 +8,11 @@
 #ifndef SkBitmapFactory_DEFINED
 #define SkBitmapFactory_DEFINED
 
+#include "SkTypes.h"
+
 class SkBitmap;
 class SkData;
+class SkImageCache;
 
 /**
  *  General purpose factory for decoding bitmaps.
@@ -41,6 +44,19 @@ public:
      */
     static bool DecodeBitmap(SkBitmap*, const SkData*,
                              Constraints constraint = kDecodePixels_Constraint);
+
+    /**
+     *  As above, but the decoded pixels are kept in cache, under sourceID,
+     *  and only decoded again once the cache has evicted them. sourceID must
+     *  identify the encoded data, e.g. one from SkImageCache::NewSourceID()
+     *  for each image, reused whenever that image is decoded again.
+     *
+     *  The bitmap shares its pixels with the cache, but they are not pinned:
+     *  if the cache evicts them, they are freed once the bitmap lets go.
+     */
+    static bool DecodeBitmap(SkBitmap*, const SkData*, SkImageCache* cache,
+                             uint32_t sourceID,
+                             Constraints constraint = kDecodePixels_Constraint);
 };
 
 #endif // SkBitmapFactory_DEFINED
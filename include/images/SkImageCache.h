@@ -0,0 +1,138 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageCache_DEFINED
+#define SkImageCache_DEFINED
+
+#include "SkBitmap.h"
+#include "SkThread.h"
+
+/**
+ *  A thread-safe cache of decoded images, which evicts the least recently
+ *  used ones once the pixels it holds exceed a byte budget.
+ *
+ *  Entries are identified by the image they were decoded from (a source ID,
+ *  see NewSourceID()), the sample size and the config. The entries are split
+ *  into shards, each with its own lock, so that lookups of different images
+ *  from different threads rarely contend.
+ *
+ *  An entry can be pinned while its pixels are in use (e.g. while locked),
+ *  which keeps it from being evicted. Pinned entries still count against the
+ *  budget.
+ */
+class SK_API SkImageCache : SkNoncopyable {
+public:
+    struct Key {
+        uint32_t         fSourceID;
+        int32_t          fSampleSize;
+        SkBitmap::Config fConfig;
+    };
+
+    struct Stats {
+        int32_t fHits;
+        int32_t fMisses;
+        int32_t fEvictions;
+        int     fCount;         // number of entries
+        size_t  fBytesUsed;
+    };
+
+    /**
+     *  Create a cache that holds up to byteLimit bytes of pixels, or any
+     *  amount if byteLimit is 0.
+     */
+    explicit SkImageCache(size_t byteLimit = 0);
+    ~SkImageCache();
+
+    /**
+     *  Returns the cache shared by SkImageRef_GlobalPool and anyone else who
+     *  does not need a cache of their own. It starts with no byte limit.
+     */
+    static SkImageCache* GetGlobal();
+
+    /**
+     *  Returns a new ID, different from all others returned, to identify a
+     *  source of images in Keys.
+     */
+    static uint32_t NewSourceID();
+
+    size_t getByteLimit() const;
+
+    /**
+     *  Sets a new byte limit (0 meaning none), evicting entries if the cache
+     *  is now over it.
+     */
+    void setByteLimit(size_t byteLimit);
+
+    size_t getBytesUsed() const;
+
+    /**
+     *  If the cache holds an entry for key, set bitmap to share its pixels and
+     *  return true. If pin is true, the entry is also pinned, and must later
+     *  be unpinned. Otherwise return false and leave bitmap unchanged.
+     */
+    bool find(const Key& key, SkBitmap* bitmap, bool pin = false);
+
+    /**
+     *  Add the (decoded) bitmap to the cache under key, pinning it if pin is
+     *  true. If another thread got there first, bitmap is set to share the
+     *  pixels of the entry already in the cache instead.
+     */
+    void add(const Key& key, SkBitmap* bitmap, bool pin = false);
+
+    /**
+     *  Undo one pin of key's entry. Once all of its pins are undone, the entry
+     *  becomes the most recently used.
+     */
+    void unpin(const Key& key);
+
+    /**
+     *  Remove key's entry, whether or not it is pinned. Bitmaps that share its
+     *  pixels keep them.
+     */
+    void remove(const Key& key);
+
+    /**
+     *  Remove key's entry unless it is pinned, returning true if it was
+     *  removed. Use this instead of remove() when other owners of the key
+     *  (e.g. imagerefs sharing a source ID) may be using the pixels.
+     */
+    bool removeIfUnpinned(const Key& key);
+
+    /**
+     *  Evict least recently used entries until the cache holds no more than
+     *  bytes. Pinned entries are never evicted, so it may hold more.
+     */
+    void purgeTo(size_t bytes);
+
+    Stats getStats() const;
+
+    void dump() const;
+
+private:
+    enum {
+        kShardCount = 8
+    };
+
+    class Shard;
+
+    Shard*          fShards[kShardCount];
+    mutable SkMutex fBudgetMutex;
+    size_t          fByteLimit;         // guarded by fBudgetMutex
+    size_t          fBytesUsed;         // guarded by fBudgetMutex
+    int32_t         fClock;             // for stamping uses, only touched atomically
+    int32_t         fHits;
+    int32_t         fMisses;
+    int32_t         fEvictions;
+
+    Shard* shardFor(const Key&) const;
+    void changeBytesUsed(size_t added, size_t removed);
+    bool isOverBudget(size_t limit) const;
+    bool evictOldest();
+    bool removeEntry(const Key&, bool evenIfPinned);
+};
+
+#endif
@@ -14,6 +14,7 @@
 #include "SkRefCnt.h"
 
 class SkStream;
+struct SkIRect;
 
 /** \class SkImageDecoder
 
@@ -178,6 +179,31 @@ public:
         return this->decode(stream, bitmap, SkBitmap::kNo_Config, mode);
     }
 
+    /** Prepare the decoder to decode arbitrary rectangles out of the image in
+        the stream, with decodeRegion(). The decoder refs the stream and keeps
+        it until it is deleted or another index is built, so the stream must
+        be rewindable. On success, width and height (if not NULL) are set to
+        the dimensions of the whole image.
+
+        Returns false if the image cannot be read, or if this decoder does not
+        support region decoding (only JPEG and PNG do).
+    */
+    bool buildTileIndex(SkStream*, int* width, int* height);
+
+    /** Decode the part of the image (previously indexed by buildTileIndex())
+        that lies inside rect into bitmap, keeping 1 of every sampleSize
+        pixels in each direction (see setSampleSize()). Only the rows and
+        columns needed for the rectangle, and one full width row to read
+        into, are kept in memory, so this can be used to cut small tiles out
+        of images too large to decode whole.
+        The config is chosen as it is for decode().
+
+        Returns false if there is no index, or if rect does not intersect the
+        image. On failure the bitmap is left untouched.
+    */
+    bool decodeRegion(SkBitmap* bitmap, const SkIRect& rect, int sampleSize,
+                      SkBitmap::Config pref = SkBitmap::kNo_Config);
+
     /** Given a stream, this will try to find an appropriate decoder object.
         If none is found, the method returns NULL.
     */
@@ -266,6 +292,18 @@ protected:
     // must be overridden in subclasses. This guy is called by decode(...)
     virtual bool onDecode(SkStream*, SkBitmap* bitmap, Mode) = 0;
 
+    // If the decoder wants to support region decoding, it must override
+    // both of these. They are called by buildTileIndex(...) and
+    // decodeRegion(...) respectively. The rect passed to onDecodeRegion
+    // is non-empty, and sampleSize is at least 1.
+    virtual bool onBuildTileIndex(SkStream*, int* width, int* height) {
+        return false;
+    }
+    virtual bool onDecodeRegion(SkBitmap* bitmap, const SkIRect& rect,
+                                int sampleSize) {
+        return false;
+    }
+
     /** Can be queried from within onDecode, to see if the user (possibly in
         a different thread) has requested the decode to cancel. If this returns
         true, your onDecode() should stop and return false.
@@ -11,6 +11,7 @@
 #include "SkTypes.h"
 
 class SkBitmap;
+class SkThreadPool;
 class SkWStream;
 
 class SkImageEncoder {
@@ -81,4 +82,19 @@ protected:
 DECLARE_ENCODER_CREATOR(JPEGImageEncoder);
 DECLARE_ENCODER_CREATOR(PNGImageEncoder);
 
+/**
+ * Returns a PNG encoder for large images, which splits the image into strips
+ * of stripHeight rows, and filters and compresses them as separate tasks on
+ * pool (which may be NULL to run them all on the calling thread, and is not
+ * owned by the encoder). The strips are joined into one zlib stream, so the
+ * result is an ordinary PNG, a little larger than CreatePNGImageEncoder()'s.
+ *
+ * zlibLevel trades speed for size, from 1 (fastest) to 9 (smallest), with 0
+ * meaning no compression and -1 zlib's default (6). A stripHeight of 0 picks
+ * one from the width of the image.
+ */
+SkImageEncoder* CreateParallelPNGImageEncoder(SkThreadPool* pool,
+                                              int zlibLevel = -1,
+                                              int stripHeight = 0);
+
 #endif
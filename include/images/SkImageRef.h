@@ -12,10 +12,10 @@
 
 #include "SkPixelRef.h"
 #include "SkBitmap.h"
+#include "SkImageCache.h"
 #include "SkImageDecoder.h"
 #include "SkString.h"
 
-class SkImageRefPool;
 class SkStream;
 
 // define this to enable dumping whenever we add/remove/purge an imageref
@@ -60,6 +60,13 @@ public:
     // returns the factory parameter
     SkImageDecoderFactory* setDecoderFactory(SkImageDecoderFactory*);
 
+    /** Each imageref is given its own source ID for identifying its pixels in
+        an SkImageCache. Imagerefs that decode the same encoded data in the
+        same way can be given the same ID, so that they share their pixels.
+     */
+    uint32_t getSourceID() const { return fSourceID; }
+    void setSourceID(uint32_t sourceID) { fSourceID = sourceID; }
+
 protected:
     /** Override if you want to install a custom allocator.
         When this is called we will have already acquired the mutex!
@@ -78,6 +85,11 @@ protected:
     SkImageRef(SkFlattenableReadBuffer&);
     virtual void flatten(SkFlattenableWriteBuffer&) const SK_OVERRIDE;
 
+    /** Returns the key for our decoded pixels in an SkImageCache.
+        Call with the mutex held.
+     */
+    SkImageCache::Key getCacheKey() const;
+
     SkBitmap fBitmap;
 
 private:
@@ -92,11 +104,7 @@ private:
     int                     fSampleSize;
     bool                    fDoDither;
     bool                    fErrorInDecoding;
-
-    friend class SkImageRefPool;
-
-    SkImageRef*  fPrev, *fNext;
-    size_t ramUsed() const;
+    uint32_t                fSourceID;
 
     typedef SkPixelRef INHERITED;
 };
@@ -12,6 +12,11 @@
 
 #include "SkImageRef.h"
 
+/** An imageref that keeps its decoded pixels in the global SkImageCache, so
+    that only as many images stay decoded as the cache's budget allows, and
+    the least recently used ones are freed first. The pixels are pinned in
+    the cache while they are locked.
+ */
 class SkImageRef_GlobalPool : public SkImageRef {
 public:
     // if pool is null, use the global pool
@@ -50,11 +55,14 @@ protected:
                           SkBitmap* bitmap, SkBitmap::Config config,
                           SkImageDecoder::Mode mode);
 
+    virtual void* onLockPixels(SkColorTable**);
     virtual void onUnlockPixels();
 
     SkImageRef_GlobalPool(SkFlattenableReadBuffer&);
 
 private:
+    bool fPinned;   // our pixels are pinned in the cache
+
     typedef SkImageRef INHERITED;
 };
 
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathOps_DEFINED
+#define SkPathOps_DEFINED
+
+#include "SkTypes.h"
+
+class SkPath;
+
+/**
+ *  The logical operations that can be performed when combining two paths.
+ *  Each combines the areas that the two paths fill, taking their fill types
+ *  (including the inverse ones) into account.
+ */
+enum SkPathOp {
+    kDifference_PathOp,     //!< subtract the second path from the first
+    kIntersect_PathOp,      //!< keep what is in both paths
+    kUnion_PathOp,          //!< keep what is in either path
+    kXOR_PathOp             //!< keep what is in one path but not the other
+};
+
+/**
+ *  Set result to the area described by combining one and two with op. The
+ *  result has no self-intersections or overlapping contours, and has the
+ *  even-odd fill type, or the inverse even-odd fill type if it covers
+ *  everything outside of its contours.
+ *
+ *  result may be the same object as one or two. Returns false, leaving
+ *  result unchanged, if either path has a non-finite point, or if the paths
+ *  are too degenerate to combine (e.g. edges that overlap a different edge
+ *  of the same contour).
+ */
+bool SK_API Op(const SkPath& one, const SkPath& two, SkPathOp op,
+               SkPath* result);
+
+/**
+ *  Set result to a path that fills the same area as path, but has no
+ *  self-intersections or overlapping contours. It has the even-odd fill
+ *  type, or the inverse even-odd one if path has an inverse fill type.
+ *
+ *  result may be the same object as path. Returns false, leaving result
+ *  unchanged, if path has a non-finite point or is too degenerate to
+ *  simplify.
+ */
+bool SK_API Simplify(const SkPath& path, SkPath* result);
+
+#endif
@@ -48,6 +48,31 @@ public:
      */
     SK_API bool emitPDF(SkWStream* stream);
 
+    /** Write the PDF to the passed stream page by page as it is built,
+     *  instead of all at once from emitPDF().  Each page added with
+     *  appendPage() is written out when the next one is appended (or by
+     *  finishStream()), and in the meantime its content stream and images
+     *  are compressed on worker threads.  Fonts are subset and written at
+     *  the end, along with the page tree and the cross reference table.
+     *  This keeps about two pages in memory at a time, however many pages
+     *  the document has.
+     *
+     *  It is an error to call this (it will return false) if any pages have
+     *  been added.  Once streaming, setPage() and emitPDF() fail, and the
+     *  stream must stay valid until finishStream() returns.
+     *
+     *  @param stream      The writable output stream to send the PDF to.
+     *  @param threadCount The number of threads to compress on, besides the
+     *                     calling thread.
+     */
+    SK_API bool beginStream(SkWStream* stream, int threadCount = 1);
+
+    /** Write out the last page, the fonts, the page tree and the trailer of
+     *  a document started with beginStream().  Returns false if the
+     *  document is not being streamed or no pages have been added.
+     */
+    SK_API bool finishStream();
+
     /** Sets the specific page to the passed PDF device. If the specified
      *  page is already set, this overrides it. Returns true if successful.
      *  Will fail if the document has already been emitted.
@@ -82,6 +107,15 @@ private:
 
     SkPDFDict* fTrailerDict;
 
+    // Only set between beginStream() and the destructor.
+    struct StreamState;
+    SkTScopedPtr<StreamState> fStreamState;
+
+    /** Write out the page most recently added while streaming, once its
+     *  objects have been prepared, and release them.
+     */
+    void emitPendingPage();
+
     /** Output the PDF header to the passed stream.
      *  @param stream    The writable output stream to send the header to.
      */
@@ -28,6 +28,11 @@ public:
      */
     void wait();
 
+    /**
+     * Returns true if run() has been called count times. Does not block.
+     */
+    bool isDone();
+
 private:
     SkCondVar fReady;
     int32_t   fCount;
@@ -61,9 +61,15 @@ public:
     virtual void drawPosTextH(const void* text, size_t byteLength,
                               const SkScalar xpos[], SkScalar constY,
                               const SkPaint&) SK_OVERRIDE;
+    virtual void drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                 const SkPaint&) SK_OVERRIDE;
     virtual void drawTextOnPath(const void* text, size_t byteLength,
                                 const SkPath& path, const SkMatrix* matrix,
                                 const SkPaint&) SK_OVERRIDE;
+    virtual void drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                        const SkMeasuredPath& path,
+                                        const SkMatrix* matrix,
+                                        const SkPaint&) SK_OVERRIDE;
     virtual void drawPicture(SkPicture&) SK_OVERRIDE;
     virtual void drawVertices(VertexMode vmode, int vertexCount,
                               const SkPoint vertices[], const SkPoint texs[],
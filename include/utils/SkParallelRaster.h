@@ -0,0 +1,45 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkParallelRaster_DEFINED
+#define SkParallelRaster_DEFINED
+
+#include "SkTypes.h"
+
+class SkBitmap;
+class SkPicture;
+
+class SK_API SkParallelRaster {
+public:
+    enum {
+        kDefaultTileSize = 256
+    };
+
+    /**
+     *  Play the picture back into dst, which must already have its pixels
+     *  allocated, using threadCount threads (the calling thread included).
+     *
+     *  dst is split into tiles of tileWidth x tileHeight pixels. Each thread
+     *  draws from its own clone of the picture into a canvas that wraps only
+     *  the pixels of the tile it is working on, so no mutable state is shared
+     *  between threads. Tiles are handed out on demand, so threads that hit
+     *  cheap tiles move on to the next one. If the picture was recorded with
+     *  a bounding box hierarchy (e.g. SkRTree or SkTileGrid), each tile only
+     *  replays the operations that can touch it.
+     *
+     *  As with any tiled playback, edges that get clipped to a tile boundary
+     *  may differ very slightly from an untiled draw.
+     *
+     *  dst is not erased first. Returns false if dst has no pixels or
+     *  unsupported parameters were given.
+     */
+    static bool DrawPicture(SkPicture* picture, SkBitmap* dst, int threadCount,
+                            int tileWidth = kDefaultTileSize,
+                            int tileHeight = kDefaultTileSize);
+};
+
+#endif
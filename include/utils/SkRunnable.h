@@ -14,4 +14,17 @@ public:
     virtual void run() = 0;
 };
 
+/**
+ * Work that can be split over a range of indices, see SkThreadPool::parallelFor.
+ */
+class SkRangeRunnable {
+public:
+    virtual ~SkRangeRunnable() {};
+    /**
+     * Do the work for indices start <= i < stop. May be called concurrently
+     * for disjoint ranges.
+     */
+    virtual void run(int start, int stop) = 0;
+};
+
 #endif
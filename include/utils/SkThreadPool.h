@@ -10,11 +10,22 @@
 
 #include "SkCondVar.h"
 #include "SkTDArray.h"
-#include "SkTInternalLList.h"
 
+class SkCountdown;
+class SkRangeRunnable;
 class SkRunnable;
-class SkThread;
 
+/**
+ * Each thread in the pool has its own queue of tasks. Tasks added from one of
+ * the pool's threads go on that thread's queue, which it runs newest first,
+ * while threads that run out of work steal the oldest tasks from the others.
+ * Threads only sleep when there is nothing left to steal, and add() only
+ * wakes one if some are asleep.
+ *
+ * Tasks may themselves add tasks and wait for them (see wait() and
+ * parallelFor()), so one pool can be shared by everything that wants to run
+ * in parallel instead of each user creating its own threads.
+ */
 class SkThreadPool {
 
 public:
@@ -22,6 +33,10 @@ public:
      * Create a threadpool with exactly count (>=0) threads.
      */
     explicit SkThreadPool(int count);
+
+    /**
+     * Runs every task that is still queued, then stops the threads.
+     */
     ~SkThreadPool();
 
     /**
@@ -30,21 +45,49 @@ public:
      */
     void add(SkRunnable*);
 
- private:
-    struct LinkedRunnable {
-        // Unowned pointer.
-        SkRunnable* fRunnable;
+    /**
+     * As add(SkRunnable*), but calls done->run() once the runnable has run.
+     * Giving a group of tasks the same SkCountdown, set to the size of the
+     * group, lets the caller wait() for just that group.
+     */
+    void add(SkRunnable*, SkCountdown* done);
 
-    private:
-        SK_DECLARE_INTERNAL_LLIST_INTERFACE(LinkedRunnable);
+    /**
+     * Blocks until done has reached zero, running queued tasks on the calling
+     * thread in the meantime. May be called from within a task.
+     */
+    void wait(SkCountdown* done);
+
+    /**
+     * Calls body->run(start, stop) for consecutive subranges of [begin, end),
+     * each no longer than grain, on the pool's threads and the calling thread,
+     * and returns once all of them have run. The subranges are handed out on
+     * demand, so threads that get cheap ones move on to the next. May be
+     * called from within a task.
+     */
+    void parallelFor(int begin, int end, SkRangeRunnable* body, int grain = 1);
+
+ private:
+    struct Task {
+        // Unowned pointers.
+        SkRunnable*  fRunnable;
+        SkCountdown* fDone;
     };
+    class Worker;
+
+    SkTDArray<Worker*>  fWorkers;
+    SkCondVar           fReady;
+    int32_t             fPending;   // Tasks queued but not yet claimed.
+    int32_t             fSleeping;  // Threads waiting on fReady.
+    int32_t             fNextWorker;
+    bool                fDone;
 
-    SkTInternalLList<LinkedRunnable>    fQueue;
-    SkCondVar                           fReady;
-    SkTDArray<SkThread*>                fThreads;
-    bool                            fDone;
+    void push(const Task&);
+    bool claim(int self, Task*);
+    int currentWorker() const;
 
-    static void Loop(void*);  // Static because we pass in this.
+    static void RunTask(const Task&);
+    static void Loop(void*);  // Static because we pass in the Worker.
 };
 
 #endif
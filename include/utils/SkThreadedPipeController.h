@@ -0,0 +1,106 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedPipeController_DEFINED
+#define SkThreadedPipeController_DEFINED
+
+#include "SkBitmap.h"
+#include "SkCondVar.h"
+#include "SkGPipe.h"
+#include "SkTDArray.h"
+
+/**
+ *  An SkGPipeController that plays the stream back on other threads while it
+ *  is being written, so that one thread can issue draw calls while others
+ *  rasterize them.
+ *
+ *  The target bitmap is split into horizontal bands, one per reader thread,
+ *  and each reader plays the whole stream back into its own band. The stream
+ *  is written into a fixed ring of blocks. Readers follow the writer around
+ *  the ring without taking a lock as long as there is data for them, and the
+ *  writer waits for every reader to be done with a block before reusing it,
+ *  so a writer that gets a full ring ahead is held back instead of buffering
+ *  without limit.
+ *
+ *  Only one thread may write into the pipe, e.g.
+ *
+ *      SkThreadedPipeController controller(bitmap, 4);
+ *      SkGPipeWriter writer;
+ *      SkCanvas* canvas = writer.startRecording(&controller,
+ *                              SkThreadedPipeController::kWriterFlags);
+ *      ... draw into canvas ...
+ *      writer.endRecording();
+ *      controller.join();
+ */
+class SK_API SkThreadedPipeController : public SkGPipeController {
+public:
+    enum {
+        /**
+         *  The flags to pass to SkGPipeWriter::startRecording(). The stream
+         *  has to carry its own copy of each bitmap, as it would for a reader
+         *  in another process, since the SkBitmapHeap that otherwise shares
+         *  them with the readers is not thread-safe.
+         */
+        kWriterFlags = SkGPipeWriter::kCrossProcess_Flag,
+
+        kDefaultBlockCount = 8,
+        kDefaultBlockSize = 16 * 1024
+    };
+
+    /**
+     *  Start readerCount threads, each drawing into a band of target, which
+     *  must already have its pixels allocated, and must not be touched by
+     *  anyone else until join() returns. The ring holds blockCount blocks of
+     *  at least blockSize bytes each.
+     */
+    SkThreadedPipeController(const SkBitmap& target, int readerCount,
+                             int blockCount = kDefaultBlockCount,
+                             size_t blockSize = kDefaultBlockSize);
+
+    /**
+     *  Calls join().
+     */
+    virtual ~SkThreadedPipeController();
+
+    virtual void* requestBlock(size_t minRequest, size_t* actual) SK_OVERRIDE;
+    virtual void notifyWritten(size_t bytes) SK_OVERRIDE;
+    virtual int numberOfReaders() const SK_OVERRIDE;
+
+    /**
+     *  Wait for the readers to play back everything written so far, and end
+     *  their threads. Call this after SkGPipeWriter::endRecording(), after
+     *  which the target holds the finished drawing. Any further requests for
+     *  a block return NULL, which stops the writer.
+     */
+    void join();
+
+private:
+    struct Block;
+    class Reader;
+
+    void wake();
+    void sleep(int32_t wakeups);
+
+    SkBitmap            fTarget;
+    SkTDArray<Block>    fBlocks;
+    SkTDArray<Reader*>  fReaders;
+    Block*              fCurrent;       // the block the writer is filling
+    int32_t             fWriteSequence; // how many blocks it has requested
+    int32_t             fReaderCount;   // the readers that were started
+    bool                fJoined;
+
+    // Readers and the writer only take fCondVar's lock to sleep until the
+    // other side makes progress, which is counted by fWakeups.
+    SkCondVar           fCondVar;
+    int32_t             fWakeups;
+    int32_t             fSleepers;
+    int32_t             fShutdown;
+
+    typedef SkGPipeController INHERITED;
+};
+
+#endif
@@ -596,6 +596,14 @@ SkAAClip::~SkAAClip() {
     this->freeRuns();
 }
 
+size_t SkAAClip::getRunsSize() const {
+    if (NULL == fRunHead) {
+        return 0;
+    }
+    return sizeof(RunHead) + fRunHead->fRowCount * sizeof(YOffset) +
+           fRunHead->fDataSize;
+}
+
 SkAAClip& SkAAClip::operator=(const SkAAClip& src) {
     AUTO_AACLIP_VALIDATE(*this);
     src.validate();
@@ -29,6 +29,12 @@ public:
     bool isEmpty() const { return NULL == fRunHead; }
     const SkIRect& getBounds() const { return fBounds; }
 
+    /**
+     *  Returns the number of bytes allocated for the runs, which copies of
+     *  this clip share.
+     */
+    size_t getRunsSize() const;
+
     bool setEmpty();
     bool setRect(const SkIRect&);
     bool setRect(const SkRect&, bool doAA = true);
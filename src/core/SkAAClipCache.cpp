@@ -0,0 +1,102 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAAClipCache.h"
+#include "SkAAClip.h"
+#include "SkGraphics.h"
+#include "SkMatrix.h"
+#include "SkPath.h"
+#include "SkTLRUCache.h"
+
+namespace {
+
+struct Key {
+    uint32_t    fGenID;
+    uint32_t    fFillType;
+    SkScalar    fMatrix[9];
+    SkIRect     fBounds;
+};
+
+typedef SkTLRUCache<Key, SkAAClip> Cache;
+
+}
+
+static Cache& get_cache() {
+    static Cache gCache;
+    return gCache;
+}
+
+bool SkAAClipCache::SetPath(SkAAClip* dst, const SkPath& srcPath,
+                            const SkMatrix& matrix, const SkPath& devPath,
+                            const SkIRect& bounds) {
+    Cache& cache = get_cache();
+    if (0 == cache.getByteLimit()) {
+        SkRegion clip(bounds);
+        return dst->setPath(devPath, &clip, true);
+    }
+
+    Key key;
+    sk_bzero(&key, sizeof(key));
+    key.fGenID = srcPath.getPathRefGenID();
+    key.fFillType = srcPath.getFillType();
+    for (int i = 0; i < 9; ++i) {
+        key.fMatrix[i] = matrix.get(i);
+    }
+    key.fBounds = bounds;
+
+    if (cache.find(key, dst)) {
+        return !dst->isEmpty();
+    }
+
+    SkRegion clip(bounds);
+    bool nonEmpty = dst->setPath(devPath, &clip, true);
+    cache.add(key, *dst, dst->getRunsSize());
+    return nonEmpty;
+}
+
+size_t SkAAClipCache::GetByteLimit() {
+    return get_cache().getByteLimit();
+}
+
+size_t SkAAClipCache::SetByteLimit(size_t bytes) {
+    return get_cache().setByteLimit(bytes);
+}
+
+size_t SkAAClipCache::GetBytesUsed() {
+    return get_cache().getBytesUsed();
+}
+
+void SkAAClipCache::GetStats(int32_t* hits, int32_t* misses) {
+    get_cache().getStats(hits, misses);
+}
+
+void SkAAClipCache::PurgeAll() {
+    get_cache().purgeAll();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t SkGraphics::GetClipMaskCacheLimit() {
+    return SkAAClipCache::GetByteLimit();
+}
+
+size_t SkGraphics::SetClipMaskCacheLimit(size_t bytes) {
+    return SkAAClipCache::SetByteLimit(bytes);
+}
+
+size_t SkGraphics::GetClipMaskCacheUsed() {
+    return SkAAClipCache::GetBytesUsed();
+}
+
+void SkGraphics::GetClipMaskCacheStats(int32_t* hits, int32_t* misses) {
+    SkAAClipCache::GetStats(hits, misses);
+}
+
+void SkGraphics::PurgeClipMaskCache() {
+    SkAAClipCache::PurgeAll();
+}
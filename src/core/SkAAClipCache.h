@@ -0,0 +1,70 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAAClipCache_DEFINED
+#define SkAAClipCache_DEFINED
+
+#include "SkTypes.h"
+
+class SkAAClip;
+class SkMatrix;
+class SkPath;
+struct SkIRect;
+
+/**
+ *  A global, thread-safe cache of antialiased clips built from paths, so that
+ *  clipping to the same path again (after a restore(), or on another canvas
+ *  drawing the same tile) does not scan convert it again. This is the raster
+ *  counterpart of GrClipMaskCache.
+ *
+ *  A clip is identified by the generation ID of the source path's points and
+ *  verbs (shared by copies of the SkPath), its fill type, the matrix that
+ *  maps it to the device, and the device bounds it was limited to.
+ *
+ *  The cache is off until it is given a byte limit (see SetByteLimit(), or
+ *  SkGraphics::SetClipMaskCacheLimit()), since only clients that clip to the
+ *  same paths over and over gain from it. Beyond that limit the least
+ *  recently used clips are evicted.
+ */
+class SkAAClipCache {
+public:
+    /**
+     *  Same as dst->setPath(devPath, &SkRegion(bounds), true), where devPath
+     *  is srcPath transformed by matrix, but reuse the runs from an earlier
+     *  call with the same srcPath, matrix and bounds if they are cached, or
+     *  cache these for later calls.
+     */
+    static bool SetPath(SkAAClip* dst, const SkPath& srcPath,
+                        const SkMatrix& matrix, const SkPath& devPath,
+                        const SkIRect& bounds);
+
+    static size_t GetByteLimit();
+
+    /**
+     *  Set the max number of bytes of clips to keep, purging entries as
+     *  needed. 0 turns the cache off (and empties it). Returns the previous
+     *  limit.
+     */
+    static size_t SetByteLimit(size_t bytes);
+
+    static size_t GetBytesUsed();
+
+    /**
+     *  Return the number of SetPath() calls that found (hits) or did not find
+     *  (misses) their clip in the cache, while it was on.
+     */
+    static void GetStats(int32_t* hits, int32_t* misses);
+
+    /**
+     *  Remove all of the clips from the cache, and zero its statistics. Does
+     *  not change the limit.
+     */
+    static void PurgeAll();
+};
+
+#endif
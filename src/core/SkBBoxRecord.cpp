@@ -7,6 +7,7 @@
  */
 
 #include "SkBBoxRecord.h"
+#include "SkMeasuredPath.h"
 
 void SkBBoxRecord::drawOval(const SkRect& rect, const SkPaint& paint) {
     if (this->transformBounds(rect, &paint)) {
@@ -209,6 +210,47 @@ void SkBBoxRecord::drawPosTextH(const void* text, size_t byteLength, const SkSca
     INHERITED::drawPosTextH(text, byteLength, xpos, constY, paint);
 }
 
+void SkBBoxRecord::drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                   const SkPaint& paint) {
+    // join() would skip the empty bounds of a run of one glyph
+    SkRect bbox;
+    bool found = false;
+    for (int i = 0; i < runCount; ++i) {
+        if (runs[i].fCount <= 0) {
+            continue;
+        }
+        SkRect runBounds;
+        runBounds.set(runs[i].fPos, runs[i].fCount);
+        if (found) {
+            bbox.fLeft = SkMinScalar(bbox.fLeft, runBounds.fLeft);
+            bbox.fTop = SkMinScalar(bbox.fTop, runBounds.fTop);
+            bbox.fRight = SkMaxScalar(bbox.fRight, runBounds.fRight);
+            bbox.fBottom = SkMaxScalar(bbox.fBottom, runBounds.fBottom);
+        } else {
+            bbox = runBounds;
+            found = true;
+        }
+    }
+    if (!found) {
+        return;
+    }
+
+    SkPaint::FontMetrics metrics;
+    paint.getFontMetrics(&metrics);
+    bbox.fTop += metrics.fTop;
+    bbox.fBottom += metrics.fBottom;
+
+    // pad on left and right by half of max vertical glyph extents, as for
+    // drawPosText()
+    SkScalar pad = (metrics.fTop - metrics.fBottom) / 2;
+    bbox.fLeft += pad;
+    bbox.fRight -= pad;
+
+    if (this->transformBounds(bbox, &paint)) {
+        INHERITED::drawPosTextRuns(runs, runCount, paint);
+    }
+}
+
 void SkBBoxRecord::drawSprite(const SkBitmap& bitmap, int left, int top,
                               const SkPaint* paint) {
     SkRect bbox;
@@ -217,9 +259,7 @@ void SkBBoxRecord::drawSprite(const SkBitmap& bitmap, int left, int top,
     INHERITED::drawSprite(bitmap, left, top, paint);
 }
 
-void SkBBoxRecord::drawTextOnPath(const void* text, size_t byteLength,
-                                  const SkPath& path, const SkMatrix* matrix,
-                                  const SkPaint& paint) {
+static SkRect text_on_path_bounds(const SkPath& path, const SkPaint& paint) {
     SkRect bbox = path.getBounds();
     SkPaint::FontMetrics metrics;
     paint.getFontMetrics(&metrics);
@@ -230,12 +270,29 @@ void SkBBoxRecord::drawTextOnPath(const void* text, size_t byteLength,
     bbox.fRight -= pad;
     bbox.fTop += pad;
     bbox.fBottom -= pad;
+    return bbox;
+}
 
+void SkBBoxRecord::drawTextOnPath(const void* text, size_t byteLength,
+                                  const SkPath& path, const SkMatrix* matrix,
+                                  const SkPaint& paint) {
+    SkRect bbox = text_on_path_bounds(path, paint);
     if (this->transformBounds(bbox, &paint)) {
         INHERITED::drawTextOnPath(text, byteLength, path, matrix, paint);
     }
 }
 
+void SkBBoxRecord::drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                          const SkMeasuredPath& path,
+                                          const SkMatrix* matrix,
+                                          const SkPaint& paint) {
+    SkRect bbox = text_on_path_bounds(path.getPath(), paint);
+    if (this->transformBounds(bbox, &paint)) {
+        INHERITED::drawTextOnMeasuredPath(text, byteLength, path, matrix,
+                                          paint);
+    }
+}
+
 void SkBBoxRecord::drawVertices(VertexMode mode, int vertexCount,
                                 const SkPoint vertices[], const SkPoint texs[],
                                 const SkColor colors[], SkXfermode* xfer,
@@ -256,6 +313,16 @@ void SkBBoxRecord::drawPicture(SkPicture& picture) {
     }
 }
 
+void SkBBoxRecord::drawSegment(SkPicture& contents,
+                               const SkIRect& deviceBounds) {
+    // Re-recorded contents can draw anywhere in the segment's clip, so their
+    // width and height say nothing about where they land.
+    if (!deviceBounds.isEmpty()) {
+        this->handleBBox(SkRect::MakeFromIRect(deviceBounds));
+        INHERITED::drawSegment(contents, deviceBounds);
+    }
+}
+
 bool SkBBoxRecord::transformBounds(const SkRect& bounds, const SkPaint* paint) {
     SkRect outBounds = bounds;
     outBounds.sort();
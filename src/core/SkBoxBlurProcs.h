@@ -0,0 +1,42 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBoxBlurProcs_DEFINED
+#define SkBoxBlurProcs_DEFINED
+
+#include "SkTypes.h"
+
+/*  Platform-specific versions of the box blur passes in SkBlurMask.cpp.
+
+    Each takes the same parameters as the portable pass, and writes the same
+    bytes, but need not handle every row: it returns how many rows (starting
+    from the first) it blurred, and the portable code finishes the rest.
+    Strides are always computed from the full height, so the destination
+    layout is unchanged.
+ */
+
+/** Blur each row in X by a box of [-leftRadius, rightRadius], transposing
+    the result if transpose is true.
+ */
+typedef int (*SkBoxBlurProc)(const uint8_t* src, int srcRowBytes,
+                             uint8_t* dst, int leftRadius, int rightRadius,
+                             int width, int height, bool transpose);
+
+/** Blur each row in X by a box of the fractional radius given by radius and
+    outerWeight (the weight of the outermost pixels, 0..255), transposing
+    the result if transpose is true.
+ */
+typedef int (*SkBoxBlurInterpProc)(const uint8_t* src, int srcRowBytes,
+                                   uint8_t* dst, int radius, int width,
+                                   int height, bool transpose,
+                                   uint8_t outerWeight);
+
+// Return NULL if there is no faster version for this platform.
+SkBoxBlurProc SkBoxBlurGetPlatformProc();
+SkBoxBlurInterpProc SkBoxBlurInterpGetPlatformProc();
+
+#endif
@@ -8,12 +8,14 @@
 
 
 #include "SkCanvas.h"
+#include "SkAAClipCache.h"
 #include "SkBounder.h"
 #include "SkDevice.h"
 #include "SkDeviceImageFilterProxy.h"
 #include "SkDraw.h"
 #include "SkDrawFilter.h"
 #include "SkDrawLooper.h"
+#include "SkMeasuredPath.h"
 #include "SkMetaData.h"
 #include "SkPicture.h"
 #include "SkRasterClip.h"
@@ -994,7 +996,8 @@ void SkCanvas::internalDrawDevice(SkDevice* srcDev, int x, int y,
             SkDeviceImageFilterProxy proxy(dstDev);
             SkBitmap dst;
             const SkBitmap& src = srcDev->accessBitmap(false);
-            if (filter->filterImage(&proxy, src, *iter.fMatrix, &dst, &pos)) {
+            SkImageFilter::Context ctx(*iter.fMatrix, iter.fRC->getBounds());
+            if (filter->filterImage(&proxy, src, ctx, &dst, &pos)) {
                 SkPaint tmpUnfiltered(*paint);
                 tmpUnfiltered.setImageFilter(NULL);
                 dstDev->drawSprite(iter, dst, pos.x(), pos.y(), tmpUnfiltered);
@@ -1029,8 +1032,8 @@ void SkCanvas::drawSprite(const SkBitmap& bitmap, int x, int y,
         if (filter && !iter.fDevice->canHandleImageFilter(filter)) {
             SkDeviceImageFilterProxy proxy(iter.fDevice);
             SkBitmap dst;
-            if (filter->filterImage(&proxy, bitmap, *iter.fMatrix,
-                                    &dst, &pos)) {
+            SkImageFilter::Context ctx(*iter.fMatrix, iter.fRC->getBounds());
+            if (filter->filterImage(&proxy, bitmap, ctx, &dst, &pos)) {
                 SkPaint tmpUnfiltered(*paint);
                 tmpUnfiltered.setImageFilter(NULL);
                 iter.fDevice->drawSprite(iter, dst, pos.x(), pos.y(),
@@ -1137,22 +1140,37 @@ bool SkCanvas::clipRect(const SkRect& rect, SkRegion::Op op, bool doAA) {
     }
 }
 
+// Set dst to the clip of devPath, limited to bounds. If doAA and srcPath is
+// not null, the clip may come from SkAAClipCache, which knows devPath as
+// srcPath transformed by matrix.
+static bool setClipPath(SkRasterClip* dst, const SkPath* srcPath,
+                        const SkMatrix& matrix, const SkPath& devPath,
+                        const SkIRect& bounds, bool doAA) {
+    if (!doAA || NULL == srcPath) {
+        return dst->setPath(devPath, bounds, doAA);
+    }
+    SkAAClip aaclip;
+    SkAAClipCache::SetPath(&aaclip, *srcPath, matrix, devPath, bounds);
+    return dst->setAAClip(aaclip);
+}
+
 static bool clipPathHelper(const SkCanvas* canvas, SkRasterClip* currClip,
+                           const SkPath* srcPath, const SkMatrix& matrix,
                            const SkPath& devPath, SkRegion::Op op, bool doAA) {
-    // base is used to limit the size (and therefore memory allocation) of the
-    // region that results from scan converting devPath.
-    SkRegion base;
+    // bounds is used to limit the size (and therefore memory allocation) of
+    // the region that results from scan converting devPath.
+    SkIRect bounds;
 
     if (SkRegion::kIntersect_Op == op) {
         // since we are intersect, we can do better (tighter) with currRgn's
         // bounds, than just using the device. However, if currRgn is complex,
         // our region blitter may hork, so we do that case in two steps.
+        bounds = currClip->getBounds();
         if (currClip->isRect()) {
-            return currClip->setPath(devPath, *currClip, doAA);
+            return setClipPath(currClip, srcPath, matrix, devPath, bounds, doAA);
         } else {
-            base.setRect(currClip->getBounds());
             SkRasterClip clip;
-            clip.setPath(devPath, base, doAA);
+            setClipPath(&clip, srcPath, matrix, devPath, bounds, doAA);
             return currClip->op(clip, op);
         }
     } else {
@@ -1161,13 +1179,13 @@ static bool clipPathHelper(const SkCanvas* canvas, SkRasterClip* currClip,
             return currClip->setEmpty();
         }
 
-        base.setRect(0, 0, device->width(), device->height());
+        bounds.set(0, 0, device->width(), device->height());
 
         if (SkRegion::kReplace_Op == op) {
-            return currClip->setPath(devPath, base, doAA);
+            return setClipPath(currClip, srcPath, matrix, devPath, bounds, doAA);
         } else {
             SkRasterClip clip;
-            clip.setPath(devPath, base, doAA);
+            setClipPath(&clip, srcPath, matrix, devPath, bounds, doAA);
             return currClip->op(clip, op);
         }
     }
@@ -1224,7 +1242,8 @@ bool SkCanvas::clipPath(const SkPath& path, SkRegion::Op op, bool doAA) {
     // if we called path.swap() we could avoid a deep copy of this path
     fClipStack.clipDevPath(devPath, op, doAA);
 
-    return clipPathHelper(this, fMCRec->fRasterClip, devPath, op, doAA);
+    return clipPathHelper(this, fMCRec->fRasterClip, &path, *fMCRec->fMatrix,
+                          devPath, op, doAA);
 }
 
 bool SkCanvas::clipRegion(const SkRegion& rgn, SkRegion::Op op) {
@@ -1260,6 +1279,8 @@ void SkCanvas::validateClip() const {
             case SkClipStack::Element::kPath_Type:
                 clipPathHelper(this,
                                &tmpClip,
+                               NULL,
+                               SkMatrix::I(),
                                element->getPath(),
                                element->getOp(),
                                element->isAA());
@@ -1897,6 +1918,42 @@ void SkCanvas::drawPosTextH(const void* text, size_t byteLength,
     LOOPER_END
 }
 
+void SkCanvas::drawPosTextRuns(const PosTextRun runs[], int runCount,
+                               const SkPaint& paint) {
+    // A looper or a filter may change the color of the paint it is given,
+    // which it can only do before the runs set their own, and an image filter
+    // applies to each run on its own.
+    if (paint.getLooper() || this->getDrawFilter() || paint.getImageFilter()) {
+        this->drawPosTextRunsAsPosText(runs, runCount, paint);
+        return;
+    }
+
+    CHECK_SHADER_NOSETCONTEXT(paint);
+
+    LOOPER_BEGIN(paint, SkDrawFilter::kText_Type)
+
+    while (iter.next()) {
+        SkDeviceFilteredPaint dfp(iter.fDevice, looper.paint());
+        iter.fDevice->drawPosTextRuns(iter, runs, runCount, dfp.paint());
+    }
+
+    LOOPER_END
+}
+
+void SkCanvas::drawPosTextRunsAsPosText(const PosTextRun runs[], int runCount,
+                                        const SkPaint& paint) {
+    SkPaint runPaint(paint);
+    runPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    for (int i = 0; i < runCount; ++i) {
+        if (runs[i].fCount <= 0) {
+            continue;
+        }
+        runPaint.setColor(runs[i].fColor);
+        this->drawPosText(runs[i].fGlyphs, runs[i].fCount * sizeof(uint16_t),
+                          runs[i].fPos, runPaint);
+    }
+}
+
 void SkCanvas::drawTextOnPath(const void* text, size_t byteLength,
                               const SkPath& path, const SkMatrix* matrix,
                               const SkPaint& paint) {
@@ -1912,6 +1969,25 @@ void SkCanvas::drawTextOnPath(const void* text, size_t byteLength,
     LOOPER_END
 }
 
+void SkCanvas::drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                      const SkMeasuredPath& path,
+                                      const SkMatrix* matrix,
+                                      const SkPaint& paint) {
+    CHECK_SHADER_NOSETCONTEXT(paint);
+
+    LOOPER_BEGIN(paint, SkDrawFilter::kText_Type)
+
+    // devices draw text on paths through SkDraw::drawTextOnPath, which picks
+    // up the measurements from the iterator
+    iter.fMeasuredPath = &path;
+    while (iter.next()) {
+        iter.fDevice->drawTextOnPath(iter, text, byteLength, path.getPath(),
+                                     matrix, looper.paint());
+    }
+
+    LOOPER_END
+}
+
 #ifdef SK_BUILD_FOR_ANDROID
 void SkCanvas::drawPosTextOnPath(const void* text, size_t byteLength,
                                  const SkPoint pos[], const SkPaint& paint,
@@ -2066,6 +2142,30 @@ void SkCanvas::drawTextOnPathHV(const void* text, size_t byteLength,
     this->drawTextOnPath(text, byteLength, path, &matrix, paint);
 }
 
+void SkCanvas::drawTextOnMeasuredPathHV(const void* text, size_t byteLength,
+                                        const SkMeasuredPath& path,
+                                        SkScalar hOffset, SkScalar vOffset,
+                                        const SkPaint& paint) {
+    SkMatrix    matrix;
+
+    matrix.setTranslate(hOffset, vOffset);
+    this->drawTextOnMeasuredPath(text, byteLength, path, &matrix, paint);
+}
+
+void SkCanvas::drawTextsOnMeasuredPath(int count, const void* const texts[],
+                                       const size_t byteLengths[],
+                                       const SkPoint offsets[],
+                                       const SkMeasuredPath& path,
+                                       const SkPaint& paint) {
+    SkMatrix    matrix;
+
+    for (int i = 0; i < count; ++i) {
+        matrix.setTranslate(offsets[i].fX, offsets[i].fY);
+        this->drawTextOnMeasuredPath(texts[i], byteLengths[i], path, &matrix,
+                                     paint);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkCanvas::drawPicture(SkPicture& picture) {
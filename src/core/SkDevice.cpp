@@ -451,6 +451,28 @@ void SkDevice::drawPosText(const SkDraw& draw, const void* text, size_t len,
     draw.drawPosText((const char*)text, len, xpos, y, scalarsPerPos, paint);
 }
 
+void SkDevice::drawPosTextRuns(const SkDraw& draw,
+                               const SkCanvas::PosTextRun runs[],
+                               int runCount, const SkPaint& paint) {
+    draw.drawPosTextRuns(runs, runCount, paint);
+}
+
+void SkDevice::drawPosTextRunsAsPosText(const SkDraw& draw,
+                                        const SkCanvas::PosTextRun runs[],
+                                        int runCount, const SkPaint& paint) {
+    SkPaint runPaint(paint);
+    runPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    for (int i = 0; i < runCount; ++i) {
+        if (runs[i].fCount <= 0) {
+            continue;
+        }
+        runPaint.setColor(runs[i].fColor);
+        this->drawPosText(draw, runs[i].fGlyphs,
+                          runs[i].fCount * sizeof(uint16_t),
+                          &runs[i].fPos->fX, 0, 2, runPaint);
+    }
+}
+
 void SkDevice::drawTextOnPath(const SkDraw& draw, const void* text,
                                   size_t len, const SkPath& path,
                                   const SkMatrix* matrix,
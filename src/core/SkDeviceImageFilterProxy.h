@@ -8,16 +8,46 @@
 #ifndef SkDeviceImageFilterProxy_DEFINED
 #define SkDeviceImageFilterProxy_DEFINED
 
+#include "SkDevice.h"
 #include "SkImageFilter.h"
+#include "SkPixelRef.h"
+#include "SkTDArray.h"
 
+/**
+ *  Creates devices for the intermediate results of one filter graph, and
+ *  keeps them around so that once a filter is done with an input's result,
+ *  a later filter of the same size can draw into it instead of allocating
+ *  another one.
+ */
 class SkDeviceImageFilterProxy : public SkImageFilter::Proxy {
 public:
     SkDeviceImageFilterProxy(SkDevice* device) : fDevice(device) {}
 
+    virtual ~SkDeviceImageFilterProxy() {
+        fScratch.unrefAll();
+    }
+
     virtual SkDevice* createDevice(int w, int h) SK_OVERRIDE {
-        return fDevice->createCompatibleDevice(SkBitmap::kARGB_8888_Config,
-                                               w, h, false);
+        for (int i = 0; i < fScratch.count(); ++i) {
+            SkDevice* device = fScratch[i];
+            // Free once only we hold the device, and no bitmap its pixels.
+            const SkPixelRef* pr = device->accessBitmap(false).pixelRef();
+            if (device->width() == w && device->height() == h &&
+                1 == device->getRefCnt() && pr && 1 == pr->getRefCnt()) {
+                device->clear(SK_ColorTRANSPARENT);
+                device->ref();
+                return device;
+            }
+        }
+        SkDevice* device = fDevice->createCompatibleDevice(
+                SkBitmap::kARGB_8888_Config, w, h, false);
+        if (device) {
+            device->ref();
+            *fScratch.append() = device;
+        }
+        return device;
     }
+
     virtual bool canHandleImageFilter(SkImageFilter* filter) SK_OVERRIDE {
         return fDevice->canHandleImageFilter(filter);
     }
@@ -28,7 +58,8 @@ public:
     }
 
 private:
-    SkDevice* fDevice;
+    SkDevice*               fDevice;
+    SkTDArray<SkDevice*>    fScratch;   // each ref'ed
 };
 
 #endif
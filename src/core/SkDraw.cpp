@@ -22,6 +22,7 @@
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 #include "SkTemplatesPriv.h"
 #include "SkTLazy.h"
 #include "SkUtils.h"
@@ -1057,7 +1058,12 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
     }
 
     if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
-        doFill = paint->getFillPath(*pathPtr, &tmpPath);
+        if (pathIsMutable) {
+            // a temporary path won't be drawn again, so don't cache it
+            doFill = paint->getFillPath(*pathPtr, &tmpPath);
+        } else {
+            doFill = SkStrokeCache::GetFillPath(*paint, *pathPtr, &tmpPath);
+        }
         pathPtr = &tmpPath;
     }
 
@@ -1851,7 +1857,6 @@ void SkDraw::drawPosText(const char text[], size_t byteLength,
 
     const SkMatrix* matrix = fMatrix;
 
-    SkDrawCacheProc     glyphCacheProc = paint.getDrawCacheProc();
     SkAutoGlyphCache    autoCache(paint, matrix);
     SkGlyphCache*       cache = autoCache.getCache();
 
@@ -1867,6 +1872,17 @@ void SkDraw::drawPosText(const char text[], size_t byteLength,
         }
     }
 
+    this->drawPosGlyphs(text, byteLength, pos, constY, scalarsPerPosition,
+                        paint, cache, blitter);
+}
+
+void SkDraw::drawPosGlyphs(const char text[], size_t byteLength,
+                           const SkScalar pos[], SkScalar constY,
+                           int scalarsPerPosition, const SkPaint& paint,
+                           SkGlyphCache* cache, SkBlitter* blitter) const {
+    const SkMatrix* matrix = fMatrix;
+
+    SkDrawCacheProc    glyphCacheProc = paint.getDrawCacheProc();
     const char*        stop = text + byteLength;
     AlignProc          alignProc = pick_align_proc(paint.getTextAlign());
     SkDraw1Glyph       d1g;
@@ -1980,16 +1996,93 @@ void SkDraw::drawPosText(const char text[], size_t byteLength,
     }
 }
 
+namespace {
+struct DescriptorMatch {
+    const SkDescriptor* fDesc;
+    bool                fMatches;
+};
+}
+
+static void descriptor_match_proc(const SkDescriptor* desc, void* context) {
+    DescriptorMatch* rec = static_cast<DescriptorMatch*>(context);
+    rec->fMatches = desc->equals(*rec->fDesc);
+}
+
+void SkDraw::drawPosTextRuns(const SkCanvas::PosTextRun runs[], int runCount,
+                             const SkPaint& origPaint) const {
+    SkASSERT(runCount == 0 || runs != NULL);
+
+    SkDEBUGCODE(this->validate();)
+
+    // nothing to draw (see drawPosText() for perspective)
+    if (runCount <= 0 || fRC->isEmpty() || fMatrix->hasPerspective()) {
+        return;
+    }
+
+    SkPaint paint(origPaint);
+    paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+    const bool rasterBlit = needsRasterTextBlit(*this);
+    SkGlyphCache* cache = NULL;
+
+    int i = 0;
+    while (i < runCount) {
+        paint.setColor(runs[i].fColor);
+
+        // The color only picks the gamma of the masks, so runs usually share
+        // a strike even when their colors differ. Comparing descriptors is
+        // much cheaper than detaching and attaching a cache.
+        if (NULL != cache) {
+            DescriptorMatch rec = { &cache->getDescriptor(), false };
+            paint.descriptorProc(fMatrix, descriptor_match_proc, &rec);
+            if (!rec.fMatches) {
+                SkGlyphCache::AttachCache(cache);
+                cache = NULL;
+            }
+        }
+        if (NULL == cache) {
+            cache = paint.detachCache(fMatrix);
+        }
+
+        // Draw all of the following runs of the same color with one blitter.
+        SkAAClipBlitterWrapper wrapper;
+        SkAutoBlitterChoose blitterChooser;
+        SkBlitter* blitter = NULL;
+        if (rasterBlit) {
+            blitterChooser.choose(*fBitmap, *fMatrix, paint);
+            blitter = blitterChooser.get();
+            if (fRC->isAA()) {
+                wrapper.init(*fRC, blitter);
+                blitter = wrapper.getBlitter();
+            }
+        }
+
+        do {
+            const SkCanvas::PosTextRun& run = runs[i];
+            if (run.fCount > 0) {
+                SkASSERT(run.fGlyphs != NULL && run.fPos != NULL);
+                this->drawPosGlyphs((const char*)run.fGlyphs,
+                                    run.fCount * sizeof(uint16_t),
+                                    &run.fPos->fX, 0, 2, paint, cache,
+                                    blitter);
+            }
+            i += 1;
+        } while (i < runCount && runs[i].fColor == paint.getColor());
+    }
+
+    SkGlyphCache::AttachCache(cache);
+}
+
 #if defined _WIN32 && _MSC_VER >= 1300
 #pragma warning ( pop )
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#include "SkPathMeasure.h"
+#include "SkMeasuredPath.h"
 
 static void morphpoints(SkPoint dst[], const SkPoint src[], int count,
-                        SkPathMeasure& meas, const SkMatrix& matrix) {
+                        const SkMeasuredPath& meas, const SkMatrix& matrix) {
     SkMatrix::MapXYProc proc = matrix.getMapXYProc();
 
     for (int i = 0; i < count; i++) {
@@ -2026,8 +2119,8 @@ static void morphpoints(SkPoint dst[], const SkPoint src[], int count,
     determine that, but we need it. I guess a cheap answer is let the caller tell us,
     but that seems like a cop-out. Another answer is to get Rob Johnson to figure it out.
 */
-static void morphpath(SkPath* dst, const SkPath& src, SkPathMeasure& meas,
-                      const SkMatrix& matrix) {
+static void morphpath(SkPath* dst, const SkPath& src,
+                      const SkMeasuredPath& meas, const SkMatrix& matrix) {
     SkPath::Iter    iter(src, false);
     SkPoint         srcP[4], dstP[3];
     SkPath::Verb    verb;
@@ -2073,8 +2166,21 @@ void SkDraw::drawTextOnPath(const char text[], size_t byteLength,
         return;
     }
 
+    // reuse the caller's measurements if they are of this path
+    if (fMeasuredPath && &fMeasuredPath->getPath() == &follow) {
+        this->drawTextOnMeasuredPath(text, byteLength, *fMeasuredPath, matrix,
+                                     paint);
+    } else {
+        SkMeasuredPath meas(follow);
+        this->drawTextOnMeasuredPath(text, byteLength, meas, matrix, paint);
+    }
+}
+
+void SkDraw::drawTextOnMeasuredPath(const char text[], size_t byteLength,
+                                    const SkMeasuredPath& meas,
+                                    const SkMatrix* matrix,
+                                    const SkPaint& paint) const {
     SkTextToPathIter    iter(text, byteLength, paint, true);
-    SkPathMeasure       meas(follow, false);
     SkScalar            hOffset = 0;
 
     // need to measure first
@@ -2122,7 +2228,7 @@ void SkDraw::drawPosTextOnPath(const char text[], size_t byteLength,
     }
 
     SkMatrix scaledMatrix;
-    SkPathMeasure meas(path, false);
+    SkMeasuredPath meas(path);
 
     SkMeasureCacheProc glyphCacheProc = paint.getMeasureCacheProc(
             SkPaint::kForward_TextBufferDirection, true);
@@ -486,35 +486,333 @@ void SkGlyphCache_Globals::purgeAll() {
     SkGlyphCache::InternalFreeCache(this, fTotalMemoryUsed);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+/*  The shared cache is split into kShardCount independent LRU lists, each with
+    its own mutex, and a strike lives in the shard picked by its descriptor's
+    checksum. Threads looking up different strikes therefore rarely contend.
+
+    The budget stays global: fTotalMemoryUsed is the sum over all shards (plus
+    the strikes parked in per-thread front caches) and is maintained with
+    atomic adds, so attaching or detaching only ever holds one shard's mutex.
+    Purging never holds two shard mutexes at once.
+*/
+class SkGlyphCache_Shards {
+public:
+    enum {
+        kShardBits  = 3,
+        kShardCount = 1 << kShardBits,
+        kShardMask  = kShardCount - 1
+    };
+
+    SkGlyphCache_Shards() {
+        for (int i = 0; i < kShardCount; ++i) {
+            fShards[i] = SkNEW_ARGS(SkGlyphCache_Globals,
+                                    (SkGlyphCache_Globals::kYes_UseMutex));
+        }
+        fTotalMemoryUsed = 0;
+        fFontCacheLimit = SK_DEFAULT_FONT_CACHE_LIMIT;
+        fPurgeCursor = 0;
+        fPurgeGenID = 0;
+    }
+
+    SkGlyphCache_Globals& shard(int index) {
+        SkASSERT((unsigned)index < kShardCount);
+        return *fShards[index];
+    }
+
+    SkGlyphCache_Globals& shardFor(const SkDescriptor* desc) {
+        uint32_t n = desc->getChecksum();
+        // the low bits of the checksum may not vary enough, so fold them
+        n ^= (n >> 16);
+        n ^= (n >> 8);
+        return *fShards[n & kShardMask];
+    }
+
+    size_t getTotalMemoryUsed() const { return (size_t)fTotalMemoryUsed; }
+    void addMemoryUsed(size_t bytes) {
+        sk_atomic_add(&fTotalMemoryUsed, (int32_t)bytes);
+    }
+    void subMemoryUsed(size_t bytes) {
+        sk_atomic_add(&fTotalMemoryUsed, -(int32_t)bytes);
+    }
+
+    size_t  getFontCacheLimit() const { return fFontCacheLimit; }
+    size_t  setFontCacheLimit(size_t limit);
+    void    purgeAll(); // does not change budget
+
+    /**
+     *  Frees strikes, one shard at a time, until the total is back within the
+     *  budget. The caller must not hold any shard's mutex.
+     */
+    void purgeIfOverBudget();
+
+    /**
+     *  Add a strike to the head of its shard, purging that shard first if the
+     *  new total would exceed the budget.
+     */
+    void attach(SkGlyphCache* cache) { this->attach(cache, false); }
+
+    /**
+     *  Return a strike that was parked in a front cache (and so is already
+     *  counted in the total). While it was parked another thread may have
+     *  built a strike for the same descriptor; if so the parked one is
+     *  deleted, so that the shards never hold two strikes for one descriptor.
+     */
+    void reattach(SkGlyphCache* cache) {
+        this->subMemoryUsed(cache->fMemoryUsed);
+        this->attach(cache, true);
+    }
+
+    /**
+     *  Bumped by purgeAll() so that the per-thread front caches, which the
+     *  purge cannot reach, drop their strikes the next time they are used.
+     */
+    int32_t getPurgeGenID() const { return fPurgeGenID; }
+    void bumpPurgeGenID() { sk_atomic_inc(&fPurgeGenID); }
+
+private:
+    SkGlyphCache_Globals*   fShards[kShardCount];
+    int32_t                 fTotalMemoryUsed;
+    size_t                  fFontCacheLimit;
+    int32_t                 fPurgeCursor;
+    int32_t                 fPurgeGenID;
+
+    void attach(SkGlyphCache* cache, bool dropIfDuplicate);
+};
+
+size_t SkGlyphCache_Shards::setFontCacheLimit(size_t newLimit) {
+    static const size_t minLimit = 256 * 1024;
+    if (newLimit < minLimit) {
+        newLimit = minLimit;
+    }
+
+    size_t prevLimit = fFontCacheLimit;
+    fFontCacheLimit = newLimit;
+    this->purgeIfOverBudget();
+    return prevLimit;
+}
+
+void SkGlyphCache_Shards::purgeAll() {
+    this->bumpPurgeGenID();
+    for (int i = 0; i < kShardCount; ++i) {
+        SkGlyphCache_Globals& shard = *fShards[i];
+        SkAutoMutexAcquire    ac(shard.fMutex);
+        this->subMemoryUsed(SkGlyphCache::InternalFreeCache(&shard,
+                                                    shard.fTotalMemoryUsed));
+    }
+}
+
+void SkGlyphCache_Shards::purgeIfOverBudget() {
+    // start at a different shard each time, so one shard isn't always the
+    // victim of everyone else's growth
+    int start = sk_atomic_inc(&fPurgeCursor);
+    for (int i = 0; i < kShardCount; ++i) {
+        size_t used = this->getTotalMemoryUsed();
+        size_t budgeted = fFontCacheLimit;
+        if (used <= budgeted) {
+            return;
+        }
+        SkGlyphCache_Globals& shard = *fShards[(start + i) & kShardMask];
+        SkAutoMutexAcquire    ac(shard.fMutex);
+        this->subMemoryUsed(SkGlyphCache::InternalFreeCache(&shard,
+                                                            used - budgeted));
+    }
+}
+
+void SkGlyphCache_Shards::attach(SkGlyphCache* cache, bool dropIfDuplicate) {
+    SkGlyphCache_Globals& shard = this->shardFor(cache->fDesc);
+    SkAutoMutexAcquire    ac(shard.fMutex);
+
+    shard.validate();
+    cache->validate();
+
+    if (dropIfDuplicate) {
+        for (SkGlyphCache* c = shard.fHead; c != NULL; c = c->fNext) {
+            if (c->fDesc->equals(*cache->fDesc)) {
+                ac.release();
+                SkDELETE(cache);
+                return;
+            }
+        }
+    }
+
+    // if we have a fixed budget for our cache, do a purge here
+    {
+        size_t allocated = this->getTotalMemoryUsed() + cache->fMemoryUsed;
+        size_t budgeted = fFontCacheLimit;
+        if (allocated > budgeted) {
+            this->subMemoryUsed(SkGlyphCache::InternalFreeCache(&shard,
+                                                    allocated - budgeted));
+        }
+    }
+
+    cache->attachToHead(&shard.fHead);
+    shard.fTotalMemoryUsed += cache->fMemoryUsed;
+    this->addMemoryUsed(cache->fMemoryUsed);
+
+#ifdef USE_CACHE_HASH
+    unsigned index = desc_to_hashindex(cache->fDesc);
+    SkASSERT(shard.fHash[index] != cache);
+    shard.fHash[index] = cache;
+#endif
+
+    shard.validate();
+    ac.release();
+
+    // this shard alone may not have been able to cover the overage
+    this->purgeIfOverBudget();
+}
+
 // Returns the shared globals
-static SkGlyphCache_Globals& getSharedGlobals() {
+static SkGlyphCache_Shards& getSharedGlobals() {
     // we leak this, so we don't incur any shutdown cost of the destructor
-    static SkGlyphCache_Globals* gGlobals = SkNEW_ARGS(SkGlyphCache_Globals,
-                                       (SkGlyphCache_Globals::kYes_UseMutex));
+    static SkGlyphCache_Shards* gGlobals = SkNEW(SkGlyphCache_Shards);
     return *gGlobals;
 }
 
-// Returns the TLS globals (if set), or the shared globals
-static SkGlyphCache_Globals& getGlobals() {
-    SkGlyphCache_Globals* tls = SkGlyphCache_Globals::FindTLS();
-    return tls ? *tls : getSharedGlobals();
-}
+///////////////////////////////////////////////////////////////////////////////
+
+static int32_t gFrontStrikeCount;
+// Set once any thread has made a front, after which lookups check for one even
+// when gFrontStrikeCount is 0, since it may still hold strikes to give back.
+static bool gFrontCreated;
+
+/*  A small per-thread MRU list of strikes sitting in front of the shared
+    cache. Lookups that hit here take no lock at all. Strikes parked here still
+    count against the shared budget, but only the owning thread can release
+    them: they go back to the shared cache when they fall off the end of the
+    list, when the thread next looks up a strike after the count was lowered,
+    or when the thread exits, and are deleted after a purgeAll().
+*/
+class SkGlyphCache_Front {
+public:
+    enum {
+        kMaxStrikeCount = 8
+    };
+
+    SkGlyphCache_Front() {
+        fCount = 0;
+        fPurgeGenID = getSharedGlobals().getPurgeGenID();
+        gFrontCreated = true;
+    }
+
+    ~SkGlyphCache_Front() {
+        SkGlyphCache_Shards& shards = getSharedGlobals();
+        for (int i = 0; i < fCount; ++i) {
+            shards.reattach(fStrikes[i]);
+        }
+    }
+
+    /**
+     *  Return the strikes beyond the current count limit to the shared cache.
+     */
+    void trim() {
+        this->checkPurgeGenID();
+        SkGlyphCache_Shards& shards = getSharedGlobals();
+        while (fCount > gFrontStrikeCount) {
+            fCount -= 1;
+            shards.reattach(fStrikes[fCount]);
+        }
+    }
+
+    /**
+     *  Remove and return the strike matching desc, or NULL. Its memory is
+     *  still counted in the shared total.
+     */
+    SkGlyphCache* detach(const SkDescriptor* desc) {
+        this->trim();
+        for (int i = 0; i < fCount; ++i) {
+            SkGlyphCache* cache = fStrikes[i];
+            if (cache->fDesc->equals(*desc)) {
+                memmove(&fStrikes[i], &fStrikes[i + 1],
+                        (fCount - i - 1) * sizeof(fStrikes[0]));
+                fCount -= 1;
+                return cache;
+            }
+        }
+        return NULL;
+    }
+
+    /**
+     *  Park cache (already counted in the shared total) at the head of the
+     *  list, returning any strikes beyond the current count limit to the
+     *  shared cache.
+     */
+    void attach(SkGlyphCache* cache) {
+        this->checkPurgeGenID();
+        SkASSERT(fCount < kMaxStrikeCount);
+        memmove(&fStrikes[1], &fStrikes[0], fCount * sizeof(fStrikes[0]));
+        fStrikes[0] = cache;
+        fCount += 1;
+
+        int maxCount = SkMin32(gFrontStrikeCount, kMaxStrikeCount - 1);
+        SkGlyphCache_Shards& shards = getSharedGlobals();
+        while (fCount > maxCount) {
+            fCount -= 1;
+            shards.reattach(fStrikes[fCount]);
+        }
+    }
+
+    // can return NULL
+    static SkGlyphCache_Front* FindTLS() {
+        return (SkGlyphCache_Front*)SkTLS::Find(CreateTLS);
+    }
+
+    static SkGlyphCache_Front& GetTLS() {
+        return *(SkGlyphCache_Front*)SkTLS::Get(CreateTLS, DeleteTLS);
+    }
+
+private:
+    SkGlyphCache*   fStrikes[kMaxStrikeCount];
+    int             fCount;
+    int32_t         fPurgeGenID;
+
+    void checkPurgeGenID() {
+        SkGlyphCache_Shards& shards = getSharedGlobals();
+        if (fPurgeGenID == shards.getPurgeGenID()) {
+            return;
+        }
+        fPurgeGenID = shards.getPurgeGenID();
+        for (int i = 0; i < fCount; ++i) {
+            shards.subMemoryUsed(fStrikes[i]->fMemoryUsed);
+            SkDELETE(fStrikes[i]);
+        }
+        fCount = 0;
+    }
+
+    static void* CreateTLS() {
+        return SkNEW(SkGlyphCache_Front);
+    }
+
+    static void DeleteTLS(void* ptr) {
+        SkDELETE((SkGlyphCache_Front*)ptr);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
 
 void SkGlyphCache::VisitAllCaches(bool (*proc)(SkGlyphCache*, void*),
                                   void* context) {
-    SkGlyphCache_Globals& globals = getGlobals();
-    SkAutoMutexAcquire    ac(globals.fMutex);
-    SkGlyphCache*         cache;
+    SkGlyphCache_Globals* tls = SkGlyphCache_Globals::FindTLS();
+    int shardCount = tls ? 1 : SkGlyphCache_Shards::kShardCount;
 
-    globals.validate();
+    for (int i = 0; i < shardCount; ++i) {
+        SkGlyphCache_Globals& globals = tls ? *tls :
+                                              getSharedGlobals().shard(i);
+        SkAutoMutexAcquire    ac(globals.fMutex);
+        SkGlyphCache*         cache;
 
-    for (cache = globals.fHead; cache != NULL; cache = cache->fNext) {
-        if (proc(cache, context)) {
-            break;
+        globals.validate();
+
+        for (cache = globals.fHead; cache != NULL; cache = cache->fNext) {
+            if (proc(cache, context)) {
+                return;
+            }
         }
-    }
 
-    globals.validate();
+        globals.validate();
+    }
 }
 
 /*  This guy calls the visitor from within the mutext lock, so the visitor
@@ -528,7 +826,26 @@ SkGlyphCache* SkGlyphCache::VisitCache(const SkDescriptor* desc,
                               void* context) {
     SkASSERT(desc);
 
-    SkGlyphCache_Globals& globals = getGlobals();
+    SkGlyphCache_Globals* tls = SkGlyphCache_Globals::FindTLS();
+    SkGlyphCache_Shards*  shards = tls ? NULL : &getSharedGlobals();
+
+    // try this thread's recently used strikes first, which needs no lock
+    if (shards && (gFrontStrikeCount > 0 || gFrontCreated)) {
+        SkGlyphCache_Front* front = SkGlyphCache_Front::FindTLS();
+        SkGlyphCache* cache = front ? front->detach(desc) : NULL;
+        if (cache) {
+            AutoValidate av(cache);
+
+            if (proc(cache, context)) {   // stay detached
+                shards->subMemoryUsed(cache->fMemoryUsed);
+                return cache;
+            }
+            front->attach(cache);
+            return NULL;
+        }
+    }
+
+    SkGlyphCache_Globals& globals = tls ? *tls : shards->shardFor(desc);
     SkAutoMutexAcquire    ac(globals.fMutex);
     SkGlyphCache*         cache;
     bool                  insideMutex = true;
@@ -568,6 +885,9 @@ FOUND_IT:
         if (insideMutex) {
             SkASSERT(globals.fTotalMemoryUsed >= cache->fMemoryUsed);
             globals.fTotalMemoryUsed -= cache->fMemoryUsed;
+            if (shards) {
+                shards->subMemoryUsed(cache->fMemoryUsed);
+            }
 #ifdef USE_CACHE_HASH
             hash[index] = NULL;
 #endif
@@ -590,7 +910,27 @@ void SkGlyphCache::AttachCache(SkGlyphCache* cache) {
     SkASSERT(cache);
     SkASSERT(cache->fNext == NULL);
 
-    SkGlyphCache_Globals& globals = getGlobals();
+    SkGlyphCache_Globals* tls = SkGlyphCache_Globals::FindTLS();
+    if (NULL == tls) {
+        SkGlyphCache_Shards& shards = getSharedGlobals();
+        // big strikes go straight to the shared cache, so that the fronts
+        // (which no other thread can purge) only ever hold a small fraction
+        // of the budget. Every strike's own hash tables take ~100K, more than
+        // that fraction of the default budget, so they are not counted here.
+        size_t bytes = cache->fMemoryUsed - sizeof(SkGlyphCache);
+        if (gFrontStrikeCount > 0 &&
+                bytes <= (shards.getFontCacheLimit() >> 5)) {
+            cache->validate();
+            shards.addMemoryUsed(cache->fMemoryUsed);
+            SkGlyphCache_Front::GetTLS().attach(cache);
+            shards.purgeIfOverBudget();
+        } else {
+            shards.attach(cache);
+        }
+        return;
+    }
+
+    SkGlyphCache_Globals& globals = *tls;
     SkAutoMutexAcquire    ac(globals.fMutex);
 
     globals.validate();
@@ -721,7 +1061,23 @@ size_t SkGraphics::SetFontCacheLimit(size_t bytes) {
 }
 
 size_t SkGraphics::GetFontCacheUsed() {
-    return getSharedGlobals().fTotalMemoryUsed;
+    return getSharedGlobals().getTotalMemoryUsed();
+}
+
+int SkGraphics::GetFontCachePerThreadStrikeCount() {
+    return gFrontStrikeCount;
+}
+
+int SkGraphics::SetFontCachePerThreadStrikeCount(int count) {
+    count = SkPin32(count, 0, SkGlyphCache_Front::kMaxStrikeCount - 1);
+    int prevCount = gFrontStrikeCount;
+    gFrontStrikeCount = count;
+    // other threads trim their fronts on their next lookup
+    SkGlyphCache_Front* front = SkGlyphCache_Front::FindTLS();
+    if (front) {
+        front->trim();
+    }
+    return prevCount;
 }
 
 void SkGraphics::PurgeFontCache() {
@@ -20,7 +20,9 @@
 
 class SkPaint;
 
+class SkGlyphCache_Front;
 class SkGlyphCache_Globals;
+class SkGlyphCache_Shards;
 
 /** \class SkGlyphCache
 
@@ -30,8 +32,12 @@ class SkGlyphCache_Globals;
     either instantly if it is already cahced, or by first generating it and then
     adding it to the strike.
 
-    The strikes are held in a global list, available to all threads. To interact
-    with one, call either VisitCache() or DetachCache().
+    The strikes are held in a global cache, available to all threads. To
+    interact with one, call either VisitCache() or DetachCache(). The global
+    cache is sharded by descriptor, so threads working on different strikes
+    rarely wait on each other, and each thread may optionally keep a few
+    recently used strikes to itself (see
+    SkGraphics::SetFontCachePerThreadStrikeCount).
 */
 class SkGlyphCache {
 public:
@@ -266,7 +272,9 @@ private:
 
     inline static SkGlyphCache* FindTail(SkGlyphCache* head);
 
+    friend class SkGlyphCache_Front;
     friend class SkGlyphCache_Globals;
+    friend class SkGlyphCache_Shards;
 };
 
 class SkAutoGlyphCache {
@@ -23,6 +23,7 @@
 #include "SkRefCnt.h"
 #include "SkRTConf.h"
 #include "SkScalerContext.h"
+#include "SkScan.h"
 #include "SkShader.h"
 #include "SkStream.h"
 #include "SkTSearch.h"
@@ -129,6 +130,8 @@ void SkGraphics::Init() {
 
 void SkGraphics::Term() {
     PurgeFontCache();
+    PurgeStrokeCache();
+    PurgeClipMaskCache();
     SkPaint::Term();
 }
 
@@ -137,12 +140,30 @@ void SkGraphics::Term() {
 static const char kFontCacheLimitStr[] = "font-cache-limit";
 static const size_t kFontCacheLimitLen = sizeof(kFontCacheLimitStr) - 1;
 
+static const char kStrokeCacheLimitStr[] = "stroke-cache-limit";
+static const size_t kStrokeCacheLimitLen = sizeof(kStrokeCacheLimitStr) - 1;
+
+static const char kClipMaskCacheLimitStr[] = "clip-mask-cache-limit";
+static const size_t kClipMaskCacheLimitLen = sizeof(kClipMaskCacheLimitStr) - 1;
+
+static const char kAnalyticAAStr[] = "analytic-aa";
+static const size_t kAnalyticAALen = sizeof(kAnalyticAAStr) - 1;
+
+static size_t set_analytic_aa(size_t useAnalytic) {
+    size_t prev = SkScan::GetUseAnalyticAA();
+    SkScan::SetUseAnalyticAA(0 != useAnalytic);
+    return prev;
+}
+
 static const struct {
     const char* fStr;
     size_t fLen;
     size_t (*fFunc)(size_t);
 } gFlags[] = {
-    { kFontCacheLimitStr, kFontCacheLimitLen, SkGraphics::SetFontCacheLimit }
+    { kFontCacheLimitStr, kFontCacheLimitLen, SkGraphics::SetFontCacheLimit },
+    { kStrokeCacheLimitStr, kStrokeCacheLimitLen, SkGraphics::SetStrokeCacheLimit },
+    { kClipMaskCacheLimitStr, kClipMaskCacheLimitLen, SkGraphics::SetClipMaskCacheLimit },
+    { kAnalyticAAStr, kAnalyticAALen, set_analytic_aa }
 };
 
 /* flags are of the form param; or param=value; */
@@ -64,22 +64,56 @@ void SkImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
     }
 }
 
+static bool is_largest(const SkIRect& r) {
+    return SK_MinS32 == r.fLeft && SK_MinS32 == r.fTop &&
+           SK_MaxS32 == r.fRight && SK_MaxS32 == r.fBottom;
+}
+
+// Crop bm, which is drawn at *loc, to bounds, by sharing its pixels. Leave it
+// alone if it has none to share (or they live in a texture, which would have
+// to be copied).
+static void crop_to_bounds(SkBitmap* bm, SkIPoint* loc, const SkIRect& bounds) {
+    if (is_largest(bounds) || NULL == bm->pixelRef() || bm->getTexture()) {
+        return;
+    }
+    SkIRect r = SkIRect::MakeXYWH(loc->x(), loc->y(), bm->width(), bm->height());
+    if (bounds.contains(r) || !r.intersect(bounds)) {
+        return;
+    }
+    SkBitmap subset;
+    SkIRect subsetBounds = r;
+    subsetBounds.offset(-loc->x(), -loc->y());
+    if (bm->extractSubset(&subset, subsetBounds)) {
+        bm->swap(subset);
+        loc->set(r.left(), r.top());
+    }
+}
+
 SkBitmap SkImageFilter::getInputResult(int index, Proxy* proxy,
-                                       const SkBitmap& src, const SkMatrix& ctm,
+                                       const SkBitmap& src, const Context& ctx,
                                        SkIPoint* loc) {
     SkASSERT(index < fInputCount);
+    SkIRect bounds;
+    if (!this->onSourceBounds(ctx.clipBounds(), ctx.ctm(), &bounds) ||
+        is_largest(ctx.clipBounds())) {
+        bounds.setLargest();
+    }
+
     SkImageFilter* input = getInput(index);
     SkBitmap result;
-    if (input && input->filterImage(proxy, src, ctm, &result, loc)) {
+    SkIPoint inputLoc = *loc;
+    if (input && input->filterImage(proxy, src, Context(ctx.ctm(), bounds),
+                                    &result, &inputLoc)) {
+        *loc = inputLoc;
         return result;
-    } else {
-        return src;
     }
+    result = src;
+    crop_to_bounds(&result, loc, bounds);
+    return result;
 }
 
-
 bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
-                                const SkMatrix& ctm,
+                                const Context& ctx,
                                 SkBitmap* result, SkIPoint* loc) {
     SkASSERT(result);
     SkASSERT(loc);
@@ -87,8 +121,24 @@ bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
      *  Give the proxy first shot at the filter. If it returns false, ask
      *  the filter to do it.
      */
-    return (proxy && proxy->filterImage(this, src, ctm, result, loc)) ||
-           this->onFilterImage(proxy, src, ctm, result, loc);
+    if (proxy && proxy->filterImage(this, src, ctx.ctm(), result, loc)) {
+        return true;
+    }
+    if (!this->onFilterImage(proxy, src, ctx, result, loc)) {
+        return false;
+    }
+    // Filters that do not know which of their inputs' pixels they need
+    // compute everything, so drop what the caller is not going to look at.
+    crop_to_bounds(result, loc, ctx.clipBounds());
+    return true;
+}
+
+bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
+                                const SkMatrix& ctm,
+                                SkBitmap* result, SkIPoint* loc) {
+    SkIRect clipBounds;
+    clipBounds.setLargest();
+    return this->filterImage(proxy, src, Context(ctm, clipBounds), result, loc);
 }
 
 bool SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
@@ -98,7 +148,30 @@ bool SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
     return this->onFilterBounds(src, ctm, dst);
 }
 
-bool SkImageFilter::onFilterImage(Proxy*, const SkBitmap&, const SkMatrix&,
+bool SkImageFilter::sourceBounds(const SkIRect& dst, const SkMatrix& ctm,
+                                 SkIRect* src) {
+    SkASSERT(src);
+    SkIRect needed;
+    if (is_largest(dst) || !this->onSourceBounds(dst, ctm, &needed)) {
+        return false;
+    }
+    SkIRect bounds;
+    for (int i = 0; i < fInputCount; ++i) {
+        SkIRect r = needed;
+        if (fInputs[i] && !fInputs[i]->sourceBounds(needed, ctm, &r)) {
+            return false;
+        }
+        if (0 == i) {
+            bounds = r;
+        } else {
+            bounds.join(r);
+        }
+    }
+    *src = fInputCount > 0 ? bounds : needed;
+    return true;
+}
+
+bool SkImageFilter::onFilterImage(Proxy*, const SkBitmap&, const Context&,
                                   SkBitmap*, SkIPoint*) {
     return false;
 }
@@ -117,6 +190,10 @@ bool SkImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
     return true;
 }
 
+bool SkImageFilter::onSourceBounds(const SkIRect&, const SkMatrix&, SkIRect*) {
+    return false;
+}
+
 bool SkImageFilter::asNewEffect(GrEffectRef**, GrTexture*) const {
     return false;
 }
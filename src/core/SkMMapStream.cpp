@@ -6,17 +6,20 @@
  * found in the LICENSE file.
  */
 #include "SkMMapStream.h"
+#include "SkData.h"
 
 #include <unistd.h>
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <errno.h>
 
-SkMMAPStream::SkMMAPStream(const char filename[])
+static void sk_munmap_releaseproc(const void* addr, size_t length, void*)
 {
-    fAddr = NULL;   // initialize to failure case
-    fSize = 0;
+    munmap(const_cast<void*>(addr), length);
+}
 
+SkMMAPStream::SkMMAPStream(const char filename[])
+{
     int fildes = open(filename, O_RDONLY);
     if (fildes < 0)
     {
@@ -50,29 +53,7 @@ SkMMAPStream::SkMMAPStream(const char filename[])
         return;
     }
 
-    this->INHERITED::setMemory(addr, size);
-
-    fAddr = addr;
-    fSize = size;
+    SkData* data = SkData::NewWithProc(addr, size, sk_munmap_releaseproc, NULL);
+    this->INHERITED::setData(data);
+    data->unref();
 }
-
-SkMMAPStream::~SkMMAPStream()
-{
-    this->closeMMap();
-}
-
-void SkMMAPStream::setMemory(const void* data, size_t length, bool copyData)
-{
-    this->closeMMap();
-    this->INHERITED::setMemory(data, length, copyData);
-}
-
-void SkMMAPStream::closeMMap()
-{
-    if (fAddr)
-    {
-        munmap(fAddr, fSize);
-        fAddr = NULL;
-    }
-}
-
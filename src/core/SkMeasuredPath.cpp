@@ -0,0 +1,26 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#include "SkMeasuredPath.h"
+
+SK_DEFINE_INST_COUNT(SkMeasuredPath)
+
+SkMeasuredPath::SkMeasuredPath(const SkPath& path)
+    : fPath(path)
+    , fMeasure(fPath, false) {
+    // build the segments now, so that we are never modified afterwards
+    fLength = fMeasure.getLength();
+}
+
+SkMeasuredPath::~SkMeasuredPath() {}
+
+bool SkMeasuredPath::getPosTan(SkScalar distance, SkPoint* position,
+                               SkVector* tangent) const {
+    return fMeasure.getPosTan(distance, position, tangent);
+}
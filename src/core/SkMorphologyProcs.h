@@ -0,0 +1,41 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMorphologyProcs_DEFINED
+#define SkMorphologyProcs_DEFINED
+
+#include "SkColor.h"
+
+/*  Platform-specific versions of the erode and dilate passes in
+    SkMorphologyImageFilter.cpp.
+
+    Each pass replaces every pixel with the per-channel min (erode) or max
+    (dilate) of the pixels within radius of it along one axis, where the
+    window is clipped to the bitmap. radius is at most the length of that
+    axis minus one.
+
+    Like SkBoxBlurProcs.h, a proc need not handle the whole bitmap: it returns
+    how many rows (for an X pass) or columns (for a Y pass), starting from the
+    first, it filtered, and the portable code finishes the rest.
+ */
+
+enum SkMorphologyProcType {
+    kErodeX_SkMorphologyProcType,
+    kErodeY_SkMorphologyProcType,
+    kDilateX_SkMorphologyProcType,
+    kDilateY_SkMorphologyProcType
+};
+
+/** srcRowPixels and dstRowPixels are the row strides, in pixels. */
+typedef int (*SkMorphologyProc)(const SkPMColor* src, int srcRowPixels,
+                                SkPMColor* dst, int dstRowPixels,
+                                int radius, int width, int height);
+
+// Return NULL if there is no faster version for this platform.
+SkMorphologyProc SkMorphologyGetPlatformProc(SkMorphologyProcType type);
+
+#endif
@@ -1029,6 +1029,10 @@ bool SkPath::hasOnlyMoveTos() const {
     return true;
 }
 
+uint32_t SkPath::getPathRefGenID() const {
+    return fPathRef->genID();
+}
+
 #define CUBIC_ARC_FACTOR    ((SK_ScalarSqrt2 - SK_Scalar1) * 4 / 3)
 
 void SkPath::addRoundRect(const SkRect& rect, SkScalar rx, SkScalar ry,
@@ -2950,6 +2954,6 @@ bool SkPath::contains(SkScalar x, SkScalar y) const {
         default:
             break;
     }
-    return SkToBool(w);
+    return SkToBool(w) ^ isInverse;
 }
 
@@ -10,6 +10,7 @@
 #include "SkPictureFlat.h"
 #include "SkPicturePlayback.h"
 #include "SkPictureRecord.h"
+#include "SkPictureSegments.h"
 
 #include "SkCanvas.h"
 #include "SkChunkAlloc.h"
@@ -62,6 +63,7 @@ const char* DrawTypeToString(DrawType drawType) {
         case DRAW_POINTS: return "DRAW_POINTS";
         case DRAW_POS_TEXT: return "DRAW_POS_TEXT";
         case DRAW_POS_TEXT_H: return "DRAW_POS_TEXT_H";
+        case DRAW_POS_TEXT_RUNS: return "DRAW_POS_TEXT_RUNS";
         case DRAW_RECT_GENERAL: return "DRAW_RECT_GENERAL";
         case DRAW_RECT_SIMPLE: return "DRAW_RECT_SIMPLE";
         case DRAW_SPRITE: return "DRAW_SPRITE";
@@ -108,12 +110,14 @@ SkPicture::SkPicture() {
     fRecord = NULL;
     fPlayback = NULL;
     fWidth = fHeight = 0;
+    fSegments = NULL;
 }
 
 SkPicture::SkPicture(const SkPicture& src) : SkRefCnt() {
     fWidth = src.fWidth;
     fHeight = src.fHeight;
     fRecord = NULL;
+    fSegments = NULL;
 
     /*  We want to copy the src's playback. However, if that hasn't been built
         yet, we need to fake a call to endRecording() without actually calling
@@ -132,6 +136,7 @@ SkPicture::SkPicture(const SkPicture& src) : SkRefCnt() {
 SkPicture::~SkPicture() {
     SkSafeUnref(fRecord);
     SkDELETE(fPlayback);
+    SkDELETE(fSegments);
 }
 
 void SkPicture::swap(SkPicture& other) {
@@ -139,6 +144,7 @@ void SkPicture::swap(SkPicture& other) {
     SkTSwap(fPlayback, other.fPlayback);
     SkTSwap(fWidth, other.fWidth);
     SkTSwap(fHeight, other.fHeight);
+    SkTSwap(fSegments, other.fSegments);
 }
 
 SkPicture* SkPicture::clone() const {
@@ -192,6 +198,9 @@ SkCanvas* SkPicture::beginRecording(int width, int height,
         fRecord = NULL;
     }
 
+    SkDELETE(fSegments);
+    fSegments = NULL;
+
     SkBitmap bm;
     bm.setConfig(SkBitmap::kNo_Config, width, height);
     SkAutoTUnref<SkDevice> dev(SkNEW_ARGS(SkDevice, (bm)));
@@ -233,6 +242,9 @@ SkCanvas* SkPicture::getRecordingCanvas() const {
 void SkPicture::endRecording() {
     if (NULL == fPlayback) {
         if (NULL != fRecord) {
+            if (NULL != fSegments && fSegments->isRecording()) {
+                this->endRecordingSegment();
+            }
             fRecord->endRecording();
             fPlayback = SkNEW_ARGS(SkPicturePlayback, (*fRecord));
             fRecord->unref();
@@ -242,6 +254,40 @@ void SkPicture::endRecording() {
     SkASSERT(NULL == fRecord);
 }
 
+SkCanvas* SkPicture::beginRecordingSegment(uint32_t segmentID) {
+    if (NULL == fSegments) {
+        if (NULL == fRecord) {
+            return NULL;
+        }
+        fSegments = SkNEW(SkPictureSegments);
+    }
+    return fSegments->beginRecording(segmentID, fRecord, fWidth, fHeight);
+}
+
+void SkPicture::endRecordingSegment() {
+    SkPicture* oldContents;
+    SkPicture* newContents;
+    if (NULL != fSegments &&
+        fSegments->endRecording(&oldContents, &newContents)) {
+        if (NULL != fPlayback) {
+            fPlayback->replacePictureRef(oldContents, newContents);
+        } else if (NULL != fRecord) {
+            fRecord->replacePictureRef(oldContents, newContents);
+        }
+        oldContents->unref();
+    }
+}
+
+bool SkPicture::getDirtyBounds(SkRect* bounds) const {
+    return NULL != fSegments && fSegments->getDirtyBounds(bounds);
+}
+
+void SkPicture::clearDirtyBounds() {
+    if (NULL != fSegments) {
+        fSegments->clearDirtyBounds();
+    }
+}
+
 void SkPicture::draw(SkCanvas* surface) {
     this->endRecording();
     if (fPlayback) {
@@ -254,12 +300,36 @@ void SkPicture::draw(SkCanvas* surface) {
 #include "SkStream.h"
 
 SkPicture::SkPicture(SkStream* stream, bool* success, SkSerializationHelpers::DecodeBitmap decoder) : SkRefCnt() {
-    if (success) {
-        *success = false;
-    }
     fRecord = NULL;
     fPlayback = NULL;
     fWidth = fHeight = 0;
+    fSegments = NULL;
+    this->initFromStream(stream, NULL, success, decoder);
+}
+
+SkPicture::SkPicture(SkData* data, bool* success, SkSerializationHelpers::DecodeBitmap decoder) : SkRefCnt() {
+    fRecord = NULL;
+    fPlayback = NULL;
+    fWidth = fHeight = 0;
+    fSegments = NULL;
+
+    // the reader needs the contents to be 4-byte aligned, so copy them if the
+    // caller handed us an unaligned subset
+    SkAutoTUnref<SkData> aligned;
+    if (SkIsAlign4((intptr_t)data->data())) {
+        aligned.reset(SkRef(data));
+    } else {
+        aligned.reset(SkData::NewWithCopy(data->data(), data->size()));
+    }
+    SkMemoryStream stream(aligned.get());
+    this->initFromStream(&stream, aligned.get(), success, decoder);
+}
+
+void SkPicture::initFromStream(SkStream* stream, SkData* data, bool* success,
+                               SkSerializationHelpers::DecodeBitmap decoder) {
+    if (success) {
+        *success = false;
+    }
 
     SkPictInfo info;
 
@@ -270,9 +340,15 @@ SkPicture::SkPicture(SkStream* stream, bool* success, SkSerializationHelpers::De
         return;
     }
 
-    if (stream->readBool()) {
+    if (stream->readU32()) {
         bool isValid = false;
-        fPlayback = SkNEW_ARGS(SkPicturePlayback, (stream, info, &isValid, decoder));
+        if (data) {
+            fPlayback = SkNEW_ARGS(SkPicturePlayback,
+                                   (static_cast<SkMemoryStream*>(stream), data,
+                                    info, &isValid, decoder));
+        } else {
+            fPlayback = SkNEW_ARGS(SkPicturePlayback, (stream, info, &isValid, decoder));
+        }
         if (!isValid) {
             SkDELETE(fPlayback);
             fPlayback = NULL;
@@ -309,15 +385,16 @@ void SkPicture::serialize(SkWStream* stream, SkSerializationHelpers::EncodeBitma
     }
 
     stream->write(&info, sizeof(info));
+    // written as 32 bits, to keep the rest of the picture 4-byte aligned
     if (playback) {
-        stream->writeBool(true);
+        stream->write32(true);
         playback->serialize(stream, encoder);
         // delete playback if it is a local version (i.e. cons'd up just now)
         if (playback != fPlayback) {
             SkDELETE(playback);
         }
     } else {
-        stream->writeBool(false);
+        stream->write32(false);
     }
 }
 
@@ -22,7 +22,6 @@
 #include "SkPath.h"
 #include "SkRegion.h"
 #include "SkTRefArray.h"
-#include "SkTSearch.h"
 
 enum DrawType {
     UNUSED,
@@ -46,6 +45,7 @@ enum DrawType {
     DRAW_POS_TEXT_TOP_BOTTOM, // fast variant of DRAW_POS_TEXT
     DRAW_POS_TEXT_H,
     DRAW_POS_TEXT_H_TOP_BOTTOM, // fast variant of DRAW_POS_TEXT_H
+    DRAW_POS_TEXT_RUNS,
     DRAW_RECT,
     DRAW_RRECT,
     DRAW_SPRITE,
@@ -401,7 +401,9 @@ public:
         fController->ref();
         // set to 1 since returning a zero from find() indicates failure
         fNextIndex = 1;
-        sk_bzero(fHash, sizeof(fHash));
+        fHash.setCount(kInitialHashCapacity);
+        sk_bzero(fHash.begin(), fHash.count() * sizeof(fHash[0]));
+        fHashCount = 0;
     }
 
     virtual ~SkFlatDictionary() {
@@ -410,6 +412,10 @@ public:
 
     int count() const { return fData.count(); }
 
+    /**
+     * Returns the entry whose 1-based index (as returned by find()) is
+     * index + 1.
+     */
     const SkFlatData*  operator[](int index) const {
         SkASSERT(index >= 0 && index < fData.count());
         return fData[index];
@@ -422,7 +428,8 @@ public:
     void reset() {
         fData.reset();
         fNextIndex = 1;
-        sk_bzero(fHash, sizeof(fHash));
+        sk_bzero(fHash.begin(), fHash.count() * sizeof(fHash[0]));
+        fHashCount = 0;
     }
 
     /**
@@ -441,21 +448,21 @@ public:
         *added = fData.count() == oldCount + 1;
         *replaced = false;
         if (*added && toReplace != NULL) {
-            // First, find the index of the one to replace
-            int indexToReplace = fData.find(toReplace);
-            if (indexToReplace >= 0) {
-                // findAndReturnFlat set the index to fNextIndex and increased
-                // fNextIndex by one. Reuse the index from the one being
-                // replaced and reset fNextIndex to the proper value.
+            // fData is in index order, so if toReplace is in the dictionary
+            // this is where it is.
+            int indexToReplace = toReplace->index() - 1;
+            if (indexToReplace >= 0 && indexToReplace < oldCount &&
+                fData[indexToReplace] == toReplace) {
+                // findAndReturnFlat appended flat with the index fNextIndex,
+                // and increased fNextIndex by one. Move it into the slot of
+                // the one being replaced, reuse its index, and reset
+                // fNextIndex to the proper value.
                 const_cast<SkFlatData*>(flat)->setIndex(toReplace->index());
+                fData[indexToReplace] = flat;
+                fData.setCount(oldCount);
                 fNextIndex--;
-                // Remove from the array.
-                fData.remove(indexToReplace);
                 // Remove from the hash table.
-                int oldHash = ChecksumToHashIndex(toReplace->checksum());
-                if (fHash[oldHash] == toReplace) {
-                    fHash[oldHash] = NULL;
-                }
+                this->removeFromHash(toReplace);
                 // Delete the actual object.
                 fController->unalloc((void*)toReplace);
                 *replaced = true;
@@ -515,60 +522,106 @@ private:
 
     SkFlatController * const     fController;
     int                          fNextIndex;
+    // In index order, i.e. fData[i]->index() == i + 1
     SkTDArray<const SkFlatData*> fData;
 
     const SkFlatData* findAndReturnFlat(const T& element) {
         SkFlatData* flat = SkFlatData::Create(fController, &element, fNextIndex, fFlattenProc);
 
-        int hashIndex = ChecksumToHashIndex(flat->checksum());
-        const SkFlatData* candidate = fHash[hashIndex];
-        if (candidate && !SkFlatData::Compare(flat, candidate)) {
+        int slot = this->findSlot(flat);
+        const SkFlatData* candidate = fHash[slot];
+        if (candidate) {
             fController->unalloc(flat);
             return candidate;
         }
 
-        int index = SkTSearch<SkFlatData>((const SkFlatData**) fData.begin(),
-                                          fData.count(), flat, sizeof(flat),
-                                          &SkFlatData::Compare);
-        if (index >= 0) {
-            fController->unalloc(flat);
-            fHash[hashIndex] = fData[index];
-            return fData[index];
-        }
-
-        index = ~index;
-        *fData.insert(index) = flat;
-        SkASSERT(fData.count() == fNextIndex);
+        SkASSERT(fData.count() == fNextIndex - 1);
+        *fData.append() = flat;
         fNextIndex++;
         flat->setSentinelInCache();
-        fHash[hashIndex] = flat;
+
+        fHash[slot] = flat;
+        if (++fHashCount > (fHash.count() >> 1)) {
+            this->growHash();
+        }
         return flat;
     }
 
-
+    /*  fHash is an open-addressed (linear probing) table of the entries in
+        fData, keyed by their checksums. Its capacity is a power of 2, and we
+        grow it to keep it at most half full, so that lookups and inserts are
+        amortized O(1), and most probes end at an empty slot or at the first
+        entry with a matching checksum.
+     */
     enum {
-        // Determined by trying diff values on picture-recording benchmarks
-        // (e.g. PictureRecordBench.cpp), choosing the smallest value that
-        // showed a big improvement. Even better would be to benchmark diff
-        // values on recording representative web-pages or other "real" content.
-        HASH_BITS   = 7,
-        HASH_MASK   = (1 << HASH_BITS) - 1,
-        HASH_COUNT  = 1 << HASH_BITS
+        kInitialHashCapacity = 128
     };
-    const SkFlatData* fHash[HASH_COUNT];
+    SkTDArray<const SkFlatData*> fHash;
+    int                          fHashCount;
+
+    static uint32_t ChecksumToHash(uint32_t checksum) {
+        // SkChecksum is not well mixed in its low bits, which we mask with
+        uint32_t n = checksum * 0x9E3779B1;
+        return n ^ (n >> 16);
+    }
+
+    // Return the slot holding an entry equal to flat, or else the empty slot
+    // where it would be inserted.
+    int findSlot(const SkFlatData* flat) const {
+        const int mask = fHash.count() - 1;
+        const uint32_t checksum = flat->checksum();
+        int slot = ChecksumToHash(checksum) & mask;
+        for (;;) {
+            const SkFlatData* candidate = fHash[slot];
+            if (NULL == candidate || (candidate->checksum() == checksum &&
+                                      !SkFlatData::Compare(flat, candidate))) {
+                return slot;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
 
-    static int ChecksumToHashIndex(uint32_t checksum) {
-        int n = checksum;
-        if (HASH_BITS < 32) {
-            n ^= n >> 16;
+    void growHash() {
+        const int mask = (fHash.count() << 1) - 1;
+        fHash.setCount(mask + 1);
+        sk_bzero(fHash.begin(), fHash.count() * sizeof(fHash[0]));
+        // Every entry is distinct, so we only need to find an empty slot.
+        for (int i = 0; i < fData.count(); i++) {
+            int slot = ChecksumToHash(fData[i]->checksum()) & mask;
+            while (fHash[slot]) {
+                slot = (slot + 1) & mask;
+            }
+            fHash[slot] = fData[i];
         }
-        if (HASH_BITS < 16) {
-            n ^= n >> 8;
+    }
+
+    void removeFromHash(const SkFlatData* flat) {
+        const int mask = fHash.count() - 1;
+        int slot = ChecksumToHash(flat->checksum()) & mask;
+        while (fHash[slot] != flat) {
+            SkASSERT(fHash[slot]);
+            slot = (slot + 1) & mask;
         }
-        if (HASH_BITS < 8) {
-            n ^= n >> 4;
+
+        // Rather than leave a tombstone, shift back any entries after the hole
+        // that may probe through it, so that lookups can still stop at the
+        // first empty slot.
+        int hole = slot;
+        for (;;) {
+            slot = (slot + 1) & mask;
+            const SkFlatData* entry = fHash[slot];
+            if (NULL == entry) {
+                break;
+            }
+            int home = ChecksumToHash(entry->checksum()) & mask;
+            // entry may move to the hole if its home is not after the hole
+            if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+                fHash[hole] = entry;
+                hole = slot;
+            }
         }
-        return n & HASH_MASK;
+        fHash[hole] = NULL;
+        fHashCount--;
     }
 };
 
@@ -7,6 +7,7 @@
  */
 #include "SkPicturePlayback.h"
 #include "SkPictureRecord.h"
+#include "SkMeasuredPath.h"
 #include "SkTypeface.h"
 #include "SkOrderedReadBuffer.h"
 #include "SkOrderedWriteBuffer.h"
@@ -24,6 +25,114 @@ template <typename T> int SafeCount(const T* obj) {
  */
 #define SPEW_CLIP_SKIPPINGx
 
+/*  A playback that was loaded in place reads its bitmaps, paints and paths
+    from the serialized data when a draw first uses them. This holds that
+    data, and is shared by the playback and its clones. Decoded bitmaps are
+    immutable, so they are shared too (under fBitmapMutex); each playback reads
+    its own paints and paths, since those are not thread-safe.
+ */
+class SkPicturePlayback::LazyData : public SkRefCnt {
+public:
+    LazyData(SkData* data, uint32_t bufferFlags,
+             SkSerializationHelpers::DecodeBitmap decoder)
+        : fData(SkRef(data))
+        , fBuffer(NULL)
+        , fSerialized(NULL)
+        , fFactoryPlayback(NULL)
+        , fBufferFlags(bufferFlags)
+        , fDecoder(decoder) {}
+
+    virtual ~LazyData() {
+        fData->unref();
+        SkSafeUnref(fBuffer);
+        SkSafeUnref(fSerialized);
+        SkDELETE(fFactoryPlayback);
+        for (int i = 0; i < fBitmaps.count(); i++) {
+            SkDELETE(fBitmaps[i]);
+        }
+    }
+
+    const SkBitmap* getBitmap(int index) {
+        SkAutoMutexAcquire lock(fBitmapMutex);
+        if (NULL == fBitmaps[index]) {
+            SkOrderedReadBuffer buffer(fBuffer->data(), fBuffer->size());
+            this->setupBuffer(&buffer, fBitmapOffsets[index]);
+            SkBitmap* bitmap = SkNEW(SkBitmap);
+            buffer.readBitmap(bitmap);
+            bitmap->setImmutable();
+            fBitmaps[index] = bitmap;
+        }
+        return fBitmaps[index];
+    }
+
+    void readPaint(int index, SkPaint* paint) const {
+        SkOrderedReadBuffer buffer(fBuffer->data(), fBuffer->size());
+        this->setupBuffer(&buffer, fPaintOffsets[index]);
+        buffer.readPaint(paint);
+    }
+
+    void readPath(int index, SkPath* path) const {
+        SkOrderedReadBuffer buffer(fBuffer->data(), fBuffer->size());
+        this->setupBuffer(&buffer, fPathOffsets[index]);
+        buffer.readPath(path);
+    }
+
+    SkData* fData;          // everything we were loaded from
+    SkData* fBuffer;        // the contents of the PICT_BUFFER_SIZE_TAG
+    SkData* fSerialized;    // the part of fData that holds our playback
+
+    SkTypefacePlayback fTFPlayback;
+    SkFactoryPlayback* fFactoryPlayback;
+
+    // where each flattened object starts in fBuffer
+    SkTDArray<uint32_t> fBitmapOffsets;
+    SkTDArray<uint32_t> fPaintOffsets;
+    SkTDArray<uint32_t> fPathOffsets;
+
+    SkTDArray<SkBitmap*> fBitmaps;
+
+private:
+    void setupBuffer(SkOrderedReadBuffer* buffer, uint32_t offset) const {
+        buffer->setFlags(fBufferFlags);
+        if (fFactoryPlayback) {
+            fFactoryPlayback->setupBuffer(*buffer);
+        }
+        fTFPlayback.setupBuffer(*buffer);
+        buffer->setBitmapDecoder(fDecoder);
+        buffer->getReader32()->setOffset(offset);
+    }
+
+    uint32_t fBufferFlags;
+    SkSerializationHelpers::DecodeBitmap fDecoder;
+    SkMutex fBitmapMutex;
+};
+
+const SkBitmap& SkPicturePlayback::getLazyBitmap(int index) {
+    if (NULL == fLazyBitmaps[index]) {
+        fLazyBitmaps[index] = fLazy->getBitmap(index);
+    }
+    return *fLazyBitmaps[index];
+}
+
+const SkPaint& SkPicturePlayback::getLazyPaint(int index) {
+    if (NULL == fLazyPaints[index]) {
+        SkPaint* paint = SkNEW(SkPaint);
+        fLazy->readPaint(index, paint);
+        fLazyPaints[index] = paint;
+    }
+    return *fLazyPaints[index];
+}
+
+const SkPath& SkPicturePlayback::getLazyPath(int index) {
+    if (NULL == fLazyPaths[index]) {
+        SkPath* path = SkNEW(SkPath);
+        fLazy->readPath(index, path);
+        path->updateBoundsCache();
+        fLazyPaths[index] = path;
+    }
+    return *fLazyPaths[index];
+}
+
 SkPicturePlayback::SkPicturePlayback() {
     this->init();
 }
@@ -110,6 +219,19 @@ SkPicturePlayback::SkPicturePlayback(const SkPictureRecord& record, bool deepCop
         }
     }
 
+    // hold on to the measured paths, so that we need not measure them again
+    const SkTDArray<SkPictureRecord::MeasuredPathRef>& measured =
+                                                    record.fMeasuredPathRefs;
+    if (measured.count() > 0) {
+        fMeasuredPaths.setCount(fPathHeap->count());
+        sk_bzero(fMeasuredPaths.begin(), fMeasuredPaths.bytes());
+        for (int i = 0; i < measured.count(); i++) {
+            SkMeasuredPath* path = const_cast<SkMeasuredPath*>(measured[i].fPath);
+            fMeasuredPaths[measured[i].fIndex - 1] = path;
+            path->ref();
+        }
+    }
+
     const SkTDArray<SkPicture* >& pictures = record.getPictureRefs();
     fPictureCount = pictures.count();
     if (fPictureCount > 0) {
@@ -170,6 +292,12 @@ SkPicturePlayback::SkPicturePlayback(const SkPicturePlayback& src, SkPictCopyInf
     fBitmapHeap.reset(SkSafeRef(src.fBitmapHeap.get()));
     fPathHeap.reset(SkSafeRef(src.fPathHeap.get()));
 
+    // measured paths are immutable, so they can be shared
+    fMeasuredPaths = src.fMeasuredPaths;
+    for (int i = 0; i < fMeasuredPaths.count(); i++) {
+        SkSafeRef(fMeasuredPaths[i]);
+    }
+
     fMatrices = SkSafeRef(src.fMatrices);
     fRegions = SkSafeRef(src.fRegions);
     fOpData = SkSafeRef(src.fOpData);
@@ -180,7 +308,16 @@ SkPicturePlayback::SkPicturePlayback(const SkPicturePlayback& src, SkPictCopyInf
     SkSafeRef(fBoundingHierarchy);
     SkSafeRef(fStateTree);
 
-    if (deepCopyInfo) {
+    if (src.fLazy) {
+        // Bitmaps are shared, but we read our own paints and paths, so there
+        // is nothing to deep copy.
+        fLazy = SkRef(src.fLazy);
+        fLazyBitmaps = src.fLazyBitmaps;
+        fLazyPaints.setCount(src.fLazyPaints.count());
+        sk_bzero(fLazyPaints.begin(), fLazyPaints.bytes());
+        fLazyPaths.setCount(src.fLazyPaths.count());
+        sk_bzero(fLazyPaths.begin(), fLazyPaths.bytes());
+    } else if (deepCopyInfo) {
 
         if (src.fBitmaps) {
             fBitmaps = SkTRefArray<SkBitmap>::Create(src.fBitmaps->begin(), src.fBitmaps->count());
@@ -266,13 +403,14 @@ void SkPicturePlayback::init() {
     fRegions = NULL;
     fPictureCount = 0;
     fOpData = NULL;
+    fLazy = NULL;
     fFactoryPlayback = NULL;
     fBoundingHierarchy = NULL;
     fStateTree = NULL;
 }
 
 SkPicturePlayback::~SkPicturePlayback() {
-    fOpData->unref();
+    SkSafeUnref(fOpData);
 
     SkSafeUnref(fBitmaps);
     SkSafeUnref(fMatrices);
@@ -280,6 +418,15 @@ SkPicturePlayback::~SkPicturePlayback() {
     SkSafeUnref(fRegions);
     SkSafeUnref(fBoundingHierarchy);
     SkSafeUnref(fStateTree);
+    fMeasuredPaths.safeUnrefAll();
+
+    SkSafeUnref(fLazy);
+    for (int i = 0; i < fLazyPaints.count(); i++) {
+        SkDELETE(fLazyPaints[i]);
+    }
+    for (int i = 0; i < fLazyPaths.count(); i++) {
+        SkDELETE(fLazyPaths[i]);
+    }
 
     for (int i = 0; i < fPictureCount; i++) {
         fPictureRefs[i]->unref();
@@ -333,11 +480,22 @@ static void writeTagSize(SkWStream* stream, uint32_t tag,
     stream->write32(size);
 }
 
+/*  The entries of the factory and typeface tags are preceded by their length,
+    and padded so that what follows them stays 4-byte aligned.
+ */
+static void writeEntries(SkWStream* stream, SkDynamicMemoryWStream* entries) {
+    stream->write32(entries->getOffset());
+    entries->padToAlign4();
+    SkAutoDataUnref data(entries->copyToData());
+    stream->write(data->data(), data->size());
+}
+
 static void writeFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
     writeTagSize(stream, PICT_FACTORY_TAG, count);
 
+    SkDynamicMemoryWStream entries;
     SkAutoSTMalloc<16, SkFlattenable::Factory> storage(count);
     SkFlattenable::Factory* array = (SkFlattenable::Factory*)storage.get();
     rec.copyToArray(array);
@@ -346,13 +504,14 @@ static void writeFactories(SkWStream* stream, const SkFactorySet& rec) {
         const char* name = SkFlattenable::FactoryToName(array[i]);
 //        SkDebugf("---- write factories [%d] %p <%s>\n", i, array[i], name);
         if (NULL == name || 0 == *name) {
-            stream->writePackedUInt(0);
+            entries.writePackedUInt(0);
         } else {
             uint32_t len = strlen(name);
-            stream->writePackedUInt(len);
-            stream->write(name, len);
+            entries.writePackedUInt(len);
+            entries.write(name, len);
         }
     }
+    writeEntries(stream, &entries);
 }
 
 static void writeTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
@@ -364,19 +523,42 @@ static void writeTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
     SkTypeface** array = (SkTypeface**)storage.get();
     rec.copyToArray((SkRefCnt**)array);
 
+    SkDynamicMemoryWStream entries;
     for (int i = 0; i < count; i++) {
-        array[i]->serialize(stream);
+        array[i]->serialize(&entries);
     }
+    writeEntries(stream, &entries);
+}
+
+/*  The flattened bitmaps, paints and paths are preceded by a table of where
+    each of them starts in the buffer, followed by where the last one ends, so
+    that a playback loaded in place can read them one at a time. This reserves
+    the table for count objects, and returns where it starts.
+ */
+static size_t reserveOffsets(SkOrderedWriteBuffer& buffer, int count) {
+    size_t table = buffer.size();
+    buffer.reserve((count + 1) * sizeof(uint32_t));
+    return table;
+}
+
+// Records that object index (or the end, if index is the count) starts here.
+static void writeOffset(SkOrderedWriteBuffer& buffer, size_t table, int index) {
+    *buffer.getWriter32()->peek32(table + index * sizeof(uint32_t)) = buffer.size();
 }
 
 void SkPicturePlayback::flattenToBuffer(SkOrderedWriteBuffer& buffer) const {
+    SkASSERT(NULL == fLazy);
     int i, n;
+    size_t table;
 
     if ((n = SafeCount(fBitmaps)) > 0) {
         writeTagSize(buffer, PICT_BITMAP_BUFFER_TAG, n);
+        table = reserveOffsets(buffer, n);
         for (i = 0; i < n; i++) {
+            writeOffset(buffer, table, i);
             buffer.writeBitmap((*fBitmaps)[i]);
         }
+        writeOffset(buffer, table, n);
     }
 
     if ((n = SafeCount(fMatrices)) > 0) {
@@ -389,14 +571,24 @@ void SkPicturePlayback::flattenToBuffer(SkOrderedWriteBuffer& buffer) const {
 
     if ((n = SafeCount(fPaints)) > 0) {
         writeTagSize(buffer, PICT_PAINT_BUFFER_TAG, n);
+        table = reserveOffsets(buffer, n);
         for (i = 0; i < n; i++) {
+            writeOffset(buffer, table, i);
             buffer.writePaint((*fPaints)[i]);
         }
+        writeOffset(buffer, table, n);
     }
 
     if ((n = SafeCount(fPathHeap.get())) > 0) {
+        // this matches SkPathHeap::flatten(), with the offsets added
         writeTagSize(buffer, PICT_PATH_BUFFER_TAG, n);
-        fPathHeap->flatten(buffer);
+        table = reserveOffsets(buffer, n);
+        buffer.writeInt(n);
+        for (i = 0; i < n; i++) {
+            writeOffset(buffer, table, i);
+            buffer.writePath((*fPathHeap.get())[i]);
+        }
+        writeOffset(buffer, table, n);
     }
 
     if ((n = SafeCount(fRegions)) > 0) {
@@ -409,6 +601,14 @@ void SkPicturePlayback::flattenToBuffer(SkOrderedWriteBuffer& buffer) const {
 
 void SkPicturePlayback::serialize(SkWStream* stream,
                                   SkSerializationHelpers::EncodeBitmap encoder) const {
+    if (fLazy) {
+        // Nothing has changed since we were loaded, so write out what we were
+        // loaded from (the bitmaps are already encoded, or not, as they were
+        // then).
+        stream->write(fLazy->fSerialized->data(), fLazy->fSerialized->size());
+        return;
+    }
+
     writeTagSize(stream, PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
 
@@ -472,6 +672,33 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
     return rbMask;
 }
 
+/**
+ *  Return the next size bytes of stream, which reads from data, without
+ *  copying them, or NULL if data is too short.
+ */
+static SkData* readInPlace(SkStream* stream, SkData* data, size_t size) {
+    SkMemoryStream* memStream = static_cast<SkMemoryStream*>(stream);
+    size_t offset = (const char*)memStream->getAtPos() - (const char*)data->data();
+    if (size > data->size() - offset) {
+        return NULL;
+    }
+    memStream->skip(size);
+    return SkData::NewSubset(data, offset, size);
+}
+
+/**
+ *  Read the (padded) entries of a factory or typeface tag into storage, and
+ *  return their length.
+ */
+static size_t readEntries(SkStream* stream, SkAutoMalloc* storage) {
+    size_t length = stream->readU32();
+    size_t padded = SkAlign4(length);
+    if (stream->read(storage->reset(padded), padded) != padded) {
+        return 0;
+    }
+    return length;
+}
+
 bool SkPicturePlayback::parseStreamTag(SkStream* stream, const SkPictInfo& info,
                                        uint32_t tag, size_t size,
                                        SkSerializationHelpers::DecodeBitmap decoder) {
@@ -486,53 +713,91 @@ bool SkPicturePlayback::parseStreamTag(SkStream* stream, const SkPictInfo& info,
      */
     bool haveBuffer = false;
 
+    // If we are being loaded in place, the factories and typefaces are kept
+    // with the rest of what we read lazily.
+    SkFactoryPlayback*& factoryPlayback = fLazy ? fLazy->fFactoryPlayback : fFactoryPlayback;
+    SkTypefacePlayback& tfPlayback = fLazy ? fLazy->fTFPlayback : fTFPlayback;
+
     switch (tag) {
         case PICT_READER_TAG: {
-            void* storage = sk_malloc_throw(size);
-            stream->read(storage, size);
             SkASSERT(NULL == fOpData);
-            fOpData = SkData::NewFromMalloc(storage, size);
+            if (fLazy) {
+                fOpData = readInPlace(stream, fLazy->fData, size);
+                if (NULL == fOpData) {
+                    return false;
+                }
+            } else {
+                void* storage = sk_malloc_throw(size);
+                stream->read(storage, size);
+                fOpData = SkData::NewFromMalloc(storage, size);
+            }
         } break;
         case PICT_FACTORY_TAG: {
             SkASSERT(!haveBuffer);
-            fFactoryPlayback = SkNEW_ARGS(SkFactoryPlayback, (size));
+            SkAutoMalloc storage;
+            size_t length = readEntries(stream, &storage);
+            SkMemoryStream entries(storage.get(), length);
+            factoryPlayback = SkNEW_ARGS(SkFactoryPlayback, (size));
             for (size_t i = 0; i < size; i++) {
                 SkString str;
-                int len = stream->readPackedUInt();
+                int len = entries.readPackedUInt();
                 str.resize(len);
-                stream->read(str.writable_str(), len);
-                fFactoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
+                entries.read(str.writable_str(), len);
+                factoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
             }
         } break;
         case PICT_TYPEFACE_TAG: {
             SkASSERT(!haveBuffer);
-            fTFPlayback.setCount(size);
+            SkAutoMalloc storage;
+            size_t length = readEntries(stream, &storage);
+            SkMemoryStream entries(storage.get(), length);
+            tfPlayback.setCount(size);
             for (size_t i = 0; i < size; i++) {
-                SkSafeUnref(fTFPlayback.set(i, SkTypeface::Deserialize(stream)));
+                SkSafeUnref(tfPlayback.set(i, SkTypeface::Deserialize(&entries)));
             }
         } break;
         case PICT_PICTURE_TAG: {
             fPictureCount = size;
             fPictureRefs = SkNEW_ARRAY(SkPicture*, fPictureCount);
             for (int i = 0; i < fPictureCount; i++) {
-                fPictureRefs[i] = SkNEW_ARGS(SkPicture, (stream));
+                if (fLazy) {
+                    fPictureRefs[i] = SkNEW(SkPicture);
+                    fPictureRefs[i]->initFromStream(stream, fLazy->fData, NULL, decoder);
+                } else {
+                    fPictureRefs[i] = SkNEW_ARGS(SkPicture, (stream));
+                }
             }
         } break;
         case PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            stream->read(storage.get(), size);
+            SkAutoMalloc storage;
+            const void* bytes;
+            if (fLazy) {
+                SkASSERT(NULL == fLazy->fBuffer);
+                fLazy->fBuffer = readInPlace(stream, fLazy->fData, size);
+                if (NULL == fLazy->fBuffer) {
+                    return false;
+                }
+                bytes = fLazy->fBuffer->data();
+            } else {
+                bytes = storage.reset(size);
+                stream->read(storage.get(), size);
+            }
 
-            SkOrderedReadBuffer buffer(storage.get(), size);
+            SkOrderedReadBuffer buffer(bytes, size);
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(info.fFlags));
 
-            fFactoryPlayback->setupBuffer(buffer);
-            fTFPlayback.setupBuffer(buffer);
+            if (factoryPlayback) {
+                factoryPlayback->setupBuffer(buffer);
+            }
+            tfPlayback.setupBuffer(buffer);
             buffer.setBitmapDecoder(decoder);
 
             while (!buffer.eof()) {
                 tag = buffer.readUInt();
                 size = buffer.readUInt();
-                if (!this->parseBufferTag(buffer, tag, size)) {
+                bool success = fLazy ? this->parseLazyBufferTag(buffer, tag, size)
+                                     : this->parseBufferTag(buffer, tag, size);
+                if (!success) {
                     return false;
                 }
             }
@@ -542,10 +807,37 @@ bool SkPicturePlayback::parseStreamTag(SkStream* stream, const SkPictInfo& info,
     return true;    // success
 }
 
+/**
+ *  Read the table that precedes count flattened bitmaps, paints or paths (see
+ *  reserveOffsets()), and skip to the end of them. Return false if the table
+ *  is not valid for buffer.
+ */
+static bool readOffsets(SkOrderedReadBuffer& buffer, size_t count,
+                        SkTDArray<uint32_t>* offsets) {
+    if (count >= (buffer.size() - buffer.offset()) / sizeof(uint32_t)) {
+        return false;
+    }
+    offsets->setCount(count + 1);
+    memcpy(offsets->begin(), buffer.skip(offsets->bytes()), offsets->bytes());
+
+    uint32_t prev = buffer.offset();
+    for (size_t i = 0; i <= count; i++) {
+        uint32_t offset = (*offsets)[i];
+        if (offset < prev || offset > buffer.size() || SkAlign4(offset) != offset) {
+            return false;
+        }
+        prev = offset;
+    }
+    buffer.getReader32()->setOffset(prev);
+    offsets->setCount(count);
+    return true;
+}
+
 bool SkPicturePlayback::parseBufferTag(SkOrderedReadBuffer& buffer,
                                        uint32_t tag, size_t size) {
     switch (tag) {
         case PICT_BITMAP_BUFFER_TAG: {
+            buffer.skip((size + 1) * sizeof(uint32_t));    // the offsets
             fBitmaps = SkTRefArray<SkBitmap>::Create(size);
             for (size_t i = 0; i < size; ++i) {
                 SkBitmap* bm = &fBitmaps->writableAt(i);
@@ -560,12 +852,14 @@ bool SkPicturePlayback::parseBufferTag(SkOrderedReadBuffer& buffer,
             }
             break;
         case PICT_PAINT_BUFFER_TAG: {
+            buffer.skip((size + 1) * sizeof(uint32_t));    // the offsets
             fPaints = SkTRefArray<SkPaint>::Create(size);
             for (size_t i = 0; i < size; ++i) {
                 buffer.readPaint(&fPaints->writableAt(i));
             }
         } break;
         case PICT_PATH_BUFFER_TAG:
+            buffer.skip((size + 1) * sizeof(uint32_t));    // the offsets
             if (size > 0) {
                 fPathHeap.reset(SkNEW_ARGS(SkPathHeap, (buffer)));
             }
@@ -580,23 +874,80 @@ bool SkPicturePlayback::parseBufferTag(SkOrderedReadBuffer& buffer,
     return true;    // success
 }
 
-SkPicturePlayback::SkPicturePlayback(SkStream* stream, const SkPictInfo& info,
-                                     bool* isValid, SkSerializationHelpers::DecodeBitmap decoder) {
-    this->init();
+bool SkPicturePlayback::parseLazyBufferTag(SkOrderedReadBuffer& buffer,
+                                           uint32_t tag, size_t size) {
+    switch (tag) {
+        case PICT_BITMAP_BUFFER_TAG:
+            if (!readOffsets(buffer, size, &fLazy->fBitmapOffsets)) {
+                return false;
+            }
+            fLazy->fBitmaps.setCount(size);
+            sk_bzero(fLazy->fBitmaps.begin(), fLazy->fBitmaps.bytes());
+            fLazyBitmaps.setCount(size);
+            sk_bzero(fLazyBitmaps.begin(), fLazyBitmaps.bytes());
+            break;
+        case PICT_PAINT_BUFFER_TAG:
+            if (!readOffsets(buffer, size, &fLazy->fPaintOffsets)) {
+                return false;
+            }
+            fLazyPaints.setCount(size);
+            sk_bzero(fLazyPaints.begin(), fLazyPaints.bytes());
+            break;
+        case PICT_PATH_BUFFER_TAG:
+            if (!readOffsets(buffer, size, &fLazy->fPathOffsets)) {
+                return false;
+            }
+            fLazyPaths.setCount(size);
+            sk_bzero(fLazyPaths.begin(), fLazyPaths.bytes());
+            break;
+        default:
+            // matrices and regions are cheap to read, so we read them now
+            return this->parseBufferTag(buffer, tag, size);
+    }
+    return true;
+}
 
-    *isValid = false;   // wait until we're done parsing to mark as true
+bool SkPicturePlayback::parseStream(SkStream* stream, const SkPictInfo& info,
+                                    SkSerializationHelpers::DecodeBitmap decoder) {
     for (;;) {
-        uint32_t tag = stream->readU32();
+        uint32_t tag;
+        if (stream->read(&tag, sizeof(tag)) != sizeof(tag)) {
+            return false;
+        }
         if (PICT_EOF_TAG == tag) {
-            break;
+            return true;
         }
 
         uint32_t size = stream->readU32();
         if (!this->parseStreamTag(stream, info, tag, size, decoder)) {
-            return; // we're invalid
+            return false;
         }
     }
-    *isValid = true;
+}
+
+SkPicturePlayback::SkPicturePlayback(SkStream* stream, const SkPictInfo& info,
+                                     bool* isValid, SkSerializationHelpers::DecodeBitmap decoder) {
+    this->init();
+
+    // wait until we're done parsing to mark as true
+    *isValid = this->parseStream(stream, info, decoder);
+}
+
+SkPicturePlayback::SkPicturePlayback(SkMemoryStream* stream, SkData* data,
+                                     const SkPictInfo& info, bool* isValid,
+                                     SkSerializationHelpers::DecodeBitmap decoder) {
+    this->init();
+
+    fLazy = SkNEW_ARGS(LazyData, (data, pictInfoFlagsToReadBufferFlags(info.fFlags),
+                                  decoder));
+
+    const char* start = (const char*)stream->getAtPos();
+    *isValid = this->parseStream(stream, info, decoder);
+    if (*isValid) {
+        const char* base = (const char*)data->data();
+        fLazy->fSerialized = SkData::NewSubset(data, start - base,
+                                               (const char*)stream->getAtPos() - start);
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -628,6 +979,48 @@ void SkPicturePlayback::postDraw(size_t offset) {
 }
 #endif
 
+/*  Within one draw, text that follows the same path can share its
+    measurements. Paths recorded with drawTextOnMeasuredPath start out
+    measured; any other path is measured the first time text is drawn along
+    it. This lives on the stack of draw(), since a playback may be drawn by
+    several threads at once.
+ */
+class SkPicturePlayback::MeasuredPathCache : SkNoncopyable {
+public:
+    MeasuredPathCache(const SkTDArray<SkMeasuredPath*>& recorded)
+        : fRecorded(recorded) {}
+
+    ~MeasuredPathCache() {
+        fPaths.safeUnrefAll();
+    }
+
+    const SkMeasuredPath& get(SkPicturePlayback* playback, int index) {
+        if (fPaths.isEmpty()) {
+            fPaths.setCount(playback->pathCount());
+            for (int i = 0; i < fPaths.count(); i++) {
+                SkMeasuredPath* path = NULL;
+                if (i < fRecorded.count()) {
+                    path = fRecorded[i];
+                }
+                fPaths[i] = SkSafeRef(path);
+            }
+        }
+        if (NULL == fPaths[index]) {
+            fPaths[index] = SkNEW_ARGS(SkMeasuredPath, (playback->getPathAt(index)));
+        }
+        return *fPaths[index];
+    }
+
+private:
+    const SkTDArray<SkMeasuredPath*>& fRecorded;
+    SkTDArray<SkMeasuredPath*> fPaths;
+};
+
+const SkMeasuredPath& SkPicturePlayback::getMeasuredPath(
+                            SkReader32& reader, MeasuredPathCache* cache) {
+    return cache->get(this, reader.readInt() - 1);
+}
+
 void SkPicturePlayback::draw(SkCanvas& canvas) {
 #ifdef ENABLE_TIME_DRAW
     SkAutoTime  at("SkPicture::draw", 50);
@@ -647,6 +1040,7 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
 
     SkReader32 reader(fOpData->bytes(), fOpData->size());
     TextContainer text;
+    MeasuredPathCache measuredPaths(fMeasuredPaths);
     SkTDArray<void*> results;
 
     if (NULL != fStateTree && NULL != fBoundingHierarchy) {
@@ -853,6 +1247,21 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
                                         constY, paint);
                 }
             } break;
+            case DRAW_POS_TEXT_RUNS: {
+                const SkPaint& paint = *getPaint(reader);
+                int runCount = reader.readInt();
+                SkAutoSTMalloc<16, SkCanvas::PosTextRun> runs(runCount);
+                for (int i = 0; i < runCount; i++) {
+                    SkCanvas::PosTextRun& run = runs[i];
+                    run.fColor = reader.readInt();
+                    run.fCount = reader.readInt();
+                    run.fGlyphs = (const uint16_t*)reader.skip(
+                                        run.fCount * sizeof(uint16_t));
+                    run.fPos = (const SkPoint*)reader.skip(
+                                        run.fCount * sizeof(SkPoint));
+                }
+                canvas.drawPosTextRuns(runs.get(), runCount, paint);
+            } break;
             case DRAW_RECT: {
                 const SkPaint& paint = *getPaint(reader);
                 canvas.drawRect(reader.skipT<SkRect>(), paint);
@@ -892,10 +1301,11 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
             case DRAW_TEXT_ON_PATH: {
                 const SkPaint& paint = *getPaint(reader);
                 getText(reader, &text);
-                const SkPath& path = getPath(reader);
+                const SkMeasuredPath& path = getMeasuredPath(reader,
+                                                             &measuredPaths);
                 const SkMatrix* matrix = getMatrix(reader);
-                canvas.drawTextOnPath(text.text(), text.length(), path,
-                                      matrix, paint);
+                canvas.drawTextOnMeasuredPath(text.text(), text.length(), path,
+                                              matrix, paint);
             } break;
             case DRAW_VERTICES: {
                 const SkPaint& paint = *getPaint(reader);
@@ -991,6 +1401,18 @@ void SkPicturePlayback::abort() {
 //    fReader.skip(fReader.size() - fReader.offset());
 }
 
+bool SkPicturePlayback::replacePictureRef(SkPicture* oldPicture,
+                                          SkPicture* newPicture) {
+    for (int i = 0; i < fPictureCount; i++) {
+        if (fPictureRefs[i] == oldPicture) {
+            fPictureRefs[i] = SkRef(newPicture);
+            oldPicture->unref();
+            return true;
+        }
+    }
+    return false;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG_SIZE
@@ -27,7 +27,9 @@
 #include "SkThread.h"
 #endif
 
+class SkMeasuredPath;
 class SkPictureRecord;
+class SkMemoryStream;
 class SkStream;
 class SkWStream;
 class SkBBoxHierarchy;
@@ -65,6 +67,10 @@ public:
     explicit SkPicturePlayback(const SkPictureRecord& record, bool deepCopy = false);
     SkPicturePlayback(SkStream*, const SkPictInfo&, bool* isValid,
                       SkSerializationHelpers::DecodeBitmap decoder);
+    // Loads the playback in place: stream must read from data, which is
+    // ref'd rather than copied.
+    SkPicturePlayback(SkMemoryStream*, SkData* data, const SkPictInfo&,
+                      bool* isValid, SkSerializationHelpers::DecodeBitmap decoder);
 
     virtual ~SkPicturePlayback();
 
@@ -78,6 +84,10 @@ public:
     // drawing and return from draw() after the "current" op code is done
     void abort();
 
+    // Make the ops that draw oldPicture draw newPicture instead. Returns false
+    // if oldPicture is not drawn.
+    bool replacePictureRef(SkPicture* oldPicture, SkPicture* newPicture);
+
 protected:
 #ifdef SK_DEVELOPER
     virtual size_t preDraw(size_t offset, int type);
@@ -99,6 +109,9 @@ private:
             SkDebugf("An invalid bitmap was recorded!\n");
             return fBadBitmap;
         }
+        if (fLazy) {
+            return this->getLazyBitmap(index);
+        }
         return (*fBitmaps)[index];
     }
 
@@ -111,9 +124,27 @@ private:
     }
 
     const SkPath& getPath(SkReader32& reader) {
-        return (*fPathHeap)[reader.readInt() - 1];
+        return this->getPathAt(reader.readInt() - 1);
+    }
+
+    const SkPath& getPathAt(int index) {
+        if (fLazy) {
+            return this->getLazyPath(index);
+        }
+        return (*fPathHeap)[index];
+    }
+
+    int pathCount() const {
+        if (fLazy) {
+            return fLazyPaths.count();
+        }
+        return fPathHeap.get() ? fPathHeap->count() : 0;
     }
 
+    class MeasuredPathCache;
+    const SkMeasuredPath& getMeasuredPath(SkReader32& reader,
+                                          MeasuredPathCache* cache);
+
     SkPicture& getPicture(SkReader32& reader) {
         int index = reader.readInt();
         SkASSERT(index > 0 && index <= fPictureCount);
@@ -125,6 +156,9 @@ private:
         if (index == 0) {
             return NULL;
         }
+        if (fLazy) {
+            return &this->getLazyPaint(index - 1);
+        }
         return &(*fPaints)[index - 1];
     }
 
@@ -156,6 +190,12 @@ private:
 
     void init();
 
+    // Each of these reads the object from fLazy the first time it is asked for
+    class LazyData;
+    const SkBitmap& getLazyBitmap(int index);
+    const SkPaint& getLazyPaint(int index);
+    const SkPath& getLazyPath(int index);
+
 #ifdef SK_DEBUG_SIZE
 public:
     int size(size_t* sizePtr);
@@ -189,9 +229,12 @@ public:
 #endif
 
 private:    // these help us with reading/writing
+    bool parseStream(SkStream*, const SkPictInfo&,
+                     SkSerializationHelpers::DecodeBitmap decoder);
     bool parseStreamTag(SkStream*, const SkPictInfo&, uint32_t tag, size_t size,
                         SkSerializationHelpers::DecodeBitmap decoder);
     bool parseBufferTag(SkOrderedReadBuffer&, uint32_t tag, size_t size);
+    bool parseLazyBufferTag(SkOrderedReadBuffer&, uint32_t tag, size_t size);
     void flattenToBuffer(SkOrderedWriteBuffer&) const;
 
 private:
@@ -201,6 +244,9 @@ private:
 
     SkAutoTUnref<SkBitmapHeap> fBitmapHeap;
     SkAutoTUnref<SkPathHeap> fPathHeap;
+    // For each path in fPathHeap, the measured path it was recorded from (we
+    // ref these), or NULL if it was not recorded by drawTextOnMeasuredPath.
+    SkTDArray<SkMeasuredPath*> fMeasuredPaths;
 
     SkTRefArray<SkBitmap>* fBitmaps;
     SkTRefArray<SkMatrix>* fMatrices;
@@ -209,6 +255,13 @@ private:
 
     SkData* fOpData;    // opcodes and parameters
 
+    // If we were loaded in place, the flattened bitmaps, paints and paths
+    // (shared with our clones), and the ones we have read from it so far.
+    LazyData* fLazy;
+    SkTDArray<const SkBitmap*> fLazyBitmaps;
+    SkTDArray<SkPaint*> fLazyPaints;
+    SkTDArray<SkPath*> fLazyPaths;
+
     SkPicture** fPictureRefs;
     int fPictureCount;
 
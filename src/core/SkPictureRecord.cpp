@@ -7,6 +7,7 @@
  */
 #include "SkPictureRecord.h"
 #include "SkTSearch.h"
+#include "SkMeasuredPath.h"
 #include "SkPixelRef.h"
 #include "SkRRect.h"
 #include "SkBBoxHierarchy.h"
@@ -52,6 +53,9 @@ SkPictureRecord::~SkPictureRecord() {
     SkSafeUnref(fStateTree);
     fFlattenableHeap.setBitmapStorage(NULL);
     fPictureRefs.unrefAll();
+    for (int i = 0; i < fMeasuredPathRefs.count(); i++) {
+        fMeasuredPathRefs[i].fPath->unref();
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -129,6 +133,7 @@ static inline uint32_t getSkipableSize(unsigned drawType) {
         0,  // DRAW_POS_TEXT_TOP_BOTTOM, // fast variant of DRAW_POS_TEXT
         0,  // DRAW_POS_TEXT_H,
         0,  // DRAW_POS_TEXT_H_TOP_BOTTOM, // fast variant of DRAW_POS_TEXT_H
+        0,  // DRAW_POS_TEXT_RUNS,
         0,  // DRAW_RECT,
         0,  // DRAW_RRECT,
         0,  // DRAW_SPRITE,
@@ -655,6 +660,25 @@ void SkPictureRecord::drawPosTextH(const void* text, size_t byteLength,
     validate();
 }
 
+void SkPictureRecord::drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                      const SkPaint& paint) {
+    if (runCount <= 0)
+        return;
+
+    addDraw(DRAW_POS_TEXT_RUNS);
+    addPaint(paint);
+    addInt(runCount);
+    for (int i = 0; i < runCount; i++) {
+        const PosTextRun& run = runs[i];
+        int count = SkMax32(run.fCount, 0);
+        addInt(run.fColor);
+        addInt(count);
+        fWriter.writePad(run.fGlyphs, count * sizeof(uint16_t));
+        fWriter.writeMul4(run.fPos, count * sizeof(SkPoint));
+    }
+    validate();
+}
+
 void SkPictureRecord::drawTextOnPath(const void* text, size_t byteLength,
                             const SkPath& path, const SkMatrix* matrix,
                             const SkPaint& paint) {
@@ -666,12 +690,28 @@ void SkPictureRecord::drawTextOnPath(const void* text, size_t byteLength,
     validate();
 }
 
+void SkPictureRecord::drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                             const SkMeasuredPath& path,
+                                             const SkMatrix* matrix,
+                                             const SkPaint& paint) {
+    addDraw(DRAW_TEXT_ON_PATH);
+    addPaint(paint);
+    addText(text, byteLength);
+    addMeasuredPath(path);
+    addMatrixPtr(matrix);
+    validate();
+}
+
 void SkPictureRecord::drawPicture(SkPicture& picture) {
     addDraw(DRAW_PICTURE);
     addPicture(picture);
     validate();
 }
 
+void SkPictureRecord::drawSegment(SkPicture& contents, const SkIRect&) {
+    this->SkPictureRecord::drawPicture(contents);
+}
+
 void SkPictureRecord::drawVertices(VertexMode vmode, int vertexCount,
                           const SkPoint vertices[], const SkPoint texs[],
                           const SkColor colors[], SkXfermode*,
@@ -744,6 +784,24 @@ void SkPictureRecord::addPath(const SkPath& path) {
     addInt(fPathHeap->append(path));
 }
 
+void SkPictureRecord::addMeasuredPath(const SkMeasuredPath& path) {
+    int count = fMeasuredPathRefs.count();
+    int index = SkTSearch<const SkMeasuredPath*>(
+                        count ? &fMeasuredPathRefs[0].fPath : NULL, count,
+                        &path, sizeof(MeasuredPathRef));
+    if (index < 0) {    // not found
+        if (NULL == fPathHeap) {
+            fPathHeap = SkNEW(SkPathHeap);
+        }
+        index = ~index;
+        MeasuredPathRef* ref = fMeasuredPathRefs.insert(index);
+        ref->fPath = &path;
+        ref->fIndex = fPathHeap->append(path.getPath());
+        path.ref();
+    }
+    addInt(fMeasuredPathRefs[index].fIndex);
+}
+
 void SkPictureRecord::addPicture(SkPicture& picture) {
     int index = fPictureRefs.find(&picture);
     if (index < 0) {    // not found
@@ -755,6 +813,17 @@ void SkPictureRecord::addPicture(SkPicture& picture) {
     addInt(index + 1);
 }
 
+bool SkPictureRecord::replacePictureRef(SkPicture* oldPicture,
+                                        SkPicture* newPicture) {
+    int index = fPictureRefs.find(oldPicture);
+    if (index < 0) {
+        return false;
+    }
+    fPictureRefs[index] = SkRef(newPicture);
+    oldPicture->unref();
+    return true;
+}
+
 void SkPictureRecord::addPoint(const SkPoint& point) {
 #ifdef SK_DEBUG_SIZE
     size_t start = fWriter.size();
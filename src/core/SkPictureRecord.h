@@ -63,9 +63,15 @@ public:
                              const SkPoint pos[], const SkPaint&) SK_OVERRIDE;
     virtual void drawPosTextH(const void* text, size_t byteLength,
                       const SkScalar xpos[], SkScalar constY, const SkPaint&) SK_OVERRIDE;
+    virtual void drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                 const SkPaint&) SK_OVERRIDE;
     virtual void drawTextOnPath(const void* text, size_t byteLength,
                             const SkPath& path, const SkMatrix* matrix,
                                 const SkPaint&) SK_OVERRIDE;
+    virtual void drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                        const SkMeasuredPath& path,
+                                        const SkMatrix* matrix,
+                                        const SkPaint&) SK_OVERRIDE;
     virtual void drawPicture(SkPicture& picture) SK_OVERRIDE;
     virtual void drawVertices(VertexMode, int vertexCount,
                           const SkPoint vertices[], const SkPoint texs[],
@@ -82,6 +88,19 @@ public:
         return fPictureRefs;
     }
 
+    /**
+     *  Draw a segment's contents (see SkPictureSegments). Unlike other
+     *  pictures, they can draw anywhere inside deviceBounds (the clip the
+     *  segment was inserted with), not just within their width and height.
+     */
+    virtual void drawSegment(SkPicture& contents, const SkIRect& deviceBounds);
+
+    /**
+     *  Make the ops that draw oldPicture draw newPicture instead. Returns
+     *  false if oldPicture is not drawn.
+     */
+    bool replacePictureRef(SkPicture* oldPicture, SkPicture* newPicture);
+
     void setFlags(uint32_t recordFlags) {
         fRecordFlags = recordFlags;
     }
@@ -125,6 +144,7 @@ private:
     int  addPaint(const SkPaint& paint) { return this->addPaintPtr(&paint); }
     int  addPaintPtr(const SkPaint* paint);
     void addPath(const SkPath& path);
+    void addMeasuredPath(const SkMeasuredPath& path);
     void addPicture(SkPicture& picture);
     void addPoint(const SkPoint& point);
     void addPoints(const SkPoint pts[], int count);
@@ -195,6 +215,14 @@ private:
     // we ref each item in these arrays
     SkTDArray<SkPicture*> fPictureRefs;
 
+    // Each measured path is recorded (and played back) by reference, and its
+    // path is added to fPathHeap only once. Sorted by fPath.
+    struct MeasuredPathRef {
+        const SkMeasuredPath* fPath;    // we ref this
+        int fIndex;                     // in fPathHeap, 1-based
+    };
+    SkTDArray<MeasuredPathRef> fMeasuredPathRefs;
+
     uint32_t fRecordFlags;
     int fInitialSaveCount;
 
@@ -0,0 +1,183 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPictureSegments.h"
+#include "SkBBoxRecord.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkDevice.h"
+#include "SkPicture.h"
+#include "SkRegion.h"
+
+/**
+ *  Records a segment's contents, starting from the matrix and clip of the
+ *  picture it is in. Those are set on the canvas without being recorded, so
+ *  the contents play back relative to wherever the picture draws them, but
+ *  the bounding boxes computed by SkBBoxRecord are in the picture's space.
+ */
+class SkPictureSegments::SegmentRecord : public SkBBoxRecord {
+public:
+    SegmentRecord(SkDevice* device, const SkMatrix& matrix, const SkIRect& clip)
+        : INHERITED(0, device)
+        , fMatrix(matrix) {
+        fClip.set(clip);
+        fBounds.setEmpty();
+        this->SkCanvas::setMatrix(matrix);
+        this->SkCanvas::clipRegion(SkRegion(clip));
+    }
+
+    virtual void handleBBox(const SkRect& bounds) SK_OVERRIDE {
+        fBounds.join(bounds);
+    }
+
+    // A recorded matrix replaces the one the contents start from at playback.
+    virtual void setMatrix(const SkMatrix& matrix) SK_OVERRIDE {
+        this->INHERITED::setMatrix(matrix);
+        SkMatrix total;
+        total.setConcat(fMatrix, matrix);
+        this->SkCanvas::setMatrix(total);
+    }
+
+    void getBounds(SkRect* bounds) const {
+        // antialiasing can touch the pixels around a draw's geometry
+        *bounds = fBounds;
+        bounds->outset(SK_Scalar1, SK_Scalar1);
+        if (fBounds.isEmpty() || !bounds->intersect(fClip)) {
+            bounds->setEmpty();
+        }
+    }
+
+private:
+    SkMatrix    fMatrix;
+    SkRect      fClip;
+    SkRect      fBounds;
+
+    typedef SkBBoxRecord INHERITED;
+};
+
+class SkPictureSegments::SegmentPicture : public SkPicture {
+public:
+    SkCanvas* beginRecording(int width, int height, const SkMatrix& matrix,
+                             const SkIRect& clip) {
+        SkASSERT(NULL == fRecord && NULL == fPlayback);
+
+        SkBitmap bm;
+        bm.setConfig(SkBitmap::kNo_Config, width, height);
+        SkAutoTUnref<SkDevice> dev(SkNEW_ARGS(SkDevice, (bm)));
+
+        fWidth = width;
+        fHeight = height;
+        fRecord = SkNEW_ARGS(SegmentRecord, (dev, matrix, clip));
+        fRecord->beginRecording();
+        return fRecord;
+    }
+
+    void endRecording(SkRect* bounds) {
+        static_cast<SegmentRecord*>(fRecord)->getBounds(bounds);
+        this->SkPicture::endRecording();
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkPictureSegments::SkPictureSegments()
+    : fRecording(NULL)
+    , fRecordingID(0) {
+    fDirty.setEmpty();
+}
+
+SkPictureSegments::~SkPictureSegments() {
+    SkSafeUnref(fRecording);
+    for (int i = 0; i < fSegments.count(); ++i) {
+        fSegments[i].fContents->unref();
+    }
+}
+
+SkPictureSegments::Segment* SkPictureSegments::find(uint32_t segmentID) {
+    for (int i = 0; i < fSegments.count(); ++i) {
+        if (fSegments[i].fID == segmentID) {
+            return &fSegments[i];
+        }
+    }
+    return NULL;
+}
+
+SkCanvas* SkPictureSegments::beginRecording(uint32_t segmentID,
+                                            SkPictureRecord* parent,
+                                            int width, int height) {
+    if (NULL != fRecording) {
+        SkDEBUGFAIL("already recording a segment");
+        return NULL;
+    }
+
+    Segment* segment = this->find(segmentID);
+    if (NULL == segment) {
+        if (NULL == parent) {
+            return NULL;
+        }
+        segment = fSegments.append();
+        segment->fID = segmentID;
+        segment->fMatrix = parent->getTotalMatrix();
+        if (!parent->getClipDeviceBounds(&segment->fClip)) {
+            segment->fClip.setEmpty();
+        }
+        segment->fBounds.setEmpty();
+        segment->fContents = NULL;
+    }
+
+    fRecording = SkNEW(SegmentPicture);
+    fRecordingID = segmentID;
+    SkCanvas* canvas = fRecording->beginRecording(width, height,
+                                                  segment->fMatrix,
+                                                  segment->fClip);
+    if (NULL == segment->fContents) {
+        // The first contents of a segment are drawn by the picture directly,
+        // while later ones have to be swapped in for them.
+        segment->fContents = SkRef(fRecording);
+        parent->drawSegment(*fRecording, segment->fClip);
+    }
+    return canvas;
+}
+
+bool SkPictureSegments::endRecording(SkPicture** oldContents,
+                                     SkPicture** newContents) {
+    if (NULL == fRecording) {
+        return false;
+    }
+
+    Segment* segment = this->find(fRecordingID);
+    SkASSERT(NULL != segment);
+    SkRect bounds;
+    fRecording->endRecording(&bounds);
+
+    bool replaced = segment->fContents != fRecording;
+    if (replaced) {
+        fDirty.join(segment->fBounds);
+        fDirty.join(bounds);
+        // hand our ref on the old contents to the caller, and take over
+        // fRecording's on the new ones
+        *oldContents = segment->fContents;
+        *newContents = fRecording;
+        segment->fContents = fRecording;
+    } else {
+        fRecording->unref();
+    }
+    segment->fBounds = bounds;
+    fRecording = NULL;
+    return replaced;
+}
+
+bool SkPictureSegments::getDirtyBounds(SkRect* bounds) const {
+    if (fDirty.isEmpty()) {
+        return false;
+    }
+    if (bounds) {
+        *bounds = fDirty;
+    }
+    return true;
+}
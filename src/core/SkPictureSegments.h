@@ -0,0 +1,82 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPictureSegments_DEFINED
+#define SkPictureSegments_DEFINED
+
+#include "SkMatrix.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+
+class SkCanvas;
+class SkPicture;
+class SkPictureRecord;
+
+/**
+ *  The segments of an SkPicture (see SkPicture::beginRecordingSegment()).
+ *
+ *  Each segment's contents are recorded into a subpicture of their own, which
+ *  the picture draws through a DRAW_PICTURE op. Re-recording a segment makes
+ *  a new subpicture, which the picture swaps in for the old one, so none of
+ *  the picture's own ops, dictionaries or bounding boxes change.
+ *
+ *  A segment is recorded with the matrix and clip its picture had at the
+ *  point where it was inserted, so that the bounds of its drawing can be
+ *  tracked in the picture's coordinates and reported as dirty when it changes.
+ */
+class SkPictureSegments {
+public:
+    SkPictureSegments();
+    ~SkPictureSegments();
+
+    /**
+     *  Begin recording the segment with the given ID. If it does not exist
+     *  yet, it is inserted into parent (the picture's recording canvas, or
+     *  NULL if the picture is no longer recording, in which case this fails).
+     *  width and height are those of the picture. Returns the canvas to
+     *  record into, or NULL.
+     */
+    SkCanvas* beginRecording(uint32_t segmentID, SkPictureRecord* parent,
+                             int width, int height);
+
+    bool isRecording() const { return NULL != fRecording; }
+
+    /**
+     *  Finish recording the current segment. If this replaced its earlier
+     *  contents, return those in oldContents and the new ones in
+     *  newContents, for the caller to swap in the picture's list of
+     *  subpictures, and return true. The caller takes over the ref on
+     *  oldContents.
+     */
+    bool endRecording(SkPicture** oldContents, SkPicture** newContents);
+
+    bool getDirtyBounds(SkRect* bounds) const;
+    void clearDirtyBounds() { fDirty.setEmpty(); }
+
+private:
+    class SegmentPicture;
+    class SegmentRecord;
+
+    struct Segment {
+        uint32_t        fID;
+        SkMatrix        fMatrix;    // the picture's matrix where it was inserted
+        SkIRect         fClip;      // and the device bounds of its clip
+        SkRect          fBounds;    // of the contents, in the picture's space
+        SkPicture*      fContents;  // we ref this
+    };
+
+    Segment* find(uint32_t segmentID);
+
+    SkTDArray<Segment>  fSegments;
+    SkRect              fDirty;
+
+    SegmentPicture*     fRecording; // the contents being recorded, or NULL
+    uint32_t            fRecordingID;
+};
+
+#endif
@@ -106,6 +106,15 @@ bool SkRasterClip::setPath(const SkPath& path, const SkRasterClip& clip,
     }
 }
 
+bool SkRasterClip::setAAClip(const SkAAClip& clip) {
+    AUTO_RASTERCLIP_VALIDATE(*this);
+
+    fIsBW = false;
+    fBW.setEmpty();
+    fAA = clip;
+    return this->updateCacheAndReturnNonEmpty();
+}
+
 bool SkRasterClip::op(const SkIRect& rect, SkRegion::Op op) {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
@@ -43,6 +43,12 @@ public:
     bool setPath(const SkPath& path, const SkIRect& clip, bool doAA);
     bool setPath(const SkPath& path, const SkRasterClip&, bool doAA);
 
+    /**
+     *  Set this to clip (sharing its runs), e.g. to reuse the result of an
+     *  earlier setPath() from SkAAClipCache.
+     */
+    bool setAAClip(const SkAAClip& clip);
+
     bool op(const SkIRect&, SkRegion::Op);
     bool op(const SkRegion&, SkRegion::Op);
     bool op(const SkRasterClip&, SkRegion::Op);
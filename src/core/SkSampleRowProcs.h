@@ -0,0 +1,33 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSampleRowProcs_DEFINED
+#define SkSampleRowProcs_DEFINED
+
+#include "SkTypes.h"
+
+/*  Platform-specific versions of the row procs in SkScaledBitmapSampler.cpp
+    that convert rows of opaque decoded pixels, when every source pixel is
+    used (no horizontal sampling).
+
+    Each writes the same pixels as the portable proc, but need not convert
+    the whole row: it returns how many pixels (starting from the first) it
+    converted, and the portable code finishes the rest.
+ */
+
+/** Convert count pixels of src (packed 3 or 4 bytes per pixel, R G B [X])
+    into dst (SkPMColor or 565, with the X byte ignored).
+ */
+typedef int (*SkSampleRowProc)(void* SK_RESTRICT dst,
+                               const uint8_t* SK_RESTRICT src, int count);
+
+// Return NULL if there is no faster version for this platform.
+SkSampleRowProc SkSampleRGBToD8888GetPlatformProc();
+SkSampleRowProc SkSampleRGBXToD8888GetPlatformProc();
+SkSampleRowProc SkSampleRGBToD565GetPlatformProc();
+
+#endif
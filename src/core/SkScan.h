@@ -61,6 +61,13 @@ public:
     static void HairPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiHairPath(const SkPath&, const SkRasterClip&, SkBlitter*);
 
+    /** Choose how AntiFillPath computes coverage: by supersampling (the
+        default), or analytically, from the area each edge covers in each
+        pixel. See SkGraphics::SetFlags("analytic-aa").
+    */
+    static void SetUseAnalyticAA(bool);
+    static bool GetUseAnalyticAA();
+
 private:
     friend class SkAAClip;
     friend class SkRegion;
@@ -33,6 +33,12 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
                   const SkRegion& clipRgn);
 
+// antialias the path by computing each pixel's exact coverage, rather than by
+// supersampling. Only the pixels in bounds (which should already be clipped)
+// are drawn; for an inverse fill, all of them are.
+void sk_analytic_fill_path(const SkPath& path, const SkIRect& bounds,
+                           SkBlitter* blitter);
+
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
 void sk_blit_below(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
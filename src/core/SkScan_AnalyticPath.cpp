@@ -0,0 +1,392 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScanPriv.h"
+#include "SkBlitter.h"
+#include "SkEdgeClipper.h"
+#include "SkGeometry.h"
+#include "SkLineClipper.h"
+#include "SkPath.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+#include "SkTSort.h"
+
+/** @file
+    Analytic-coverage antialiasing.
+
+    Instead of supersampling, each edge adds the exact area it sweeps out of
+    every pixel it crosses to a per-row accumulation buffer; summing that
+    buffer from left to right then gives the exact (signed) coverage of each
+    pixel. Curves are flattened into lines first, and everything is clipped to
+    the bounds being drawn, with the portions left of the bounds turned into
+    vertical lines on the left edge (as SkEdgeBuilder does), so that they
+    still contribute their winding.
+
+    Each row is produced in one pass, no matter how many edges cross it.
+    Coverage is exact for paths that don't overlap themselves; where they do,
+    the summed coverage is clamped (winding) or folded (even-odd).
+ */
+
+static bool gSkUseAnalyticAA;
+
+void SkScan::SetUseAnalyticAA(bool useAnalytic) {
+    gSkUseAnalyticAA = useAnalytic;
+}
+
+bool SkScan::GetUseAnalyticAA() {
+    return gSkUseAnalyticAA;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Max distance, in pixels, between a curve and its flattened lines.
+#define FLATTEN_TOLERANCE       (1.0f / 32)
+#define MAX_FLATTEN_SEGMENTS    256
+
+namespace {
+
+static inline float min_f(float a, float b) { return a < b ? a : b; }
+static inline float max_f(float a, float b) { return a > b ? a : b; }
+static inline float pin_f(float x, float lo, float hi) {
+    return max_f(lo, min_f(x, hi));
+}
+
+struct AnalyticLine {
+    // Relative to the left/top of the bounds, with fY0 < fY1.
+    float   fX0, fY0, fX1, fY1;
+    float   fDXDY;
+    // +1 for edges going down, -1 for edges going up.
+    float   fDir;
+
+    bool operator<(const AnalyticLine& other) const {
+        return fY0 < other.fY0;
+    }
+};
+
+class AnalyticLineBuilder {
+public:
+    AnalyticLineBuilder(const SkIRect& bounds) {
+        fLeft = SkIntToScalar(bounds.fLeft);
+        fTop = SkIntToScalar(bounds.fTop);
+        fClip.set(bounds);
+    }
+
+    void build(const SkPath& path) {
+        SkPath::Iter    iter(path, true);
+        SkPoint         pts[4];
+        SkPath::Verb    verb;
+        SkEdgeClipper   clipper;
+
+        while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kLine_Verb: {
+                    SkPoint lines[SkLineClipper::kMaxPoints];
+                    int lineCount = SkLineClipper::ClipLine(pts, fClip, lines);
+                    for (int i = 0; i < lineCount; i++) {
+                        this->addLine(lines[i], lines[i + 1]);
+                    }
+                    break;
+                }
+                case SkPath::kQuad_Verb:
+                    if (clipper.clipQuad(pts, fClip)) {
+                        this->addClipper(&clipper);
+                    }
+                    break;
+                case SkPath::kCubic_Verb:
+                    if (clipper.clipCubic(pts, fClip)) {
+                        this->addClipper(&clipper);
+                    }
+                    break;
+                default:
+                    // we ignore move and close, and just get the whole
+                    // segment from the line/quad/cubic verbs
+                    break;
+            }
+        }
+    }
+
+    SkTDArray<AnalyticLine>& lines() { return fLines; }
+
+private:
+    SkRect                  fClip;
+    SkScalar                fLeft, fTop;
+    SkTDArray<AnalyticLine> fLines;
+
+    void addLine(const SkPoint& p0, const SkPoint& p1) {
+        float x0 = SkScalarToFloat(p0.fX - fLeft);
+        float y0 = SkScalarToFloat(p0.fY - fTop);
+        float x1 = SkScalarToFloat(p1.fX - fLeft);
+        float y1 = SkScalarToFloat(p1.fY - fTop);
+        if (y0 == y1) {
+            return; // horizontal lines don't change the coverage
+        }
+
+        AnalyticLine* line = fLines.append();
+        if (y0 < y1) {
+            line->fDir = 1;
+        } else {
+            SkTSwap(x0, x1);
+            SkTSwap(y0, y1);
+            line->fDir = -1;
+        }
+        line->fX0 = x0;
+        line->fY0 = y0;
+        line->fX1 = x1;
+        line->fY1 = y1;
+        line->fDXDY = (x1 - x0) / (y1 - y0);
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        SkScalar dx = pts[0].fX - 2 * pts[1].fX + pts[2].fX;
+        SkScalar dy = pts[0].fY - 2 * pts[1].fY + pts[2].fY;
+        // the chord error of n equal steps is at most |p0 - 2p1 + p2| / 4n^2
+        float dist = SkScalarToFloat(SkScalarAbs(dx) + SkScalarAbs(dy));
+        int n = count_segments(dist / (4 * FLATTEN_TOLERANCE));
+
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint pt;
+            SkEvalQuadAt(pts, SkScalarDiv(SkIntToScalar(i), SkIntToScalar(n)),
+                         &pt);
+            this->addLine(prev, pt);
+            prev = pt;
+        }
+        this->addLine(prev, pts[2]);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        SkScalar dx0 = pts[0].fX - 2 * pts[1].fX + pts[2].fX;
+        SkScalar dy0 = pts[0].fY - 2 * pts[1].fY + pts[2].fY;
+        SkScalar dx1 = pts[1].fX - 2 * pts[2].fX + pts[3].fX;
+        SkScalar dy1 = pts[1].fY - 2 * pts[2].fY + pts[3].fY;
+        // the chord error of n equal steps is at most 3/4 max|d| / n^2
+        float dist = SkScalarToFloat(SkMaxScalar(
+                                SkScalarAbs(dx0) + SkScalarAbs(dy0),
+                                SkScalarAbs(dx1) + SkScalarAbs(dy1)));
+        int n = count_segments(dist * 3 / (4 * FLATTEN_TOLERANCE));
+
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint pt;
+            SkEvalCubicAt(pts, SkScalarDiv(SkIntToScalar(i), SkIntToScalar(n)),
+                          &pt, NULL, NULL);
+            this->addLine(prev, pt);
+            prev = pt;
+        }
+        this->addLine(prev, pts[3]);
+    }
+
+    void addClipper(SkEdgeClipper* clipper) {
+        SkPoint      pts[4];
+        SkPath::Verb verb;
+
+        while ((verb = clipper->next(pts)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kLine_Verb:
+                    this->addLine(pts[0], pts[1]);
+                    break;
+                case SkPath::kQuad_Verb:
+                    this->addQuad(pts);
+                    break;
+                case SkPath::kCubic_Verb:
+                    this->addCubic(pts);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // returns ceil(sqrt(nSquared)), pinned to [1, MAX_FLATTEN_SEGMENTS]
+    static int count_segments(float nSquared) {
+        if (!(nSquared > 1)) {  // also catches NaN
+            return 1;
+        }
+        if (nSquared >= MAX_FLATTEN_SEGMENTS * MAX_FLATTEN_SEGMENTS) {
+            return MAX_FLATTEN_SEGMENTS;
+        }
+        return (int)ceilf(sqrtf(nSquared));
+    }
+};
+
+/*  Adds the area that the part of an edge inside one row, running from x to
+    xNext and spanning d (signed) of the row's height, covers in each pixel.
+    Pixel i ends up with its coverage in the sum of accum[0..i].
+ */
+static void accumulate_edge(float accum[], float x, float xNext, float d) {
+    float x0 = min_f(x, xNext);
+    float x1 = max_f(x, xNext);
+    float x0Floor = floorf(x0);
+    int   x0i = (int)x0Floor;
+    float x1Ceil = ceilf(x1);
+    int   x1i = (int)x1Ceil;
+
+    if (x1i <= x0i + 1) {
+        // the edge stays within one pixel
+        float xmf = 0.5f * (x + xNext) - x0Floor;
+        accum[x0i] += d - d * xmf;
+        accum[x0i + 1] += d * xmf;
+        return;
+    }
+
+    float s = 1 / (x1 - x0);
+    float x0f = x0 - x0Floor;
+    float a0 = 0.5f * s * (1 - x0f) * (1 - x0f);
+    float x1f = x1 - x1Ceil + 1;
+    float am = 0.5f * s * x1f * x1f;
+
+    accum[x0i] += d * a0;
+    if (x1i == x0i + 2) {
+        accum[x0i + 1] += d * (1 - a0 - am);
+    } else {
+        float a1 = s * (1.5f - x0f);
+        accum[x0i + 1] += d * (a1 - a0);
+        float ds = d * s;
+        for (int xi = x0i + 2; xi < x1i - 1; ++xi) {
+            accum[xi] += ds;
+        }
+        float a2 = a1 + (x1i - x0i - 3) * s;
+        accum[x1i - 1] += d * (1 - a2 - am);
+    }
+    accum[x1i] += d * am;
+}
+
+static inline SkAlpha coverage_to_alpha(float coverage, bool evenOdd,
+                                        bool inverse) {
+    coverage = fabsf(coverage);
+    if (evenOdd) {
+        coverage -= 2 * floorf(coverage * 0.5f);
+        if (coverage > 1) {
+            coverage = 2 - coverage;
+        }
+    } else if (coverage > 1) {
+        coverage = 1;
+    }
+    int alpha = (int)(coverage * 255 + 0.5f);
+    return SkToU8(inverse ? 255 - alpha : alpha);
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void sk_analytic_fill_path(const SkPath& path, const SkIRect& bounds,
+                           SkBlitter* blitter) {
+    if (bounds.isEmpty()) {
+        return;
+    }
+
+    AnalyticLineBuilder builder(bounds);
+    builder.build(path);
+
+    SkTDArray<AnalyticLine>& lines = builder.lines();
+    const int lineCount = lines.count();
+    if (lineCount > 1) {
+        SkTQSort(lines.begin(), lines.end() - 1);
+    }
+
+    const bool inverse = path.isInverseFillType();
+    const bool evenOdd = SkPath::kEvenOdd_FillType ==
+                         (path.getFillType() & ~SkPath::kInverseWinding_FillType);
+    const int width = bounds.width();
+    const int height = bounds.height();
+
+    // accum needs two extra cells, for edges on the right bound
+    SkAutoTMalloc<float>    accumStorage(width + 2);
+    SkAutoTMalloc<SkAlpha>  alphaStorage(width + 1);
+    SkAutoTMalloc<int16_t>  runStorage(width + 1);
+    float*      accum = accumStorage.get();
+    SkAlpha*    alpha = alphaStorage.get();
+    int16_t*    runs = runStorage.get();
+    sk_bzero(accum, (width + 2) * sizeof(float));
+
+    SkTDArray<const AnalyticLine*> active;
+    int nextLine = 0;
+
+    for (int y = 0; y < height; ++y) {
+        const float rowTop = (float)y;
+        const float rowBottom = (float)(y + 1);
+
+        // retire the edges that ended above this row, then add the new ones
+        for (int i = active.count() - 1; i >= 0; --i) {
+            if (active[i]->fY1 <= rowTop) {
+                active.removeShuffle(i);
+            }
+        }
+        while (nextLine < lineCount && lines[nextLine].fY0 < rowBottom) {
+            *active.append() = &lines[nextLine++];
+        }
+
+        if (active.isEmpty()) {
+            if (inverse) {
+                blitter->blitH(bounds.fLeft, bounds.fTop + y, width);
+            } else if (nextLine == lineCount) {
+                break;
+            } else {
+                // skip straight to the row of the next edge
+                y = SkMax32(y, (int)floorf(lines[nextLine].fY0) - 1);
+            }
+            continue;
+        }
+
+        int minX = width + 1;
+        int maxX = 0;
+        for (int i = 0; i < active.count(); ++i) {
+            const AnalyticLine& line = *active[i];
+            float y0 = max_f(line.fY0, rowTop);
+            float y1 = min_f(line.fY1, rowBottom);
+            if (y1 <= y0) {
+                continue;
+            }
+            float x0 = line.fX0 + (y0 - line.fY0) * line.fDXDY;
+            float x1 = line.fX0 + (y1 - line.fY0) * line.fDXDY;
+            // the clipper keeps us within the bounds, up to float error
+            x0 = pin_f(x0, 0, (float)width);
+            x1 = pin_f(x1, 0, (float)width);
+
+            accumulate_edge(accum, x0, x1, (y1 - y0) * line.fDir);
+            minX = SkMin32(minX, (int)min_f(x0, x1));
+            maxX = SkMax32(maxX, (int)max_f(x0, x1) + 1);
+        }
+        if (minX > maxX) {
+            // all of the active edges were horizontal within this row
+            if (inverse) {
+                blitter->blitH(bounds.fLeft, bounds.fTop + y, width);
+            }
+            continue;
+        }
+
+        // Past the touched cells the running sum is back to zero (all of
+        // our contours are closed), so only those cells need to be summed.
+        int start = inverse ? 0 : SkMin32(minX, width);
+        int stop = inverse ? width : SkMin32(maxX + 1, width);
+        float sum = 0;
+        int runStart = start;
+        for (int x = start; x < stop; ++x) {
+            if (x >= minX) {
+                sum += accum[x];
+            }
+            alpha[x] = coverage_to_alpha(sum, evenOdd, inverse);
+            if (alpha[x] != alpha[runStart]) {
+                runs[runStart] = SkToS16(x - runStart);
+                runStart = x;
+            }
+        }
+        if (stop > start) {
+            runs[runStart] = SkToS16(stop - runStart);
+            runs[stop] = 0;
+            blitter->blitAntiH(bounds.fLeft + start, bounds.fTop + y,
+                               alpha + start, runs + start);
+        }
+
+        // clear what we touched, ready for the next row
+        int clearStop = SkMin32(maxX + 2, width + 2);
+        if (minX < clearStop) {
+            sk_bzero(&accum[minX], (clearStop - minX) * sizeof(float));
+        }
+    }
+}
@@ -679,6 +679,22 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         sk_blit_above(blitter, ir, *clipRgn);
     }
 
+    if (SkScan::GetUseAnalyticAA()) {
+        // an inverse fill covers the whole width of the clip in ir's rows
+        SkIRect bounds = ir;
+        if (path.isInverseFillType()) {
+            bounds.fLeft = clipRgn->getBounds().fLeft;
+            bounds.fRight = clipRgn->getBounds().fRight;
+        }
+        if (bounds.intersect(clipRgn->getBounds())) {
+            sk_analytic_fill_path(path, bounds, blitter);
+        }
+        if (path.isInverseFillType()) {
+            sk_blit_below(blitter, ir, *clipRgn);
+        }
+        return;
+    }
+
     SkIRect superRect, *superClipRect = NULL;
 
     if (clipRect) {
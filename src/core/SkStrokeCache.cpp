@@ -0,0 +1,122 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStrokeCache.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPathEffect.h"
+#include "SkTLRUCache.h"
+
+namespace {
+
+struct Key {
+    uint32_t        fGenID;
+    uint8_t         fFillType;
+    uint8_t         fStyle;
+    uint8_t         fCap;
+    uint8_t         fJoin;
+    SkScalar        fWidth;
+    SkScalar        fMiter;
+    SkPathEffect*   fPathEffect;
+};
+
+struct Outline {
+    SkPath                      fPath;
+    bool                        fDoFill;
+    // The entry owns a ref on the key's path effect, so that the address
+    // can't be reused by a different path effect while it is in the cache.
+    SkRefPtr<SkPathEffect>      fPathEffect;
+};
+
+typedef SkTLRUCache<Key, Outline> Cache;
+
+}
+
+static Cache& get_cache() {
+    static Cache gCache;
+    return gCache;
+}
+
+bool SkStrokeCache::GetFillPath(const SkPaint& paint, const SkPath& src,
+                                SkPath* dst) {
+    Cache& cache = get_cache();
+    if (0 == cache.getByteLimit() ||
+            (NULL == paint.getPathEffect() &&
+             (SkPaint::kFill_Style == paint.getStyle() ||
+              0 == paint.getStrokeWidth()))) {
+        // Filling and hairlining just copy src, which is already cheap.
+        return paint.getFillPath(src, dst);
+    }
+
+    Key key;
+    sk_bzero(&key, sizeof(key));
+    key.fGenID = src.getPathRefGenID();
+    key.fFillType = SkToU8(src.getFillType());
+    key.fStyle = SkToU8(paint.getStyle());
+    key.fCap = SkToU8(paint.getStrokeCap());
+    key.fJoin = SkToU8(paint.getStrokeJoin());
+    key.fWidth = paint.getStrokeWidth();
+    key.fMiter = paint.getStrokeMiter();
+    key.fPathEffect = paint.getPathEffect();
+
+    Outline outline;
+    if (cache.find(key, &outline)) {
+        *dst = outline.fPath;
+        return outline.fDoFill;
+    }
+
+    outline.fDoFill = paint.getFillPath(src, dst);
+    outline.fPath = *dst;
+    outline.fPathEffect = key.fPathEffect;
+    cache.add(key, outline, dst->countPoints() * sizeof(SkPoint) +
+                            dst->countVerbs() * sizeof(uint8_t));
+    return outline.fDoFill;
+}
+
+size_t SkStrokeCache::GetByteLimit() {
+    return get_cache().getByteLimit();
+}
+
+size_t SkStrokeCache::SetByteLimit(size_t bytes) {
+    return get_cache().setByteLimit(bytes);
+}
+
+size_t SkStrokeCache::GetBytesUsed() {
+    return get_cache().getBytesUsed();
+}
+
+void SkStrokeCache::GetStats(int32_t* hits, int32_t* misses) {
+    get_cache().getStats(hits, misses);
+}
+
+void SkStrokeCache::PurgeAll() {
+    get_cache().purgeAll();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t SkGraphics::GetStrokeCacheLimit() {
+    return SkStrokeCache::GetByteLimit();
+}
+
+size_t SkGraphics::SetStrokeCacheLimit(size_t bytes) {
+    return SkStrokeCache::SetByteLimit(bytes);
+}
+
+size_t SkGraphics::GetStrokeCacheUsed() {
+    return SkStrokeCache::GetBytesUsed();
+}
+
+void SkGraphics::GetStrokeCacheStats(int32_t* hits, int32_t* misses) {
+    SkStrokeCache::GetStats(hits, misses);
+}
+
+void SkGraphics::PurgeStrokeCache() {
+    SkStrokeCache::PurgeAll();
+}
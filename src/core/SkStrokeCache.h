@@ -0,0 +1,66 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "SkTypes.h"
+
+class SkPaint;
+class SkPath;
+
+/**
+ *  A global, thread-safe cache of the outlines SkPaint::getFillPath() computes
+ *  when it strokes a path or applies a path effect to it, for clients that
+ *  draw the same paths with the same paints over and over (e.g. map tiles).
+ *
+ *  Outlines are keyed by the generation ID of the source path's points and
+ *  verbs (so copies of an SkPath share entries, and editing a path retires
+ *  them), its fill type, and the paint's style, stroke width, miter limit,
+ *  cap, join and path effect. The cached outline does not depend on the
+ *  matrix it is drawn with, so one entry serves every scale.
+ *
+ *  The cache is off until it is given a byte limit (see SetByteLimit(), or
+ *  SkGraphics::SetStrokeCacheLimit()). Beyond that limit the least recently
+ *  used outlines are evicted.
+ */
+class SkStrokeCache {
+public:
+    /**
+     *  Same as paint.getFillPath(src, dst), but if the cache is on, reuse the
+     *  outline from an earlier call with the same path and paint settings, or
+     *  cache this one for later calls.
+     */
+    static bool GetFillPath(const SkPaint& paint, const SkPath& src,
+                            SkPath* dst);
+
+    static size_t GetByteLimit();
+
+    /**
+     *  Set the max number of bytes of outlines to keep, purging entries as
+     *  needed. 0 turns the cache off (and empties it). Returns the previous
+     *  limit.
+     */
+    static size_t SetByteLimit(size_t bytes);
+
+    static size_t GetBytesUsed();
+
+    /**
+     *  Return the number of GetFillPath() calls that found (hits) or did not
+     *  find (misses) their outline in the cache, while it was on.
+     */
+    static void GetStats(int32_t* hits, int32_t* misses);
+
+    /**
+     *  Remove all of the outlines from the cache, and zero its statistics.
+     *  Does not change the limit.
+     */
+    static void PurgeAll();
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTLRUCache_DEFINED
+#define SkTLRUCache_DEFINED
+
+#include "SkTDArray.h"
+#include "SkTInternalLList.h"
+#include "SkThread.h"
+
+/**
+ *  A thread-safe cache of values of type V, keyed by K, that evicts the least
+ *  recently used values once they take up more than its byte limit. A limit
+ *  of 0 (the default) turns the cache off.
+ *
+ *  Keys are compared with memcmp, so they must be plain structs that the
+ *  caller zeroes (padding included) before filling in. Values are copied in
+ *  and out of the cache, with the lock held for the copy out.
+ *
+ *  The entries are kept sorted by key, for lookup, and in a list from most to
+ *  least recently used, for eviction. Everything but the limit is guarded by
+ *  the cache's mutex.
+ */
+template <typename K, typename V> class SkTLRUCache : SkNoncopyable {
+public:
+    SkTLRUCache() : fByteLimit(0), fBytesUsed(0), fHits(0), fMisses(0) {}
+
+    ~SkTLRUCache() {
+        this->purgeTo(0);
+    }
+
+    /**
+     *  Read without the lock, so that callers can skip building a key when the
+     *  cache is off.
+     */
+    size_t getByteLimit() const { return fByteLimit; }
+
+    /**
+     *  Set the max number of bytes of values to keep, purging entries as
+     *  needed. 0 turns the cache off (and empties it). Returns the previous
+     *  limit.
+     */
+    size_t setByteLimit(size_t bytes) {
+        SkAutoMutexAcquire ama(fMutex);
+        size_t prevLimit = fByteLimit;
+        fByteLimit = bytes;
+        this->purgeTo(bytes);
+        return prevLimit;
+    }
+
+    size_t getBytesUsed() {
+        SkAutoMutexAcquire ama(fMutex);
+        return fBytesUsed;
+    }
+
+    /**
+     *  Return the number of find() calls that found (hits) or did not find
+     *  (misses) their key. Either parameter may be null.
+     */
+    void getStats(int32_t* hits, int32_t* misses) {
+        SkAutoMutexAcquire ama(fMutex);
+        if (hits) {
+            *hits = fHits;
+        }
+        if (misses) {
+            *misses = fMisses;
+        }
+    }
+
+    /**
+     *  Remove all of the entries, and zero the statistics. Does not change the
+     *  limit.
+     */
+    void purgeAll() {
+        SkAutoMutexAcquire ama(fMutex);
+        this->purgeTo(0);
+        fHits = 0;
+        fMisses = 0;
+    }
+
+    /**
+     *  If key is in the cache, copy its value into value, mark it as the most
+     *  recently used, and return true. Otherwise return false.
+     */
+    bool find(const K& key, V* value) {
+        SkAutoMutexAcquire ama(fMutex);
+        int index = this->search(key);
+        if (index < 0) {
+            fMisses += 1;
+            return false;
+        }
+        Entry* entry = fEntries[index];
+        fLRU.remove(entry);
+        fLRU.addToHead(entry);
+        fHits += 1;
+        *value = entry->fValue;
+        return true;
+    }
+
+    /**
+     *  Add a copy of value for key, which takes up bytes of memory beyond the
+     *  value itself, evicting other entries as needed to stay within the
+     *  limit. Does nothing if key is already in the cache (another thread may
+     *  have added it first), or if the value is too big to cache.
+     */
+    void add(const K& key, const V& value, size_t bytes) {
+        // Build the entry outside of the lock, since this copies the value.
+        Entry* entry = SkNEW_ARGS(Entry, (key, value, sizeof(Entry) + bytes));
+        {
+            SkAutoMutexAcquire ama(fMutex);
+            int index = this->search(key);
+            if (index < 0 && entry->fBytes <= fByteLimit) {
+                this->purgeTo(fByteLimit - entry->fBytes);
+                *fEntries.insert(~index) = entry;
+                fLRU.addToHead(entry);
+                fBytesUsed += entry->fBytes;
+                entry = NULL;
+            }
+        }
+        SkDELETE(entry);
+    }
+
+private:
+    struct Entry {
+        Entry(const K& key, const V& value, size_t bytes)
+            : fKey(key)
+            , fValue(value)
+            , fBytes(bytes) {}
+
+        K       fKey;
+        V       fValue;
+        size_t  fBytes;
+
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+    };
+
+    // Returns the index of key's entry, or ~(the index to insert it at).
+    int search(const K& key) const {
+        int lo = 0;
+        int hi = fEntries.count();
+        while (lo < hi) {
+            int mid = (lo + hi) >> 1;
+            int cmp = memcmp(&fEntries[mid]->fKey, &key, sizeof(K));
+            if (0 == cmp) {
+                return mid;
+            }
+            if (cmp < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return ~lo;
+    }
+
+    void purgeTo(size_t bytes) {
+        while (fBytesUsed > bytes) {
+            Entry* entry = fLRU.tail();
+            SkASSERT(entry);
+            int index = this->search(entry->fKey);
+            SkASSERT(index >= 0);
+            fEntries.remove(index);
+            fLRU.remove(entry);
+            fBytesUsed -= entry->fBytes;
+            SkDELETE(entry);
+        }
+    }
+
+    SkMutex                     fMutex;
+    size_t                      fByteLimit;
+    SkTDArray<Entry*>           fEntries;
+    SkTInternalLList<Entry>     fLRU;
+    size_t                      fBytesUsed;
+    int32_t                     fHits;
+    int32_t                     fMisses;
+};
+
+#endif
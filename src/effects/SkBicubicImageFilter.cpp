@@ -74,10 +74,10 @@ inline SkPMColor cubicBlend(const SkScalar c[16], SkScalar t, SkPMColor c0, SkPM
 
 bool SkBicubicImageFilter::onFilterImage(Proxy* proxy,
                                          const SkBitmap& source,
-                                         const SkMatrix& matrix,
+                                         const Context& ctx,
                                          SkBitmap* result,
                                          SkIPoint* loc) {
-    SkBitmap src = this->getInputResult(proxy, source, matrix, loc);
+    SkBitmap src = this->getInputResult(proxy, source, ctx, loc);
     if (src.config() != SkBitmap::kARGB_8888_Config) {
         return false;
     }
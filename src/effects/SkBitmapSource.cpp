@@ -22,7 +22,7 @@ void SkBitmapSource::flatten(SkFlattenableWriteBuffer& buffer) const {
     fBitmap.flatten(buffer);
 }
 
-bool SkBitmapSource::onFilterImage(Proxy*, const SkBitmap&, const SkMatrix&,
+bool SkBitmapSource::onFilterImage(Proxy*, const SkBitmap&, const Context&,
                                    SkBitmap* result, SkIPoint* offset) {
     *result = fBitmap;
     return true;
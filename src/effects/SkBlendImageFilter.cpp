@@ -75,18 +75,28 @@ void SkBlendImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
 
 bool SkBlendImageFilter::onFilterImage(Proxy* proxy,
                                        const SkBitmap& src,
-                                       const SkMatrix& ctm,
+                                       const Context& ctx,
                                        SkBitmap* dst,
                                        SkIPoint* offset) {
-    SkBitmap background, foreground = src;
+    SkBitmap background, foreground;
     SkImageFilter* backgroundInput = getBackgroundInput();
     SkImageFilter* foregroundInput = getForegroundInput();
     SkASSERT(NULL != backgroundInput);
-    if (!backgroundInput->filterImage(proxy, src, ctm, &background, offset)) {
+    // The inputs may each have been cropped differently, so keep track of
+    // where each of them goes.
+    SkIPoint backgroundOffset = *offset;
+    SkIPoint foregroundOffset = *offset;
+    if (!backgroundInput->filterImage(proxy, src, ctx, &background,
+                                      &backgroundOffset)) {
         return false;
     }
-    if (foregroundInput && !foregroundInput->filterImage(proxy, src, ctm, &foreground, offset)) {
-        return false;
+    if (foregroundInput) {
+        if (!foregroundInput->filterImage(proxy, src, ctx, &foreground,
+                                          &foregroundOffset)) {
+            return false;
+        }
+    } else {
+        foreground = this->getInputResult(1, proxy, src, ctx, &foregroundOffset);
     }
     SkAutoLockPixels alp_foreground(foreground), alp_background(background);
     if (!foreground.getPixels() || !background.getPixels()) {
@@ -106,7 +116,17 @@ bool SkBlendImageFilter::onFilterImage(Proxy* proxy,
     } else {
         paint.setXfermodeMode(modeToXfermode(fMode));
     }
-    canvas.drawBitmap(foreground, 0, 0, &paint);
+    canvas.drawBitmap(foreground,
+                      SkIntToScalar(foregroundOffset.x() - backgroundOffset.x()),
+                      SkIntToScalar(foregroundOffset.y() - backgroundOffset.y()),
+                      &paint);
+    *offset = backgroundOffset;
+    return true;
+}
+
+bool SkBlendImageFilter::onSourceBounds(const SkIRect& dst, const SkMatrix&,
+                                        SkIRect* src) {
+    *src = dst;
     return true;
 }
 
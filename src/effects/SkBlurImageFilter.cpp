@@ -134,9 +134,9 @@ static void getBox3Params(SkScalar s, int *kernelSize, int* kernelSize3, int *lo
 }
 
 bool SkBlurImageFilter::onFilterImage(Proxy* proxy,
-                                      const SkBitmap& source, const SkMatrix& ctm,
+                                      const SkBitmap& source, const Context& ctx,
                                       SkBitmap* dst, SkIPoint* offset) {
-    SkBitmap src = this->getInputResult(proxy, source, ctm, offset);
+    SkBitmap src = this->getInputResult(proxy, source, ctx, offset);
     if (src.config() != SkBitmap::kARGB_8888_Config) {
         return false;
     }
@@ -187,6 +187,18 @@ bool SkBlurImageFilter::onFilterImage(Proxy* proxy,
     return true;
 }
 
+bool SkBlurImageFilter::onSourceBounds(const SkIRect& dst, const SkMatrix&,
+                                       SkIRect* src) {
+    int kernelSizeX, kernelSizeX3, lowOffsetX, highOffsetX;
+    int kernelSizeY, kernelSizeY3, lowOffsetY, highOffsetY;
+    getBox3Params(fSigma.width(), &kernelSizeX, &kernelSizeX3, &lowOffsetX, &highOffsetX);
+    getBox3Params(fSigma.height(), &kernelSizeY, &kernelSizeY3, &lowOffsetY, &highOffsetY);
+    // Each of the three box passes reaches at most highOffset to either side.
+    *src = dst;
+    src->outset(3 * highOffsetX, 3 * highOffsetY);
+    return true;
+}
+
 GrTexture* SkBlurImageFilter::filterImageGPU(Proxy* proxy, GrTexture* src, const SkRect& rect) {
 #if SK_SUPPORT_GPU
     SkAutoTUnref<GrTexture> input(this->getInputResultAsTexture(proxy, src, rect));
@@ -8,6 +8,7 @@
 
 
 #include "SkBlurMask.h"
+#include "SkBoxBlurProcs.h"
 #include "SkMath.h"
 #include "SkTemplates.h"
 #include "SkEndian.h"
@@ -22,6 +23,16 @@
 
 #define UNROLL_SEPARABLE_LOOPS
 
+static SkBoxBlurProc box_blur_platform_proc() {
+    static SkBoxBlurProc gProc = SkBoxBlurGetPlatformProc();
+    return gProc;
+}
+
+static SkBoxBlurInterpProc box_blur_interp_platform_proc() {
+    static SkBoxBlurInterpProc gProc = SkBoxBlurInterpGetPlatformProc();
+    return gProc;
+}
+
 /**
  * This function performs a box blur in X, of the given radius.  If the
  * "transpose" parameter is true, it will transpose the pixels on write,
@@ -40,7 +51,13 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
     int new_width = width + SkMax32(leftRadius, rightRadius) * 2;
     int dst_x_stride = transpose ? height : 1;
     int dst_y_stride = transpose ? 1 : new_width;
-    for (int y = 0; y < height; ++y) {
+    int firstRow = 0;
+    SkBoxBlurProc proc = box_blur_platform_proc();
+    if (proc) {
+        firstRow = proc(src, src_y_stride, dst, leftRadius, rightRadius,
+                        width, height, transpose);
+    }
+    for (int y = firstRow; y < height; ++y) {
         int sum = 0;
         uint8_t* dptr = dst + y * dst_y_stride;
         const uint8_t* right = src + y * src_y_stride;
@@ -189,6 +206,13 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
                          int radius, int width, int height,
                          bool transpose, uint8_t outer_weight)
 {
+    int firstRow = 0;
+    SkBoxBlurInterpProc proc = box_blur_interp_platform_proc();
+    if (proc) {
+        firstRow = proc(src, src_y_stride, dst, radius, width, height,
+                        transpose, outer_weight);
+    }
+
     int diameter = radius * 2;
     int kernelSize = diameter + 1;
     int border = SkMin32(width, diameter);
@@ -200,7 +224,7 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
     int new_width = width + diameter;
     int dst_x_stride = transpose ? height : 1;
     int dst_y_stride = transpose ? 1 : new_width;
-    for (int y = 0; y < height; ++y) {
+    for (int y = firstRow; y < height; ++y) {
         int outer_sum = 0, inner_sum = 0;
         uint8_t* dptr = dst + y * dst_y_stride;
         const uint8_t* right = src + y * src_y_stride;
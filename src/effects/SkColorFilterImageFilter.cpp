@@ -94,10 +94,10 @@ SkColorFilterImageFilter::~SkColorFilterImageFilter() {
 }
 
 bool SkColorFilterImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& source,
-                                             const SkMatrix& matrix,
+                                             const Context& ctx,
                                              SkBitmap* result,
                                              SkIPoint* loc) {
-    SkBitmap src = this->getInputResult(proxy, source, matrix, loc);
+    SkBitmap src = this->getInputResult(proxy, source, ctx, loc);
     SkAutoTUnref<SkDevice> device(proxy->createDevice(src.width(), src.height()));
     SkCanvas canvas(device.get());
     SkPaint paint;
@@ -110,6 +110,12 @@ bool SkColorFilterImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& sourc
     return true;
 }
 
+bool SkColorFilterImageFilter::onSourceBounds(const SkIRect& dst,
+                                              const SkMatrix&, SkIRect* src) {
+    *src = dst;
+    return true;
+}
+
 SkColorFilter* SkColorFilterImageFilter::asColorFilter() const {
     return fColorFilter;
 }
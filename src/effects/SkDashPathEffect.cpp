@@ -88,93 +88,341 @@ SkDashPathEffect::~SkDashPathEffect() {
     sk_free(fIntervals);
 }
 
-class SpecialLineRec {
+/*  Dashing a contour of lines needs neither SkPathMeasure nor, when stroking,
+    the stroker: each piece of a dash along one line is a quad, and the caps
+    and joins are small polygons (circles, when round) around the ends and
+    the vertices. Everything is added to the path with the same orientation,
+    so that filling it with the winding rule covers the union, which is what
+    the stroker would have produced. Hairlines are just the lines.
+
+    This has the same interface as SkPathMeasure, so that the dashing loop can
+    use either.
+ */
+class PolylineMeasure : SkNoncopyable {
 public:
-    bool init(const SkPath& src, SkPath* dst, SkStrokeRec* rec,
-              SkScalar pathLength,
-              int intervalCount, SkScalar intervalLength) {
-        if (rec->isHairlineStyle() || !src.isLine(fPts)) {
+    /** Return true if src only has lines, and rec is a style we can dash
+        without the stroker. If so, rec is changed to the style of the
+        path that we will produce.
+     */
+    static bool CanDash(const SkPath& src, SkStrokeRec* rec) {
+        if (SkPath::kLine_SegmentMask != src.getSegmentMasks()) {
             return false;
         }
+        if (SkStrokeRec::kStroke_Style == rec->getStyle()) {
+            rec->setFillStyle();    // we will take care of the stroking
+            return true;
+        }
+        return rec->isHairlineStyle();
+    }
 
-        // can relax this in the future, if we handle square and round caps
-        if (SkPaint::kButt_Cap != rec->getCap()) {
-            return false;
+    // rec is the style before CanDash changed it
+    PolylineMeasure(const SkPath& src, const SkStrokeRec& rec)
+        : fIter(src, false) {
+        fStroke = !rec.isHairlineStyle();
+        fRadius = SkScalarHalf(rec.getWidth());
+        fCap = rec.getCap();
+        fJoin = rec.getJoin();
+        if (SkPaint::kMiter_Join == fJoin && rec.getMiter() <= SK_Scalar1) {
+            fJoin = SkPaint::kBevel_Join;
         }
+        fMiterLimit = rec.getMiter();
+        fHasNextMove = false;
+        fHasPendingCap = false;
+        fDst = NULL;
+        this->buildContour();
+    }
 
-        fTangent = fPts[1] - fPts[0];
-        if (fTangent.isZero()) {
+    SkScalar getLength() const { return fLength; }
+    bool isClosed() const { return fIsClosed; }
+
+    bool getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
+                    bool startWithMoveTo) {
+        if (startD < 0) {
+            startD = 0;
+        }
+        if (stopD > fLength) {
+            stopD = fLength;
+        }
+        if (startD >= stopD) {
             return false;
         }
 
-        fPathLength = pathLength;
-        fTangent.scale(SkScalarInvert(pathLength));
-        fTangent.rotateCCW(&fNormal);
-        fNormal.scale(SkScalarHalf(rec->getWidth()));
+        int startSeg = this->findSegment(startD, false);
+        int stopSeg = this->findSegment(stopD, true);
+        SkPoint start = this->pointAt(startSeg, startD);
+        SkPoint stop = this->pointAt(stopSeg, stopD);
+
+        if (!fStroke) {
+            if (startWithMoveTo) {
+                dst->moveTo(start);
+            }
+            for (int i = startSeg; i < stopSeg; ++i) {
+                dst->lineTo(fPts[i + 1]);
+            }
+            dst->lineTo(stop);
+            return true;
+        }
 
-        // now estimate how many quads will be added to the path
-        //     resulting segments = pathLen * intervalCount / intervalLen
-        //     resulting points = 4 * segments
+        if (startWithMoveTo) {
+            this->flushCap();
+            this->addCap(dst, start, -fTangents[startSeg]);
+        } else if (fHasPendingCap) {
+            // we are continuing the previous dash
+            this->addJoin(dst, start, fCapTangent, fTangents[startSeg]);
+            fHasPendingCap = false;
+        }
 
-        SkScalar ptCount = SkScalarMulDiv(pathLength,
-                                          SkIntToScalar(intervalCount),
-                                          intervalLength);
-        int n = SkScalarCeilToInt(ptCount) << 2;
-        dst->incReserve(n);
+        SkPoint pt = start;
+        for (int i = startSeg; i < stopSeg; ++i) {
+            this->addQuad(dst, pt, fPts[i + 1], fTangents[i]);
+            this->addJoin(dst, fPts[i + 1], fTangents[i], fTangents[i + 1]);
+            pt = fPts[i + 1];
+        }
+        this->addQuad(dst, pt, stop, fTangents[stopSeg]);
 
-        // we will take care of the stroking
-        rec->setFillStyle();
+        // wait to see if the next dash continues this one
+        fHasPendingCap = true;
+        fCapPt = stop;
+        fCapTangent = fTangents[stopSeg];
+        fDst = dst;
         return true;
     }
 
-    void addSegment(SkScalar d0, SkScalar d1, SkPath* path) const {
-        SkASSERT(d0 < fPathLength);
-        // clamp the segment to our length
-        if (d1 > fPathLength) {
-            d1 = fPathLength;
+    bool nextContour() {
+        this->flushCap();
+        this->buildContour();
+        return fLength > 0;
+    }
+
+private:
+    SkPath::Iter        fIter;
+    bool                fHasNextMove;
+    SkPoint             fNextMove;
+
+    // the current contour, skipping lines that add no length
+    SkTDArray<SkPoint>  fPts;
+    SkTDArray<SkScalar> fDistances;     // from the start to each of fPts
+    SkTDArray<SkVector> fTangents;      // unit tangent of each line
+    SkScalar            fLength;
+    bool                fIsClosed;
+    int                 fCurrSeg;       // where to start searching
+
+    bool                fStroke;
+    SkScalar            fRadius;
+    SkPaint::Cap        fCap;
+    SkPaint::Join       fJoin;
+    SkScalar            fMiterLimit;
+
+    // the end of the last dash, which is capped once we know that the next
+    // dash does not continue it
+    bool                fHasPendingCap;
+    SkPoint             fCapPt;
+    SkVector            fCapTangent;
+    SkPath*             fDst;
+
+    // Mirrors SkPathMeasure::buildSegments
+    void buildContour() {
+        fPts.rewind();
+        fDistances.rewind();
+        fTangents.rewind();
+        fLength = 0;
+        fIsClosed = false;
+        fCurrSeg = 0;
+
+        if (fHasNextMove) {
+            *fPts.append() = fNextMove;
+            *fDistances.append() = 0;
+            fHasNextMove = false;
         }
 
-        SkScalar x0 = fPts[0].fX + SkScalarMul(fTangent.fX, d0);
-        SkScalar x1 = fPts[0].fX + SkScalarMul(fTangent.fX, d1);
-        SkScalar y0 = fPts[0].fY + SkScalarMul(fTangent.fY, d0);
-        SkScalar y1 = fPts[0].fY + SkScalarMul(fTangent.fY, d1);
+        SkPoint pts[4];
+        for (;;) {
+            switch (fIter.next(pts)) {
+                case SkPath::kMove_Verb:
+                    if (fPts.count() > 0) {
+                        fNextMove = pts[0];
+                        fHasNextMove = true;
+                        return;
+                    }
+                    *fPts.append() = pts[0];
+                    *fDistances.append() = 0;
+                    break;
+                case SkPath::kLine_Verb: {
+                    SkScalar prevD = fLength;
+                    fLength += SkPoint::Distance(pts[0], pts[1]);
+                    if (fLength > prevD) {
+                        SkVector* tangent = fTangents.append();
+                        tangent->setNormalize(pts[1].fX - pts[0].fX,
+                                              pts[1].fY - pts[0].fY);
+                        *fPts.append() = pts[1];
+                        *fDistances.append() = fLength;
+                    }
+                } break;
+                case SkPath::kClose_Verb:
+                    fIsClosed = true;
+                    break;
+                case SkPath::kDone_Verb:
+                    return;
+                default:
+                    SkDEBUGFAIL("not a polyline");
+                    return;
+            }
+        }
+    }
+
+    /*  Return the line containing distance d: the one with
+        fDistances[i] <= d < fDistances[i + 1], or if atEnd is true,
+        fDistances[i] < d <= fDistances[i + 1]. Dashes are mostly asked for
+        in order, so we search forward from the last line we found.
+     */
+    int findSegment(SkScalar d, bool atEnd) {
+        const int lastSeg = fTangents.count() - 1;
+        int i = fCurrSeg;
+        if (d < fDistances[i]) {
+            i = 0;
+        }
+        if (atEnd) {
+            while (i < lastSeg && fDistances[i + 1] < d) {
+                ++i;
+            }
+        } else {
+            while (i < lastSeg && fDistances[i + 1] <= d) {
+                ++i;
+            }
+        }
+        fCurrSeg = i;
+        return i;
+    }
 
+    SkPoint pointAt(int seg, SkScalar d) const {
+        const SkPoint& p0 = fPts[seg];
+        const SkPoint& p1 = fPts[seg + 1];
+        SkScalar t = SkScalarDiv(d - fDistances[seg],
+                                 fDistances[seg + 1] - fDistances[seg]);
+        SkPoint pt;
+        pt.set(SkScalarInterp(p0.fX, p1.fX, t), SkScalarInterp(p0.fY, p1.fY, t));
+        return pt;
+    }
+
+    SkVector normal(const SkVector& tangent) const {
+        SkVector n;
+        tangent.rotateCCW(&n);
+        n.scale(fRadius);
+        return n;
+    }
+
+    // the stroke of the line from p0 to p1, whose unit tangent is given
+    void addQuad(SkPath* dst, const SkPoint& p0, const SkPoint& p1,
+                 const SkVector& tangent) const {
+        SkVector n = this->normal(tangent);
         SkPoint pts[4];
-        pts[0].set(x0 + fNormal.fX, y0 + fNormal.fY);   // moveTo
-        pts[1].set(x1 + fNormal.fX, y1 + fNormal.fY);   // lineTo
-        pts[2].set(x1 - fNormal.fX, y1 - fNormal.fY);   // lineTo
-        pts[3].set(x0 - fNormal.fX, y0 - fNormal.fY);   // lineTo
+        pts[0] = p0 + n;
+        pts[1] = p1 + n;
+        pts[2] = p1 - n;
+        pts[3] = p0 - n;
+        dst->addPoly(pts, SK_ARRAY_COUNT(pts), false);
+    }
 
-        path->addPoly(pts, SK_ARRAY_COUNT(pts), false);
+    // Add a polygon, oriented like the quads from addQuad.
+    static void AddOrientedPoly(SkPath* dst, SkPoint pts[], int count) {
+        SkScalar area = 0;
+        for (int i = 0; i < count; ++i) {
+            const SkPoint& next = pts[i + 1 < count ? i + 1 : 0];
+            area += SkScalarMul(pts[i].fX, next.fY) -
+                    SkScalarMul(next.fX, pts[i].fY);
+        }
+        if (area < 0) {
+            for (int i = 0, j = count - 1; i < j; ++i, --j) {
+                SkTSwap(pts[i], pts[j]);
+            }
+        }
+        dst->addPoly(pts, count, false);
     }
 
-private:
-    SkPoint fPts[2];
-    SkVector fTangent;
-    SkVector fNormal;
-    SkScalar fPathLength;
-};
+    // dir is the unit vector pointing out of the dash
+    void addCap(SkPath* dst, const SkPoint& pt, const SkVector& dir) const {
+        switch (fCap) {
+            case SkPaint::kButt_Cap:
+                break;
+            case SkPaint::kSquare_Cap: {
+                SkPoint end;
+                end.set(pt.fX + SkScalarMul(dir.fX, fRadius),
+                        pt.fY + SkScalarMul(dir.fY, fRadius));
+                this->addQuad(dst, pt, end, dir);
+            } break;
+            default:
+                dst->addCircle(pt.fX, pt.fY, fRadius, SkPath::kCW_Direction);
+                break;
+        }
+    }
 
-bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
-                                  SkStrokeRec* rec) const {
-    // we do nothing if the src wants to be filled, or if our dashlength is 0
-    if (rec->isFillStyle() || fInitialDashLength < 0) {
-        return false;
+    void flushCap() {
+        if (fHasPendingCap) {
+            this->addCap(fDst, fCapPt, fCapTangent);
+            fHasPendingCap = false;
+        }
     }
 
-    SkPathMeasure   meas(src, false);
-    const SkScalar* intervals = fIntervals;
-    SkScalar        dashCount = 0;
+    /*  The quads on either side of the vertex already overlap on the inside
+        of the turn; fill the gap between them on the outside.
+     */
+    void addJoin(SkPath* dst, const SkPoint& pt, const SkVector& before,
+                 const SkVector& after) const {
+        SkScalar dot = SkPoint::DotProduct(before, after);
+        if (dot > 0 &&
+            SkScalarNearlyZero(SkPoint::CrossProduct(before, after))) {
+            return;     // close enough to straight
+        }
+
+        if (SkPaint::kRound_Join == fJoin) {
+            dst->addCircle(pt.fX, pt.fY, fRadius, SkPath::kCW_Direction);
+            return;
+        }
+
+        SkVector outer0 = this->normal(before);
+        SkVector outer1 = this->normal(after);
+        if (SkPoint::DotProduct(outer0, after) > 0) {
+            outer0.negate();
+            outer1.negate();
+        }
 
-    SpecialLineRec lineRec;
-    const bool specialLine = lineRec.init(src, dst, rec, meas.getLength(),
-                                          fCount >> 1, fIntervalLength);
+        SkPoint pts[4];
+        int count = 0;
+        pts[count++] = pt;
+        pts[count++] = pt + outer0;
+        if (SkPaint::kMiter_Join == fJoin) {
+            // the miter is along the bisector, radius / sin(halfAngle) from pt
+            SkVector mid;
+            mid.set(SkScalarHalf(outer0.fX + outer1.fX),
+                    SkScalarHalf(outer0.fY + outer1.fY));
+            SkScalar midSqd = mid.lengthSqd();
+            SkScalar radiusSqd = SkScalarMul(fRadius, fRadius);
+            if (SkScalarMul(midSqd, SkScalarMul(fMiterLimit, fMiterLimit)) >=
+                    radiusSqd && midSqd > 0) {
+                mid.scale(SkScalarDiv(radiusSqd, midSqd));
+                pts[count++] = pt + mid;
+            }
+        }
+        pts[count++] = pt + outer1;
+        AddOrientedPoly(dst, pts, count);
+    }
+};
+
+/*  Dash each contour of meas (an SkPathMeasure or a PolylineMeasure) into
+    dst. Returns false if there would be too many dashes.
+ */
+template <typename Measure>
+static bool dash_contours(Measure* meas, SkPath* dst, const SkScalar intervals[],
+                          int count, SkScalar intervalLength,
+                          SkScalar initialDashLength, int initialDashIndex,
+                          bool scaleToFit) {
+    SkScalar        dashCount = 0;
 
     do {
-        bool        skipFirstSegment = meas.isClosed();
+        bool        skipFirstSegment = meas->isClosed();
         bool        addedSegment = false;
-        SkScalar    length = meas.getLength();
-        int         index = fInitialDashIndex;
+        SkScalar    length = meas->getLength();
+        int         index = initialDashIndex;
         SkScalar    scale = SK_Scalar1;
 
         // Since the path length / dash length ratio may be arbitrarily large, we can exert
@@ -186,42 +434,35 @@ bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
         // segments seems reasonable: at 2 verbs per segment * 9 bytes per verb, this caps the
         // maximum dash memory overhead at roughly 17MB per path.
         static const SkScalar kMaxDashCount = 1000000;
-        dashCount += length * (fCount >> 1) / fIntervalLength;
+        dashCount += length * (count >> 1) / intervalLength;
         if (dashCount > kMaxDashCount) {
             dst->reset();
             return false;
         }
 
-        if (fScaleToFit) {
-            if (fIntervalLength >= length) {
-                scale = SkScalarDiv(length, fIntervalLength);
+        if (scaleToFit) {
+            if (intervalLength >= length) {
+                scale = SkScalarDiv(length, intervalLength);
             } else {
-                SkScalar div = SkScalarDiv(length, fIntervalLength);
+                SkScalar div = SkScalarDiv(length, intervalLength);
                 int n = SkScalarFloor(div);
-                scale = SkScalarDiv(length, n * fIntervalLength);
+                scale = SkScalarDiv(length, n * intervalLength);
             }
         }
 
         // Using double precision to avoid looping indefinitely due to single precision rounding
         // (for extreme path_length/dash_length ratios). See test_infinite_dash() unittest.
         double  distance = 0;
-        double  dlen = SkScalarMul(fInitialDashLength, scale);
+        double  dlen = SkScalarMul(initialDashLength, scale);
 
         while (distance < length) {
             SkASSERT(dlen >= 0);
             addedSegment = false;
             if (is_even(index) && dlen > 0 && !skipFirstSegment) {
                 addedSegment = true;
-
-                if (specialLine) {
-                    lineRec.addSegment(SkDoubleToScalar(distance),
-                                       SkDoubleToScalar(distance + dlen),
-                                       dst);
-                } else {
-                    meas.getSegment(SkDoubleToScalar(distance),
-                                    SkDoubleToScalar(distance + dlen),
-                                    dst, true);
-                }
+                meas->getSegment(SkDoubleToScalar(distance),
+                                 SkDoubleToScalar(distance + dlen),
+                                 dst, true);
             }
             distance += dlen;
 
@@ -230,8 +471,8 @@ bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
 
             // wrap around our intervals array if necessary
             index += 1;
-            SkASSERT(index <= fCount);
-            if (index == fCount) {
+            SkASSERT(index <= count);
+            if (index == count) {
                 index = 0;
             }
 
@@ -240,15 +481,39 @@ bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
         }
 
         // extend if we ended on a segment and we need to join up with the (skipped) initial segment
-        if (meas.isClosed() && is_even(fInitialDashIndex) &&
-                fInitialDashLength > 0) {
-            meas.getSegment(0, SkScalarMul(fInitialDashLength, scale), dst, !addedSegment);
+        if (meas->isClosed() && is_even(initialDashIndex) &&
+                initialDashLength > 0) {
+            meas->getSegment(0, SkScalarMul(initialDashLength, scale), dst, !addedSegment);
         }
-    } while (meas.nextContour());
+    } while (meas->nextContour());
 
     return true;
 }
 
+bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
+                                  SkStrokeRec* rec) const {
+    // we do nothing if the src wants to be filled, or if our dashlength is 0
+    if (rec->isFillStyle() || fInitialDashLength < 0) {
+        return false;
+    }
+
+    const SkStrokeRec srcRec(*rec);
+    if (PolylineMeasure::CanDash(src, rec)) {
+        PolylineMeasure meas(src, srcRec);
+        if (!dash_contours(&meas, dst, fIntervals, fCount, fIntervalLength,
+                           fInitialDashLength, fInitialDashIndex,
+                           fScaleToFit)) {
+            *rec = srcRec;  // we did not stroke after all
+            return false;
+        }
+        return true;
+    }
+
+    SkPathMeasure meas(src, false);
+    return dash_contours(&meas, dst, fIntervals, fCount, fIntervalLength,
+                         fInitialDashLength, fInitialDashIndex, fScaleToFit);
+}
+
 // Currently asPoints is more restrictive then it needs to be. In the future
 // we need to:
 //      allow kRound_Cap capping (could allow rotations in the matrix with this)
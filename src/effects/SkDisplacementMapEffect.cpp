@@ -164,13 +164,16 @@ void SkDisplacementMapEffect::flatten(SkFlattenableWriteBuffer& buffer) const {
 
 bool SkDisplacementMapEffect::onFilterImage(Proxy* proxy,
                                             const SkBitmap& src,
-                                            const SkMatrix& ctm,
+                                            const Context& ctx,
                                             SkBitmap* dst,
                                             SkIPoint* offset) {
     SkBitmap displ, color = src;
     SkImageFilter* colorInput = getColorInput();
     SkImageFilter* displacementInput = getDisplacementInput();
     SkASSERT(NULL != displacementInput);
+    // Any pixel of the color input may be displaced into the clip, so
+    // neither input can be limited to it.
+    const SkMatrix& ctm = ctx.ctm();
     if ((colorInput && !colorInput->filterImage(proxy, src, ctm, &color, offset)) ||
         !displacementInput->filterImage(proxy, src, ctm, &displ, offset)) {
         return false;
@@ -293,7 +293,7 @@ void SkMagnifierImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
 }
 
 bool SkMagnifierImageFilter::onFilterImage(Proxy*, const SkBitmap& src,
-                                           const SkMatrix&, SkBitmap* dst,
+                                           const Context&, SkBitmap* dst,
                                            SkIPoint* offset) {
     SkASSERT(src.config() == SkBitmap::kARGB_8888_Config);
     SkASSERT(fSrcRect.width() < src.width());
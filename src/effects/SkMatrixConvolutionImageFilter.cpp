@@ -200,10 +200,10 @@ static SkBitmap unpremultiplyBitmap(const SkBitmap& src)
 
 bool SkMatrixConvolutionImageFilter::onFilterImage(Proxy* proxy,
                                                    const SkBitmap& source,
-                                                   const SkMatrix& matrix,
+                                                   const Context& ctx,
                                                    SkBitmap* result,
                                                    SkIPoint* loc) {
-    SkBitmap src = this->getInputResult(proxy, source, matrix, loc);
+    SkBitmap src = this->getInputResult(proxy, source, ctx, loc);
     if (src.config() != SkBitmap::kARGB_8888_Config) {
         return false;
     }
@@ -92,8 +92,14 @@ bool SkMergeImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
     return true;
 }
 
+bool SkMergeImageFilter::onSourceBounds(const SkIRect& dst, const SkMatrix&,
+                                        SkIRect* src) {
+    *src = dst;
+    return true;
+}
+
 bool SkMergeImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
-                                       const SkMatrix& ctm,
+                                       const Context& ctx,
                                        SkBitmap* result, SkIPoint* loc) {
     if (countInputs() < 1) {
         return false;
@@ -102,9 +108,15 @@ bool SkMergeImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
     const SkIRect srcBounds = SkIRect::MakeXYWH(loc->x(), loc->y(),
                                                 src.width(), src.height());
     SkIRect bounds;
-    if (!this->filterBounds(srcBounds, ctm, &bounds)) {
+    if (!this->filterBounds(srcBounds, ctx.ctm(), &bounds)) {
         return false;
     }
+    // Only allocate what the caller will look at. If that is nothing, still
+    // succeed, since failing would take our siblings down with us.
+    SkIRect clippedBounds = bounds;
+    if (clippedBounds.intersect(ctx.clipBounds())) {
+        bounds = clippedBounds;
+    }
 
     const int x0 = bounds.left();
     const int y0 = bounds.top();
@@ -119,16 +131,14 @@ bool SkMergeImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
     int inputCount = countInputs();
     for (int i = 0; i < inputCount; ++i) {
         SkBitmap tmp;
-        const SkBitmap* srcPtr;
         SkIPoint pos = *loc;
         SkImageFilter* filter = getInput(i);
         if (filter) {
-            if (!filter->filterImage(proxy, src, ctm, &tmp, &pos)) {
+            if (!filter->filterImage(proxy, src, ctx, &tmp, &pos)) {
                 return false;
             }
-            srcPtr = &tmp;
         } else {
-            srcPtr = &src;
+            tmp = this->getInputResult(i, proxy, src, ctx, &pos);
         }
 
         if (fModes) {
@@ -136,7 +146,7 @@ bool SkMergeImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
         } else {
             paint.setXfermode(NULL);
         }
-        canvas.drawSprite(*srcPtr, pos.x() - x0, pos.y() - y0, &paint);
+        canvas.drawSprite(tmp, pos.x() - x0, pos.y() - y0, &paint);
     }
 
     loc->set(bounds.left(), bounds.top());
@@ -9,7 +9,10 @@
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
 #include "SkFlattenableBuffers.h"
+#include "SkMorphologyProcs.h"
 #include "SkRect.h"
+#include "SkTemplates.h"
+#include "SkUtils.h"
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
 #include "GrTexture.h"
@@ -36,106 +39,231 @@ void SkMorphologyImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
     buffer.writeInt(fRadius.fHeight);
 }
 
-static void erode(const SkPMColor* src, SkPMColor* dst,
-                  int radius, int width, int height,
-                  int srcStrideX, int srcStrideY,
-                  int dstStrideX, int dstStrideY)
-{
-    radius = SkMin32(radius, width - 1);
-    const SkPMColor* upperSrc = src + radius * srcStrideX;
-    for (int x = 0; x < width; ++x) {
-        const SkPMColor* lp = src;
-        const SkPMColor* up = upperSrc;
-        SkPMColor* dptr = dst;
-        for (int y = 0; y < height; ++y) {
-            int minB = 255, minG = 255, minR = 255, minA = 255;
-            for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                int b = SkGetPackedB32(*p);
-                int g = SkGetPackedG32(*p);
-                int r = SkGetPackedR32(*p);
-                int a = SkGetPackedA32(*p);
-                if (b < minB) minB = b;
-                if (g < minG) minG = g;
-                if (r < minR) minR = r;
-                if (a < minA) minA = a;
+bool SkMorphologyImageFilter::onSourceBounds(const SkIRect& dst, const SkMatrix&,
+                                             SkIRect* src) {
+    *src = dst;
+    src->outset(SkMax32(fRadius.width(), 0), SkMax32(fRadius.height(), 0));
+    return true;
+}
+
+namespace {
+
+// Returns 0x00FF in each 16 bit lane where a's lane is >= b's, and 0 where it
+// is less. Both hold a channel in the low byte of each lane.
+static inline uint32_t lanes_ge_mask(uint32_t a, uint32_t b) {
+    uint32_t ge = ((a | 0x01000100) - b) & 0x01000100;
+    return ge - (ge >> 8);
+}
+
+template <bool isMax>
+static inline uint32_t select_lanes(uint32_t a, uint32_t b) {
+    uint32_t mask = lanes_ge_mask(a, b);
+    return isMax ? (a & mask) | (b & ~mask) : (b & mask) | (a & ~mask);
+}
+
+// The per-channel min or max of two pixels, two channels at a time.
+template <bool isMax>
+static inline SkPMColor morph_pixels(SkPMColor a, SkPMColor b) {
+    uint32_t rb = select_lanes<isMax>(a & 0x00FF00FF, b & 0x00FF00FF);
+    uint32_t ag = select_lanes<isMax>((a >> 8) & 0x00FF00FF,
+                                      (b >> 8) & 0x00FF00FF);
+    return rb | (ag << 8);
+}
+
+/*  The van Herk/Gil-Werman running min/max. The line is padded with radius
+    pixels on each side that do not change the result (so the window is in
+    effect clipped to the line), and cut into blocks as long as the window,
+    2 * radius + 1. Each window then covers the end of one block and the start
+    of the next (or exactly one block), so its result is the op of a suffix of
+    one block and a prefix of the next: three ops per pixel, however big the
+    radius.
+
+    pad holds the padded line, width + 2 * radius pixels. prefix is scratch of
+    the same length.
+ */
+template <bool isMax>
+static void morph_padded_line(const SkPMColor* pad, SkPMColor* prefix,
+                              SkPMColor* dst, int radius, int width) {
+    const int window = 2 * radius + 1;
+    const int count = width + 2 * radius;
+
+    for (int start = 0; start < count; start += window) {
+        int end = SkMin32(start + window, count);
+        SkPMColor m = pad[start];
+        prefix[start] = m;
+        for (int i = start + 1; i < end; ++i) {
+            m = morph_pixels<isMax>(m, pad[i]);
+            prefix[i] = m;
+        }
+    }
+
+    // Walk back through the blocks that start a window, keeping the suffix.
+    for (int start = (width - 1) / window * window; start >= 0;
+         start -= window) {
+        int i = SkMin32(start + window, count) - 1;
+        SkPMColor suffix = pad[i];
+        for (;;) {
+            if (i < width) {
+                dst[i] = morph_pixels<isMax>(suffix, prefix[i + 2 * radius]);
             }
-            *dptr = SkPackARGB32(minA, minR, minG, minB);
-            dptr += dstStrideY;
-            lp += srcStrideY;
-            up += srcStrideY;
+            if (--i < start) {
+                break;
+            }
+            suffix = morph_pixels<isMax>(suffix, pad[i]);
         }
-        if (x >= radius) src += srcStrideX;
-        if (x + radius < width - 1) upperSrc += srcStrideX;
-        dst += dstStrideX;
     }
 }
 
-static void erodeX(const SkBitmap& src, SkBitmap* dst, int radiusX)
-{
-    erode(src.getAddr32(0, 0), dst->getAddr32(0, 0),
-          radiusX, src.width(), src.height(),
-          1, src.rowBytesAsPixels(), 1, dst->rowBytesAsPixels());
+template <bool isMax>
+static void morph_x(const SkPMColor* src, int srcRowPixels,
+                    SkPMColor* dst, int dstRowPixels,
+                    int radius, int width, int height) {
+    const SkPMColor identity = isMax ? 0 : 0xFFFFFFFF;
+    const int count = width + 2 * radius;
+    SkAutoTMalloc<SkPMColor> storage(2 * count);
+    SkPMColor* pad = storage.get();
+    SkPMColor* prefix = pad + count;
+
+    sk_memset32(pad, identity, radius);
+    sk_memset32(pad + radius + width, identity, radius);
+    for (int y = 0; y < height; ++y) {
+        memcpy(pad + radius, src, width * sizeof(SkPMColor));
+        morph_padded_line<isMax>(pad, prefix, dst, radius, width);
+        src += srcRowPixels;
+        dst += dstRowPixels;
+    }
 }
 
-static void erodeY(const SkBitmap& src, SkBitmap* dst, int radiusY)
-{
-    erode(src.getAddr32(0, 0), dst->getAddr32(0, 0),
-          radiusY, src.height(), src.width(),
-          src.rowBytesAsPixels(), 1, dst->rowBytesAsPixels(), 1);
-}
+enum {
+    // a 64 byte cache line of pixels
+    kTileColumns = 16
+};
 
-static void dilate(const SkPMColor* src, SkPMColor* dst,
-                   int radius, int width, int height,
-                   int srcStrideX, int srcStrideY,
-                   int dstStrideX, int dstStrideY)
-{
-    radius = SkMin32(radius, width - 1);
-    const SkPMColor* upperSrc = src + radius * srcStrideX;
-    for (int x = 0; x < width; ++x) {
-        const SkPMColor* lp = src;
-        const SkPMColor* up = upperSrc;
-        SkPMColor* dptr = dst;
+/*  Rather than walk down each column (touching a new cache line for every
+    pixel), transpose a strip of columns into padded lines, reading src a row
+    at a time, filter those, and transpose the results back.
+ */
+template <bool isMax>
+static void morph_y(const SkPMColor* src, int srcRowPixels,
+                    SkPMColor* dst, int dstRowPixels,
+                    int radius, int width, int height) {
+    const SkPMColor identity = isMax ? 0 : 0xFFFFFFFF;
+    const int count = height + 2 * radius;
+    SkAutoTMalloc<SkPMColor> storage(kTileColumns * (count + height) + count);
+    SkPMColor* pads = storage.get();
+    SkPMColor* results = pads + kTileColumns * count;
+    SkPMColor* prefix = results + kTileColumns * height;
+
+    for (int i = 0; i < kTileColumns; ++i) {
+        sk_memset32(pads + i * count, identity, radius);
+        sk_memset32(pads + i * count + radius + height, identity, radius);
+    }
+    for (int x = 0; x < width; x += kTileColumns) {
+        int n = SkMin32(kTileColumns, width - x);
+
+        const SkPMColor* s = src + x;
+        for (int y = 0; y < height; ++y) {
+            for (int i = 0; i < n; ++i) {
+                pads[i * count + radius + y] = s[i];
+            }
+            s += srcRowPixels;
+        }
+        for (int i = 0; i < n; ++i) {
+            morph_padded_line<isMax>(pads + i * count, prefix,
+                                     results + i * height, radius, height);
+        }
+        SkPMColor* d = dst + x;
         for (int y = 0; y < height; ++y) {
-            int maxB = 0, maxG = 0, maxR = 0, maxA = 0;
-            for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                int b = SkGetPackedB32(*p);
-                int g = SkGetPackedG32(*p);
-                int r = SkGetPackedR32(*p);
-                int a = SkGetPackedA32(*p);
-                if (b > maxB) maxB = b;
-                if (g > maxG) maxG = g;
-                if (r > maxR) maxR = r;
-                if (a > maxA) maxA = a;
+            for (int i = 0; i < n; ++i) {
+                d[i] = results[i * height + y];
             }
-            *dptr = SkPackARGB32(maxA, maxR, maxG, maxB);
-            dptr += dstStrideY;
-            lp += srcStrideY;
-            up += srcStrideY;
+            d += dstRowPixels;
         }
-        if (x >= radius) src += srcStrideX;
-        if (x + radius < width - 1) upperSrc += srcStrideX;
-        dst += dstStrideX;
     }
 }
 
+}
+
+static void callProcX(SkMorphologyProcType procType, const SkBitmap& src,
+                      SkBitmap* dst, int radiusX) {
+    const SkPMColor* s = src.getAddr32(0, 0);
+    SkPMColor* d = dst->getAddr32(0, 0);
+    int srcRowPixels = src.rowBytesAsPixels();
+    int dstRowPixels = dst->rowBytesAsPixels();
+    int width = src.width();
+    int height = src.height();
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    radiusX = SkMin32(radiusX, width - 1);
+
+    SkMorphologyProc proc = SkMorphologyGetPlatformProc(procType);
+    if (proc) {
+        int rows = proc(s, srcRowPixels, d, dstRowPixels,
+                        radiusX, width, height);
+        s += rows * srcRowPixels;
+        d += rows * dstRowPixels;
+        height -= rows;
+    }
+    if (kDilateX_SkMorphologyProcType == procType) {
+        morph_x<true>(s, srcRowPixels, d, dstRowPixels, radiusX, width, height);
+    } else {
+        morph_x<false>(s, srcRowPixels, d, dstRowPixels, radiusX, width, height);
+    }
+}
+
+static void callProcY(SkMorphologyProcType procType, const SkBitmap& src,
+                      SkBitmap* dst, int radiusY) {
+    const SkPMColor* s = src.getAddr32(0, 0);
+    SkPMColor* d = dst->getAddr32(0, 0);
+    int srcRowPixels = src.rowBytesAsPixels();
+    int dstRowPixels = dst->rowBytesAsPixels();
+    int width = src.width();
+    int height = src.height();
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    radiusY = SkMin32(radiusY, height - 1);
+
+    SkMorphologyProc proc = SkMorphologyGetPlatformProc(procType);
+    if (proc) {
+        int columns = proc(s, srcRowPixels, d, dstRowPixels,
+                           radiusY, width, height);
+        s += columns;
+        d += columns;
+        width -= columns;
+    }
+    if (kDilateY_SkMorphologyProcType == procType) {
+        morph_y<true>(s, srcRowPixels, d, dstRowPixels, radiusY, width, height);
+    } else {
+        morph_y<false>(s, srcRowPixels, d, dstRowPixels, radiusY, width, height);
+    }
+}
+
+static void erodeX(const SkBitmap& src, SkBitmap* dst, int radiusX)
+{
+    callProcX(kErodeX_SkMorphologyProcType, src, dst, radiusX);
+}
+
+static void erodeY(const SkBitmap& src, SkBitmap* dst, int radiusY)
+{
+    callProcY(kErodeY_SkMorphologyProcType, src, dst, radiusY);
+}
+
 static void dilateX(const SkBitmap& src, SkBitmap* dst, int radiusX)
 {
-    dilate(src.getAddr32(0, 0), dst->getAddr32(0, 0),
-           radiusX, src.width(), src.height(),
-           1, src.rowBytesAsPixels(), 1, dst->rowBytesAsPixels());
+    callProcX(kDilateX_SkMorphologyProcType, src, dst, radiusX);
 }
 
 static void dilateY(const SkBitmap& src, SkBitmap* dst, int radiusY)
 {
-    dilate(src.getAddr32(0, 0), dst->getAddr32(0, 0),
-           radiusY, src.height(), src.width(),
-           src.rowBytesAsPixels(), 1, dst->rowBytesAsPixels(), 1);
+    callProcY(kDilateY_SkMorphologyProcType, src, dst, radiusY);
 }
 
 bool SkErodeImageFilter::onFilterImage(Proxy* proxy,
-                                       const SkBitmap& source, const SkMatrix& ctm,
+                                       const SkBitmap& source, const Context& ctx,
                                        SkBitmap* dst, SkIPoint* offset) {
-    SkBitmap src = this->getInputResult(proxy, source, ctm, offset);
+    SkBitmap src = this->getInputResult(proxy, source, ctx, offset);
     if (src.config() != SkBitmap::kARGB_8888_Config) {
         return false;
     }
@@ -178,9 +306,9 @@ bool SkErodeImageFilter::onFilterImage(Proxy* proxy,
 }
 
 bool SkDilateImageFilter::onFilterImage(Proxy* proxy,
-                                        const SkBitmap& source, const SkMatrix& ctm,
+                                        const SkBitmap& source, const Context& ctx,
                                         SkBitmap* dst, SkIPoint* offset) {
-    SkBitmap src = this->getInputResult(proxy, source, ctm, offset);
+    SkBitmap src = this->getInputResult(proxy, source, ctx, offset);
     if (src.config() != SkBitmap::kARGB_8888_Config) {
         return false;
     }
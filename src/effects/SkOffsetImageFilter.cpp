@@ -11,12 +11,12 @@
 #include "SkFlattenableBuffers.h"
 
 bool SkOffsetImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& source,
-                                        const SkMatrix& matrix,
+                                        const Context& ctx,
                                         SkBitmap* result,
                                         SkIPoint* loc) {
-    SkBitmap src = this->getInputResult(proxy, source, matrix, loc);
+    SkBitmap src = this->getInputResult(proxy, source, ctx, loc);
     SkVector vec;
-    matrix.mapVectors(&vec, &fOffset, 1);
+    ctx.ctm().mapVectors(&vec, &fOffset, 1);
 
     loc->fX += SkScalarRoundToInt(vec.fX);
     loc->fY += SkScalarRoundToInt(vec.fY);
@@ -34,6 +34,15 @@ bool SkOffsetImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm
     return true;
 }
 
+bool SkOffsetImageFilter::onSourceBounds(const SkIRect& dst, const SkMatrix& ctm,
+                                         SkIRect* src) {
+    SkVector vec;
+    ctm.mapVectors(&vec, &fOffset, 1);
+    *src = dst;
+    src->offset(-SkScalarRoundToInt(vec.fX), -SkScalarRoundToInt(vec.fY));
+    return true;
+}
+
 void SkOffsetImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
     this->INHERITED::flatten(buffer);
     buffer.writePoint(fOffset);
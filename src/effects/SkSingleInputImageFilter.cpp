@@ -31,9 +31,9 @@ void SkSingleInputImageFilter::flatten(SkFlattenableWriteBuffer& wb) const {
 
 SkBitmap SkSingleInputImageFilter::getInputResult(Proxy* proxy,
                                                   const SkBitmap& src,
-                                                  const SkMatrix& ctm,
+                                                  const Context& ctx,
                                                   SkIPoint* offset) {
-    return this->INHERITED::getInputResult(0, proxy, src, ctm, offset);
+    return this->INHERITED::getInputResult(0, proxy, src, ctx, offset);
 }
 
 #if SK_SUPPORT_GPU
@@ -25,7 +25,7 @@ SkComposeImageFilter::~SkComposeImageFilter() {
 
 bool SkComposeImageFilter::onFilterImage(Proxy* proxy,
                                          const SkBitmap& src,
-                                         const SkMatrix& ctm,
+                                         const Context& ctx,
                                          SkBitmap* result,
                                          SkIPoint* loc) {
     SkImageFilter* outer = getInput(0);
@@ -36,12 +36,18 @@ bool SkComposeImageFilter::onFilterImage(Proxy* proxy,
     }
 
     if (!outer || !inner) {
-        return (outer ? outer : inner)->filterImage(proxy, src, ctm, result, loc);
+        return (outer ? outer : inner)->filterImage(proxy, src, ctx, result, loc);
     }
 
+    // inner only has to produce what outer is going to read
+    SkIRect innerBounds;
+    if (!outer->sourceBounds(ctx.clipBounds(), ctx.ctm(), &innerBounds)) {
+        innerBounds.setLargest();
+    }
     SkBitmap tmp;
-    return inner->filterImage(proxy, src, ctm, &tmp, loc) &&
-           outer->filterImage(proxy, tmp, ctm, result, loc);
+    return inner->filterImage(proxy, src, Context(ctx.ctm(), innerBounds),
+                              &tmp, loc) &&
+           outer->filterImage(proxy, tmp, ctx, result, loc);
 }
 
 bool SkComposeImageFilter::onFilterBounds(const SkIRect& src,
@@ -69,7 +75,7 @@ SkComposeImageFilter::SkComposeImageFilter(SkFlattenableReadBuffer& buffer) : IN
 ///////////////////////////////////////////////////////////////////////////////
 
 bool SkDownSampleImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
-                                            const SkMatrix& matrix,
+                                            const Context&,
                                             SkBitmap* result, SkIPoint*) {
     SkScalar scale = fScale;
     if (scale > SK_Scalar1 || scale <= 0) {
@@ -9,6 +9,7 @@
 
 #include "SkBitmap.h"
 #include "SkData.h"
+#include "SkImageCache.h"
 #include "SkImageDecoder.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
@@ -39,3 +40,41 @@ bool SkBitmapFactory::DecodeBitmap(SkBitmap* dst, const SkData* data, Constraint
         return false;
     }
 }
+
+bool SkBitmapFactory::DecodeBitmap(SkBitmap* dst, const SkData* data, SkImageCache* cache,
+                                   uint32_t sourceID, Constraints constraint) {
+    if (NULL == cache) {
+        return DecodeBitmap(dst, data, constraint);
+    }
+    if (NULL == dst) {
+        return false;
+    }
+
+    // We always decode to the decoder's preferred config, so there is only
+    // ever one entry per source.
+    SkImageCache::Key key;
+    key.fSourceID = sourceID;
+    key.fSampleSize = 1;
+    key.fConfig = SkBitmap::kNo_Config;
+
+    SkBitmap tmp;
+    if (cache->find(key, &tmp)) {
+        if (kDecodeBoundsOnly_Constraint == constraint) {
+            dst->setConfig(tmp.config(), tmp.width(), tmp.height());
+        } else {
+            // match the decoded case, which returns the pixels locked
+            tmp.lockPixels();
+            tmp.swap(*dst);
+        }
+        return true;
+    }
+
+    if (!DecodeBitmap(&tmp, data, constraint)) {
+        return false;
+    }
+    if (kDecodePixels_Constraint == constraint) {
+        cache->add(key, &tmp);
+    }
+    tmp.swap(*dst);
+    return true;
+}
@@ -0,0 +1,388 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkImageCache.h"
+#include "SkTDArray.h"
+#include "SkTInternalLList.h"
+
+static int compare_keys(const SkImageCache::Key& a, const SkImageCache::Key& b) {
+    if (a.fSourceID != b.fSourceID) {
+        return a.fSourceID < b.fSourceID ? -1 : 1;
+    }
+    if (a.fSampleSize != b.fSampleSize) {
+        return a.fSampleSize < b.fSampleSize ? -1 : 1;
+    }
+    return (int)a.fConfig - (int)b.fConfig;
+}
+
+static size_t bitmap_bytes(const SkBitmap& bitmap) {
+    size_t bytes = bitmap.getSize();
+    if (bitmap.getColorTable()) {
+        bytes += bitmap.getColorTable()->count() * sizeof(SkPMColor);
+    }
+    return bytes;
+}
+
+namespace {
+
+struct Entry {
+    Entry(const SkImageCache::Key& key, const SkBitmap& bitmap)
+        : fKey(key)
+        , fBitmap(bitmap)
+        , fBytes(bitmap_bytes(bitmap))
+        , fPinCount(0)
+        , fStamp(0) {}
+
+    SkImageCache::Key   fKey;
+    SkBitmap            fBitmap;
+    size_t              fBytes;
+    int                 fPinCount;
+    int32_t             fStamp;     // when it was last used
+
+    // Only unpinned entries are in their shard's list.
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+};
+
+}
+
+/**
+ *  A shard holds its entries sorted by key, for lookup, and its unpinned
+ *  entries in a list from most to least recently used, for eviction.
+ *  Everything in it is guarded by fMutex.
+ */
+class SkImageCache::Shard : SkNoncopyable {
+public:
+    ~Shard() {
+        fEntries.deleteAll();
+    }
+
+    // Returns the index of key's entry, or ~(the index to insert it at).
+    int search(const Key& key) const {
+        int lo = 0;
+        int hi = fEntries.count();
+        while (lo < hi) {
+            int mid = (lo + hi) >> 1;
+            int cmp = compare_keys(fEntries[mid]->fKey, key);
+            if (0 == cmp) {
+                return mid;
+            }
+            if (cmp < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return ~lo;
+    }
+
+    Entry* find(const Key& key) const {
+        int index = this->search(key);
+        return index >= 0 ? fEntries[index] : NULL;
+    }
+
+    void pin(Entry* entry) {
+        if (0 == entry->fPinCount++) {
+            fLRU.remove(entry);
+        }
+    }
+
+    void unpin(Entry* entry, int32_t stamp) {
+        SkASSERT(entry->fPinCount > 0);
+        if (0 == --entry->fPinCount) {
+            entry->fStamp = stamp;
+            fLRU.addToHead(entry);
+        }
+    }
+
+    void touch(Entry* entry, int32_t stamp) {
+        entry->fStamp = stamp;
+        if (0 == entry->fPinCount) {
+            fLRU.remove(entry);
+            fLRU.addToHead(entry);
+        }
+    }
+
+    void insert(int index, Entry* entry, int32_t stamp) {
+        *fEntries.insert(index) = entry;
+        entry->fStamp = stamp;
+        fLRU.addToHead(entry);
+    }
+
+    // Removes the entry at index, and returns it for the caller to delete,
+    // which it should do after releasing fMutex.
+    Entry* detach(int index) {
+        Entry* entry = fEntries[index];
+        if (0 == entry->fPinCount) {
+            fLRU.remove(entry);
+        }
+        fEntries.remove(index);
+        return entry;
+    }
+
+    Entry* oldest() { return fLRU.tail(); }
+
+    int count() const { return fEntries.count(); }
+
+    void dump() const {
+        for (int i = 0; i < fEntries.count(); ++i) {
+            const Entry* entry = fEntries[i];
+            SkDebugf("  [%3d %3d %d] source=%u sample=%d bytes=%d pins=%d\n",
+                     entry->fBitmap.width(), entry->fBitmap.height(),
+                     entry->fBitmap.config(), entry->fKey.fSourceID,
+                     entry->fKey.fSampleSize, (int)entry->fBytes,
+                     entry->fPinCount);
+        }
+    }
+
+    mutable SkMutex             fMutex;
+
+private:
+    SkTDArray<Entry*>           fEntries;
+    SkTInternalLList<Entry>     fLRU;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkImageCache::SkImageCache(size_t byteLimit)
+    : fByteLimit(byteLimit)
+    , fBytesUsed(0)
+    , fClock(0)
+    , fHits(0)
+    , fMisses(0)
+    , fEvictions(0) {
+    for (int i = 0; i < kShardCount; ++i) {
+        fShards[i] = SkNEW(Shard);
+    }
+}
+
+SkImageCache::~SkImageCache() {
+    for (int i = 0; i < kShardCount; ++i) {
+        SkDELETE(fShards[i]);
+    }
+}
+
+SK_DECLARE_STATIC_MUTEX(gGlobalCacheMutex);
+
+SkImageCache* SkImageCache::GetGlobal() {
+    static SkImageCache* gCache;
+    SkAutoMutexAcquire ac(gGlobalCacheMutex);
+    if (NULL == gCache) {
+        gCache = SkNEW(SkImageCache);
+        // call sk_atexit(...) when we have that, to free the global cache
+    }
+    return gCache;
+}
+
+uint32_t SkImageCache::NewSourceID() {
+    static int32_t gSourceID;
+    return (uint32_t)sk_atomic_inc(&gSourceID) + 1;
+}
+
+SkImageCache::Shard* SkImageCache::shardFor(const Key& key) const {
+    uint32_t hash = key.fSourceID * 0x9E3779B1 + key.fSampleSize * 31 +
+                    key.fConfig;
+    return fShards[(hash >> 16) % kShardCount];
+}
+
+size_t SkImageCache::getByteLimit() const {
+    SkAutoMutexAcquire ac(fBudgetMutex);
+    return fByteLimit;
+}
+
+void SkImageCache::setByteLimit(size_t byteLimit) {
+    {
+        SkAutoMutexAcquire ac(fBudgetMutex);
+        fByteLimit = byteLimit;
+    }
+    if (byteLimit > 0) {
+        this->purgeTo(byteLimit);
+    }
+}
+
+size_t SkImageCache::getBytesUsed() const {
+    SkAutoMutexAcquire ac(fBudgetMutex);
+    return fBytesUsed;
+}
+
+void SkImageCache::changeBytesUsed(size_t added, size_t removed) {
+    SkAutoMutexAcquire ac(fBudgetMutex);
+    SkASSERT(fBytesUsed + added >= removed);
+    fBytesUsed = fBytesUsed + added - removed;
+}
+
+bool SkImageCache::isOverBudget(size_t limit) const {
+    SkAutoMutexAcquire ac(fBudgetMutex);
+    return fBytesUsed > limit;
+}
+
+bool SkImageCache::find(const Key& key, SkBitmap* bitmap, bool pin) {
+    Shard* shard = this->shardFor(key);
+    SkAutoMutexAcquire ac(shard->fMutex);
+
+    Entry* entry = shard->find(key);
+    if (NULL == entry) {
+        sk_atomic_inc(&fMisses);
+        return false;
+    }
+    sk_atomic_inc(&fHits);
+    if (pin) {
+        shard->pin(entry);
+    } else {
+        shard->touch(entry, sk_atomic_inc(&fClock));
+    }
+    *bitmap = entry->fBitmap;
+    return true;
+}
+
+void SkImageCache::add(const Key& key, SkBitmap* bitmap, bool pin) {
+    SkASSERT(bitmap);
+    size_t added = 0;
+    {
+        Shard* shard = this->shardFor(key);
+        SkAutoMutexAcquire ac(shard->fMutex);
+
+        int index = shard->search(key);
+        Entry* entry;
+        if (index >= 0) {
+            // Someone else decoded it first, so share theirs.
+            entry = shard->find(key);
+            shard->touch(entry, sk_atomic_inc(&fClock));
+            *bitmap = entry->fBitmap;
+        } else {
+            entry = SkNEW_ARGS(Entry, (key, *bitmap));
+            shard->insert(~index, entry, sk_atomic_inc(&fClock));
+            added = entry->fBytes;
+        }
+        if (pin) {
+            shard->pin(entry);
+        }
+    }
+    if (added > 0) {
+        this->changeBytesUsed(added, 0);
+        size_t limit = this->getByteLimit();
+        if (limit > 0) {
+            this->purgeTo(limit);
+        }
+    }
+}
+
+void SkImageCache::unpin(const Key& key) {
+    {
+        Shard* shard = this->shardFor(key);
+        SkAutoMutexAcquire ac(shard->fMutex);
+
+        Entry* entry = shard->find(key);
+        if (NULL == entry) {
+            // it was removed while pinned
+            return;
+        }
+        shard->unpin(entry, sk_atomic_inc(&fClock));
+    }
+    size_t limit = this->getByteLimit();
+    if (limit > 0) {
+        this->purgeTo(limit);
+    }
+}
+
+void SkImageCache::remove(const Key& key) {
+    (void)this->removeEntry(key, true);
+}
+
+bool SkImageCache::removeIfUnpinned(const Key& key) {
+    return this->removeEntry(key, false);
+}
+
+bool SkImageCache::removeEntry(const Key& key, bool evenIfPinned) {
+    Entry* entry = NULL;
+    {
+        Shard* shard = this->shardFor(key);
+        SkAutoMutexAcquire ac(shard->fMutex);
+
+        int index = shard->search(key);
+        if (index >= 0 &&
+                (evenIfPinned || 0 == shard->find(key)->fPinCount)) {
+            entry = shard->detach(index);
+        }
+    }
+    if (NULL == entry) {
+        return false;
+    }
+    this->changeBytesUsed(0, entry->fBytes);
+    SkDELETE(entry);
+    return true;
+}
+
+/*  Each shard keeps its own order of use, so to find the least recently used
+    entry overall we compare the stamps of the oldest entry in each shard.
+ */
+bool SkImageCache::evictOldest() {
+    Shard* oldestShard = NULL;
+    int32_t oldestStamp = 0;
+    for (int i = 0; i < kShardCount; ++i) {
+        SkAutoMutexAcquire ac(fShards[i]->fMutex);
+        Entry* entry = fShards[i]->oldest();
+        // compare with a subtraction, so that wrapping stamps still order
+        if (NULL != entry &&
+                (NULL == oldestShard || entry->fStamp - oldestStamp < 0)) {
+            oldestShard = fShards[i];
+            oldestStamp = entry->fStamp;
+        }
+    }
+    if (NULL == oldestShard) {
+        return false;
+    }
+
+    Entry* entry = NULL;
+    {
+        SkAutoMutexAcquire ac(oldestShard->fMutex);
+        // It may have been used (or evicted) since we looked, but whatever is
+        // oldest in that shard now is still a good choice.
+        Entry* oldest = oldestShard->oldest();
+        if (NULL != oldest) {
+            entry = oldestShard->detach(oldestShard->search(oldest->fKey));
+        }
+    }
+    if (NULL != entry) {
+        sk_atomic_inc(&fEvictions);
+        this->changeBytesUsed(0, entry->fBytes);
+        SkDELETE(entry);
+    }
+    return true;
+}
+
+void SkImageCache::purgeTo(size_t bytes) {
+    while (this->isOverBudget(bytes) && this->evictOldest()) {
+    }
+}
+
+SkImageCache::Stats SkImageCache::getStats() const {
+    Stats stats;
+    stats.fHits = fHits;
+    stats.fMisses = fMisses;
+    stats.fEvictions = fEvictions;
+    stats.fCount = 0;
+    for (int i = 0; i < kShardCount; ++i) {
+        SkAutoMutexAcquire ac(fShards[i]->fMutex);
+        stats.fCount += fShards[i]->count();
+    }
+    stats.fBytesUsed = this->getBytesUsed();
+    return stats;
+}
+
+void SkImageCache::dump() const {
+#if defined(SK_DEBUG) || defined(DUMP_IMAGEREF_LIFECYCLE)
+    Stats stats = this->getStats();
+    SkDebugf("ImageCache dump: budget: %d used: %d count: %d "
+             "hits: %d misses: %d evictions: %d\n",
+             (int)this->getByteLimit(), (int)stats.fBytesUsed, stats.fCount,
+             stats.fHits, stats.fMisses, stats.fEvictions);
+    for (int i = 0; i < kShardCount; ++i) {
+        SkAutoMutexAcquire ac(fShards[i]->fMutex);
+        fShards[i]->dump();
+    }
+#endif
+}
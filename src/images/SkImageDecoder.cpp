@@ -10,6 +10,7 @@
 #include "SkImageDecoder.h"
 #include "SkBitmap.h"
 #include "SkPixelRef.h"
+#include "SkRect.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
 
@@ -146,6 +147,44 @@ bool SkImageDecoder::decode(SkStream* stream, SkBitmap* bm,
     return true;
 }
 
+bool SkImageDecoder::buildTileIndex(SkStream* stream, int* width, int* height) {
+    SkASSERT(stream);
+
+    int w, h;
+    if (!this->onBuildTileIndex(stream, &w, &h)) {
+        return false;
+    }
+    if (width) {
+        *width = w;
+    }
+    if (height) {
+        *height = h;
+    }
+    return true;
+}
+
+bool SkImageDecoder::decodeRegion(SkBitmap* bm, const SkIRect& rect,
+                                  int sampleSize, SkBitmap::Config pref) {
+    if (rect.isEmpty()) {
+        return false;
+    }
+
+    // pass a temporary bitmap, so that if we return false, we are assured of
+    // leaving the caller's bitmap untouched.
+    SkBitmap    tmp;
+
+    // we reset this to false before calling onDecodeRegion
+    fShouldCancelDecode = false;
+    // assign this, for use by getPrefConfig(), in case fUsePrefTable is false
+    fDefaultPref = pref;
+
+    if (!this->onDecodeRegion(&tmp, rect, SkMax32(sampleSize, 1))) {
+        return false;
+    }
+    bm->swap(tmp);
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 bool SkImageDecoder::DecodeFile(const char file[], SkBitmap* bm,
@@ -12,6 +12,7 @@
 #include "SkJpegUtility.h"
 #include "SkColorPriv.h"
 #include "SkDither.h"
+#include "SkRect.h"
 #include "SkScaledBitmapSampler.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
@@ -27,6 +28,12 @@ extern "C" {
 //#define TIME_ENCODE
 //#define TIME_DECODE
 
+// libjpeg-turbo can skip scanlines (without decoding whole iMCU rows) and
+// crop them to the columns we need, which makes region decoding much cheaper
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && LIBJPEG_TURBO_VERSION_NUMBER >= 1005000
+    #define SK_JPEG_HAS_SKIP_SCANLINES
+#endif
+
 // this enables our rgb->yuv code, which is faster than libjpeg on ARM
 // disable for the moment, as we have some glitches when width != multiple of 4
 #define WE_CONVERT_TO_YUV
@@ -36,12 +43,30 @@ extern "C" {
 
 class SkJPEGImageDecoder : public SkImageDecoder {
 public:
+    SkJPEGImageDecoder() : fIndexStream(NULL), fIndexWidth(0), fIndexHeight(0) {}
+    virtual ~SkJPEGImageDecoder() {
+        SkSafeUnref(fIndexStream);
+    }
+
     virtual Format getFormat() const {
         return kJPEG_Format;
     }
 
 protected:
     virtual bool onDecode(SkStream* stream, SkBitmap* bm, Mode);
+    virtual bool onBuildTileIndex(SkStream* stream, int* width, int* height);
+    virtual bool onDecodeRegion(SkBitmap* bm, const SkIRect& rect,
+                                int sampleSize);
+
+private:
+    SkBitmap::Config setupDecompress(jpeg_decompress_struct* cinfo,
+                                     int sampleSize) const;
+
+    // libjpeg cannot start decoding at an arbitrary scanline, so our index is
+    // just the (rewindable) stream, and the dimensions of the image.
+    SkStream*   fIndexStream;
+    int         fIndexWidth;
+    int         fIndexHeight;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -166,6 +191,110 @@ static void convert_CMYK_to_RGB(uint8_t* scanline, unsigned int width) {
     }
 }
 
+// Fast path for skipping rows when libjpeg can do it without handing us each
+// scanline.
+static bool skip_src_rows_fast(jpeg_decompress_struct* cinfo, void* buffer,
+                               int count) {
+#ifdef SK_JPEG_HAS_SKIP_SCANLINES
+    return jpeg_skip_scanlines(cinfo, count) == (JDIMENSION)count;
+#else
+    return skip_src_rows(cinfo, buffer, count);
+#endif
+}
+
+// Return the SkScaledBitmapSampler config for the output of libjpeg, and
+// the size of each of its pixels, or false if we can't handle it.
+static bool get_src_config(const jpeg_decompress_struct& cinfo,
+                           SkScaledBitmapSampler::SrcConfig* sc,
+                           int* srcBytesPerPixel) {
+    if (JCS_CMYK == cinfo.out_color_space) {
+        // In this case we will manually convert the CMYK values to RGB
+        *sc = SkScaledBitmapSampler::kRGBX;
+        *srcBytesPerPixel = 4;
+    } else if (3 == cinfo.out_color_components && JCS_RGB == cinfo.out_color_space) {
+        *sc = SkScaledBitmapSampler::kRGB;
+        *srcBytesPerPixel = 3;
+#ifdef ANDROID_RGB
+    } else if (JCS_RGBA_8888 == cinfo.out_color_space) {
+        *sc = SkScaledBitmapSampler::kRGBX;
+        *srcBytesPerPixel = 4;
+    } else if (JCS_RGB_565 == cinfo.out_color_space) {
+        *sc = SkScaledBitmapSampler::kRGB_565;
+        *srcBytesPerPixel = 2;
+#endif
+    } else if (1 == cinfo.out_color_components &&
+               JCS_GRAYSCALE == cinfo.out_color_space) {
+        *sc = SkScaledBitmapSampler::kGray;
+        *srcBytesPerPixel = 1;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/*  Set the decompression parameters shared by onDecode and onDecodeRegion, and
+    return the config we will decode into. Must be called after
+    jpeg_read_header().
+ */
+SkBitmap::Config SkJPEGImageDecoder::setupDecompress(jpeg_decompress_struct* cinfo,
+                                                     int sampleSize) const {
+    /*  Try to fulfill the requested sampleSize. libjpeg can scale by 1/2, 1/4
+        and 1/8 while it decodes (by computing fewer outputs of each DCT),
+        which is much faster than decoding every pixel and then sampling. So
+        have it scale by the largest of those that divides sampleSize, and
+        let SkScaledBitmapSampler make up the rest (see recompute_sampleSize).
+        Asking libjpeg for other ratios would have it round to the nearest
+        one it supports, and we would get back a different size than was
+        requested.
+    */
+    int denom = 1;
+    while (denom < 8 && 0 == sampleSize % (denom << 1)) {
+        denom <<= 1;
+    }
+    cinfo->dct_method = JDCT_IFAST;
+    cinfo->scale_num = 1;
+    cinfo->scale_denom = denom;
+
+    /* this gives about 30% performance improvement. In theory it may
+       reduce the visual quality, in practice I'm not seeing a difference
+     */
+    cinfo->do_fancy_upsampling = 0;
+
+    /* this gives another few percents */
+    cinfo->do_block_smoothing = 0;
+
+    /* default format is RGB */
+    if (cinfo->jpeg_color_space == JCS_CMYK) {
+        // libjpeg cannot convert from CMYK to RGB - here we set up
+        // so libjpeg will give us CMYK samples back and we will
+        // later manually convert them to RGB
+        cinfo->out_color_space = JCS_CMYK;
+    } else {
+        cinfo->out_color_space = JCS_RGB;
+    }
+
+    SkBitmap::Config config = this->getPrefConfig(k32Bit_SrcDepth, false);
+    // only these make sense for jpegs
+    if (config != SkBitmap::kARGB_8888_Config &&
+        config != SkBitmap::kARGB_4444_Config &&
+        config != SkBitmap::kRGB_565_Config) {
+        config = SkBitmap::kARGB_8888_Config;
+    }
+
+#ifdef ANDROID_RGB
+    cinfo->dither_mode = JDITHER_NONE;
+    if (SkBitmap::kARGB_8888_Config == config && JCS_CMYK != cinfo->out_color_space) {
+        cinfo->out_color_space = JCS_RGBA_8888;
+    } else if (SkBitmap::kRGB_565_Config == config && JCS_CMYK != cinfo->out_color_space) {
+        cinfo->out_color_space = JCS_RGB_565;
+        if (this->getDitherImage()) {
+            cinfo->dither_mode = JDITHER_ORDERED;
+        }
+    }
+#endif
+    return config;
+}
+
 bool SkJPEGImageDecoder::onDecode(SkStream* stream, SkBitmap* bm, Mode mode) {
 #ifdef TIME_DECODE
     AutoTimeMillis atm("JPEG Decode");
@@ -202,53 +331,8 @@ bool SkJPEGImageDecoder::onDecode(SkStream* stream, SkBitmap* bm, Mode mode) {
         return return_false(cinfo, *bm, "read_header");
     }
 
-    /*  Try to fulfill the requested sampleSize. Since jpeg can do it (when it
-        can) much faster that we, just use their num/denom api to approximate
-        the size.
-    */
     int sampleSize = this->getSampleSize();
-
-    cinfo.dct_method = JDCT_IFAST;
-    cinfo.scale_num = 1;
-    cinfo.scale_denom = sampleSize;
-
-    /* this gives about 30% performance improvement. In theory it may
-       reduce the visual quality, in practice I'm not seeing a difference
-     */
-    cinfo.do_fancy_upsampling = 0;
-
-    /* this gives another few percents */
-    cinfo.do_block_smoothing = 0;
-
-    /* default format is RGB */
-    if (cinfo.jpeg_color_space == JCS_CMYK) {
-        // libjpeg cannot convert from CMYK to RGB - here we set up
-        // so libjpeg will give us CMYK samples back and we will
-        // later manually convert them to RGB
-        cinfo.out_color_space = JCS_CMYK;
-    } else {
-        cinfo.out_color_space = JCS_RGB;
-    }
-
-    SkBitmap::Config config = this->getPrefConfig(k32Bit_SrcDepth, false);
-    // only these make sense for jpegs
-    if (config != SkBitmap::kARGB_8888_Config &&
-        config != SkBitmap::kARGB_4444_Config &&
-        config != SkBitmap::kRGB_565_Config) {
-        config = SkBitmap::kARGB_8888_Config;
-    }
-
-#ifdef ANDROID_RGB
-    cinfo.dither_mode = JDITHER_NONE;
-    if (SkBitmap::kARGB_8888_Config == config && JCS_CMYK != cinfo.out_color_space) {
-        cinfo.out_color_space = JCS_RGBA_8888;
-    } else if (SkBitmap::kRGB_565_Config == config && JCS_CMYK != cinfo.out_color_space) {
-        cinfo.out_color_space = JCS_RGB_565;
-        if (this->getDitherImage()) {
-            cinfo.dither_mode = JDITHER_ORDERED;
-        }
-    }
-#endif
+    SkBitmap::Config config = this->setupDecompress(&cinfo, sampleSize);
 
     if (sampleSize == 1 && mode == SkImageDecoder::kDecodeBounds_Mode) {
         bm->setConfig(config, cinfo.image_width, cinfo.image_height);
@@ -330,21 +414,8 @@ bool SkJPEGImageDecoder::onDecode(SkStream* stream, SkBitmap* bm, Mode mode) {
 
     // check for supported formats
     SkScaledBitmapSampler::SrcConfig sc;
-    if (JCS_CMYK == cinfo.out_color_space) {
-        // In this case we will manually convert the CMYK values to RGB
-        sc = SkScaledBitmapSampler::kRGBX;
-    } else if (3 == cinfo.out_color_components && JCS_RGB == cinfo.out_color_space) {
-        sc = SkScaledBitmapSampler::kRGB;
-#ifdef ANDROID_RGB
-    } else if (JCS_RGBA_8888 == cinfo.out_color_space) {
-        sc = SkScaledBitmapSampler::kRGBX;
-    } else if (JCS_RGB_565 == cinfo.out_color_space) {
-        sc = SkScaledBitmapSampler::kRGB_565;
-#endif
-    } else if (1 == cinfo.out_color_components &&
-               JCS_GRAYSCALE == cinfo.out_color_space) {
-        sc = SkScaledBitmapSampler::kGray;
-    } else {
+    int srcBytesPerPixel;
+    if (!get_src_config(cinfo, &sc, &srcBytesPerPixel)) {
         return return_false(cinfo, *bm, "jpeg colorspace");
     }
 
@@ -412,6 +483,172 @@ bool SkJPEGImageDecoder::onDecode(SkStream* stream, SkBitmap* bm, Mode mode) {
     return true;
 }
 
+bool SkJPEGImageDecoder::onBuildTileIndex(SkStream* stream, int* width,
+                                          int* height) {
+    JPEGAutoClean autoClean;
+
+    jpeg_decompress_struct  cinfo;
+    skjpeg_error_mgr        sk_err;
+    skjpeg_source_mgr       sk_stream(stream, this, false);
+
+    cinfo.err = jpeg_std_error(&sk_err);
+    sk_err.error_exit = skjpeg_error_exit;
+
+    // All objects need to be instantiated before this setjmp call so that
+    // they will be cleaned up properly if an error occurs.
+    if (setjmp(sk_err.fJmpBuf)) {
+        return false;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    autoClean.set(&cinfo);
+    cinfo.src = &sk_stream;
+
+    if (jpeg_read_header(&cinfo, true) != JPEG_HEADER_OK) {
+        return false;
+    }
+
+    SkRefCnt_SafeAssign(fIndexStream, stream);
+    fIndexWidth = cinfo.image_width;
+    fIndexHeight = cinfo.image_height;
+    *width = fIndexWidth;
+    *height = fIndexHeight;
+    return true;
+}
+
+bool SkJPEGImageDecoder::onDecodeRegion(SkBitmap* bm, const SkIRect& region,
+                                        int sampleSize) {
+#ifdef TIME_DECODE
+    AutoTimeMillis atm("JPEG Region Decode");
+#endif
+
+    if (NULL == fIndexStream) {
+        return false;
+    }
+    SkIRect rect = SkIRect::MakeWH(fIndexWidth, fIndexHeight);
+    if (!rect.intersect(region) || !fIndexStream->rewind()) {
+        return false;
+    }
+
+    SkAutoMalloc  srcStorage;
+    JPEGAutoClean autoClean;
+
+    jpeg_decompress_struct  cinfo;
+    skjpeg_error_mgr        sk_err;
+    skjpeg_source_mgr       sk_stream(fIndexStream, this, false);
+
+    cinfo.err = jpeg_std_error(&sk_err);
+    sk_err.error_exit = skjpeg_error_exit;
+
+    // All objects need to be instantiated before this setjmp call so that
+    // they will be cleaned up properly if an error occurs.
+    if (setjmp(sk_err.fJmpBuf)) {
+        return return_false(cinfo, *bm, "setjmp");
+    }
+
+    jpeg_create_decompress(&cinfo);
+    autoClean.set(&cinfo);
+
+#ifdef SK_BUILD_FOR_ANDROID
+    overwrite_mem_buffer_size(&cinfo);
+#endif
+
+    cinfo.src = &sk_stream;
+
+    if (jpeg_read_header(&cinfo, true) != JPEG_HEADER_OK) {
+        return return_false(cinfo, *bm, "read_header");
+    }
+    SkBitmap::Config config = this->setupDecompress(&cinfo, sampleSize);
+
+    if (!jpeg_start_decompress(&cinfo)) {
+        return return_false(cinfo, *bm, "start_decompress");
+    }
+
+    // jpeg may have already downsampled for us, so map our rect into its
+    // output, and only sample what remains.
+    const int outWidth = cinfo.output_width;
+    const int outHeight = cinfo.output_height;
+    int left = SkMulDiv(rect.fLeft, outWidth, fIndexWidth);
+    int top = SkMulDiv(rect.fTop, outHeight, fIndexHeight);
+    int right = SkMax32(SkMulDiv(rect.fRight, outWidth, fIndexWidth), left + 1);
+    int bottom = SkMax32(SkMulDiv(rect.fBottom, outHeight, fIndexHeight), top + 1);
+    SkASSERT(right <= outWidth && bottom <= outHeight);
+    sampleSize = recompute_sampleSize(sampleSize, cinfo);
+
+    SkScaledBitmapSampler::SrcConfig sc;
+    int srcBytesPerPixel;
+    if (!get_src_config(cinfo, &sc, &srcBytesPerPixel)) {
+        return return_false(cinfo, *bm, "jpeg colorspace");
+    }
+
+    const int regionWidth = right - left;
+    SkScaledBitmapSampler sampler(regionWidth, bottom - top, sampleSize);
+    if (!this->chooseFromOneChoice(config, sampler.scaledWidth(),
+                                   sampler.scaledHeight())) {
+        return return_false(cinfo, *bm, "chooseFromOneChoice");
+    }
+
+    bm->setConfig(config, sampler.scaledWidth(), sampler.scaledHeight());
+    // jpegs are always opaque (i.e. have no per-pixel alpha)
+    bm->setIsOpaque(true);
+
+    if (!this->allocPixelRef(bm, NULL)) {
+        return return_false(cinfo, *bm, "allocPixelRef");
+    }
+
+    SkAutoLockPixels alp(*bm);
+    if (!sampler.begin(bm, sc, this->getDitherImage())) {
+        return return_false(cinfo, *bm, "sampler.begin");
+    }
+
+#ifdef SK_JPEG_HAS_SKIP_SCANLINES
+    // Have libjpeg only hand us (roughly) the columns we need. It may widen
+    // the range to a whole iMCU, so our columns start at left - xoffset.
+    JDIMENSION xoffset = left;
+    JDIMENSION cropWidth = regionWidth;
+    jpeg_crop_scanline(&cinfo, &xoffset, &cropWidth);
+    left -= xoffset;
+#endif
+
+    // The CMYK work-around relies on 4 components per pixel here
+    uint8_t* srcRow = (uint8_t*)srcStorage.reset(cinfo.output_width * 4);
+    uint8_t* regionRow = srcRow + left * srcBytesPerPixel;
+
+    //  Skip down to the first row we sample
+    if (!skip_src_rows_fast(&cinfo, srcRow, top + sampler.srcY0())) {
+        return return_false(cinfo, *bm, "skip rows");
+    }
+
+    for (int y = 0;; y++) {
+        JSAMPLE* rowptr = (JSAMPLE*)srcRow;
+        int row_count = jpeg_read_scanlines(&cinfo, &rowptr, 1);
+        if (0 == row_count) {
+            return return_false(cinfo, *bm, "read_scanlines");
+        }
+        if (this->shouldCancelDecode()) {
+            return return_false(cinfo, *bm, "shouldCancelDecode");
+        }
+
+        if (JCS_CMYK == cinfo.out_color_space) {
+            convert_CMYK_to_RGB(regionRow, regionWidth);
+        }
+
+        sampler.next(regionRow);
+        if (bm->height() - 1 == y) {
+            // we're done
+            break;
+        }
+
+        if (!skip_src_rows_fast(&cinfo, srcRow, sampler.srcDY() - 1)) {
+            return return_false(cinfo, *bm, "skip rows");
+        }
+    }
+
+    // We don't need the rows below the region, so rather than decode them
+    // just to keep libjpeg from complaining, let autoClean throw them away.
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SkColorPriv.h"
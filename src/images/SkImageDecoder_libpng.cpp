@@ -13,6 +13,7 @@
 #include "SkColorPriv.h"
 #include "SkDither.h"
 #include "SkMath.h"
+#include "SkRect.h"
 #include "SkScaledBitmapSampler.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
@@ -25,12 +26,35 @@ extern "C" {
 
 class SkPNGImageDecoder : public SkImageDecoder {
 public:
+    SkPNGImageDecoder() : fIndexStream(NULL), fIndexWidth(0), fIndexHeight(0) {}
+    virtual ~SkPNGImageDecoder() {
+        SkSafeUnref(fIndexStream);
+    }
+
     virtual Format getFormat() const {
         return kPNG_Format;
     }
 
 protected:
     virtual bool onDecode(SkStream* stream, SkBitmap* bm, Mode);
+    virtual bool onBuildTileIndex(SkStream* stream, int* width, int* height);
+    virtual bool onDecodeRegion(SkBitmap* bm, const SkIRect& rect,
+                                int sampleSize);
+
+private:
+    // Create the png structs for the stream, and read up to the image data.
+    // On failure the structs are already destroyed.
+    bool onDecodeInit(SkStream* stream, png_structp* png_ptrp,
+                      png_infop* info_ptrp);
+    bool getBitmapConfig(png_structp png_ptr, png_infop info_ptr,
+                         SkBitmap::Config* config, bool* hasAlpha,
+                         bool* doDither, SkPMColor* theTranspColor);
+
+    // libpng cannot start decoding at an arbitrary row, so our index is just
+    // the (rewindable) stream, and the dimensions of the image.
+    SkStream*   fIndexStream;
+    int         fIndexWidth;
+    int         fIndexHeight;
 };
 
 #ifndef png_jmpbuf
@@ -128,10 +152,8 @@ static bool hasTransparencyInPalette(png_structp png_ptr, png_infop info_ptr) {
     return false;
 }
 
-bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
-                                 Mode mode) {
-//    SkAutoTrace    apr("SkPNGImageDecoder::onDecode");
-
+bool SkPNGImageDecoder::onDecodeInit(SkStream* sk_stream, png_structp* png_ptrp,
+                                     png_infop* info_ptrp) {
     /* Create and initialize the png_struct with the desired error handler
     * functions.  If you want to use the default stderr and longjump method,
     * you can supply NULL for the last three parameters.  We also supply the
@@ -143,21 +165,22 @@ bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
     if (png_ptr == NULL) {
         return false;
     }
+    *png_ptrp = png_ptr;
 
     /* Allocate/initialize the memory for image information. */
     png_infop info_ptr = png_create_info_struct(png_ptr);
     if (info_ptr == NULL) {
-        png_destroy_read_struct(&png_ptr, NULL, NULL);
+        png_destroy_read_struct(png_ptrp, NULL, NULL);
         return false;
     }
-
-    PNGAutoClean autoClean(png_ptr, info_ptr);
+    *info_ptrp = info_ptr;
 
     /* Set error handling if you are using the setjmp/longjmp method (this is
     * the normal method of doing things with libpng).  REQUIRED unless you
     * set up your own error handlers in the png_create_read_struct() earlier.
     */
     if (setjmp(png_jmpbuf(png_ptr))) {
+        png_destroy_read_struct(png_ptrp, info_ptrp, NULL);
         return false;
     }
 
@@ -202,15 +225,21 @@ bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
         color_type == PNG_COLOR_TYPE_GRAY_ALPHA) {
         png_set_gray_to_rgb(png_ptr);
     }
+    return true;
+}
 
-    SkBitmap::Config    config;
-    bool                hasAlpha = false;
-    bool                doDither = this->getDitherImage();
-    SkPMColor           theTranspColor = 0; // 0 tells us not to try to match
+bool SkPNGImageDecoder::getBitmapConfig(png_structp png_ptr, png_infop info_ptr,
+                                        SkBitmap::Config* configp,
+                                        bool* hasAlphap, bool* doDitherp,
+                                        SkPMColor* theTranspColorp) {
+    png_uint_32 origWidth, origHeight;
+    int bit_depth, color_type;
+    png_get_IHDR(png_ptr, info_ptr, &origWidth, &origHeight, &bit_depth,
+                 &color_type, NULL, NULL, NULL);
 
     // check for sBIT chunk data, in case we should disable dithering because
     // our data is not truely 8bits per component
-    if (doDither) {
+    if (*doDitherp) {
         png_color_8p sig_bit = NULL;
         bool has_sbit = PNG_INFO_sBIT == png_get_sBIT(png_ptr, info_ptr,
                                                       &sig_bit);
@@ -224,16 +253,16 @@ bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
         if (has_sbit && pos_le(sig_bit->red, SK_R16_BITS) &&
                 pos_le(sig_bit->green, SK_G16_BITS) &&
                 pos_le(sig_bit->blue, SK_B16_BITS)) {
-            doDither = false;
+            *doDitherp = false;
         }
     }
 
     if (color_type == PNG_COLOR_TYPE_PALETTE) {
         bool paletteHasAlpha = hasTransparencyInPalette(png_ptr, info_ptr);
-        config = this->getPrefConfig(kIndex_SrcDepth, paletteHasAlpha);
+        *configp = this->getPrefConfig(kIndex_SrcDepth, paletteHasAlpha);
         // now see if we can upscale to their requested config
-        if (!canUpscalePaletteToConfig(config, paletteHasAlpha)) {
-            config = SkBitmap::kIndex8_Config;
+        if (!canUpscalePaletteToConfig(*configp, paletteHasAlpha)) {
+            *configp = SkBitmap::kIndex8_Config;
         }
     } else {
         png_color_16p   transpColor = NULL;
@@ -253,18 +282,18 @@ bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
             */
             if (color_type & PNG_COLOR_MASK_COLOR) {
                 if (16 == bit_depth) {
-                    theTranspColor = SkPackARGB32(0xFF, transpColor->red >> 8,
+                    *theTranspColorp = SkPackARGB32(0xFF, transpColor->red >> 8,
                               transpColor->green >> 8, transpColor->blue >> 8);
                 } else {
-                    theTranspColor = SkPackARGB32(0xFF, transpColor->red,
+                    *theTranspColorp = SkPackARGB32(0xFF, transpColor->red,
                                       transpColor->green, transpColor->blue);
                 }
             } else {    // gray
                 if (16 == bit_depth) {
-                    theTranspColor = SkPackARGB32(0xFF, transpColor->gray >> 8,
+                    *theTranspColorp = SkPackARGB32(0xFF, transpColor->gray >> 8,
                               transpColor->gray >> 8, transpColor->gray >> 8);
                 } else {
-                    theTranspColor = SkPackARGB32(0xFF, transpColor->gray,
+                    *theTranspColorp = SkPackARGB32(0xFF, transpColor->gray,
                                           transpColor->gray, transpColor->gray);
                 }
             }
@@ -273,18 +302,18 @@ bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
         if (valid ||
                 PNG_COLOR_TYPE_RGB_ALPHA == color_type ||
                 PNG_COLOR_TYPE_GRAY_ALPHA == color_type) {
-            hasAlpha = true;
+            *hasAlphap = true;
         }
-        config = this->getPrefConfig(k32Bit_SrcDepth, hasAlpha);
+        *configp = this->getPrefConfig(k32Bit_SrcDepth, *hasAlphap);
         // now match the request against our capabilities
-        if (hasAlpha) {
-            if (config != SkBitmap::kARGB_4444_Config) {
-                config = SkBitmap::kARGB_8888_Config;
+        if (*hasAlphap) {
+            if (*configp != SkBitmap::kARGB_4444_Config) {
+                *configp = SkBitmap::kARGB_8888_Config;
             }
         } else {
-            if (config != SkBitmap::kRGB_565_Config &&
-                config != SkBitmap::kARGB_4444_Config) {
-                config = SkBitmap::kARGB_8888_Config;
+            if (*configp != SkBitmap::kRGB_565_Config &&
+                *configp != SkBitmap::kARGB_4444_Config) {
+                *configp = SkBitmap::kARGB_8888_Config;
             }
         }
     }
@@ -301,90 +330,70 @@ bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
             return false;
         }
     }
+    return true;
+}
 
-    if (!this->chooseFromOneChoice(config, origWidth, origHeight)) {
-        return false;
-    }
-
-    const int sampleSize = this->getSampleSize();
-    SkScaledBitmapSampler sampler(origWidth, origHeight, sampleSize);
-
-    decodedBitmap->setConfig(config, sampler.scaledWidth(),
-                             sampler.scaledHeight(), 0);
-    if (SkImageDecoder::kDecodeBounds_Mode == mode) {
-        return true;
-    }
-
-    // from here down we are concerned with colortables and pixels
-
-    // we track if we actually see a non-opaque pixels, since sometimes a PNG sets its colortype
-    // to |= PNG_COLOR_MASK_ALPHA, but all of its pixels are in fact opaque. We care, since we
-    // draw lots faster if we can flag the bitmap has being opaque
-    bool reallyHasAlpha = false;
-    SkColorTable* colorTable = NULL;
-
-    if (color_type == PNG_COLOR_TYPE_PALETTE) {
-        int num_palette;
-        png_colorp palette;
-        png_bytep trans;
-        int num_trans;
-
-        png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette);
-
-        /*  BUGGY IMAGE WORKAROUND
+// call only if color_type is PALETTE. Returns a new colortable for the
+// palette, setting hasAlpha and reallyHasAlpha to reflect its contents.
+static SkColorTable* decodePalette(png_structp png_ptr, png_infop info_ptr,
+                                   bool* hasAlphap, bool* reallyHasAlphap) {
+    int num_palette;
+    png_colorp palette;
+    png_bytep trans;
+    int num_trans;
 
-            We hit some images (e.g. fruit_.png) who contain bytes that are == colortable_count
-            which is a problem since we use the byte as an index. To work around this we grow
-            the colortable by 1 (if its < 256) and duplicate the last color into that slot.
-        */
-        int colorCount = num_palette + (num_palette < 256);
+    png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette);
 
-        colorTable = SkNEW_ARGS(SkColorTable, (colorCount));
+    /*  BUGGY IMAGE WORKAROUND
 
-        SkPMColor* colorPtr = colorTable->lockColors();
-        if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) {
-            png_get_tRNS(png_ptr, info_ptr, &trans, &num_trans, NULL);
-            hasAlpha = (num_trans > 0);
-        } else {
-            num_trans = 0;
-            colorTable->setFlags(colorTable->getFlags() | SkColorTable::kColorsAreOpaque_Flag);
-        }
-        // check for bad images that might make us crash
-        if (num_trans > num_palette) {
-            num_trans = num_palette;
-        }
+        We hit some images (e.g. fruit_.png) who contain bytes that are == colortable_count
+        which is a problem since we use the byte as an index. To work around this we grow
+        the colortable by 1 (if its < 256) and duplicate the last color into that slot.
+    */
+    int colorCount = num_palette + (num_palette < 256);
 
-        int index = 0;
-        int transLessThanFF = 0;
+    SkColorTable* colorTable = SkNEW_ARGS(SkColorTable, (colorCount));
 
-        for (; index < num_trans; index++) {
-            transLessThanFF |= (int)*trans - 0xFF;
-            *colorPtr++ = SkPreMultiplyARGB(*trans++, palette->red, palette->green, palette->blue);
-            palette++;
-        }
-        reallyHasAlpha |= (transLessThanFF < 0);
+    SkPMColor* colorPtr = colorTable->lockColors();
+    if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) {
+        png_get_tRNS(png_ptr, info_ptr, &trans, &num_trans, NULL);
+        *hasAlphap = (num_trans > 0);
+    } else {
+        num_trans = 0;
+        colorTable->setFlags(colorTable->getFlags() | SkColorTable::kColorsAreOpaque_Flag);
+    }
+    // check for bad images that might make us crash
+    if (num_trans > num_palette) {
+        num_trans = num_palette;
+    }
 
-        for (; index < num_palette; index++) {
-            *colorPtr++ = SkPackARGB32(0xFF, palette->red, palette->green, palette->blue);
-            palette++;
-        }
+    int index = 0;
+    int transLessThanFF = 0;
 
-        // see BUGGY IMAGE WORKAROUND comment above
-        if (num_palette < 256) {
-            *colorPtr = colorPtr[-1];
-        }
-        colorTable->unlockColors(true);
+    for (; index < num_trans; index++) {
+        transLessThanFF |= (int)*trans - 0xFF;
+        *colorPtr++ = SkPreMultiplyARGB(*trans++, palette->red, palette->green, palette->blue);
+        palette++;
     }
+    *reallyHasAlphap |= (transLessThanFF < 0);
 
-    SkAutoUnref aur(colorTable);
+    for (; index < num_palette; index++) {
+        *colorPtr++ = SkPackARGB32(0xFF, palette->red, palette->green, palette->blue);
+        palette++;
+    }
 
-    if (!this->allocPixelRef(decodedBitmap,
-                             SkBitmap::kIndex8_Config == config ?
-                                colorTable : NULL)) {
-        return false;
+    // see BUGGY IMAGE WORKAROUND comment above
+    if (num_palette < 256) {
+        *colorPtr = colorPtr[-1];
     }
+    colorTable->unlockColors(true);
+    return colorTable;
+}
 
-    SkAutoLockPixels alp(*decodedBitmap);
+// Set up the remaining transforms before we read any rows, and return the
+// number of passes we'll have to make over them.
+static int start_reading_rows(png_structp png_ptr, png_infop info_ptr) {
+    int color_type = png_get_color_type(png_ptr, info_ptr);
 
     /* swap the RGBA or GA data to ARGB or AG (or BGRA to ABGR) */
 //  if (color_type == PNG_COLOR_TYPE_RGB_ALPHA)
@@ -402,7 +411,7 @@ bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
     * png_read_image().  To see how to handle interlacing passes,
     * see the png_read_row() method below:
     */
-    const int number_passes = interlace_type != PNG_INTERLACE_NONE ?
+    const int number_passes = png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE ?
                         png_set_interlace_handling(png_ptr) : 1;
 
     /* Optional call to gamma correct and add the background to the palette
@@ -410,6 +419,78 @@ bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
     * update the palette for you (ie you selected such a transform above).
     */
     png_read_update_info(png_ptr, info_ptr);
+    return number_passes;
+}
+
+bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
+                                 Mode mode) {
+//    SkAutoTrace    apr("SkPNGImageDecoder::onDecode");
+
+    png_structp png_ptr;
+    png_infop info_ptr;
+
+    if (!this->onDecodeInit(sk_stream, &png_ptr, &info_ptr)) {
+        return false;
+    }
+
+    PNGAutoClean autoClean(png_ptr, info_ptr);
+
+    // onDecodeInit's jump buffer is gone now that it has returned
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        return false;
+    }
+
+    png_uint_32 origWidth, origHeight;
+    int bit_depth, color_type, interlace_type;
+    png_get_IHDR(png_ptr, info_ptr, &origWidth, &origHeight, &bit_depth, &color_type,
+        &interlace_type, NULL, NULL);
+
+    SkBitmap::Config    config;
+    bool                hasAlpha = false;
+    bool                doDither = this->getDitherImage();
+    SkPMColor           theTranspColor = 0; // 0 tells us not to try to match
+
+    if (!this->getBitmapConfig(png_ptr, info_ptr, &config, &hasAlpha,
+                               &doDither, &theTranspColor)) {
+        return false;
+    }
+
+    if (!this->chooseFromOneChoice(config, origWidth, origHeight)) {
+        return false;
+    }
+
+    const int sampleSize = this->getSampleSize();
+    SkScaledBitmapSampler sampler(origWidth, origHeight, sampleSize);
+
+    decodedBitmap->setConfig(config, sampler.scaledWidth(),
+                             sampler.scaledHeight(), 0);
+    if (SkImageDecoder::kDecodeBounds_Mode == mode) {
+        return true;
+    }
+
+    // from here down we are concerned with colortables and pixels
+
+    // we track if we actually see a non-opaque pixels, since sometimes a PNG sets its colortype
+    // to |= PNG_COLOR_MASK_ALPHA, but all of its pixels are in fact opaque. We care, since we
+    // draw lots faster if we can flag the bitmap has being opaque
+    bool reallyHasAlpha = false;
+    SkColorTable* colorTable = NULL;
+
+    if (color_type == PNG_COLOR_TYPE_PALETTE) {
+        colorTable = decodePalette(png_ptr, info_ptr, &hasAlpha, &reallyHasAlpha);
+    }
+
+    SkAutoUnref aur(colorTable);
+
+    if (!this->allocPixelRef(decodedBitmap,
+                             SkBitmap::kIndex8_Config == config ?
+                                colorTable : NULL)) {
+        return false;
+    }
+
+    SkAutoLockPixels alp(*decodedBitmap);
+
+    const int number_passes = start_reading_rows(png_ptr, info_ptr);
 
     if (SkBitmap::kIndex8_Config == config && 1 == sampleSize) {
         for (int i = 0; i < number_passes; i++) {
@@ -492,6 +573,179 @@ bool SkPNGImageDecoder::onDecode(SkStream* sk_stream, SkBitmap* decodedBitmap,
     return true;
 }
 
+bool SkPNGImageDecoder::onBuildTileIndex(SkStream* sk_stream, int* width,
+                                         int* height) {
+    png_structp png_ptr;
+    png_infop info_ptr;
+
+    if (!this->onDecodeInit(sk_stream, &png_ptr, &info_ptr)) {
+        return false;
+    }
+    PNGAutoClean autoClean(png_ptr, info_ptr);
+
+    // onDecodeInit's jump buffer is gone now that it has returned
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        return false;
+    }
+
+    png_uint_32 origWidth, origHeight;
+    png_get_IHDR(png_ptr, info_ptr, &origWidth, &origHeight, NULL, NULL,
+                 NULL, NULL, NULL);
+
+    SkRefCnt_SafeAssign(fIndexStream, sk_stream);
+    fIndexWidth = origWidth;
+    fIndexHeight = origHeight;
+    *width = fIndexWidth;
+    *height = fIndexHeight;
+    return true;
+}
+
+bool SkPNGImageDecoder::onDecodeRegion(SkBitmap* decodedBitmap,
+                                       const SkIRect& region, int sampleSize) {
+    if (NULL == fIndexStream) {
+        return false;
+    }
+    SkIRect rect = SkIRect::MakeWH(fIndexWidth, fIndexHeight);
+    if (!rect.intersect(region) || !fIndexStream->rewind()) {
+        return false;
+    }
+
+    png_structp png_ptr;
+    png_infop info_ptr;
+
+    if (!this->onDecodeInit(fIndexStream, &png_ptr, &info_ptr)) {
+        return false;
+    }
+
+    PNGAutoClean autoClean(png_ptr, info_ptr);
+
+    // onDecodeInit's jump buffer is gone now that it has returned
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        return false;
+    }
+
+    png_uint_32 origWidth, origHeight;
+    int bit_depth, color_type, interlace_type;
+    png_get_IHDR(png_ptr, info_ptr, &origWidth, &origHeight, &bit_depth, &color_type,
+        &interlace_type, NULL, NULL);
+
+    SkBitmap::Config    config;
+    bool                hasAlpha = false;
+    bool                doDither = this->getDitherImage();
+    SkPMColor           theTranspColor = 0; // 0 tells us not to try to match
+
+    if (!this->getBitmapConfig(png_ptr, info_ptr, &config, &hasAlpha,
+                               &doDither, &theTranspColor)) {
+        return false;
+    }
+
+    SkScaledBitmapSampler sampler(rect.width(), rect.height(), sampleSize);
+    if (!this->chooseFromOneChoice(config, sampler.scaledWidth(),
+                                   sampler.scaledHeight())) {
+        return false;
+    }
+
+    decodedBitmap->setConfig(config, sampler.scaledWidth(),
+                             sampler.scaledHeight(), 0);
+
+    bool reallyHasAlpha = false;
+    SkColorTable* colorTable = NULL;
+
+    if (color_type == PNG_COLOR_TYPE_PALETTE) {
+        colorTable = decodePalette(png_ptr, info_ptr, &hasAlpha, &reallyHasAlpha);
+    }
+
+    SkAutoUnref aur(colorTable);
+
+    if (!this->allocPixelRef(decodedBitmap,
+                             SkBitmap::kIndex8_Config == config ?
+                                colorTable : NULL)) {
+        return false;
+    }
+
+    SkAutoLockPixels alp(*decodedBitmap);
+
+    const int number_passes = start_reading_rows(png_ptr, info_ptr);
+
+    SkScaledBitmapSampler::SrcConfig sc;
+    int srcBytesPerPixel = 4;
+
+    if (colorTable != NULL) {
+        sc = SkScaledBitmapSampler::kIndex;
+        srcBytesPerPixel = 1;
+    } else if (hasAlpha) {
+        sc = SkScaledBitmapSampler::kRGBA;
+    } else {
+        sc = SkScaledBitmapSampler::kRGBX;
+    }
+
+    SkAutoLockColors ctLock(colorTable);
+    if (!sampler.begin(decodedBitmap, sc, doDither, ctLock.colors())) {
+        return false;
+    }
+    const int height = decodedBitmap->height();
+    const size_t rb = origWidth * srcBytesPerPixel;
+    const size_t regionOffset = rect.fLeft * srcBytesPerPixel;
+
+    if (number_passes > 1) {
+        // Every pass visits every row, so we have to read the whole image,
+        // but we only keep the part of each row inside the region. libpng
+        // reads each row into one full width scratch row, which only has the
+        // region's pixels from the earlier passes copied into it, since each
+        // pass only writes its own pixels.
+        const size_t regionRB = rect.width() * srcBytesPerPixel;
+        SkAutoMalloc storage(rect.height() * regionRB + rb);
+        uint8_t* base = (uint8_t*)storage.get();
+        uint8_t* scratch = base + rect.height() * regionRB;
+
+        for (int i = 0; i < number_passes; i++) {
+            for (png_uint_32 y = 0; y < origHeight; y++) {
+                if ((int)y < rect.fTop || (int)y >= rect.fBottom) {
+                    png_read_rows(png_ptr, &scratch, NULL, 1);
+                    continue;
+                }
+                uint8_t* regionRow = base + (y - rect.fTop) * regionRB;
+                memcpy(scratch + regionOffset, regionRow, regionRB);
+                png_read_rows(png_ptr, &scratch, NULL, 1);
+                memcpy(regionRow, scratch + regionOffset, regionRB);
+            }
+            if (this->shouldCancelDecode()) {
+                return false;
+            }
+        }
+        // now sample it
+        base += sampler.srcY0() * regionRB;
+        for (int y = 0; y < height; y++) {
+            reallyHasAlpha |= sampler.next(base);
+            base += sampler.srcDY() * regionRB;
+        }
+    } else {
+        SkAutoMalloc storage(rb);
+        uint8_t* srcRow = (uint8_t*)storage.get();
+        skip_src_rows(png_ptr, srcRow, rect.fTop + sampler.srcY0());
+
+        for (int y = 0; y < height; y++) {
+            uint8_t* tmp = srcRow;
+            png_read_rows(png_ptr, &tmp, NULL, 1);
+            reallyHasAlpha |= sampler.next(srcRow + regionOffset);
+            if (this->shouldCancelDecode()) {
+                return false;
+            }
+            if (y < height - 1) {
+                skip_src_rows(png_ptr, srcRow, sampler.srcDY() - 1);
+            }
+        }
+        // We don't need the rows below the region, so unlike onDecode we
+        // stop here rather than reading to the end of the file.
+    }
+
+    if (0 != theTranspColor) {
+        reallyHasAlpha |= substituteTranspColor(decodedBitmap, theTranspColor);
+    }
+    decodedBitmap->setIsOpaque(!reallyHasAlpha);
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SkColorPriv.h"
@@ -610,6 +864,14 @@ static inline int pack_palette(SkColorTable* ctable,
 class SkPNGImageEncoder : public SkImageEncoder {
 protected:
     virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality);
+
+    // Write the image data, and everything after it, once the chunks that
+    // come before the data have been written. bytesPerPixel is for the rows
+    // that proc produces.
+    virtual bool writeImage(png_structp png_ptr, png_infop info_ptr,
+                            SkWStream* stream, const SkBitmap& bitmap,
+                            transform_scanline_proc proc, int bytesPerPixel,
+                            int colorType);
 private:
     bool doEncode(SkWStream* stream, const SkBitmap& bm,
                   const bool& hasAlpha, int colorType,
@@ -740,10 +1002,28 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
     png_set_sBIT(png_ptr, info_ptr, &sig_bit);
     png_write_info(png_ptr, info_ptr);
 
+    int bytesPerPixel;
+    if (colorType & PNG_COLOR_MASK_PALETTE) {
+        bytesPerPixel = 1;
+    } else {
+        bytesPerPixel = (colorType & PNG_COLOR_MASK_ALPHA) ? 4 : 3;
+    }
+    bool success = this->writeImage(png_ptr, info_ptr, stream, bitmap,
+                                    choose_proc(config, hasAlpha),
+                                    bytesPerPixel, colorType);
+
+    /* clean up after the write, and free any memory allocated */
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+    return success;
+}
+
+bool SkPNGImageEncoder::writeImage(png_structp png_ptr, png_infop info_ptr,
+                                   SkWStream* stream, const SkBitmap& bitmap,
+                                   transform_scanline_proc proc,
+                                   int bytesPerPixel, int colorType) {
     const char* srcImage = (const char*)bitmap.getPixels();
     SkAutoSMalloc<1024> rowStorage(bitmap.width() << 2);
     char* storage = (char*)rowStorage.get();
-    transform_scanline_proc proc = choose_proc(config, hasAlpha);
 
     for (int y = 0; y < bitmap.height(); y++) {
         png_bytep row_ptr = (png_bytep)storage;
@@ -753,12 +1033,388 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
     }
 
     png_write_end(png_ptr, info_ptr);
-
-    /* clean up after the write, and free any memory allocated */
-    png_destroy_write_struct(&png_ptr, &info_ptr);
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkCountdown.h"
+#include "SkRunnable.h"
+#include "SkThreadPool.h"
+#include "zlib.h"
+
+namespace {
+
+// The filter types of PNG's adaptive filtering, which go in front of each
+// filtered row.
+enum {
+    kNone_Filter,
+    kSub_Filter,
+    kUp_Filter,
+    kAverage_Filter,
+    kPaeth_Filter,
+
+    kFilterCount
+};
+
+// deflate() can refer back this far, so this much of the filtered data before
+// a strip is all that is worth giving it as a dictionary.
+static const int kDeflateWindowSize = 32 * 1024;
+
+// Aim for strips of about this many bytes of filtered data.
+static const int kDefaultStripSize = 256 * 1024;
+
+static inline uint8_t paeth_predictor(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = SkAbs32(p - a);
+    int pb = SkAbs32(p - b);
+    int pc = SkAbs32(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return (pb <= pc) ? b : c;
+}
+
+static inline uint32_t signed_sum(const uint8_t* SK_RESTRICT bytes,
+                                  int count) {
+    uint32_t sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += (bytes[i] < 128) ? bytes[i] : 256 - bytes[i];
+    }
+    return sum;
+}
+
+/*  Filter one row of count bytes, with prior as the row above it (all zeros
+    for the first row), into dst, and return the sum of the filtered bytes as
+    signed values, which is what libpng minimizes to choose a filter. The
+    first bpp bytes have nothing to their left, which the filters treat as 0.
+*/
+static uint32_t filter_row(int filter, const uint8_t* SK_RESTRICT row,
+                           const uint8_t* SK_RESTRICT prior, int count,
+                           int bpp, uint8_t* SK_RESTRICT dst) {
+    int i;
+    switch (filter) {
+        case kSub_Filter:
+            memcpy(dst, row, bpp);
+            for (i = bpp; i < count; i++) {
+                dst[i] = row[i] - row[i - bpp];
+            }
+            break;
+        case kUp_Filter:
+            for (i = 0; i < count; i++) {
+                dst[i] = row[i] - prior[i];
+            }
+            break;
+        case kAverage_Filter:
+            for (i = 0; i < bpp; i++) {
+                dst[i] = row[i] - (prior[i] >> 1);
+            }
+            for (; i < count; i++) {
+                dst[i] = row[i] - ((row[i - bpp] + prior[i]) >> 1);
+            }
+            break;
+        case kPaeth_Filter:
+            // With nothing to the left, Paeth predicts the byte above.
+            for (i = 0; i < bpp; i++) {
+                dst[i] = row[i] - prior[i];
+            }
+            for (; i < count; i++) {
+                dst[i] = row[i] - paeth_predictor(row[i - bpp], prior[i],
+                                                  prior[i - bpp]);
+            }
+            break;
+        default:
+            memcpy(dst, row, count);
+            break;
+    }
+    return signed_sum(dst, count);
+}
+
+static void write_be32(uint8_t dst[4], uint32_t value) {
+    dst[0] = value >> 24;
+    dst[1] = value >> 16;
+    dst[2] = value >> 8;
+    dst[3] = value;
+}
+
+static bool write_chunk(SkWStream* stream, const char tag[4],
+                        const uint8_t* data, size_t length) {
+    uint8_t header[8];
+    write_be32(header, SkToU32(length));
+    memcpy(header + 4, tag, 4);
+    uLong crc = crc32(0L, (const Bytef*)tag, 4);
+    if (length > 0) {
+        crc = crc32(crc, data, length);
+    }
+    uint8_t trailer[4];
+    write_be32(trailer, crc);
+    return stream->write(header, sizeof(header)) &&
+           (0 == length || stream->write(data, length)) &&
+           stream->write(trailer, sizeof(trailer));
+}
+
+/**
+ *  Filters and deflates the rows [fTop, fBottom) of the image as one piece of
+ *  a zlib stream. Every strip but the last ends with a sync flush, which
+ *  leaves the stream byte aligned and unfinished, so the strips' output can
+ *  simply be concatenated. Each strip's deflate starts with the filtered data
+ *  before it as its dictionary, so it loses very little to the split.
+ */
+class PNGStrip : public SkRunnable {
+public:
+    PNGStrip()
+        : fAdler(0)
+        , fLength(0)
+        , fSuccess(false)
+        , fBitmap(NULL) {}
+
+    void init(const SkBitmap* bitmap, transform_scanline_proc proc,
+              int bytesPerPixel, bool filter, int zlibLevel, int top,
+              int bottom) {
+        fBitmap = bitmap;
+        fProc = proc;
+        fBytesPerPixel = bytesPerPixel;
+        fFilter = filter;
+        fZLibLevel = zlibLevel;
+        fTop = top;
+        fBottom = bottom;
+    }
+
+    virtual void run() SK_OVERRIDE {
+        const int rowBytes = fBitmap->width() * fBytesPerPixel;
+        // Room for the previous and current rows, and the filtered row (with
+        // its filter type) for each filter we try.
+        const int filterCount = fFilter ? kFilterCount : 1;
+        SkAutoMalloc storage(2 * rowBytes + filterCount * (rowBytes + 1));
+        fRows[0] = (uint8_t*)storage.get();
+        fRows[1] = fRows[0] + rowBytes;
+        fFiltered = fRows[1] + rowBytes;
+
+        int first = fTop;
+        if (fTop > 0) {
+            int dictRows = SkMin32(fTop, (kDeflateWindowSize + rowBytes) /
+                                         (rowBytes + 1));
+            first = fTop - dictRows;
+        }
+        // The row above the first one is all zeros by definition.
+        if (first > 0) {
+            this->transformRow(first - 1, fRows[0]);
+        } else {
+            memset(fRows[0], 0, rowBytes);
+        }
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (Z_OK != deflateInit2(&stream, fZLibLevel, Z_DEFLATED,
+                                 -MAX_WBITS, 8,
+                                 fFilter ? Z_FILTERED : Z_DEFAULT_STRATEGY)) {
+            return;
+        }
+
+        fSuccess = true;
+        if (first < fTop) {
+            SkAutoMalloc dict((fTop - first) * (rowBytes + 1));
+            uint8_t* dst = (uint8_t*)dict.get();
+            for (int y = first; y < fTop; y++) {
+                memcpy(dst, this->filterRow(y), rowBytes + 1);
+                dst += rowBytes + 1;
+            }
+            size_t dictSize = SkMin32(kDeflateWindowSize,
+                                      (fTop - first) * (rowBytes + 1));
+            fSuccess = Z_OK == deflateSetDictionary(&stream, dst - dictSize,
+                                                    dictSize);
+        }
+
+        fAdler = adler32(0L, NULL, 0);
+        for (int y = fTop; y < fBottom && fSuccess; y++) {
+            uint8_t* filtered = this->filterRow(y);
+            fAdler = adler32(fAdler, filtered, rowBytes + 1);
+            fLength += rowBytes + 1;
+            stream.next_in = filtered;
+            stream.avail_in = rowBytes + 1;
+            fSuccess = this->deflateTo(&stream, Z_NO_FLUSH);
+        }
+        if (fSuccess) {
+            bool last = fBitmap->height() == fBottom;
+            fSuccess = this->deflateTo(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        }
+        deflateEnd(&stream);
+    }
+
+    SkTDArray<uint8_t>  fCompressed;
+    uLong               fAdler;     // of the strip's filtered data
+    size_t              fLength;    // of the strip's filtered data
+    bool                fSuccess;
+
+private:
+    void transformRow(int y, uint8_t* dst) {
+        const char* src = (const char*)fBitmap->getPixels() +
+                          y * fBitmap->rowBytes();
+        fProc(src, fBitmap->width(), (char*)dst);
+    }
+
+    // Transform row y into fRows[1], which must follow the row above it in
+    // fRows[0], filter it, and leave it in fRows[0] for the next row.
+    uint8_t* filterRow(int y) {
+        const int rowBytes = fBitmap->width() * fBytesPerPixel;
+        this->transformRow(y, fRows[1]);
+
+        uint8_t* best = fFiltered;
+        if (fFilter) {
+            uint32_t bestSum = 0;
+            for (int filter = 0; filter < kFilterCount; filter++) {
+                uint8_t* dst = fFiltered + filter * (rowBytes + 1);
+                dst[0] = filter;
+                uint32_t sum = filter_row(filter, fRows[1], fRows[0], rowBytes,
+                                          fBytesPerPixel, dst + 1);
+                if (0 == filter || sum < bestSum) {
+                    best = dst;
+                    bestSum = sum;
+                }
+            }
+        } else {
+            best[0] = kNone_Filter;
+            memcpy(best + 1, fRows[1], rowBytes);
+        }
+
+        SkTSwap(fRows[0], fRows[1]);
+        return best;
+    }
+
+    // Compress all of stream's input into fCompressed.
+    bool deflateTo(z_stream* stream, int flush) {
+        static const int kChunkSize = 16 * 1024;
+        int result;
+        do {
+            int count = fCompressed.count();
+            stream->next_out = fCompressed.append(kChunkSize);
+            stream->avail_out = kChunkSize;
+            result = deflate(stream, flush);
+            fCompressed.setCount(count + kChunkSize - stream->avail_out);
+            if (Z_STREAM_ERROR == result) {
+                return false;
+            }
+        } while (0 == stream->avail_out ||
+                 (Z_FINISH == flush && Z_STREAM_END != result));
+        return true;
+    }
+
+    const SkBitmap*         fBitmap;
+    transform_scanline_proc fProc;
+    int                     fBytesPerPixel;
+    bool                    fFilter;
+    int                     fZLibLevel;
+    int                     fTop;
+    int                     fBottom;
+
+    uint8_t*                fRows[2];
+    uint8_t*                fFiltered;
+};
+
+}
+
+class SkParallelPNGImageEncoder : public SkPNGImageEncoder {
+public:
+    SkParallelPNGImageEncoder(SkThreadPool* pool, int zlibLevel,
+                              int stripHeight)
+        : fPool(pool)
+        , fZLibLevel(zlibLevel)
+        , fStripHeight(stripHeight) {}
+
+protected:
+    virtual bool writeImage(png_structp png_ptr, png_infop info_ptr,
+                            SkWStream* stream, const SkBitmap& bitmap,
+                            transform_scanline_proc proc, int bytesPerPixel,
+                            int colorType) SK_OVERRIDE;
+
+private:
+    SkThreadPool*   fPool;
+    int             fZLibLevel;
+    int             fStripHeight;
+
+    typedef SkPNGImageEncoder INHERITED;
+};
+
+bool SkParallelPNGImageEncoder::writeImage(png_structp png_ptr,
+                                           png_infop info_ptr,
+                                           SkWStream* stream,
+                                           const SkBitmap& bitmap,
+                                           transform_scanline_proc proc,
+                                           int bytesPerPixel, int colorType) {
+    // libpng is done once the header has been written; everything after it
+    // is written straight to the stream, so an error cannot longjmp past the
+    // strips' destructors.
+    const int height = bitmap.height();
+    const int filteredRowBytes = bitmap.width() * bytesPerPixel + 1;
+    int stripHeight = fStripHeight;
+    if (stripHeight <= 0) {
+        stripHeight = SkMax32(1, kDefaultStripSize / filteredRowBytes);
+    }
+    const int stripCount = (height + stripHeight - 1) / stripHeight;
+
+    // Like libpng, only filter the rows of images that are not palettized.
+    const bool filter = !(colorType & PNG_COLOR_MASK_PALETTE);
+
+    PNGStrip* strips = SkNEW_ARRAY(PNGStrip, stripCount);
+    SkAutoTDeleteArray<PNGStrip> ada(strips);
+    SkCountdown done(stripCount);
+    for (int i = 0; i < stripCount; i++) {
+        strips[i].init(&bitmap, proc, bytesPerPixel, filter, fZLibLevel,
+                       i * stripHeight, SkMin32(height, (i + 1) * stripHeight));
+        if (NULL != fPool) {
+            fPool->add(&strips[i], &done);
+        } else {
+            strips[i].run();
+        }
+    }
+    if (NULL != fPool) {
+        fPool->wait(&done);
+    }
+
+    // The zlib header: deflate with a 32K window, and a check value that
+    // makes it a multiple of 31.
+    int flevel;
+    if (fZLibLevel >= 0 && fZLibLevel < 2) {
+        flevel = 0;
+    } else if (fZLibLevel >= 2 && fZLibLevel < 6) {
+        flevel = 1;
+    } else if (fZLibLevel == 6 || fZLibLevel == Z_DEFAULT_COMPRESSION) {
+        flevel = 2;
+    } else {
+        flevel = 3;
+    }
+    uint8_t header[2];
+    header[0] = 0x78;
+    header[1] = flevel << 6;
+    header[1] += 31 - ((header[0] << 8) + header[1]) % 31;
+    if (!write_chunk(stream, "IDAT", header, sizeof(header))) {
+        return false;
+    }
+
+    uLong adler = adler32(0L, NULL, 0);
+    for (int i = 0; i < stripCount; i++) {
+        const PNGStrip& strip = strips[i];
+        if (!strip.fSuccess ||
+            !write_chunk(stream, "IDAT", strip.fCompressed.begin(),
+                         strip.fCompressed.count())) {
+            return false;
+        }
+        adler = adler32_combine(adler, strip.fAdler, strip.fLength);
+    }
+
+    uint8_t trailer[4];
+    write_be32(trailer, adler);
+    return write_chunk(stream, "IDAT", trailer, sizeof(trailer)) &&
+           write_chunk(stream, "IEND", NULL, 0);
+}
+
+SkImageEncoder* CreateParallelPNGImageEncoder(SkThreadPool* pool,
+                                              int zlibLevel,
+                                              int stripHeight) {
+    return SkNEW_ARGS(SkParallelPNGImageEncoder,
+                      (pool, SkPin32(zlibLevel, -1, 9), stripHeight));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 DEFINE_DECODER_CREATOR(PNGImageDecoder);
 DEFINE_ENCODER_CREATOR(PNGImageEncoder);
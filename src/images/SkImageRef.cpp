@@ -15,22 +15,34 @@
 
 //#define DUMP_IMAGEREF_LIFECYCLE
 
-// can't be static, as SkImageRef_Pool needs to see it
-SK_DECLARE_GLOBAL_MUTEX(gImageRefMutex);
+/*  Rather than sharing one global mutex, imagerefs take turns using a ring
+    of them, so that decoding one image does not block the others. They
+    can't use SkPixelRef's default mutexes, since we lock the pixelrefs we
+    decode into while holding ours.
+ */
+#define IMAGEREF_MUTEX_RING_COUNT   16
+
+static int32_t gImageRefMutexRingIndex;
+static SK_DECLARE_MUTEX_ARRAY(gImageRefMutexRing, IMAGEREF_MUTEX_RING_COUNT);
+
+static SkBaseMutex* get_imageref_mutex() {
+    int index = sk_atomic_inc(&gImageRefMutexRingIndex);
+    return &gImageRefMutexRing[index & (IMAGEREF_MUTEX_RING_COUNT - 1)];
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 
 SkImageRef::SkImageRef(SkStream* stream, SkBitmap::Config config,
                        int sampleSize)
-        : SkPixelRef(&gImageRefMutex), fErrorInDecoding(false) {
+        : SkPixelRef(get_imageref_mutex()), fErrorInDecoding(false) {
     SkASSERT(stream);
     stream->ref();
     fStream = stream;
     fConfig = config;
     fSampleSize = sampleSize;
     fDoDither = true;
-    fPrev = fNext = NULL;
     fFactory = NULL;
+    fSourceID = SkImageCache::NewSourceID();
 
 #ifdef DUMP_IMAGEREF_LIFECYCLE
     SkDebugf("add ImageRef %p [%d] data=%d\n",
@@ -39,8 +51,6 @@ SkImageRef::SkImageRef(SkStream* stream, SkBitmap::Config config,
 }
 
 SkImageRef::~SkImageRef() {
-    SkASSERT(&gImageRefMutex == this->mutex());
-
 #ifdef DUMP_IMAGEREF_LIFECYCLE
     SkDebugf("delete ImageRef %p [%d] data=%d\n",
               this, fConfig, (int)fStream->getLength());
@@ -51,7 +61,7 @@ SkImageRef::~SkImageRef() {
 }
 
 bool SkImageRef::getInfo(SkBitmap* bitmap) {
-    SkAutoMutexAcquire ac(gImageRefMutex);
+    SkAutoMutexAcquire ac(this->mutex());
 
     if (!this->prepareBitmap(SkImageDecoder::kDecodeBounds_Mode)) {
         return false;
@@ -89,8 +99,6 @@ bool SkImageRef::onDecode(SkImageDecoder* codec, SkStream* stream,
 }
 
 bool SkImageRef::prepareBitmap(SkImageDecoder::Mode mode) {
-    SkASSERT(&gImageRefMutex == this->mutex());
-
     if (fErrorInDecoding) {
         return false;
     }
@@ -144,8 +152,6 @@ bool SkImageRef::prepareBitmap(SkImageDecoder::Mode mode) {
 }
 
 void* SkImageRef::onLockPixels(SkColorTable** ct) {
-    SkASSERT(&gImageRefMutex == this->mutex());
-
     if (NULL == fBitmap.getPixels()) {
         (void)this->prepareBitmap(SkImageDecoder::kDecodePixels_Mode);
     }
@@ -158,25 +164,22 @@ void* SkImageRef::onLockPixels(SkColorTable** ct) {
 
 void SkImageRef::onUnlockPixels() {
     // we're already have the mutex locked
-    SkASSERT(&gImageRefMutex == this->mutex());
 }
 
-size_t SkImageRef::ramUsed() const {
-    size_t size = 0;
-
-    if (fBitmap.getPixels()) {
-        size = fBitmap.getSize();
-        if (fBitmap.getColorTable()) {
-            size += fBitmap.getColorTable()->count() * sizeof(SkPMColor);
-        }
-    }
-    return size;
+SkImageCache::Key SkImageRef::getCacheKey() const {
+    SkImageCache::Key key;
+    key.fSourceID = fSourceID;
+    key.fSampleSize = fSampleSize;
+    // once we have decoded (even just the bounds), use the config we got
+    key.fConfig = SkBitmap::kNo_Config != fBitmap.config() ? fBitmap.config()
+                                                           : fConfig;
+    return key;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 SkImageRef::SkImageRef(SkFlattenableReadBuffer& buffer)
-        : INHERITED(buffer, &gImageRefMutex), fErrorInDecoding(false) {
+        : INHERITED(buffer, get_imageref_mutex()), fErrorInDecoding(false) {
     fConfig = (SkBitmap::Config)buffer.readUInt();
     fSampleSize = buffer.readInt();
     fDoDither = buffer.readBool();
@@ -185,8 +188,8 @@ SkImageRef::SkImageRef(SkFlattenableReadBuffer& buffer)
     fStream = SkNEW_ARGS(SkMemoryStream, (length));
     buffer.readByteArray((void*)fStream->getMemoryBase());
 
-    fPrev = fNext = NULL;
     fFactory = NULL;
+    fSourceID = SkImageCache::NewSourceID();
 }
 
 void SkImageRef::flatten(SkFlattenableWriteBuffer& buffer) const {
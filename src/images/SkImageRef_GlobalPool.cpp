@@ -6,44 +6,37 @@
  * found in the LICENSE file.
  */
 #include "SkImageRef_GlobalPool.h"
-#include "SkImageRefPool.h"
-#include "SkThread.h"
-
-extern SkBaseMutex gImageRefMutex;
-
-/*
- *  This returns the lazily-allocated global pool. It must be called
- *  from inside the guard mutex, so we safely only ever allocate 1.
- */
-static SkImageRefPool* GetGlobalPool() {
-    static SkImageRefPool* gPool;
-    if (NULL == gPool) {
-        gPool = SkNEW(SkImageRefPool);
-        // call sk_atexit(...) when we have that, to free the global pool
-    }
-    return gPool;
-}
+#include "SkImageCache.h"
 
 SkImageRef_GlobalPool::SkImageRef_GlobalPool(SkStream* stream,
                                              SkBitmap::Config config,
                                              int sampleSize)
-        : SkImageRef(stream, config, sampleSize) {
-    this->mutex()->acquire();
-    GetGlobalPool()->addToHead(this);
-    this->mutex()->release();
+        : SkImageRef(stream, config, sampleSize)
+        , fPinned(false) {
 }
 
 SkImageRef_GlobalPool::~SkImageRef_GlobalPool() {
-    this->mutex()->acquire();
-    GetGlobalPool()->detach(this);
-    this->mutex()->release();
+    // Don't leave our pixels in the cache, unless another imageref sharing
+    // our source ID has them pinned; then the cache evicts them as usual.
+    (void)SkImageCache::GetGlobal()->removeIfUnpinned(this->getCacheKey());
 }
 
-/*  By design, onUnlockPixels() already is inside the mutex-lock,
- *  and it is the (indirect) caller of onDecode(), therefore we can assume
- *  that we also are already inside the mutex. Hence, we can reference
- *  the global-pool directly.
+/*  By design, onLockPixels() and onUnlockPixels() are called with the mutex
+ *  held, and onLockPixels() is the (indirect) caller of onDecode(), so we
+ *  are also inside the mutex there.
  */
+void* SkImageRef_GlobalPool::onLockPixels(SkColorTable** ct) {
+    if (NULL == fBitmap.getPixels()) {
+        SkBitmap cached;
+        if (SkImageCache::GetGlobal()->find(this->getCacheKey(), &cached, true)) {
+            fBitmap.swap(cached);
+            fBitmap.lockPixels();
+            fPinned = true;
+        }
+    }
+    return this->INHERITED::onLockPixels(ct);
+}
+
 bool SkImageRef_GlobalPool::onDecode(SkImageDecoder* codec, SkStream* stream,
                                      SkBitmap* bitmap, SkBitmap::Config config,
                                      SkImageDecoder::Mode mode) {
@@ -51,8 +44,9 @@ bool SkImageRef_GlobalPool::onDecode(SkImageDecoder* codec, SkStream* stream,
         return false;
     }
     if (mode == SkImageDecoder::kDecodePixels_Mode) {
-        // no need to grab the mutex here, it has already been acquired.
-        GetGlobalPool()->justAddedPixels(this);
+        SkASSERT(&fBitmap == bitmap);
+        SkImageCache::GetGlobal()->add(this->getCacheKey(), bitmap, true);
+        fPinned = true;
     }
     return true;
 }
@@ -60,41 +54,39 @@ bool SkImageRef_GlobalPool::onDecode(SkImageDecoder* codec, SkStream* stream,
 void SkImageRef_GlobalPool::onUnlockPixels() {
     this->INHERITED::onUnlockPixels();
 
-    // by design, onUnlockPixels() already is inside the mutex-lock
-    GetGlobalPool()->canLosePixels(this);
+    if (fPinned) {
+        SkImageCache::GetGlobal()->unpin(this->getCacheKey());
+        fPinned = false;
+        // Let the cache decide when to free the pixels. Keep the config,
+        // so that we still know our size.
+        fBitmap.setPixels(NULL);
+    }
 }
 
 SkImageRef_GlobalPool::SkImageRef_GlobalPool(SkFlattenableReadBuffer& buffer)
-        : INHERITED(buffer) {
-    this->mutex()->acquire();
-    GetGlobalPool()->addToHead(this);
-    this->mutex()->release();
+        : INHERITED(buffer)
+        , fPinned(false) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 // global imagerefpool wrappers
 
 size_t SkImageRef_GlobalPool::GetRAMBudget() {
-    SkAutoMutexAcquire ac(gImageRefMutex);
-    return GetGlobalPool()->getRAMBudget();
+    return SkImageCache::GetGlobal()->getByteLimit();
 }
 
 void SkImageRef_GlobalPool::SetRAMBudget(size_t size) {
-    SkAutoMutexAcquire ac(gImageRefMutex);
-    GetGlobalPool()->setRAMBudget(size);
+    SkImageCache::GetGlobal()->setByteLimit(size);
 }
 
 size_t SkImageRef_GlobalPool::GetRAMUsed() {
-    SkAutoMutexAcquire ac(gImageRefMutex);
-    return GetGlobalPool()->getRAMUsed();
+    return SkImageCache::GetGlobal()->getBytesUsed();
 }
 
 void SkImageRef_GlobalPool::SetRAMUsed(size_t usage) {
-    SkAutoMutexAcquire ac(gImageRefMutex);
-    GetGlobalPool()->setRAMUsed(usage);
+    SkImageCache::GetGlobal()->purgeTo(usage);
 }
 
 void SkImageRef_GlobalPool::DumpPool() {
-    SkAutoMutexAcquire ac(gImageRefMutex);
-    GetGlobalPool()->dump();
+    SkImageCache::GetGlobal()->dump();
 }
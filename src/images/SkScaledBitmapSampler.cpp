@@ -11,6 +11,7 @@
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
 #include "SkDither.h"
+#include "SkSampleRowProcs.h"
 
 // 8888
 
@@ -29,7 +30,21 @@ static bool Sample_RGBx_D8888(void* SK_RESTRICT dstRow,
                               const uint8_t* SK_RESTRICT src,
                               int width, int deltaSrc, int, const SkPMColor[]) {
     SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
-    for (int x = 0; x < width; x++) {
+    int x = 0;
+    // Rows that are not sampled in X are packed, so they can be converted
+    // many pixels at a time.
+    if (3 == deltaSrc || 4 == deltaSrc) {
+        static const SkSampleRowProc gRGBProc =
+                SkSampleRGBToD8888GetPlatformProc();
+        static const SkSampleRowProc gRGBXProc =
+                SkSampleRGBXToD8888GetPlatformProc();
+        SkSampleRowProc proc = (3 == deltaSrc) ? gRGBProc : gRGBXProc;
+        if (proc) {
+            x = proc(dst, src, width);
+            src += x * deltaSrc;
+        }
+    }
+    for (; x < width; x++) {
         dst[x] = SkPackARGB32(0xFF, src[0], src[1], src[2]);
         src += deltaSrc;
     }
@@ -79,7 +94,15 @@ static bool Sample_RGBx_D565(void* SK_RESTRICT dstRow,
                              const uint8_t* SK_RESTRICT src,
                              int width, int deltaSrc, int, const SkPMColor[]) {
     uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
-    for (int x = 0; x < width; x++) {
+    int x = 0;
+    if (3 == deltaSrc) {
+        static const SkSampleRowProc gProc = SkSampleRGBToD565GetPlatformProc();
+        if (gProc) {
+            x = gProc(dst, src, width);
+            src += x * deltaSrc;
+        }
+    }
+    for (; x < width; x++) {
         dst[x] = SkPack888ToRGB16(src[0], src[1], src[2]);
         src += deltaSrc;
     }
@@ -9,6 +9,7 @@
 
 #include <emmintrin.h>
 #include "SkBitmapProcState_opts_SSE2.h"
+#include "SkColorPriv.h"
 #include "SkUtils.h"
 
 void S32_opaque_D32_filter_DX_SSE2(const SkBitmapProcState& s,
@@ -763,3 +764,442 @@ void S32_D16_filter_DX_SSE2(const SkBitmapProcState& s,
 
     } while (--count > 0);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+//  565 and A8 sources
+//
+//  These work on 8 pixels at a time, with each color component in its own
+//  vector of 16 bit lanes. They use the same integer math as the portable
+//  procs in SkBitmapProcState_procs.h, so their results are identical.
+
+namespace {
+
+// The four samples, and the subpixel x and y, of up to 8 filtered pixels.
+template <typename T> struct FilterSamples {
+    T           fA00[8], fA01[8], fA10[8], fA11[8];
+    uint16_t    fSubX[8], fSubY[8];
+
+    // Lanes past the last pixel are left as they are, but must be initialized.
+    FilterSamples() {
+        sk_bzero(this, sizeof(*this));
+    }
+};
+
+}  // namespace
+
+// Gather n pixels from the xy buffer of a filter_DX proc, after its row
+// pointers have been set up. Returns the advanced xy.
+template <typename T>
+static const uint32_t* gather_filter_DX(const T* row0, const T* row1,
+                                        unsigned subY, const uint32_t* xy,
+                                        int n, FilterSamples<T>* samples) {
+    for (int i = 0; i < n; i++) {
+        uint32_t XX = *xy++;    // x0:14 | 4 | x1:14
+        unsigned x0 = XX >> 18;
+        unsigned x1 = XX & 0x3FFF;
+        samples->fA00[i] = row0[x0];
+        samples->fA01[i] = row0[x1];
+        samples->fA10[i] = row1[x0];
+        samples->fA11[i] = row1[x1];
+        samples->fSubX[i] = (XX >> 14) & 0xF;
+        samples->fSubY[i] = subY;
+    }
+    return xy;
+}
+
+// Gather n pixels from the xy buffer of a filter_DXDY proc. Returns the
+// advanced xy.
+template <typename T>
+static const uint32_t* gather_filter_DXDY(const char* srcAddr, unsigned rb,
+                                          const uint32_t* xy, int n,
+                                          FilterSamples<T>* samples) {
+    for (int i = 0; i < n; i++) {
+        uint32_t YY = *xy++;    // y0:14 | 4 | y1:14
+        uint32_t XX = *xy++;    // x0:14 | 4 | x1:14
+        const T* row0 = reinterpret_cast<const T*>(srcAddr + (YY >> 18) * rb);
+        const T* row1 = reinterpret_cast<const T*>(srcAddr + (YY & 0x3FFF) * rb);
+        unsigned x0 = XX >> 18;
+        unsigned x1 = XX & 0x3FFF;
+        samples->fA00[i] = row0[x0];
+        samples->fA01[i] = row0[x1];
+        samples->fA10[i] = row1[x0];
+        samples->fA11[i] = row1[x1];
+        samples->fSubX[i] = (XX >> 14) & 0xF;
+        samples->fSubY[i] = (YY >> 14) & 0xF;
+    }
+    return xy;
+}
+
+static inline __m128i load_8(const uint16_t* values) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+}
+
+static inline __m128i load_8(const uint8_t* values) {
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(values));
+    return _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+}
+
+// (c * scale) >> 8 in each lane, for c <= 255 and scale <= 256.
+static inline __m128i scale_8(__m128i c, __m128i scale) {
+    return _mm_srli_epi16(_mm_mullo_epi16(c, scale), 8);
+}
+
+static inline __m128i pack_component(__m128i c, int shift) {
+    return _mm_slli_epi32(c, shift);
+}
+
+// Store count (at most 8) SkPMColors, from a vector of 16 bit lanes for each
+// component.
+static inline void store_8(__m128i a, __m128i r, __m128i g, __m128i b,
+                           uint32_t* colors, int count) {
+    __m128i zero = _mm_setzero_si128();
+
+    __m128i lo = _mm_or_si128(
+        _mm_or_si128(pack_component(_mm_unpacklo_epi16(a, zero), SK_A32_SHIFT),
+                     pack_component(_mm_unpacklo_epi16(r, zero), SK_R32_SHIFT)),
+        _mm_or_si128(pack_component(_mm_unpacklo_epi16(g, zero), SK_G32_SHIFT),
+                     pack_component(_mm_unpacklo_epi16(b, zero), SK_B32_SHIFT)));
+    __m128i hi = _mm_or_si128(
+        _mm_or_si128(pack_component(_mm_unpackhi_epi16(a, zero), SK_A32_SHIFT),
+                     pack_component(_mm_unpackhi_epi16(r, zero), SK_R32_SHIFT)),
+        _mm_or_si128(pack_component(_mm_unpackhi_epi16(g, zero), SK_G32_SHIFT),
+                     pack_component(_mm_unpackhi_epi16(b, zero), SK_B32_SHIFT)));
+
+    if (8 == count) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(colors), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(colors + 4), hi);
+    } else {
+        uint32_t tmp[8];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(tmp), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(tmp + 4), hi);
+        memcpy(colors, tmp, count * sizeof(uint32_t));
+    }
+}
+
+// Split 8 565 pixels into their 5, 6 and 5 bit components.
+static inline void unpack_565(__m128i c, __m128i* r, __m128i* g, __m128i* b) {
+    *r = _mm_and_si128(_mm_srli_epi16(c, SK_R16_SHIFT), _mm_set1_epi16(SK_R16_MASK));
+    *g = _mm_and_si128(_mm_srli_epi16(c, SK_G16_SHIFT), _mm_set1_epi16(SK_G16_MASK));
+    *b = _mm_and_si128(_mm_srli_epi16(c, SK_B16_SHIFT), _mm_set1_epi16(SK_B16_MASK));
+}
+
+/*  Filter 8 565 pixels as Filter_565_Expanded() and
+    SkExpanded_565_To_PMColor() do: each component is weighted in 5 bits (the
+    weights add up to 32), and then shifted down to 8 bits.
+ */
+static void filter_565_8(const FilterSamples<uint16_t>& samples,
+                         __m128i* r, __m128i* g, __m128i* b) {
+    __m128i x = load_8(samples.fSubX);
+    __m128i y = load_8(samples.fSubY);
+    __m128i xy = _mm_srli_epi16(_mm_mullo_epi16(x, y), 3);
+    __m128i x2 = _mm_slli_epi16(x, 1);
+    __m128i y2 = _mm_slli_epi16(y, 1);
+
+    // 32 - 2y - 2x + xy, 2x - xy, 2y - xy, xy
+    __m128i w00 = _mm_add_epi16(_mm_sub_epi16(_mm_sub_epi16(_mm_set1_epi16(32), y2), x2), xy);
+    __m128i w01 = _mm_sub_epi16(x2, xy);
+    __m128i w10 = _mm_sub_epi16(y2, xy);
+    __m128i w11 = xy;
+
+    __m128i cr, cg, cb;
+    unpack_565(load_8(samples.fA00), &cr, &cg, &cb);
+    __m128i sr = _mm_mullo_epi16(cr, w00);
+    __m128i sg = _mm_mullo_epi16(cg, w00);
+    __m128i sb = _mm_mullo_epi16(cb, w00);
+
+    unpack_565(load_8(samples.fA01), &cr, &cg, &cb);
+    sr = _mm_add_epi16(sr, _mm_mullo_epi16(cr, w01));
+    sg = _mm_add_epi16(sg, _mm_mullo_epi16(cg, w01));
+    sb = _mm_add_epi16(sb, _mm_mullo_epi16(cb, w01));
+
+    unpack_565(load_8(samples.fA10), &cr, &cg, &cb);
+    sr = _mm_add_epi16(sr, _mm_mullo_epi16(cr, w10));
+    sg = _mm_add_epi16(sg, _mm_mullo_epi16(cg, w10));
+    sb = _mm_add_epi16(sb, _mm_mullo_epi16(cb, w10));
+
+    unpack_565(load_8(samples.fA11), &cr, &cg, &cb);
+    sr = _mm_add_epi16(sr, _mm_mullo_epi16(cr, w11));
+    sg = _mm_add_epi16(sg, _mm_mullo_epi16(cg, w11));
+    sb = _mm_add_epi16(sb, _mm_mullo_epi16(cb, w11));
+
+    *r = _mm_srli_epi16(sr, 2);
+    *g = _mm_srli_epi16(sg, 3);
+    *b = _mm_srli_epi16(sb, 2);
+}
+
+/*  Filter 8 A8 pixels as Filter_8() does: the weights add up to 256, so the
+    sum fits in 16 bits.
+ */
+static __m128i filter_A8_8(const FilterSamples<uint8_t>& samples) {
+    __m128i x = load_8(samples.fSubX);
+    __m128i y = load_8(samples.fSubY);
+    __m128i xy = _mm_mullo_epi16(x, y);
+    __m128i x16 = _mm_slli_epi16(x, 4);
+    __m128i y16 = _mm_slli_epi16(y, 4);
+
+    // 256 - 16y - 16x + xy, 16x - xy, 16y - xy, xy
+    __m128i w00 = _mm_add_epi16(_mm_sub_epi16(_mm_sub_epi16(_mm_set1_epi16(256), y16), x16), xy);
+    __m128i w01 = _mm_sub_epi16(x16, xy);
+    __m128i w10 = _mm_sub_epi16(y16, xy);
+    __m128i w11 = xy;
+
+    __m128i sum = _mm_mullo_epi16(load_8(samples.fA00), w00);
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(load_8(samples.fA01), w01));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(load_8(samples.fA10), w10));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(load_8(samples.fA11), w11));
+    return _mm_srli_epi16(sum, 8);
+}
+
+// Store the paint color scaled by SkAlpha255To256() of each lane of alpha.
+static inline void store_A8_8(SkPMColor pmColor, __m128i alpha,
+                              uint32_t* colors, int count) {
+    __m128i scale = _mm_add_epi16(alpha, _mm_set1_epi16(1));
+    store_8(scale_8(_mm_set1_epi16(SkGetPackedA32(pmColor)), scale),
+            scale_8(_mm_set1_epi16(SkGetPackedR32(pmColor)), scale),
+            scale_8(_mm_set1_epi16(SkGetPackedG32(pmColor)), scale),
+            scale_8(_mm_set1_epi16(SkGetPackedB32(pmColor)), scale),
+            colors, count);
+}
+
+// Store filtered 565 pixels, scaled by alphaScale unless that is 256.
+static inline void store_565_8(__m128i r, __m128i g, __m128i b,
+                               unsigned alphaScale, uint32_t* colors,
+                               int count) {
+    __m128i a = _mm_set1_epi16(0xFF);
+    if (alphaScale < 256) {
+        __m128i scale = _mm_set1_epi16(alphaScale);
+        a = scale_8(a, scale);
+        r = scale_8(r, scale);
+        g = scale_8(g, scale);
+        b = scale_8(b, scale);
+    }
+    store_8(a, r, g, b, colors, count);
+}
+
+static void S16_D32_filter_DX_SSE2(const SkBitmapProcState& s,
+                                   const uint32_t* xy,
+                                   int count, uint32_t* colors) {
+    const char* srcAddr = static_cast<const char*>(s.fBitmap->getPixels());
+    unsigned rb = s.fBitmap->rowBytes();
+    uint32_t XY = *xy++;
+    unsigned y0 = XY >> 14;
+    const uint16_t* row0 = reinterpret_cast<const uint16_t*>(srcAddr + (y0 >> 4) * rb);
+    const uint16_t* row1 = reinterpret_cast<const uint16_t*>(srcAddr + (XY & 0x3FFF) * rb);
+    unsigned subY = y0 & 0xF;
+
+    FilterSamples<uint16_t> samples;
+    while (count > 0) {
+        int n = SkMin32(count, 8);
+        xy = gather_filter_DX(row0, row1, subY, xy, n, &samples);
+
+        __m128i r, g, b;
+        filter_565_8(samples, &r, &g, &b);
+        store_565_8(r, g, b, s.fAlphaScale, colors, n);
+        colors += n;
+        count -= n;
+    }
+}
+
+static void S16_D32_filter_DXDY_SSE2(const SkBitmapProcState& s,
+                                     const uint32_t* xy,
+                                     int count, uint32_t* colors) {
+    const char* srcAddr = static_cast<const char*>(s.fBitmap->getPixels());
+    unsigned rb = s.fBitmap->rowBytes();
+
+    FilterSamples<uint16_t> samples;
+    while (count > 0) {
+        int n = SkMin32(count, 8);
+        xy = gather_filter_DXDY(srcAddr, rb, xy, n, &samples);
+
+        __m128i r, g, b;
+        filter_565_8(samples, &r, &g, &b);
+        store_565_8(r, g, b, s.fAlphaScale, colors, n);
+        colors += n;
+        count -= n;
+    }
+}
+
+static void S16_D32_nofilter_DX_SSE2(const SkBitmapProcState& s,
+                                     const uint32_t* xy,
+                                     int count, uint32_t* colors) {
+    const uint16_t* srcAddr = static_cast<const uint16_t*>(s.fBitmap->getPixels());
+
+    // buffer is y32, x16, x16, x16, x16, x16
+    // bump srcAddr to the proper row, since we're told Y never changes
+    SkASSERT((unsigned)xy[0] < (unsigned)s.fBitmap->height());
+    srcAddr = reinterpret_cast<const uint16_t*>(
+                reinterpret_cast<const char*>(srcAddr) + xy[0] * s.fBitmap->rowBytes());
+    const uint16_t* xx = reinterpret_cast<const uint16_t*>(xy + 1);
+
+    if (1 == s.fBitmap->width()) {
+        SkPMColor color = SkPixel16ToPixel32(srcAddr[0]);
+        if (s.fAlphaScale < 256) {
+            color = SkAlphaMulQ(color, s.fAlphaScale);
+        }
+        sk_memset32(colors, color, count);
+        return;
+    }
+
+    uint16_t src[8] = { 0 };
+    while (count > 0) {
+        int n = SkMin32(count, 8);
+        for (int i = 0; i < n; i++) {
+            SkASSERT(xx[i] < (unsigned)s.fBitmap->width());
+            src[i] = srcAddr[xx[i]];
+        }
+        xx += n;
+
+        // widen each component to 8 bits, as SkPixel16ToPixel32() does
+        __m128i r, g, b;
+        unpack_565(load_8(src), &r, &g, &b);
+        r = _mm_or_si128(_mm_slli_epi16(r, 8 - SK_R16_BITS), _mm_srli_epi16(r, 2 * SK_R16_BITS - 8));
+        g = _mm_or_si128(_mm_slli_epi16(g, 8 - SK_G16_BITS), _mm_srli_epi16(g, 2 * SK_G16_BITS - 8));
+        b = _mm_or_si128(_mm_slli_epi16(b, 8 - SK_B16_BITS), _mm_srli_epi16(b, 2 * SK_B16_BITS - 8));
+        store_565_8(r, g, b, s.fAlphaScale, colors, n);
+        colors += n;
+        count -= n;
+    }
+}
+
+void S16_opaque_D32_filter_DX_SSE2(const SkBitmapProcState& s,
+                                   const uint32_t* xy,
+                                   int count, uint32_t* colors) {
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fDoFilter);
+    SkASSERT(s.fBitmap->config() == SkBitmap::kRGB_565_Config);
+    SkASSERT(s.fAlphaScale == 256);
+    S16_D32_filter_DX_SSE2(s, xy, count, colors);
+}
+
+void S16_alpha_D32_filter_DX_SSE2(const SkBitmapProcState& s,
+                                  const uint32_t* xy,
+                                  int count, uint32_t* colors) {
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fDoFilter);
+    SkASSERT(s.fBitmap->config() == SkBitmap::kRGB_565_Config);
+    SkASSERT(s.fAlphaScale < 256);
+    S16_D32_filter_DX_SSE2(s, xy, count, colors);
+}
+
+void S16_opaque_D32_filter_DXDY_SSE2(const SkBitmapProcState& s,
+                                     const uint32_t* xy,
+                                     int count, uint32_t* colors) {
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fDoFilter);
+    SkASSERT(s.fBitmap->config() == SkBitmap::kRGB_565_Config);
+    SkASSERT(s.fAlphaScale == 256);
+    S16_D32_filter_DXDY_SSE2(s, xy, count, colors);
+}
+
+void S16_alpha_D32_filter_DXDY_SSE2(const SkBitmapProcState& s,
+                                    const uint32_t* xy,
+                                    int count, uint32_t* colors) {
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fDoFilter);
+    SkASSERT(s.fBitmap->config() == SkBitmap::kRGB_565_Config);
+    SkASSERT(s.fAlphaScale < 256);
+    S16_D32_filter_DXDY_SSE2(s, xy, count, colors);
+}
+
+void S16_opaque_D32_nofilter_DX_SSE2(const SkBitmapProcState& s,
+                                     const uint32_t* xy,
+                                     int count, uint32_t* colors) {
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fInvType <= (SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask));
+    SkASSERT(!s.fDoFilter);
+    SkASSERT(s.fBitmap->config() == SkBitmap::kRGB_565_Config);
+    SkASSERT(s.fAlphaScale == 256);
+    S16_D32_nofilter_DX_SSE2(s, xy, count, colors);
+}
+
+void S16_alpha_D32_nofilter_DX_SSE2(const SkBitmapProcState& s,
+                                    const uint32_t* xy,
+                                    int count, uint32_t* colors) {
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fInvType <= (SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask));
+    SkASSERT(!s.fDoFilter);
+    SkASSERT(s.fBitmap->config() == SkBitmap::kRGB_565_Config);
+    SkASSERT(s.fAlphaScale < 256);
+    S16_D32_nofilter_DX_SSE2(s, xy, count, colors);
+}
+
+void SA8_alpha_D32_filter_DX_SSE2(const SkBitmapProcState& s,
+                                  const uint32_t* xy,
+                                  int count, uint32_t* colors) {
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fDoFilter);
+    SkASSERT(s.fBitmap->config() == SkBitmap::kA8_Config);
+
+    const char* srcAddr = static_cast<const char*>(s.fBitmap->getPixels());
+    unsigned rb = s.fBitmap->rowBytes();
+    uint32_t XY = *xy++;
+    unsigned y0 = XY >> 14;
+    const uint8_t* row0 = reinterpret_cast<const uint8_t*>(srcAddr + (y0 >> 4) * rb);
+    const uint8_t* row1 = reinterpret_cast<const uint8_t*>(srcAddr + (XY & 0x3FFF) * rb);
+    unsigned subY = y0 & 0xF;
+
+    FilterSamples<uint8_t> samples;
+    while (count > 0) {
+        int n = SkMin32(count, 8);
+        xy = gather_filter_DX(row0, row1, subY, xy, n, &samples);
+        store_A8_8(s.fPaintPMColor, filter_A8_8(samples), colors, n);
+        colors += n;
+        count -= n;
+    }
+}
+
+void SA8_alpha_D32_filter_DXDY_SSE2(const SkBitmapProcState& s,
+                                    const uint32_t* xy,
+                                    int count, uint32_t* colors) {
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fDoFilter);
+    SkASSERT(s.fBitmap->config() == SkBitmap::kA8_Config);
+
+    const char* srcAddr = static_cast<const char*>(s.fBitmap->getPixels());
+    unsigned rb = s.fBitmap->rowBytes();
+
+    FilterSamples<uint8_t> samples;
+    while (count > 0) {
+        int n = SkMin32(count, 8);
+        xy = gather_filter_DXDY(srcAddr, rb, xy, n, &samples);
+        store_A8_8(s.fPaintPMColor, filter_A8_8(samples), colors, n);
+        colors += n;
+        count -= n;
+    }
+}
+
+void SA8_alpha_D32_nofilter_DX_SSE2(const SkBitmapProcState& s,
+                                    const uint32_t* xy,
+                                    int count, uint32_t* colors) {
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(s.fInvType <= (SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask));
+    SkASSERT(!s.fDoFilter);
+    SkASSERT(s.fBitmap->config() == SkBitmap::kA8_Config);
+
+    const uint8_t* srcAddr = static_cast<const uint8_t*>(s.fBitmap->getPixels());
+
+    // buffer is y32, x16, x16, x16, x16, x16
+    // bump srcAddr to the proper row, since we're told Y never changes
+    SkASSERT((unsigned)xy[0] < (unsigned)s.fBitmap->height());
+    srcAddr += xy[0] * s.fBitmap->rowBytes();
+    const uint16_t* xx = reinterpret_cast<const uint16_t*>(xy + 1);
+
+    const SkPMColor pmColor = s.fPaintPMColor;
+    if (1 == s.fBitmap->width()) {
+        sk_memset32(colors, SkAlphaMulQ(pmColor, SkAlpha255To256(srcAddr[0])), count);
+        return;
+    }
+
+    uint8_t src[8] = { 0 };
+    while (count > 0) {
+        int n = SkMin32(count, 8);
+        for (int i = 0; i < n; i++) {
+            SkASSERT(xx[i] < (unsigned)s.fBitmap->width());
+            src[i] = srcAddr[xx[i]];
+        }
+        xx += n;
+        store_A8_8(pmColor, load_8(src), colors, n);
+        colors += n;
+        count -= n;
+    }
+}
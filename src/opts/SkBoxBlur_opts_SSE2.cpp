@@ -0,0 +1,325 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkBoxBlur_opts_SSE2.h"
+#include "SkTemplates.h"
+
+/*  The box blur's running sums are serial along a row, so instead of
+    vectorizing along a row we blur 16 rows at once, one per byte lane.
+    The rows are transposed into columns 16x16 bytes at a time, run through
+    the same integer arithmetic as the portable code (so the output is
+    identical), and then either stored straight to dst (when transposing,
+    each column of output is 16 contiguous bytes in dst), or transposed back
+    into rows.
+ */
+
+namespace {
+
+enum {
+    kRows = 16
+};
+
+/*  Transposes 16 rows of 16 bytes in place. Each round interleaves rows i
+    and i+8, which rotates the 8 bits of (row, column) left by one; after
+    four rounds row and column have swapped.
+ */
+static inline void transpose16x16(__m128i v[16]) {
+    for (int round = 0; round < 4; ++round) {
+        __m128i t[16];
+        for (int i = 0; i < 8; ++i) {
+            t[2*i]     = _mm_unpacklo_epi8(v[i], v[i + 8]);
+            t[2*i + 1] = _mm_unpackhi_epi8(v[i], v[i + 8]);
+        }
+        for (int i = 0; i < 16; ++i) {
+            v[i] = t[i];
+        }
+    }
+}
+
+// cols[x * kRows + y] = src[y * rowBytes + x]
+static void rows_to_columns(const uint8_t* src, int rowBytes, int width,
+                            uint8_t* cols) {
+    int x = 0;
+    for (; x + kRows <= width; x += kRows) {
+        __m128i v[kRows];
+        for (int y = 0; y < kRows; ++y) {
+            v[y] = _mm_loadu_si128((const __m128i*)(src + y * rowBytes + x));
+        }
+        transpose16x16(v);
+        for (int i = 0; i < kRows; ++i) {
+            _mm_storeu_si128((__m128i*)(cols + (x + i) * kRows), v[i]);
+        }
+    }
+    for (; x < width; ++x) {
+        for (int y = 0; y < kRows; ++y) {
+            cols[x * kRows + y] = src[y * rowBytes + x];
+        }
+    }
+}
+
+// dst[y * rowBytes + x] = cols[x * kRows + y]
+static void columns_to_rows(const uint8_t* cols, int width, uint8_t* dst,
+                            int rowBytes) {
+    int x = 0;
+    for (; x + kRows <= width; x += kRows) {
+        __m128i v[kRows];
+        for (int i = 0; i < kRows; ++i) {
+            v[i] = _mm_loadu_si128((const __m128i*)(cols + (x + i) * kRows));
+        }
+        transpose16x16(v);
+        for (int y = 0; y < kRows; ++y) {
+            _mm_storeu_si128((__m128i*)(dst + y * rowBytes + x), v[y]);
+        }
+    }
+    for (; x < width; ++x) {
+        for (int y = 0; y < kRows; ++y) {
+            dst[y * rowBytes + x] = cols[x * kRows + y];
+        }
+    }
+}
+
+// A running sum for each of the 16 rows, as 32 bits each
+struct ColumnSum {
+    __m128i fSum[4];
+
+    void setZero() {
+        fSum[0] = fSum[1] = fSum[2] = fSum[3] = _mm_setzero_si128();
+    }
+
+    static void Widen(const uint8_t* col, __m128i wide[4]) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i c = _mm_loadu_si128((const __m128i*)col);
+        __m128i lo = _mm_unpacklo_epi8(c, zero);
+        __m128i hi = _mm_unpackhi_epi8(c, zero);
+        wide[0] = _mm_unpacklo_epi16(lo, zero);
+        wide[1] = _mm_unpackhi_epi16(lo, zero);
+        wide[2] = _mm_unpacklo_epi16(hi, zero);
+        wide[3] = _mm_unpackhi_epi16(hi, zero);
+    }
+
+    void add(const uint8_t* col) {
+        __m128i wide[4];
+        Widen(col, wide);
+        for (int i = 0; i < 4; ++i) {
+            fSum[i] = _mm_add_epi32(fSum[i], wide[i]);
+        }
+    }
+
+    void sub(const uint8_t* col) {
+        __m128i wide[4];
+        Widen(col, wide);
+        for (int i = 0; i < 4; ++i) {
+            fSum[i] = _mm_sub_epi32(fSum[i], wide[i]);
+        }
+    }
+};
+
+/*  SSE2 has no 32-bit multiply, so we multiply the even and odd lanes into
+    64 bits separately. The blur's products always fit in 32 bits, so after
+    shifting down by 24 each result is in the low byte of its lane.
+ */
+static inline __m128i even_odd_to_lanes(__m128i even, __m128i odd) {
+    even = _mm_srli_epi64(even, 24);
+    odd = _mm_slli_epi64(_mm_srli_epi64(odd, 24), 32);
+    return _mm_or_si128(even, odd);
+}
+
+static inline __m128i scale_shr24(__m128i sum, __m128i scale) {
+    __m128i even = _mm_mul_epu32(sum, scale);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(sum, 32), scale);
+    return even_odd_to_lanes(even, odd);
+}
+
+static inline __m128i scale2_shr24(__m128i sum0, __m128i scale0,
+                                   __m128i sum1, __m128i scale1) {
+    __m128i even = _mm_add_epi64(_mm_mul_epu32(sum0, scale0),
+                                 _mm_mul_epu32(sum1, scale1));
+    __m128i odd = _mm_add_epi64(
+                    _mm_mul_epu32(_mm_srli_epi64(sum0, 32), scale0),
+                    _mm_mul_epu32(_mm_srli_epi64(sum1, 32), scale1));
+    return even_odd_to_lanes(even, odd);
+}
+
+static inline void store_lanes(uint8_t* dst, const __m128i r[4]) {
+    __m128i lo = _mm_packs_epi32(r[0], r[1]);
+    __m128i hi = _mm_packs_epi32(r[2], r[3]);
+    _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(lo, hi));
+}
+
+// (sum * scale) >> 24
+static inline void store_scaled(uint8_t* dst, const ColumnSum& sum,
+                                __m128i scale) {
+    __m128i r[4];
+    for (int i = 0; i < 4; ++i) {
+        r[i] = scale_shr24(sum.fSum[i], scale);
+    }
+    store_lanes(dst, r);
+}
+
+// (outer * outerScale + inner * innerScale) >> 24
+static inline void store_scaled2(uint8_t* dst, const ColumnSum& outer,
+                                 __m128i outerScale, const ColumnSum& inner,
+                                 __m128i innerScale) {
+    __m128i r[4];
+    for (int i = 0; i < 4; ++i) {
+        r[i] = scale2_shr24(outer.fSum[i], outerScale,
+                            inner.fSum[i], innerScale);
+    }
+    store_lanes(dst, r);
+}
+
+static inline void store_zero(uint8_t* dst) {
+    _mm_storeu_si128((__m128i*)dst, _mm_setzero_si128());
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int SkBoxBlur_SSE2(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                   int leftRadius, int rightRadius, int width, int height,
+                   bool transpose) {
+    const int rows = height & ~(kRows - 1);
+    if (0 == rows) {
+        return 0;
+    }
+
+    int diameter = leftRadius + rightRadius;
+    int kernelSize = diameter + 1;
+    int border = SkMin32(width, diameter);
+    uint32_t scale = (1 << 24) / kernelSize;
+    int newWidth = width + SkMax32(leftRadius, rightRadius) * 2;
+    const __m128i vscale = _mm_set1_epi32(scale);
+
+    SkAutoTMalloc<uint8_t> storage((width + newWidth) * kRows);
+    uint8_t* srcCols = storage.get();
+    uint8_t* dstCols = srcCols + width * kRows;
+
+    for (int y = 0; y < rows; y += kRows) {
+        rows_to_columns(src + y * srcRowBytes, srcRowBytes, width, srcCols);
+
+        uint8_t* dptr = transpose ? dst + y : dstCols;
+        const int dstStride = transpose ? height : kRows;
+        const uint8_t* right = srcCols;
+        const uint8_t* left = srcCols;
+        ColumnSum sum;
+        sum.setZero();
+
+        int x;
+        for (x = 0; x < rightRadius - leftRadius; ++x) {
+            store_zero(dptr);
+            dptr += dstStride;
+        }
+        for (x = 0; x < border; ++x) {
+            sum.add(right);
+            right += kRows;
+            store_scaled(dptr, sum, vscale);
+            dptr += dstStride;
+        }
+        for (x = width; x < diameter; ++x) {
+            store_scaled(dptr, sum, vscale);
+            dptr += dstStride;
+        }
+        for (x = diameter; x < width; ++x) {
+            sum.add(right);
+            right += kRows;
+            store_scaled(dptr, sum, vscale);
+            sum.sub(left);
+            left += kRows;
+            dptr += dstStride;
+        }
+        for (x = 0; x < border; ++x) {
+            store_scaled(dptr, sum, vscale);
+            sum.sub(left);
+            left += kRows;
+            dptr += dstStride;
+        }
+        for (x = 0; x < leftRadius - rightRadius; ++x) {
+            store_zero(dptr);
+            dptr += dstStride;
+        }
+
+        if (!transpose) {
+            columns_to_rows(dstCols, newWidth, dst + y * newWidth, newWidth);
+        }
+    }
+    return rows;
+}
+
+int SkBoxBlurInterp_SSE2(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                         int radius, int width, int height, bool transpose,
+                         uint8_t outer_weight) {
+    const int rows = height & ~(kRows - 1);
+    if (0 == rows) {
+        return 0;
+    }
+
+    int diameter = radius * 2;
+    int kernelSize = diameter + 1;
+    int border = SkMin32(width, diameter);
+    int inner_weight = 255 - outer_weight;
+    outer_weight += outer_weight >> 7;
+    inner_weight += inner_weight >> 7;
+    uint32_t outer_scale = (outer_weight << 16) / kernelSize;
+    uint32_t inner_scale = (inner_weight << 16) / (kernelSize - 2);
+    int newWidth = width + diameter;
+    const __m128i vouter = _mm_set1_epi32(outer_scale);
+    const __m128i vinner = _mm_set1_epi32(inner_scale);
+
+    SkAutoTMalloc<uint8_t> storage((width + newWidth) * kRows);
+    uint8_t* srcCols = storage.get();
+    uint8_t* dstCols = srcCols + width * kRows;
+
+    for (int y = 0; y < rows; y += kRows) {
+        rows_to_columns(src + y * srcRowBytes, srcRowBytes, width, srcCols);
+
+        uint8_t* dptr = transpose ? dst + y : dstCols;
+        const int dstStride = transpose ? height : kRows;
+        const uint8_t* right = srcCols;
+        const uint8_t* left = srcCols;
+        ColumnSum outer, inner;
+        outer.setZero();
+        inner.setZero();
+
+        int x;
+        for (x = 0; x < border; ++x) {
+            inner = outer;
+            outer.add(right);
+            right += kRows;
+            store_scaled2(dptr, outer, vouter, inner, vinner);
+            dptr += dstStride;
+        }
+        for (x = width; x < diameter; ++x) {
+            store_scaled2(dptr, outer, vouter, inner, vinner);
+            dptr += dstStride;
+        }
+        for (x = diameter; x < width; ++x) {
+            inner = outer;
+            inner.sub(left);
+            outer.add(right);
+            right += kRows;
+            store_scaled2(dptr, outer, vouter, inner, vinner);
+            outer.sub(left);
+            left += kRows;
+            dptr += dstStride;
+        }
+        for (x = 0; x < border; ++x) {
+            inner = outer;
+            inner.sub(left);
+            left += kRows;
+            store_scaled2(dptr, outer, vouter, inner, vinner);
+            outer = inner;
+            dptr += dstStride;
+        }
+
+        if (!transpose) {
+            columns_to_rows(dstCols, newWidth, dst + y * newWidth, newWidth);
+        }
+    }
+    return rows;
+}
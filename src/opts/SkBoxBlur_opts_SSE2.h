@@ -0,0 +1,20 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBoxBlur_opts_SSE2_DEFINED
+#define SkBoxBlur_opts_SSE2_DEFINED
+
+#include "SkTypes.h"
+
+int SkBoxBlur_SSE2(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                   int leftRadius, int rightRadius, int width, int height,
+                   bool transpose);
+int SkBoxBlurInterp_SSE2(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                         int radius, int width, int height, bool transpose,
+                         uint8_t outerWeight);
+
+#endif
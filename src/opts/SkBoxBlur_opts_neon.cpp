@@ -0,0 +1,311 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBoxBlur_opts_neon.h"
+#include "SkTemplates.h"
+
+#include <arm_neon.h>
+
+/*  See SkBoxBlur_opts_SSE2.cpp: we blur 16 rows at once, one per byte lane,
+    using the portable code's integer arithmetic so that the output is
+    identical.
+ */
+
+namespace {
+
+enum {
+    kRows = 16
+};
+
+// Each round of zips rotates the bits of (row, column) left by one.
+static inline void transpose16x16(uint8x16_t v[16]) {
+    for (int round = 0; round < 4; ++round) {
+        uint8x16_t t[16];
+        for (int i = 0; i < 8; ++i) {
+            uint8x16x2_t z = vzipq_u8(v[i], v[i + 8]);
+            t[2*i]     = z.val[0];
+            t[2*i + 1] = z.val[1];
+        }
+        for (int i = 0; i < 16; ++i) {
+            v[i] = t[i];
+        }
+    }
+}
+
+// cols[x * kRows + y] = src[y * rowBytes + x]
+static void rows_to_columns(const uint8_t* src, int rowBytes, int width,
+                            uint8_t* cols) {
+    int x = 0;
+    for (; x + kRows <= width; x += kRows) {
+        uint8x16_t v[kRows];
+        for (int y = 0; y < kRows; ++y) {
+            v[y] = vld1q_u8(src + y * rowBytes + x);
+        }
+        transpose16x16(v);
+        for (int i = 0; i < kRows; ++i) {
+            vst1q_u8(cols + (x + i) * kRows, v[i]);
+        }
+    }
+    for (; x < width; ++x) {
+        for (int y = 0; y < kRows; ++y) {
+            cols[x * kRows + y] = src[y * rowBytes + x];
+        }
+    }
+}
+
+// dst[y * rowBytes + x] = cols[x * kRows + y]
+static void columns_to_rows(const uint8_t* cols, int width, uint8_t* dst,
+                            int rowBytes) {
+    int x = 0;
+    for (; x + kRows <= width; x += kRows) {
+        uint8x16_t v[kRows];
+        for (int i = 0; i < kRows; ++i) {
+            v[i] = vld1q_u8(cols + (x + i) * kRows);
+        }
+        transpose16x16(v);
+        for (int y = 0; y < kRows; ++y) {
+            vst1q_u8(dst + y * rowBytes + x, v[y]);
+        }
+    }
+    for (; x < width; ++x) {
+        for (int y = 0; y < kRows; ++y) {
+            dst[y * rowBytes + x] = cols[x * kRows + y];
+        }
+    }
+}
+
+// A running sum for each of the 16 rows, as 32 bits each
+struct ColumnSum {
+    uint32x4_t fSum[4];
+
+    void setZero() {
+        fSum[0] = fSum[1] = fSum[2] = fSum[3] = vdupq_n_u32(0);
+    }
+
+    static void Widen(const uint8_t* col, uint32x4_t wide[4]) {
+        uint8x16_t c = vld1q_u8(col);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(c));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(c));
+        wide[0] = vmovl_u16(vget_low_u16(lo));
+        wide[1] = vmovl_u16(vget_high_u16(lo));
+        wide[2] = vmovl_u16(vget_low_u16(hi));
+        wide[3] = vmovl_u16(vget_high_u16(hi));
+    }
+
+    void add(const uint8_t* col) {
+        uint32x4_t wide[4];
+        Widen(col, wide);
+        for (int i = 0; i < 4; ++i) {
+            fSum[i] = vaddq_u32(fSum[i], wide[i]);
+        }
+    }
+
+    void sub(const uint8_t* col) {
+        uint32x4_t wide[4];
+        Widen(col, wide);
+        for (int i = 0; i < 4; ++i) {
+            fSum[i] = vsubq_u32(fSum[i], wide[i]);
+        }
+    }
+};
+
+/*  The blur's products always fit in 32 bits, so after shifting the 64 bit
+    products down by 24 each result is in the low byte of its lane.
+ */
+static inline uint32x4_t scale_shr24(uint32x4_t sum, uint32x2_t scale) {
+    uint64x2_t lo = vmull_u32(vget_low_u32(sum), scale);
+    uint64x2_t hi = vmull_u32(vget_high_u32(sum), scale);
+    return vcombine_u32(vshrn_n_u64(lo, 24), vshrn_n_u64(hi, 24));
+}
+
+static inline uint32x4_t scale2_shr24(uint32x4_t sum0, uint32x2_t scale0,
+                                      uint32x4_t sum1, uint32x2_t scale1) {
+    uint64x2_t lo = vmull_u32(vget_low_u32(sum0), scale0);
+    uint64x2_t hi = vmull_u32(vget_high_u32(sum0), scale0);
+    lo = vmlal_u32(lo, vget_low_u32(sum1), scale1);
+    hi = vmlal_u32(hi, vget_high_u32(sum1), scale1);
+    return vcombine_u32(vshrn_n_u64(lo, 24), vshrn_n_u64(hi, 24));
+}
+
+static inline void store_lanes(uint8_t* dst, const uint32x4_t r[4]) {
+    uint16x8_t lo = vcombine_u16(vmovn_u32(r[0]), vmovn_u32(r[1]));
+    uint16x8_t hi = vcombine_u16(vmovn_u32(r[2]), vmovn_u32(r[3]));
+    vst1q_u8(dst, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+}
+
+// (sum * scale) >> 24
+static inline void store_scaled(uint8_t* dst, const ColumnSum& sum,
+                                uint32x2_t scale) {
+    uint32x4_t r[4];
+    for (int i = 0; i < 4; ++i) {
+        r[i] = scale_shr24(sum.fSum[i], scale);
+    }
+    store_lanes(dst, r);
+}
+
+// (outer * outerScale + inner * innerScale) >> 24
+static inline void store_scaled2(uint8_t* dst, const ColumnSum& outer,
+                                 uint32x2_t outerScale, const ColumnSum& inner,
+                                 uint32x2_t innerScale) {
+    uint32x4_t r[4];
+    for (int i = 0; i < 4; ++i) {
+        r[i] = scale2_shr24(outer.fSum[i], outerScale,
+                            inner.fSum[i], innerScale);
+    }
+    store_lanes(dst, r);
+}
+
+static inline void store_zero(uint8_t* dst) {
+    vst1q_u8(dst, vdupq_n_u8(0));
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int SkBoxBlur_neon(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                   int leftRadius, int rightRadius, int width, int height,
+                   bool transpose) {
+    const int rows = height & ~(kRows - 1);
+    if (0 == rows) {
+        return 0;
+    }
+
+    int diameter = leftRadius + rightRadius;
+    int kernelSize = diameter + 1;
+    int border = SkMin32(width, diameter);
+    uint32_t scale = (1 << 24) / kernelSize;
+    int newWidth = width + SkMax32(leftRadius, rightRadius) * 2;
+    const uint32x2_t vscale = vdup_n_u32(scale);
+
+    SkAutoTMalloc<uint8_t> storage((width + newWidth) * kRows);
+    uint8_t* srcCols = storage.get();
+    uint8_t* dstCols = srcCols + width * kRows;
+
+    for (int y = 0; y < rows; y += kRows) {
+        rows_to_columns(src + y * srcRowBytes, srcRowBytes, width, srcCols);
+
+        uint8_t* dptr = transpose ? dst + y : dstCols;
+        const int dstStride = transpose ? height : kRows;
+        const uint8_t* right = srcCols;
+        const uint8_t* left = srcCols;
+        ColumnSum sum;
+        sum.setZero();
+
+        int x;
+        for (x = 0; x < rightRadius - leftRadius; ++x) {
+            store_zero(dptr);
+            dptr += dstStride;
+        }
+        for (x = 0; x < border; ++x) {
+            sum.add(right);
+            right += kRows;
+            store_scaled(dptr, sum, vscale);
+            dptr += dstStride;
+        }
+        for (x = width; x < diameter; ++x) {
+            store_scaled(dptr, sum, vscale);
+            dptr += dstStride;
+        }
+        for (x = diameter; x < width; ++x) {
+            sum.add(right);
+            right += kRows;
+            store_scaled(dptr, sum, vscale);
+            sum.sub(left);
+            left += kRows;
+            dptr += dstStride;
+        }
+        for (x = 0; x < border; ++x) {
+            store_scaled(dptr, sum, vscale);
+            sum.sub(left);
+            left += kRows;
+            dptr += dstStride;
+        }
+        for (x = 0; x < leftRadius - rightRadius; ++x) {
+            store_zero(dptr);
+            dptr += dstStride;
+        }
+
+        if (!transpose) {
+            columns_to_rows(dstCols, newWidth, dst + y * newWidth, newWidth);
+        }
+    }
+    return rows;
+}
+
+int SkBoxBlurInterp_neon(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                         int radius, int width, int height, bool transpose,
+                         uint8_t outer_weight) {
+    const int rows = height & ~(kRows - 1);
+    if (0 == rows) {
+        return 0;
+    }
+
+    int diameter = radius * 2;
+    int kernelSize = diameter + 1;
+    int border = SkMin32(width, diameter);
+    int inner_weight = 255 - outer_weight;
+    outer_weight += outer_weight >> 7;
+    inner_weight += inner_weight >> 7;
+    uint32_t outer_scale = (outer_weight << 16) / kernelSize;
+    uint32_t inner_scale = (inner_weight << 16) / (kernelSize - 2);
+    int newWidth = width + diameter;
+    const uint32x2_t vouter = vdup_n_u32(outer_scale);
+    const uint32x2_t vinner = vdup_n_u32(inner_scale);
+
+    SkAutoTMalloc<uint8_t> storage((width + newWidth) * kRows);
+    uint8_t* srcCols = storage.get();
+    uint8_t* dstCols = srcCols + width * kRows;
+
+    for (int y = 0; y < rows; y += kRows) {
+        rows_to_columns(src + y * srcRowBytes, srcRowBytes, width, srcCols);
+
+        uint8_t* dptr = transpose ? dst + y : dstCols;
+        const int dstStride = transpose ? height : kRows;
+        const uint8_t* right = srcCols;
+        const uint8_t* left = srcCols;
+        ColumnSum outer, inner;
+        outer.setZero();
+        inner.setZero();
+
+        int x;
+        for (x = 0; x < border; ++x) {
+            inner = outer;
+            outer.add(right);
+            right += kRows;
+            store_scaled2(dptr, outer, vouter, inner, vinner);
+            dptr += dstStride;
+        }
+        for (x = width; x < diameter; ++x) {
+            store_scaled2(dptr, outer, vouter, inner, vinner);
+            dptr += dstStride;
+        }
+        for (x = diameter; x < width; ++x) {
+            inner = outer;
+            inner.sub(left);
+            outer.add(right);
+            right += kRows;
+            store_scaled2(dptr, outer, vouter, inner, vinner);
+            outer.sub(left);
+            left += kRows;
+            dptr += dstStride;
+        }
+        for (x = 0; x < border; ++x) {
+            inner = outer;
+            inner.sub(left);
+            left += kRows;
+            store_scaled2(dptr, outer, vouter, inner, vinner);
+            outer = inner;
+            dptr += dstStride;
+        }
+
+        if (!transpose) {
+            columns_to_rows(dstCols, newWidth, dst + y * newWidth, newWidth);
+        }
+    }
+    return rows;
+}
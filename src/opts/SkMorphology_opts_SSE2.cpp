@@ -0,0 +1,245 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkMorphology_opts_SSE2.h"
+#include "SkTemplates.h"
+
+/*  The same van Herk/Gil-Werman passes as SkMorphologyImageFilter.cpp, but on
+    four lines at once, one per 32 bit lane, so that one _mm_min_epu8 or
+    _mm_max_epu8 takes care of all four channels of four pixels. For a Y pass
+    the lanes are four neighboring columns, which already sit side by side in
+    each row; like the portable Y pass, it reads a strip of 16 columns (four
+    vectors, a whole cache line) from each row, rather than walking down the
+    bitmap once per vector. For an X pass, four rows are transposed into lanes
+    4x4 pixels at a time, and the results transposed back.
+
+    The buffers hold four pixels (one vector) per position of the line.
+ */
+
+namespace {
+
+template <bool isMax>
+static inline __m128i morph(__m128i a, __m128i b) {
+    return isMax ? _mm_max_epu8(a, b) : _mm_min_epu8(a, b);
+}
+
+static inline __m128i load(const SkPMColor* buffer, int i) {
+    return _mm_loadu_si128((const __m128i*)(buffer + 4 * i));
+}
+
+static inline void store(SkPMColor* buffer, int i, __m128i v) {
+    _mm_storeu_si128((__m128i*)(buffer + 4 * i), v);
+}
+
+static inline void transpose4x4(__m128i& a0, __m128i& a1,
+                                __m128i& a2, __m128i& a3) {
+    __m128i t0 = _mm_unpacklo_epi32(a0, a1);
+    __m128i t1 = _mm_unpacklo_epi32(a2, a3);
+    __m128i t2 = _mm_unpackhi_epi32(a0, a1);
+    __m128i t3 = _mm_unpackhi_epi32(a2, a3);
+    a0 = _mm_unpacklo_epi64(t0, t1);
+    a1 = _mm_unpackhi_epi64(t0, t1);
+    a2 = _mm_unpacklo_epi64(t2, t3);
+    a3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+template <bool isMax>
+static inline __m128i identity() {
+    return isMax ? _mm_setzero_si128() : _mm_set1_epi32(-1);
+}
+
+// See morph_padded_line() in SkMorphologyImageFilter.cpp.
+template <bool isMax>
+static void morph_padded_lines(const SkPMColor* pad, SkPMColor* prefix,
+                               SkPMColor* dst, int radius, int width) {
+    const int window = 2 * radius + 1;
+    const int count = width + 2 * radius;
+
+    for (int start = 0; start < count; start += window) {
+        int end = SkMin32(start + window, count);
+        __m128i m = load(pad, start);
+        store(prefix, start, m);
+        for (int i = start + 1; i < end; ++i) {
+            m = morph<isMax>(m, load(pad, i));
+            store(prefix, i, m);
+        }
+    }
+
+    for (int start = (width - 1) / window * window; start >= 0;
+         start -= window) {
+        int i = SkMin32(start + window, count) - 1;
+        __m128i suffix = load(pad, i);
+        for (;;) {
+            if (i < width) {
+                store(dst, i, morph<isMax>(suffix,
+                                           load(prefix, i + 2 * radius)));
+            }
+            if (--i < start) {
+                break;
+            }
+            suffix = morph<isMax>(suffix, load(pad, i));
+        }
+    }
+}
+
+template <bool isMax>
+static int morph_x(const SkPMColor* src, int srcRowPixels,
+                   SkPMColor* dst, int dstRowPixels,
+                   int radius, int width, int height) {
+    const int rows = height & ~3;
+    if (0 == rows) {
+        return 0;
+    }
+
+    const int count = width + 2 * radius;
+    SkAutoTMalloc<SkPMColor> storage(4 * (2 * count + width));
+    SkPMColor* pad = storage.get();
+    SkPMColor* prefix = pad + 4 * count;
+    SkPMColor* results = prefix + 4 * count;
+
+    for (int i = 0; i < radius; ++i) {
+        store(pad, i, identity<isMax>());
+        store(pad, radius + width + i, identity<isMax>());
+    }
+
+    for (int y = 0; y < rows; y += 4) {
+        const SkPMColor* s0 = src + y * srcRowPixels;
+        const SkPMColor* s1 = s0 + srcRowPixels;
+        const SkPMColor* s2 = s1 + srcRowPixels;
+        const SkPMColor* s3 = s2 + srcRowPixels;
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            __m128i a0 = _mm_loadu_si128((const __m128i*)(s0 + x));
+            __m128i a1 = _mm_loadu_si128((const __m128i*)(s1 + x));
+            __m128i a2 = _mm_loadu_si128((const __m128i*)(s2 + x));
+            __m128i a3 = _mm_loadu_si128((const __m128i*)(s3 + x));
+            transpose4x4(a0, a1, a2, a3);
+            store(pad, radius + x, a0);
+            store(pad, radius + x + 1, a1);
+            store(pad, radius + x + 2, a2);
+            store(pad, radius + x + 3, a3);
+        }
+        for (; x < width; ++x) {
+            store(pad, radius + x, _mm_set_epi32(s3[x], s2[x], s1[x], s0[x]));
+        }
+
+        morph_padded_lines<isMax>(pad, prefix, results, radius, width);
+
+        SkPMColor* d0 = dst + y * dstRowPixels;
+        SkPMColor* d1 = d0 + dstRowPixels;
+        SkPMColor* d2 = d1 + dstRowPixels;
+        SkPMColor* d3 = d2 + dstRowPixels;
+        x = 0;
+        for (; x + 4 <= width; x += 4) {
+            __m128i a0 = load(results, x);
+            __m128i a1 = load(results, x + 1);
+            __m128i a2 = load(results, x + 2);
+            __m128i a3 = load(results, x + 3);
+            transpose4x4(a0, a1, a2, a3);
+            _mm_storeu_si128((__m128i*)(d0 + x), a0);
+            _mm_storeu_si128((__m128i*)(d1 + x), a1);
+            _mm_storeu_si128((__m128i*)(d2 + x), a2);
+            _mm_storeu_si128((__m128i*)(d3 + x), a3);
+        }
+        for (; x < width; ++x) {
+            const SkPMColor* r = results + 4 * x;
+            d0[x] = r[0];
+            d1[x] = r[1];
+            d2[x] = r[2];
+            d3[x] = r[3];
+        }
+    }
+    return rows;
+}
+
+enum {
+    // a 64 byte cache line of pixels
+    kTileVectors = 4
+};
+
+template <bool isMax>
+static int morph_y(const SkPMColor* src, int srcRowPixels,
+                   SkPMColor* dst, int dstRowPixels,
+                   int radius, int width, int height) {
+    const int columns = width & ~3;
+    if (0 == columns) {
+        return 0;
+    }
+
+    // in pixels, for each strip of four columns
+    const int padSize = 4 * (height + 2 * radius);
+    const int resultSize = 4 * height;
+    SkAutoTMalloc<SkPMColor> storage(kTileVectors * (padSize + resultSize) +
+                                     padSize);
+    SkPMColor* pads = storage.get();
+    SkPMColor* results = pads + kTileVectors * padSize;
+    SkPMColor* prefix = results + kTileVectors * resultSize;
+
+    for (int v = 0; v < kTileVectors; ++v) {
+        SkPMColor* pad = pads + v * padSize;
+        for (int i = 0; i < radius; ++i) {
+            store(pad, i, identity<isMax>());
+            store(pad, radius + height + i, identity<isMax>());
+        }
+    }
+
+    for (int x = 0; x < columns; x += 4 * kTileVectors) {
+        int n = SkMin32(kTileVectors, (columns - x) >> 2);
+
+        const SkPMColor* s = src + x;
+        for (int y = 0; y < height; ++y) {
+            for (int v = 0; v < n; ++v) {
+                store(pads + v * padSize, radius + y,
+                      _mm_loadu_si128((const __m128i*)(s + 4 * v)));
+            }
+            s += srcRowPixels;
+        }
+
+        for (int v = 0; v < n; ++v) {
+            morph_padded_lines<isMax>(pads + v * padSize, prefix,
+                                      results + v * resultSize,
+                                      radius, height);
+        }
+
+        SkPMColor* d = dst + x;
+        for (int y = 0; y < height; ++y) {
+            for (int v = 0; v < n; ++v) {
+                _mm_storeu_si128((__m128i*)(d + 4 * v),
+                                 load(results + v * resultSize, y));
+            }
+            d += dstRowPixels;
+        }
+    }
+    return columns;
+}
+
+}
+
+int SkErodeX_SSE2(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                  int dstRowPixels, int radius, int width, int height) {
+    return morph_x<false>(src, srcRowPixels, dst, dstRowPixels,
+                          radius, width, height);
+}
+
+int SkErodeY_SSE2(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                  int dstRowPixels, int radius, int width, int height) {
+    return morph_y<false>(src, srcRowPixels, dst, dstRowPixels,
+                          radius, width, height);
+}
+
+int SkDilateX_SSE2(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                   int dstRowPixels, int radius, int width, int height) {
+    return morph_x<true>(src, srcRowPixels, dst, dstRowPixels,
+                         radius, width, height);
+}
+
+int SkDilateY_SSE2(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                   int dstRowPixels, int radius, int width, int height) {
+    return morph_y<true>(src, srcRowPixels, dst, dstRowPixels,
+                         radius, width, height);
+}
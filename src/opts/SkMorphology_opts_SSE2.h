@@ -0,0 +1,22 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMorphology_opts_SSE2_DEFINED
+#define SkMorphology_opts_SSE2_DEFINED
+
+#include "SkColor.h"
+
+int SkErodeX_SSE2(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                  int dstRowPixels, int radius, int width, int height);
+int SkErodeY_SSE2(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                  int dstRowPixels, int radius, int width, int height);
+int SkDilateX_SSE2(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                   int dstRowPixels, int radius, int width, int height);
+int SkDilateY_SSE2(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                   int dstRowPixels, int radius, int width, int height);
+
+#endif
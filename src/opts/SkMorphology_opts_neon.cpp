@@ -0,0 +1,220 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMorphology_opts_neon.h"
+#include "SkTemplates.h"
+
+#include <arm_neon.h>
+
+/*  See SkMorphology_opts_SSE2.cpp: we filter four lines at once, one per 32
+    bit lane, with vminq_u8 or vmaxq_u8 doing all four channels of four
+    pixels.
+ */
+
+namespace {
+
+template <bool isMax>
+static inline uint32x4_t morph(uint32x4_t a, uint32x4_t b) {
+    uint8x16_t a8 = vreinterpretq_u8_u32(a);
+    uint8x16_t b8 = vreinterpretq_u8_u32(b);
+    return vreinterpretq_u32_u8(isMax ? vmaxq_u8(a8, b8) : vminq_u8(a8, b8));
+}
+
+static inline uint32x4_t load(const SkPMColor* buffer, int i) {
+    return vld1q_u32(buffer + 4 * i);
+}
+
+static inline void store(SkPMColor* buffer, int i, uint32x4_t v) {
+    vst1q_u32(buffer + 4 * i, v);
+}
+
+static inline void transpose4x4(uint32x4_t& a0, uint32x4_t& a1,
+                                uint32x4_t& a2, uint32x4_t& a3) {
+    uint32x4x2_t t01 = vtrnq_u32(a0, a1);
+    uint32x4x2_t t23 = vtrnq_u32(a2, a3);
+    a0 = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+    a1 = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+    a2 = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+    a3 = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+}
+
+template <bool isMax>
+static inline uint32x4_t identity() {
+    return vdupq_n_u32(isMax ? 0 : 0xFFFFFFFF);
+}
+
+// See morph_padded_line() in SkMorphologyImageFilter.cpp.
+template <bool isMax>
+static void morph_padded_lines(const SkPMColor* pad, SkPMColor* prefix,
+                               SkPMColor* dst, int radius, int width) {
+    const int window = 2 * radius + 1;
+    const int count = width + 2 * radius;
+
+    for (int start = 0; start < count; start += window) {
+        int end = SkMin32(start + window, count);
+        uint32x4_t m = load(pad, start);
+        store(prefix, start, m);
+        for (int i = start + 1; i < end; ++i) {
+            m = morph<isMax>(m, load(pad, i));
+            store(prefix, i, m);
+        }
+    }
+
+    for (int start = (width - 1) / window * window; start >= 0;
+         start -= window) {
+        int i = SkMin32(start + window, count) - 1;
+        uint32x4_t suffix = load(pad, i);
+        for (;;) {
+            if (i < width) {
+                store(dst, i, morph<isMax>(suffix,
+                                           load(prefix, i + 2 * radius)));
+            }
+            if (--i < start) {
+                break;
+            }
+            suffix = morph<isMax>(suffix, load(pad, i));
+        }
+    }
+}
+
+template <bool isMax>
+static int morph_x(const SkPMColor* src, int srcRowPixels,
+                   SkPMColor* dst, int dstRowPixels,
+                   int radius, int width, int height) {
+    const int rows = height & ~3;
+    if (0 == rows) {
+        return 0;
+    }
+
+    const int count = width + 2 * radius;
+    SkAutoTMalloc<SkPMColor> storage(4 * (2 * count + width));
+    SkPMColor* pad = storage.get();
+    SkPMColor* prefix = pad + 4 * count;
+    SkPMColor* results = prefix + 4 * count;
+
+    for (int i = 0; i < radius; ++i) {
+        store(pad, i, identity<isMax>());
+        store(pad, radius + width + i, identity<isMax>());
+    }
+
+    for (int y = 0; y < rows; y += 4) {
+        const SkPMColor* s0 = src + y * srcRowPixels;
+        const SkPMColor* s1 = s0 + srcRowPixels;
+        const SkPMColor* s2 = s1 + srcRowPixels;
+        const SkPMColor* s3 = s2 + srcRowPixels;
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            uint32x4_t a0 = vld1q_u32(s0 + x);
+            uint32x4_t a1 = vld1q_u32(s1 + x);
+            uint32x4_t a2 = vld1q_u32(s2 + x);
+            uint32x4_t a3 = vld1q_u32(s3 + x);
+            transpose4x4(a0, a1, a2, a3);
+            store(pad, radius + x, a0);
+            store(pad, radius + x + 1, a1);
+            store(pad, radius + x + 2, a2);
+            store(pad, radius + x + 3, a3);
+        }
+        for (; x < width; ++x) {
+            SkPMColor* p = pad + 4 * (radius + x);
+            p[0] = s0[x];
+            p[1] = s1[x];
+            p[2] = s2[x];
+            p[3] = s3[x];
+        }
+
+        morph_padded_lines<isMax>(pad, prefix, results, radius, width);
+
+        SkPMColor* d0 = dst + y * dstRowPixels;
+        SkPMColor* d1 = d0 + dstRowPixels;
+        SkPMColor* d2 = d1 + dstRowPixels;
+        SkPMColor* d3 = d2 + dstRowPixels;
+        x = 0;
+        for (; x + 4 <= width; x += 4) {
+            uint32x4_t a0 = load(results, x);
+            uint32x4_t a1 = load(results, x + 1);
+            uint32x4_t a2 = load(results, x + 2);
+            uint32x4_t a3 = load(results, x + 3);
+            transpose4x4(a0, a1, a2, a3);
+            vst1q_u32(d0 + x, a0);
+            vst1q_u32(d1 + x, a1);
+            vst1q_u32(d2 + x, a2);
+            vst1q_u32(d3 + x, a3);
+        }
+        for (; x < width; ++x) {
+            const SkPMColor* r = results + 4 * x;
+            d0[x] = r[0];
+            d1[x] = r[1];
+            d2[x] = r[2];
+            d3[x] = r[3];
+        }
+    }
+    return rows;
+}
+
+template <bool isMax>
+static int morph_y(const SkPMColor* src, int srcRowPixels,
+                   SkPMColor* dst, int dstRowPixels,
+                   int radius, int width, int height) {
+    const int columns = width & ~3;
+    if (0 == columns) {
+        return 0;
+    }
+
+    const int count = height + 2 * radius;
+    SkAutoTMalloc<SkPMColor> storage(4 * (2 * count + height));
+    SkPMColor* pad = storage.get();
+    SkPMColor* prefix = pad + 4 * count;
+    SkPMColor* results = prefix + 4 * count;
+
+    for (int i = 0; i < radius; ++i) {
+        store(pad, i, identity<isMax>());
+        store(pad, radius + height + i, identity<isMax>());
+    }
+
+    for (int x = 0; x < columns; x += 4) {
+        const SkPMColor* s = src + x;
+        for (int y = 0; y < height; ++y) {
+            store(pad, radius + y, vld1q_u32(s));
+            s += srcRowPixels;
+        }
+
+        morph_padded_lines<isMax>(pad, prefix, results, radius, height);
+
+        SkPMColor* d = dst + x;
+        for (int y = 0; y < height; ++y) {
+            vst1q_u32(d, load(results, y));
+            d += dstRowPixels;
+        }
+    }
+    return columns;
+}
+
+}
+
+int SkErodeX_neon(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                  int dstRowPixels, int radius, int width, int height) {
+    return morph_x<false>(src, srcRowPixels, dst, dstRowPixels,
+                          radius, width, height);
+}
+
+int SkErodeY_neon(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                  int dstRowPixels, int radius, int width, int height) {
+    return morph_y<false>(src, srcRowPixels, dst, dstRowPixels,
+                          radius, width, height);
+}
+
+int SkDilateX_neon(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                   int dstRowPixels, int radius, int width, int height) {
+    return morph_x<true>(src, srcRowPixels, dst, dstRowPixels,
+                         radius, width, height);
+}
+
+int SkDilateY_neon(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                   int dstRowPixels, int radius, int width, int height) {
+    return morph_y<true>(src, srcRowPixels, dst, dstRowPixels,
+                         radius, width, height);
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMorphology_opts_neon_DEFINED
+#define SkMorphology_opts_neon_DEFINED
+
+#include "SkColor.h"
+
+int SkErodeX_neon(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                  int dstRowPixels, int radius, int width, int height);
+int SkErodeY_neon(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                  int dstRowPixels, int radius, int width, int height);
+int SkDilateX_neon(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                   int dstRowPixels, int radius, int width, int height);
+int SkDilateY_neon(const SkPMColor* src, int srcRowPixels, SkPMColor* dst,
+                   int dstRowPixels, int radius, int width, int height);
+
+#endif
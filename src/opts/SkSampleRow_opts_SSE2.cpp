@@ -0,0 +1,136 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkSampleRow_opts_SSE2.h"
+#include "SkColorPriv.h"
+
+namespace {
+
+/*  Splits 32 packed RGB pixels (96 bytes, in[0..5]) into planes: out[0..1]
+    hold the reds of pixels 0-15 and 16-31, out[2..3] the greens, and
+    out[4..5] the blues. Each round interleaves registers i and i+3, which
+    moves a byte from offset n (in the 96 byte string) to offset 32 * (n % 3)
+    + n / 3 after five rounds.
+ */
+static inline void deinterleave_rgb(const __m128i in[6], __m128i out[6]) {
+    __m128i v[6];
+    for (int i = 0; i < 6; ++i) {
+        v[i] = in[i];
+    }
+    for (int round = 0; round < 5; ++round) {
+        __m128i t[6];
+        for (int i = 0; i < 3; ++i) {
+            t[2*i]     = _mm_unpacklo_epi8(v[i], v[i + 3]);
+            t[2*i + 1] = _mm_unpackhi_epi8(v[i], v[i + 3]);
+        }
+        for (int i = 0; i < 6; ++i) {
+            v[i] = t[i];
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        out[i] = v[i];
+    }
+}
+
+// Writes 16 opaque SkPMColors from planes of red, green and blue.
+static inline void store_8888(SkPMColor* dst, __m128i r, __m128i g,
+                              __m128i b) {
+    __m128i bytes[4];
+    bytes[SK_A32_SHIFT / 8] = _mm_set1_epi8((char)0xFF);
+    bytes[SK_R32_SHIFT / 8] = r;
+    bytes[SK_G32_SHIFT / 8] = g;
+    bytes[SK_B32_SHIFT / 8] = b;
+
+    __m128i lo01 = _mm_unpacklo_epi8(bytes[0], bytes[1]);
+    __m128i hi01 = _mm_unpackhi_epi8(bytes[0], bytes[1]);
+    __m128i lo23 = _mm_unpacklo_epi8(bytes[2], bytes[3]);
+    __m128i hi23 = _mm_unpackhi_epi8(bytes[2], bytes[3]);
+
+    __m128i* d = (__m128i*)dst;
+    _mm_storeu_si128(d + 0, _mm_unpacklo_epi16(lo01, lo23));
+    _mm_storeu_si128(d + 1, _mm_unpackhi_epi16(lo01, lo23));
+    _mm_storeu_si128(d + 2, _mm_unpacklo_epi16(hi01, hi23));
+    _mm_storeu_si128(d + 3, _mm_unpackhi_epi16(hi01, hi23));
+}
+
+// Same as SkPack888ToRGB16() on 8 pixels with 16 bit lanes.
+static inline __m128i pack_565(__m128i r, __m128i g, __m128i b) {
+    r = _mm_slli_epi16(_mm_srli_epi16(r, 8 - SK_R16_BITS), SK_R16_SHIFT);
+    g = _mm_slli_epi16(_mm_srli_epi16(g, 8 - SK_G16_BITS), SK_G16_SHIFT);
+    b = _mm_slli_epi16(_mm_srli_epi16(b, 8 - SK_B16_BITS), SK_B16_SHIFT);
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+// Moves byte 'from' of each 32 bit lane to bit 'to'.
+static inline __m128i move_byte(__m128i v, int from, int to) {
+    v = _mm_and_si128(_mm_srli_epi32(v, from * 8), _mm_set1_epi32(0xFF));
+    return _mm_slli_epi32(v, to);
+}
+
+}
+
+int SkSampleRGBToD8888_SSE2(void* SK_RESTRICT dstRow,
+                            const uint8_t* SK_RESTRICT src, int count) {
+    SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+    int x = 0;
+    for (; x + 32 <= count; x += 32) {
+        __m128i v[6];
+        for (int i = 0; i < 6; ++i) {
+            v[i] = _mm_loadu_si128((const __m128i*)src + i);
+        }
+        deinterleave_rgb(v, v);
+        store_8888(dst + x, v[0], v[2], v[4]);
+        store_8888(dst + x + 16, v[1], v[3], v[5]);
+        src += 96;
+    }
+    return x;
+}
+
+int SkSampleRGBXToD8888_SSE2(void* SK_RESTRICT dstRow,
+                             const uint8_t* SK_RESTRICT src, int count) {
+    SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+    const __m128i alpha = _mm_set1_epi32(0xFF << SK_A32_SHIFT);
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)src);
+        __m128i c = _mm_or_si128(move_byte(v, 0, SK_R32_SHIFT),
+                    _mm_or_si128(move_byte(v, 1, SK_G32_SHIFT),
+                                 move_byte(v, 2, SK_B32_SHIFT)));
+        _mm_storeu_si128((__m128i*)(dst + x), _mm_or_si128(c, alpha));
+        src += 16;
+    }
+    return x;
+}
+
+int SkSampleRGBToD565_SSE2(void* SK_RESTRICT dstRow,
+                           const uint8_t* SK_RESTRICT src, int count) {
+    uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 32 <= count; x += 32) {
+        __m128i v[6];
+        for (int i = 0; i < 6; ++i) {
+            v[i] = _mm_loadu_si128((const __m128i*)src + i);
+        }
+        deinterleave_rgb(v, v);
+        __m128i* d = (__m128i*)(dst + x);
+        for (int i = 0; i < 2; ++i) {
+            __m128i r = v[i], g = v[2 + i], b = v[4 + i];
+            _mm_storeu_si128(d + 2*i,
+                             pack_565(_mm_unpacklo_epi8(r, zero),
+                                      _mm_unpacklo_epi8(g, zero),
+                                      _mm_unpacklo_epi8(b, zero)));
+            _mm_storeu_si128(d + 2*i + 1,
+                             pack_565(_mm_unpackhi_epi8(r, zero),
+                                      _mm_unpackhi_epi8(g, zero),
+                                      _mm_unpackhi_epi8(b, zero)));
+        }
+        src += 96;
+    }
+    return x;
+}
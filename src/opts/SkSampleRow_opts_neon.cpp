@@ -0,0 +1,77 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSampleRow_opts_neon.h"
+#include "SkColorPriv.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+// Writes 16 opaque SkPMColors from planes of red, green and blue.
+static inline void store_8888(SkPMColor* dst, uint8x16_t r, uint8x16_t g,
+                              uint8x16_t b) {
+    uint8x16x4_t bytes;
+    bytes.val[SK_A32_SHIFT / 8] = vdupq_n_u8(0xFF);
+    bytes.val[SK_R32_SHIFT / 8] = r;
+    bytes.val[SK_G32_SHIFT / 8] = g;
+    bytes.val[SK_B32_SHIFT / 8] = b;
+    vst4q_u8((uint8_t*)dst, bytes);
+}
+
+// Same as SkPack888ToRGB16() on 8 pixels.
+static inline uint16x8_t pack_565(uint8x8_t r, uint8x8_t g, uint8x8_t b) {
+    uint16x8_t r16 = vmovl_u8(vshr_n_u8(r, 8 - SK_R16_BITS));
+    uint16x8_t g16 = vmovl_u8(vshr_n_u8(g, 8 - SK_G16_BITS));
+    uint16x8_t b16 = vmovl_u8(vshr_n_u8(b, 8 - SK_B16_BITS));
+    return vorrq_u16(vorrq_u16(vshlq_n_u16(r16, SK_R16_SHIFT),
+                               vshlq_n_u16(g16, SK_G16_SHIFT)),
+                     vshlq_n_u16(b16, SK_B16_SHIFT));
+}
+
+}
+
+int SkSampleRGBToD8888_neon(void* SK_RESTRICT dstRow,
+                            const uint8_t* SK_RESTRICT src, int count) {
+    SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        uint8x16x3_t rgb = vld3q_u8(src);
+        store_8888(dst + x, rgb.val[0], rgb.val[1], rgb.val[2]);
+        src += 48;
+    }
+    return x;
+}
+
+int SkSampleRGBXToD8888_neon(void* SK_RESTRICT dstRow,
+                             const uint8_t* SK_RESTRICT src, int count) {
+    SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        uint8x16x4_t rgbx = vld4q_u8(src);
+        store_8888(dst + x, rgbx.val[0], rgbx.val[1], rgbx.val[2]);
+        src += 64;
+    }
+    return x;
+}
+
+int SkSampleRGBToD565_neon(void* SK_RESTRICT dstRow,
+                           const uint8_t* SK_RESTRICT src, int count) {
+    uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        uint8x16x3_t rgb = vld3q_u8(src);
+        vst1q_u16(dst + x, pack_565(vget_low_u8(rgb.val[0]),
+                                    vget_low_u8(rgb.val[1]),
+                                    vget_low_u8(rgb.val[2])));
+        vst1q_u16(dst + x + 8, pack_565(vget_high_u8(rgb.val[0]),
+                                        vget_high_u8(rgb.val[1]),
+                                        vget_high_u8(rgb.val[2])));
+        src += 48;
+    }
+    return x;
+}
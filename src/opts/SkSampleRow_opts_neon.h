@@ -0,0 +1,20 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSampleRow_opts_neon_DEFINED
+#define SkSampleRow_opts_neon_DEFINED
+
+#include "SkTypes.h"
+
+int SkSampleRGBToD8888_neon(void* SK_RESTRICT dst,
+                            const uint8_t* SK_RESTRICT src, int count);
+int SkSampleRGBXToD8888_neon(void* SK_RESTRICT dst,
+                             const uint8_t* SK_RESTRICT src, int count);
+int SkSampleRGBToD565_neon(void* SK_RESTRICT dst,
+                           const uint8_t* SK_RESTRICT src, int count);
+
+#endif
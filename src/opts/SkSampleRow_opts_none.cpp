@@ -0,0 +1,20 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSampleRowProcs.h"
+
+SkSampleRowProc SkSampleRGBToD8888GetPlatformProc() {
+    return NULL;
+}
+
+SkSampleRowProc SkSampleRGBXToD8888GetPlatformProc() {
+    return NULL;
+}
+
+SkSampleRowProc SkSampleRGBToD565GetPlatformProc() {
+    return NULL;
+}
@@ -11,6 +11,12 @@
 #include "SkBlitRow.h"
 #include "SkBlitRect_opts_SSE2.h"
 #include "SkBlitRow_opts_SSE2.h"
+#include "SkBoxBlur_opts_SSE2.h"
+#include "SkBoxBlurProcs.h"
+#include "SkMorphology_opts_SSE2.h"
+#include "SkMorphologyProcs.h"
+#include "SkSampleRow_opts_SSE2.h"
+#include "SkSampleRowProcs.h"
 #include "SkUtils_opts_SSE2.h"
 #include "SkUtils.h"
 
@@ -131,6 +137,27 @@ void SkBitmapProcState::platformProcs() {
     }
 
     if (cachedHasSSSE3() || cachedHasSSE2()) {
+        // 565 and A8 sources only need SSE2, so SSSE3 machines use these too
+        if (fSampleProc32 == S16_opaque_D32_filter_DX) {
+            fSampleProc32 = S16_opaque_D32_filter_DX_SSE2;
+        } else if (fSampleProc32 == S16_alpha_D32_filter_DX) {
+            fSampleProc32 = S16_alpha_D32_filter_DX_SSE2;
+        } else if (fSampleProc32 == S16_opaque_D32_filter_DXDY) {
+            fSampleProc32 = S16_opaque_D32_filter_DXDY_SSE2;
+        } else if (fSampleProc32 == S16_alpha_D32_filter_DXDY) {
+            fSampleProc32 = S16_alpha_D32_filter_DXDY_SSE2;
+        } else if (fSampleProc32 == S16_opaque_D32_nofilter_DX) {
+            fSampleProc32 = S16_opaque_D32_nofilter_DX_SSE2;
+        } else if (fSampleProc32 == S16_alpha_D32_nofilter_DX) {
+            fSampleProc32 = S16_alpha_D32_nofilter_DX_SSE2;
+        } else if (fSampleProc32 == SA8_alpha_D32_filter_DX) {
+            fSampleProc32 = SA8_alpha_D32_filter_DX_SSE2;
+        } else if (fSampleProc32 == SA8_alpha_D32_filter_DXDY) {
+            fSampleProc32 = SA8_alpha_D32_filter_DXDY_SSE2;
+        } else if (fSampleProc32 == SA8_alpha_D32_nofilter_DX) {
+            fSampleProc32 = SA8_alpha_D32_nofilter_DX_SSE2;
+        }
+
         if (fMatrixProc == ClampX_ClampY_filter_scale) {
             fMatrixProc = ClampX_ClampY_filter_scale_SSE2;
         } else if (fMatrixProc == ClampX_ClampY_nofilter_scale) {
@@ -245,4 +272,60 @@ SkBlitRow::ColorRectProc PlatformColorRectProcFactory() {
     }
 }
 
+SkBoxBlurProc SkBoxBlurGetPlatformProc() {
+    if (cachedHasSSE2()) {
+        return SkBoxBlur_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+SkBoxBlurInterpProc SkBoxBlurInterpGetPlatformProc() {
+    if (cachedHasSSE2()) {
+        return SkBoxBlurInterp_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+SkMorphologyProc SkMorphologyGetPlatformProc(SkMorphologyProcType type) {
+    if (!cachedHasSSE2()) {
+        return NULL;
+    }
+    switch (type) {
+        case kErodeX_SkMorphologyProcType:
+            return SkErodeX_SSE2;
+        case kErodeY_SkMorphologyProcType:
+            return SkErodeY_SSE2;
+        case kDilateX_SkMorphologyProcType:
+            return SkDilateX_SSE2;
+        case kDilateY_SkMorphologyProcType:
+            return SkDilateY_SSE2;
+        default:
+            return NULL;
+    }
+}
 
+SkSampleRowProc SkSampleRGBToD8888GetPlatformProc() {
+    if (cachedHasSSE2()) {
+        return SkSampleRGBToD8888_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+SkSampleRowProc SkSampleRGBXToD8888GetPlatformProc() {
+    if (cachedHasSSE2()) {
+        return SkSampleRGBXToD8888_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
+SkSampleRowProc SkSampleRGBToD565GetPlatformProc() {
+    if (cachedHasSSE2()) {
+        return SkSampleRGBToD565_SSE2;
+    } else {
+        return NULL;
+    }
+}
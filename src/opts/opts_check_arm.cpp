@@ -14,10 +14,19 @@
  */
 
 #include "SkBlitRow.h"
+#include "SkBoxBlurProcs.h"
+#include "SkMorphologyProcs.h"
+#include "SkSampleRowProcs.h"
 #include "SkUtils.h"
 
 #include "SkUtilsArm.h"
 
+#if !SK_ARM_NEON_IS_NONE
+#include "SkBoxBlur_opts_neon.h"
+#include "SkMorphology_opts_neon.h"
+#include "SkSampleRow_opts_neon.h"
+#endif
+
 #if defined(SK_CPU_LENDIAN) && !SK_ARM_NEON_IS_NONE
 extern "C" void memset16_neon(uint16_t dst[], uint16_t value, int count);
 extern "C" void memset32_neon(uint32_t dst[], uint32_t value, int count);
@@ -66,3 +75,79 @@ SkBlitRow::ColorRectProc PlatformColorRectProcFactory() {
     return NULL;
 }
 
+SkBoxBlurProc SkBoxBlurGetPlatformProc() {
+#if SK_ARM_NEON_IS_DYNAMIC
+    return sk_cpu_arm_has_neon() ? SkBoxBlur_neon : NULL;
+#elif SK_ARM_NEON_IS_ALWAYS
+    return SkBoxBlur_neon;
+#else
+    return NULL;
+#endif
+}
+
+SkBoxBlurInterpProc SkBoxBlurInterpGetPlatformProc() {
+#if SK_ARM_NEON_IS_DYNAMIC
+    return sk_cpu_arm_has_neon() ? SkBoxBlurInterp_neon : NULL;
+#elif SK_ARM_NEON_IS_ALWAYS
+    return SkBoxBlurInterp_neon;
+#else
+    return NULL;
+#endif
+}
+
+#if !SK_ARM_NEON_IS_NONE
+static SkMorphologyProc morphology_neon_proc(SkMorphologyProcType type) {
+    switch (type) {
+        case kErodeX_SkMorphologyProcType:
+            return SkErodeX_neon;
+        case kErodeY_SkMorphologyProcType:
+            return SkErodeY_neon;
+        case kDilateX_SkMorphologyProcType:
+            return SkDilateX_neon;
+        case kDilateY_SkMorphologyProcType:
+            return SkDilateY_neon;
+        default:
+            return NULL;
+    }
+}
+#endif
+
+SkMorphologyProc SkMorphologyGetPlatformProc(SkMorphologyProcType type) {
+#if SK_ARM_NEON_IS_DYNAMIC
+    return sk_cpu_arm_has_neon() ? morphology_neon_proc(type) : NULL;
+#elif SK_ARM_NEON_IS_ALWAYS
+    return morphology_neon_proc(type);
+#else
+    return NULL;
+#endif
+}
+
+SkSampleRowProc SkSampleRGBToD8888GetPlatformProc() {
+#if SK_ARM_NEON_IS_DYNAMIC
+    return sk_cpu_arm_has_neon() ? SkSampleRGBToD8888_neon : NULL;
+#elif SK_ARM_NEON_IS_ALWAYS
+    return SkSampleRGBToD8888_neon;
+#else
+    return NULL;
+#endif
+}
+
+SkSampleRowProc SkSampleRGBXToD8888GetPlatformProc() {
+#if SK_ARM_NEON_IS_DYNAMIC
+    return sk_cpu_arm_has_neon() ? SkSampleRGBXToD8888_neon : NULL;
+#elif SK_ARM_NEON_IS_ALWAYS
+    return SkSampleRGBXToD8888_neon;
+#else
+    return NULL;
+#endif
+}
+
+SkSampleRowProc SkSampleRGBToD565GetPlatformProc() {
+#if SK_ARM_NEON_IS_DYNAMIC
+    return sk_cpu_arm_has_neon() ? SkSampleRGBToD565_neon : NULL;
+#elif SK_ARM_NEON_IS_ALWAYS
+    return SkSampleRGBToD565_neon;
+#else
+    return NULL;
+#endif
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPathOps.h"
+#include "SkPath.h"
+#include "ShapeOps.h"
+
+// The edge walker only looks at whether a path is even-odd or winding, and
+// always fills the inside of its contours. An op involving an inverse path
+// is rewritten as an op on the plain paths, whose result is then inverted,
+// e.g. (~one & two) == (two - one), and (~one | two) == ~(one - two).
+struct InverseOp {
+    ShapeOp fOp;
+    bool    fSwap;      // apply the op to (two, one) instead
+    bool    fInverse;   // the result fills the outside of its contours
+};
+
+static const InverseOp gInverseOps[][4] = {
+    // one is inverse, two is not
+    {
+        { kUnion_Op,      false, true  },   // difference
+        { kDifference_Op, true,  false },   // intersect
+        { kDifference_Op, false, true  },   // union
+        { kXor_Op,        false, true  },   // xor
+    },
+    // both are inverse
+    {
+        { kDifference_Op, true,  false },
+        { kUnion_Op,      false, true  },
+        { kIntersect_Op,  false, true  },
+        { kXor_Op,        false, false },
+    },
+    // one is not inverse, two is
+    {
+        { kIntersect_Op,  false, false },
+        { kDifference_Op, false, false },
+        { kDifference_Op, true,  true  },
+        { kXor_Op,        false, true  },
+    },
+};
+
+// SkPathOp and ShapeOp list the ops in the same order.
+SK_COMPILE_ASSERT(kDifference_PathOp == (int) kDifference_Op, op_mismatch);
+SK_COMPILE_ASSERT(kIntersect_PathOp == (int) kIntersect_Op, op_mismatch);
+SK_COMPILE_ASSERT(kUnion_PathOp == (int) kUnion_Op, op_mismatch);
+SK_COMPILE_ASSERT(kXOR_PathOp == (int) kXor_Op, op_mismatch);
+
+bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
+    SkASSERT(result);
+    if (!one.isFinite() || !two.isFinite()) {
+        return false;
+    }
+    ShapeOp shapeOp = (ShapeOp) op;
+    bool swap = false;
+    bool inverse = false;
+    bool oneInverse = one.isInverseFillType();
+    bool twoInverse = two.isInverseFillType();
+    if (oneInverse || twoInverse) {
+        int row = oneInverse ? (twoInverse ? 1 : 0) : 2;
+        const InverseOp& rec = gInverseOps[row][op];
+        shapeOp = rec.fOp;
+        swap = rec.fSwap;
+        inverse = rec.fInverse;
+    }
+    SkPath temp;
+    const SkPath& first = swap ? two : one;
+    const SkPath& second = swap ? one : two;
+    if (!operate(first, second, shapeOp, temp)) {
+        return false;
+    }
+    if (inverse) {
+        temp.toggleInverseFillType();
+    }
+    result->swap(temp);
+    return true;
+}
+
+bool Simplify(const SkPath& path, SkPath* result) {
+    SkASSERT(result);
+    if (!path.isFinite()) {
+        return false;
+    }
+    SkPath temp;
+    if (!simplifyx(path, temp)) {
+        return false;
+    }
+    if (path.isInverseFillType()) {
+        temp.toggleInverseFillType();
+    }
+    result->swap(temp);
+    return true;
+}
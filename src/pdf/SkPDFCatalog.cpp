@@ -28,7 +28,10 @@ SkPDFObject* SkPDFCatalog::addObject(SkPDFObject* obj, bool onFirstPage) {
     if (findObjectIndex(obj) != -1) {  // object already added
         return obj;
     }
-    SkASSERT(fNextFirstPageObjNum == 0);
+    // Objects can only be added once numbers have been handed out if none
+    // of them go on the first page (i.e. the document is being streamed).
+    SkASSERT(fNextFirstPageObjNum == 0 ||
+             (!onFirstPage && fFirstPageCount == 0));
     if (onFirstPage) {
         fFirstPageCount++;
     }
@@ -39,12 +42,26 @@ SkPDFObject* SkPDFCatalog::addObject(SkPDFObject* obj, bool onFirstPage) {
 }
 
 size_t SkPDFCatalog::setFileOffset(SkPDFObject* obj, off_t offset) {
+    recordFileOffset(obj, offset);
+    return getSubstituteObject(obj)->getOutputSize(this, true);
+}
+
+void SkPDFCatalog::recordFileOffset(SkPDFObject* obj, off_t offset) {
     int objIndex = assignObjNum(obj) - 1;
     SkASSERT(fCatalog[objIndex].fObjNumAssigned);
     SkASSERT(fCatalog[objIndex].fFileOffset == 0);
     fCatalog[objIndex].fFileOffset = offset;
+}
 
-    return getSubstituteObject(obj)->getOutputSize(this, true);
+void SkPDFCatalog::retireObject(SkPDFObject* obj) {
+    for (int i = 0; i < fCatalog.count(); i++) {
+        if (fCatalog[i].fObject == obj) {
+            SkASSERT(fCatalog[i].fFileOffset > 0);
+            fCatalog[i].fObject = NULL;
+            return;
+        }
+    }
+    SkASSERT(false);  // obj not in catalog
 }
 
 void SkPDFCatalog::emitObjectNumber(SkWStream* stream, SkPDFObject* obj) {
@@ -44,6 +44,20 @@ public:
      */
     size_t setFileOffset(SkPDFObject* obj, off_t offset);
 
+    /** Like setFileOffset(), but for objects that are written out as soon
+     *  as their offset is known, so their size is not needed.
+     *  @param obj         The object to add.
+     *  @param offset      The byte offset in the output stream of this object.
+     */
+    void recordFileOffset(SkPDFObject* obj, off_t offset);
+
+    /** Forget the passed object once it has been written out, keeping its
+     *  object number and offset for the cross reference table.  The object
+     *  may then be freed, and its address reused by a new object.
+     *  @param obj         The object to retire.
+     */
+    void retireObject(SkPDFObject* obj);
+
     /** Output the object number for the passed object.
      *  @param obj         The object of interest.
      *  @param stream      The writable output stream to send the output to.
@@ -7,13 +7,16 @@
  */
 
 
+#include "SkCountdown.h"
 #include "SkPDFCatalog.h"
 #include "SkPDFDevice.h"
 #include "SkPDFDocument.h"
 #include "SkPDFFont.h"
 #include "SkPDFPage.h"
 #include "SkPDFTypes.h"
+#include "SkRunnable.h"
 #include "SkStream.h"
+#include "SkThreadPool.h"
 
 // Add the resources, starting at firstIndex to the catalog, removing any dupes.
 // A hash table would be really nice here.
@@ -33,15 +36,11 @@ static void addResourcesToCatalog(int firstIndex, bool firstPage,
 }
 
 static void perform_font_subsetting(SkPDFCatalog* catalog,
-                                    const SkTDArray<SkPDFPage*>& pages,
+                                    const SkPDFGlyphSetMap& usage,
                                     SkTDArray<SkPDFObject*>* substitutes) {
     SkASSERT(catalog);
     SkASSERT(substitutes);
 
-    SkPDFGlyphSetMap usage;
-    for (int i = 0; i < pages.count(); ++i) {
-        usage.merge(pages[i]->getFontGlyphUsage());
-    }
     SkPDFGlyphSetMap::F2BIter iterator(usage);
     SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next();
     while (entry) {
@@ -55,6 +54,132 @@ static void perform_font_subsetting(SkPDFCatalog* catalog,
     }
 }
 
+// Append obj to list, taking over the caller's reference, unless it is
+// already there. Returns true if it was appended.
+static bool append_unique(SkPDFObject* obj, SkTDArray<SkPDFObject*>* list) {
+    if (list->find(obj) >= 0) {
+        obj->unref();
+        return false;
+    }
+    list->push(obj);
+    return true;
+}
+
+static void count_font_types(const SkTDArray<SkPDFFont*>& fonts,
+                             SkTDArray<SkFontID>* seenFonts,
+                             int counts[]) {
+    for (int font = 0; font < fonts.count(); font++) {
+        SkFontID fontID = fonts[font]->typeface()->uniqueID();
+        if (seenFonts->find(fontID) == -1) {
+            counts[fonts[font]->getType()]++;
+            seenFonts->push(fontID);
+        }
+    }
+}
+
+namespace {
+
+// Forwards to another stream, keeping track of the offset, so that objects
+// can be put in the cross reference table as they are written.
+class OffsetWStream : public SkWStream {
+public:
+    explicit OffsetWStream(SkWStream* stream) : fStream(stream), fOffset(0) {}
+
+    virtual bool write(const void* buffer, size_t size) SK_OVERRIDE {
+        fOffset += size;
+        return fStream->write(buffer, size);
+    }
+
+    virtual void flush() SK_OVERRIDE {
+        fStream->flush();
+    }
+
+    off_t offset() const { return fOffset; }
+
+private:
+    SkWStream* fStream;
+    off_t fOffset;
+};
+
+class PrepareTask : public SkRunnable {
+public:
+    PrepareTask(SkPDFObject* object, SkPDFCatalog* catalog)
+        : fObject(object),
+          fCatalog(catalog) {
+    }
+
+    virtual void run() SK_OVERRIDE {
+        fObject->prepareForEmit(fCatalog);
+    }
+
+private:
+    SkPDFObject* fObject;
+    SkPDFCatalog* fCatalog;
+};
+
+}
+
+struct SkPDFDocument::StreamState {
+    StreamState(SkWStream* stream, int threadCount)
+        : fOut(stream),
+          fPool(threadCount),
+          fPageTreeRoot(SkNEW_ARGS(SkPDFDict, ("Pages"))),
+          fPendingPage(NULL),
+          fPendingDone(0),
+          fFinished(false) {
+    }
+
+    ~StreamState() {
+        // The tasks still running use the pending objects.
+        fPool.wait(&fPendingDone);
+        fTasks.deleteAll();
+        fPendingObjects.unrefAll();
+        fDeferred.unrefAll();
+        fFonts.unrefAll();
+        // Once the page tree has been written, it and the pages refer to
+        // each other.
+        fPageTreeRoot->clear();
+        fPageTreeRoot->unref();
+    }
+
+    /** Start preparing objects on the thread pool. Wait for them with
+     *  fPool.wait(&fPendingDone).
+     */
+    void prepare(const SkTDArray<SkPDFObject*>& objects,
+                 SkPDFCatalog* catalog) {
+        SkASSERT(fTasks.isEmpty());
+        fPendingDone.reset(objects.count());
+        for (int i = 0; i < objects.count(); i++) {
+            PrepareTask* task = SkNEW_ARGS(PrepareTask, (objects[i], catalog));
+            fTasks.push(task);
+            fPool.add(task, &fPendingDone);
+        }
+    }
+
+    void emit(SkPDFObject* obj, SkPDFCatalog* catalog) {
+        catalog->recordFileOffset(obj, fOut.offset());
+        obj->emit(&fOut, catalog, true);
+    }
+
+    OffsetWStream fOut;
+    SkThreadPool fPool;
+    SkPDFDict* fPageTreeRoot;
+
+    // The fonts used on every page so far and all the objects they refer
+    // to, which are written at the end, once the fonts have been subset.
+    SkPDFGlyphSetMap fGlyphUsage;
+    SkTDArray<SkPDFObject*> fDeferred;
+    SkTDArray<SkPDFFont*> fFonts;
+
+    // The last page appended, and the objects that will be written with it.
+    SkPDFPage* fPendingPage;
+    SkTDArray<SkPDFObject*> fPendingObjects;
+    SkTDArray<PrepareTask*> fTasks;
+    SkCountdown fPendingDone;
+
+    bool fFinished;
+};
+
 SkPDFDocument::SkPDFDocument(Flags flags)
         : fXRefFileOffset(0),
           fSecondPageFirstResourceIndex(0),
@@ -65,6 +190,7 @@ SkPDFDocument::SkPDFDocument(Flags flags)
 }
 
 SkPDFDocument::~SkPDFDocument() {
+    fStreamState.reset();
     fPages.safeUnrefAll();
 
     // The page tree has both child and parent pointers, so it creates a
@@ -81,7 +207,7 @@ SkPDFDocument::~SkPDFDocument() {
 }
 
 bool SkPDFDocument::emitPDF(SkWStream* stream) {
-    if (fPages.isEmpty()) {
+    if (fPages.isEmpty() || fStreamState.get()) {
         return false;
     }
     for (int i = 0; i < fPages.count(); i++) {
@@ -120,7 +246,11 @@ bool SkPDFDocument::emitPDF(SkWStream* stream) {
         }
 
         // Build font subsetting info before proceeding.
-        perform_font_subsetting(fCatalog.get(), fPages, &fSubstitutes);
+        SkPDFGlyphSetMap usage;
+        for (int i = 0; i < fPages.count(); ++i) {
+            usage.merge(fPages[i]->getFontGlyphUsage());
+        }
+        perform_font_subsetting(fCatalog.get(), usage, &fSubstitutes);
 
         // Figure out the size of things and inform the catalog of file offsets.
         off_t fileOffset = headerSize();
@@ -193,8 +323,108 @@ bool SkPDFDocument::emitPDF(SkWStream* stream) {
     return true;
 }
 
+bool SkPDFDocument::beginStream(SkWStream* stream, int threadCount) {
+    if (!fPages.isEmpty() || fStreamState.get() || NULL == stream) {
+        return false;
+    }
+
+    // Objects are numbered in the order they are written, so nothing can
+    // be set aside for the first page: start over with a catalog that has
+    // the document catalog as an ordinary object.
+    Flags flags = fCatalog->getDocumentFlags();
+    fCatalog.reset(new SkPDFCatalog(flags));
+    fCatalog->addObject(fDocCatalog, false);
+
+    fStreamState.reset(SkNEW_ARGS(StreamState,
+                                  (stream, SkMax32(threadCount, 0))));
+    SkPDFDict* pageTreeRoot = fStreamState->fPageTreeRoot;
+    fCatalog->addObject(pageTreeRoot, false);
+    fDocCatalog->insert("Pages", new SkPDFObjRef(pageTreeRoot))->unref();
+
+    emitHeader(&fStreamState->fOut);
+    return true;
+}
+
+bool SkPDFDocument::finishStream() {
+    StreamState* state = fStreamState.get();
+    if (NULL == state || state->fFinished || fPages.isEmpty()) {
+        return false;
+    }
+    state->fFinished = true;
+    SkPDFCatalog* catalog = fCatalog.get();
+
+    this->emitPendingPage();
+
+    // Now that all of the glyphs are known, subset the fonts, and write them
+    // out with everything they refer to.
+    perform_font_subsetting(catalog, state->fGlyphUsage, &fSubstitutes);
+    SkTDArray<SkPDFObject*> substituteResources;
+    for (int i = 0; i < fSubstitutes.count(); i++) {
+        SkTDArray<SkPDFObject*> resources;
+        fSubstitutes[i]->getResources(&resources);
+        for (int j = 0; j < resources.count(); j++) {
+            append_unique(resources[j], &substituteResources);
+        }
+    }
+    SkTDArray<SkPDFObject*> fontObjects;
+    fontObjects.append(state->fDeferred.count(), state->fDeferred.begin());
+    fontObjects.append(substituteResources.count(),
+                       substituteResources.begin());
+    state->prepare(fontObjects, catalog);
+    state->fPool.wait(&state->fPendingDone);
+    state->fTasks.deleteAll();
+    for (int i = 0; i < fontObjects.count(); i++) {
+        state->emit(fontObjects[i], catalog);
+    }
+    substituteResources.unrefAll();
+
+    // A single level page tree can hold any number of pages, and lets each
+    // page point at its parent before the tree is complete.
+    SkPDFDict* pageTreeRoot = state->fPageTreeRoot;
+    SkAutoTUnref<SkPDFArray> kids(new SkPDFArray);
+    kids->reserve(fPages.count());
+    for (int i = 0; i < fPages.count(); i++) {
+        kids->append(new SkPDFObjRef(fPages[i]))->unref();
+    }
+    pageTreeRoot->insert("Kids", kids.get());
+    pageTreeRoot->insertInt("Count", fPages.count());
+    state->emit(pageTreeRoot, catalog);
+    state->emit(fDocCatalog, catalog);
+
+    fXRefFileOffset = state->fOut.offset();
+    int64_t objCount = catalog->emitXrefTable(&state->fOut, false);
+    emitFooter(&state->fOut, objCount);
+    return true;
+}
+
+void SkPDFDocument::emitPendingPage() {
+    StreamState* state = fStreamState.get();
+    SkPDFPage* page = state->fPendingPage;
+    if (NULL == page) {
+        return;
+    }
+    SkPDFCatalog* catalog = fCatalog.get();
+
+    state->fPool.wait(&state->fPendingDone);
+    state->fTasks.deleteAll();
+
+    state->emit(page, catalog);
+    for (int i = 0; i < state->fPendingObjects.count(); i++) {
+        state->emit(state->fPendingObjects[i], catalog);
+    }
+
+    // Only the page itself (for the page tree) and the fonts stay. If a
+    // later page uses one of the other objects too, it is written again.
+    for (int i = 0; i < state->fPendingObjects.count(); i++) {
+        catalog->retireObject(state->fPendingObjects[i]);
+    }
+    state->fPendingObjects.unrefAll();
+    page->releaseContent();
+    state->fPendingPage = NULL;
+}
+
 bool SkPDFDocument::setPage(int pageNumber, SkPDFDevice* pdfDevice) {
-    if (!fPageTree.isEmpty()) {
+    if (!fPageTree.isEmpty() || fStreamState.get()) {
         return false;
     }
 
@@ -216,12 +446,70 @@ bool SkPDFDocument::setPage(int pageNumber, SkPDFDevice* pdfDevice) {
 }
 
 bool SkPDFDocument::appendPage(SkPDFDevice* pdfDevice) {
-    if (!fPageTree.isEmpty()) {
+    StreamState* state = fStreamState.get();
+    if (!fPageTree.isEmpty() || (state && state->fFinished)) {
         return false;
     }
 
     SkPDFPage* page = new SkPDFPage(pdfDevice);
     fPages.push(page);  // Reference from new passed to fPages.
+    if (NULL == state) {
+        return true;
+    }
+
+    // Write out the previous page first, so that any object it shares with
+    // this one has been retired, and is added back for this page below.
+    this->emitPendingPage();
+
+    SkPDFCatalog* catalog = fCatalog.get();
+    page->insert("Parent", new SkPDFObjRef(state->fPageTreeRoot))->unref();
+    SkTDArray<SkPDFObject*> resources;
+    page->finalizePage(catalog, false, &resources);
+    catalog->addObject(page, false);
+
+    // Hold on to the fonts until the end, since they can only be subset
+    // once every page that uses them is known.
+    const SkPDFGlyphSetMap& usage = page->getFontGlyphUsage();
+    state->fGlyphUsage.merge(usage);
+    SkPDFGlyphSetMap::F2BIter iterator(usage);
+    for (SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next();
+            entry != NULL;
+            entry = iterator.next()) {
+        SkPDFFont* font = entry->fFont;
+        font->ref();
+        if (!append_unique(font, &state->fDeferred)) {
+            continue;
+        }
+        catalog->addObject(font, false);
+        SkTDArray<SkPDFObject*> fontResources;
+        font->getResources(&fontResources);
+        for (int i = 0; i < fontResources.count(); i++) {
+            if (append_unique(fontResources[i], &state->fDeferred)) {
+                catalog->addObject(fontResources[i], false);
+            }
+        }
+    }
+    const SkTDArray<SkPDFFont*>& fonts = page->getFontResources();
+    for (int i = 0; i < fonts.count(); i++) {
+        if (state->fFonts.find(fonts[i]) < 0) {
+            fonts[i]->ref();
+            state->fFonts.push(fonts[i]);
+        }
+    }
+
+    // Everything else goes out with the page, once it has been compressed.
+    SkPDFStream* content = page->getContentStream();
+    content->ref();
+    state->fPendingObjects.push(content);
+    for (int i = 0; i < resources.count(); i++) {
+        if (state->fDeferred.find(resources[i]) >= 0) {
+            resources[i]->unref();
+        } else if (append_unique(resources[i], &state->fPendingObjects)) {
+            catalog->addObject(resources[i], false);
+        }
+    }
+    state->fPendingPage = page;
+    state->prepare(state->fPendingObjects, catalog);
     return true;
 }
 
@@ -231,16 +519,14 @@ void SkPDFDocument::getCountOfFontTypes(
                      (SkAdvancedTypefaceMetrics::kNotEmbeddable_Font + 1));
     SkTDArray<SkFontID> seenFonts;
 
+    // The pages of a streamed document drop their fonts once written.
+    if (fStreamState.get()) {
+        count_font_types(fStreamState->fFonts, &seenFonts, counts);
+        return;
+    }
     for (int pageNumber = 0; pageNumber < fPages.count(); pageNumber++) {
-        const SkTDArray<SkPDFFont*>& fontResources =
-                fPages[pageNumber]->getFontResources();
-        for (int font = 0; font < fontResources.count(); font++) {
-            SkFontID fontID = fontResources[font]->typeface()->uniqueID();
-            if (seenFonts.find(fontID) == -1) {
-                counts[fontResources[font]->getType()]++;
-                seenFonts.push(fontID);
-            }
-        }
+        count_font_types(fPages[pageNumber]->getFontResources(), &seenFonts,
+                         counts);
     }
 }
 
@@ -52,6 +52,12 @@ void SkPDFPage::emitPage(SkWStream* stream, SkPDFCatalog* catalog) {
     fContentStream->emitObject(stream, catalog, true);
 }
 
+void SkPDFPage::releaseContent() {
+    this->clear();
+    fContentStream.reset(NULL);
+    fDevice.reset(NULL);
+}
+
 // static
 void SkPDFPage::GeneratePageTree(const SkTDArray<SkPDFPage*>& pages,
                                  SkPDFCatalog* catalog,
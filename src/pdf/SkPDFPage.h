@@ -63,6 +63,17 @@ public:
      */
     void emitPage(SkWStream* stream, SkPDFCatalog* catalog);
 
+    /** Return the page's content stream, once it has been finalized.
+     */
+    SkPDFStream* getContentStream() const { return fContentStream.get(); }
+
+    /** Drop the page's content, resources and dictionary entries, so that
+     *  all that is left is enough to refer to the page.  Used once a page
+     *  of a streamed document has been written out.  The page can not be
+     *  finalized or emitted again afterwards.
+     */
+    void releaseContent();
+
     /** Generate a page tree for the passed vector of pages.  New objects are
      *  added to the catalog.  The pageTree vector is populated with all of
      *  the 'Pages' dictionaries as well as the 'Page' objects.  Page trees
@@ -82,6 +82,14 @@ size_t SkPDFStream::getOutputSize(SkPDFCatalog* catalog, bool indirect) {
         strlen(" stream\n\nendstream") + fData->getLength();
 }
 
+void SkPDFStream::prepareForEmit(SkPDFCatalog* catalog) {
+    // Only compressing a stream that has not been requested yet is local to
+    // this object; switching to a compressed substitute changes the catalog.
+    if (fState == kUnused_State) {
+        this->populate(catalog);
+    }
+}
+
 SkPDFStream::SkPDFStream() : fState(kUnused_State) {}
 
 void SkPDFStream::setData(SkStream* stream) {
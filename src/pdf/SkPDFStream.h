@@ -42,6 +42,7 @@ public:
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
                             bool indirect);
     virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
+    virtual void prepareForEmit(SkPDFCatalog* catalog);
 
 protected:
     /* Create a PDF stream with no data.  The setData method must be called to
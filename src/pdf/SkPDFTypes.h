@@ -46,6 +46,14 @@ public:
      */
     virtual void getResources(SkTDArray<SkPDFObject*>* resourceList);
 
+    /** Do the expensive part of emitting this object (e.g. compressing a
+     *  stream) ahead of time.  Different objects may be prepared on
+     *  different threads at once, so this must not change the catalog or
+     *  any object other than this one.
+     *  @param catalog  The object catalog to use.
+     */
+    virtual void prepareForEmit(SkPDFCatalog* catalog) {}
+
     /** Emit this object unless the catalog has a substitute object, in which
      *  case emit that.
      *  @see emitObject
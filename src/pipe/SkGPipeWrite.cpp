@@ -16,6 +16,7 @@
 #include "SkGPipePriv.h"
 #include "SkImageFilter.h"
 #include "SkMaskFilter.h"
+#include "SkMeasuredPath.h"
 #include "SkOrderedWriteBuffer.h"
 #include "SkPaint.h"
 #include "SkPathEffect.h"
@@ -243,9 +244,15 @@ public:
     virtual void drawPosTextH(const void* text, size_t byteLength,
                               const SkScalar xpos[], SkScalar constY,
                               const SkPaint&) SK_OVERRIDE;
+    virtual void drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                 const SkPaint&) SK_OVERRIDE;
     virtual void drawTextOnPath(const void* text, size_t byteLength,
                             const SkPath& path, const SkMatrix* matrix,
                                 const SkPaint&) SK_OVERRIDE;
+    virtual void drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                        const SkMeasuredPath& path,
+                                        const SkMatrix* matrix,
+                                        const SkPaint&) SK_OVERRIDE;
     virtual void drawPicture(SkPicture& picture) SK_OVERRIDE;
     virtual void drawVertices(VertexMode, int vertexCount,
                           const SkPoint vertices[], const SkPoint texs[],
@@ -873,6 +880,13 @@ void SkGPipeCanvas::drawPosTextH(const void* text, size_t byteLength,
     }
 }
 
+// The pipe has no op for a batch of runs, so each run goes down it as its
+// own drawPosText, with its color in the paint.
+void SkGPipeCanvas::drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                    const SkPaint& paint) {
+    this->drawPosTextRunsAsPosText(runs, runCount, paint);
+}
+
 void SkGPipeCanvas::drawTextOnPath(const void* text, size_t byteLength,
                                    const SkPath& path, const SkMatrix* matrix,
                                    const SkPaint& paint) {
@@ -899,6 +913,15 @@ void SkGPipeCanvas::drawTextOnPath(const void* text, size_t byteLength,
     }
 }
 
+// The reader measures the path again, since the measurements are not shared
+// across the pipe.
+void SkGPipeCanvas::drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                           const SkMeasuredPath& path,
+                                           const SkMatrix* matrix,
+                                           const SkPaint& paint) {
+    this->drawTextOnPath(text, byteLength, path.getPath(), matrix, paint);
+}
+
 void SkGPipeCanvas::drawPicture(SkPicture& picture) {
     // we want to playback the picture into individual draw calls
     this->INHERITED::drawPicture(picture);
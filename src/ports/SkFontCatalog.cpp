@@ -0,0 +1,201 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkFontCatalog.h"
+#include "SkMMapStream.h"
+#include "SkStream.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum {
+    kMagic = SkSetFourByteTag('s', 'k', 'f', 'c'),
+    kVersion = 1
+};
+
+struct SkFontCatalog::Entry {
+    uint32_t    fPathOffset;    // into the strings
+    uint32_t    fNameOffset;
+    uint32_t    fFileSize;
+    uint32_t    fFileTime;
+    uint8_t     fStyle;
+    uint8_t     fIsFixedWidth;
+    uint16_t    fPad;
+};
+
+SkFontCatalog::SkFontCatalog(const char path[])
+        : fPath(path)
+        , fStream(NULL)
+        , fEntries(NULL)
+        , fCount(0)
+        , fStrings(NULL)
+        , fDirty(true) {
+    if (NULL != path) {
+        this->load();
+    }
+}
+
+SkFontCatalog::~SkFontCatalog() {
+    SkSafeUnref(fStream);
+}
+
+bool SkFontCatalog::stamp(const char path[], uint32_t* size,
+                          uint32_t* time) const {
+    struct stat st;
+    if (NULL == fPath || 0 != stat(path, &st)) {
+        return false;
+    }
+    *size = (uint32_t)st.st_size;
+    *time = (uint32_t)st.st_mtime;
+    return true;
+}
+
+bool SkFontCatalog::find(const char path[], uint32_t size, uint32_t time,
+                         SkString* name, SkTypeface::Style* style,
+                         bool* isFixedWidth) const {
+    int lo = 0;
+    int hi = fCount - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) >> 1;
+        const Entry& entry = fEntries[mid];
+        int cmp = strcmp(fStrings + entry.fPathOffset, path);
+        if (0 == cmp) {
+            if (entry.fFileSize != size || entry.fFileTime != time) {
+                return false;
+            }
+            name->set(fStrings + entry.fNameOffset);
+            *style = (SkTypeface::Style)entry.fStyle;
+            *isFixedWidth = 0 != entry.fIsFixedWidth;
+            return true;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return false;
+}
+
+void SkFontCatalog::add(const char path[], uint32_t size, uint32_t time,
+                        const SkString& name, SkTypeface::Style style,
+                        bool isFixedWidth, bool found) {
+    Record& rec = fRecords.push_back();
+    rec.fPath.set(path);
+    rec.fName = name;
+    rec.fFileSize = size;
+    rec.fFileTime = time;
+    rec.fStyle = style;
+    rec.fIsFixedWidth = isFixedWidth;
+    if (!found) {
+        fDirty = true;
+    }
+}
+
+void SkFontCatalog::save() {
+    if (NULL == fPath) {
+        return;
+    }
+    // a font that was removed leaves an entry that nothing matched
+    if (!fDirty && fRecords.count() == fCount) {
+        return;
+    }
+
+    SkTDArray<Record*> sorted;
+    sorted.setCount(fRecords.count());
+    for (int i = 0; i < fRecords.count(); ++i) {
+        sorted[i] = &fRecords[i];
+    }
+    if (sorted.count() > 1) {
+        SkTQSort(sorted.begin(), sorted.end() - 1);
+    }
+
+    // write a temporary file, and then swap it in, so that a process
+    // starting up at the same time never sees half a catalog
+    SkString tmpPath;
+    tmpPath.printf("%s.%d", fPath, (int)getpid());
+    bool success;
+    {
+        SkFILEWStream stream(tmpPath.c_str());
+        success = stream.isValid() &&
+                  stream.write32(kMagic) &&
+                  stream.write32(kVersion) &&
+                  stream.write32(sorted.count());
+        uint32_t offset = 0;
+        for (int i = 0; success && i < sorted.count(); ++i) {
+            const Record& rec = *sorted[i];
+            Entry entry;
+            entry.fPathOffset = offset;
+            entry.fNameOffset = offset + rec.fPath.size() + 1;
+            entry.fFileSize = rec.fFileSize;
+            entry.fFileTime = rec.fFileTime;
+            entry.fStyle = SkToU8(rec.fStyle);
+            entry.fIsFixedWidth = rec.fIsFixedWidth;
+            entry.fPad = 0;
+            success = stream.write(&entry, sizeof(entry));
+            offset = entry.fNameOffset + rec.fName.size() + 1;
+        }
+        for (int i = 0; success && i < sorted.count(); ++i) {
+            const Record& rec = *sorted[i];
+            success = stream.write(rec.fPath.c_str(), rec.fPath.size() + 1) &&
+                      stream.write(rec.fName.c_str(), rec.fName.size() + 1);
+        }
+    }
+    if (!success || 0 != rename(tmpPath.c_str(), fPath)) {
+        SkDebugf("---- failed to write the font catalog <%s>\n", fPath);
+        remove(tmpPath.c_str());
+    }
+}
+
+void SkFontCatalog::load() {
+    struct stat st;
+    if (0 != stat(fPath, &st)) {
+        return;     // not written yet
+    }
+    SkMMAPStream* stream = SkNEW_ARGS(SkMMAPStream, (fPath));
+    SkAutoUnref aur(stream);
+
+    const size_t headerSize = 3 * sizeof(uint32_t);
+    const char* base = (const char*)stream->getMemoryBase();
+    size_t length = stream->getLength();
+    if (NULL == base || length < headerSize) {
+        return;
+    }
+    const uint32_t* header = (const uint32_t*)base;
+    if (kMagic != header[0] || kVersion != header[1]) {
+        return;
+    }
+    uint32_t count = header[2];
+    if (count > (length - headerSize) / sizeof(Entry)) {
+        return;
+    }
+    size_t stringsOffset = headerSize + count * sizeof(Entry);
+    const char* strings = base + stringsOffset;
+    size_t stringsSize = length - stringsOffset;
+    // every string ends before the end of the file
+    if (0 == stringsSize || 0 != strings[stringsSize - 1]) {
+        return;
+    }
+    const Entry* entries = (const Entry*)(base + headerSize);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (entries[i].fPathOffset >= stringsSize ||
+            entries[i].fNameOffset >= stringsSize ||
+            entries[i].fStyle > SkTypeface::kBoldItalic) {
+            return;
+        }
+    }
+
+    fStream = stream;
+    fStream->ref();
+    fEntries = entries;
+    fCount = count;
+    fStrings = strings;
+    fDirty = false;
+}
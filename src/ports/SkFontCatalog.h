@@ -0,0 +1,92 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFontCatalog_DEFINED
+#define SkFontCatalog_DEFINED
+
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTypeface.h"
+
+class SkMMAPStream;
+
+/*  A cache of the name and style found in each font file, so that starting up
+    with hundreds of fonts does not mean opening and parsing all of them. The
+    directories are still walked, but a file whose size and modification time
+    match its entry is only stat'ed.
+
+    The file is mapped in and used in place. It holds a header, the entries
+    sorted by path, and then the NUL terminated strings they point into:
+
+        uint32_t    kMagic
+        uint32_t    kVersion
+        uint32_t    count
+        Entry       entries[count]
+        char        strings[]
+
+    A file that is truncated or has bad offsets is ignored as if it were
+    missing. If anything was missing, stale or unreadable, save() writes the
+    whole file again.
+ */
+class SkFontCatalog : SkNoncopyable {
+public:
+    /** Load the catalog at path. If path is NULL there is no catalog:
+        nothing is found, and nothing is saved. */
+    explicit SkFontCatalog(const char path[]);
+    ~SkFontCatalog();
+
+    /** Return the number of entries loaded from the file, or 0 if it was
+        missing or rejected. */
+    int count() const { return fCount; }
+
+    /** Return the size and modification time of a file, or false if it
+        cannot be stat'ed or there is no catalog to look it up in. */
+    bool stamp(const char path[], uint32_t* size, uint32_t* time) const;
+
+    /** If the catalog has path with the same size and time, return what was
+        saved for it. */
+    bool find(const char path[], uint32_t size, uint32_t time, SkString* name,
+              SkTypeface::Style* style, bool* isFixedWidth) const;
+
+    /** Record a font file for the catalog that save() writes. If the file
+        was not found in the catalog, the catalog has to be written again. */
+    void add(const char path[], uint32_t size, uint32_t time,
+             const SkString& name, SkTypeface::Style style,
+             bool isFixedWidth, bool found);
+
+    /** Write out the files that were add()ed, if they differ from what
+        was loaded. */
+    void save();
+
+private:
+    struct Entry;
+    struct Record {
+        SkString            fPath;
+        SkString            fName;
+        uint32_t            fFileSize;
+        uint32_t            fFileTime;
+        SkTypeface::Style   fStyle;
+        bool                fIsFixedWidth;
+
+        bool operator<(const Record& other) const {
+            return strcmp(fPath.c_str(), other.fPath.c_str()) < 0;
+        }
+    };
+
+    // Leaves the catalog empty (and so dirty) unless the file is intact.
+    void load();
+
+    const char*         fPath;
+    SkMMAPStream*       fStream;    // keeps the catalog mapped
+    const Entry*        fEntries;
+    int                 fCount;
+    const char*         fStrings;
+    SkTArray<Record>    fRecords;   // the catalog save() writes
+    bool                fDirty;
+};
+
+#endif
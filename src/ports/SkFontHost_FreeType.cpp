@@ -78,10 +78,37 @@ static bool isLCD(const SkScalerContext::Rec& rec) {
 
 struct SkFaceRec;
 
-SK_DECLARE_STATIC_MUTEX(gFTMutex);
-static int          gFTCount;
-static FT_Library   gFTLibrary;
-static SkFaceRec*   gFaceRecHead;
+/*  Scaler contexts are spread over a fixed number of slots, each of which has
+    its own FT_Library and its own list of open faces, guarded by its own
+    mutex. A context only ever uses the slot it was given when it was created,
+    so contexts in different slots can load and render glyphs at the same time,
+    at the cost of each slot opening its own FT_Face for a font. With a single
+    slot (the default) every context shares one library and one lock.
+*/
+#ifndef SK_FONTHOST_FREETYPE_SLOT_COUNT
+    #define SK_FONTHOST_FREETYPE_SLOT_COUNT 1
+#endif
+
+struct SkFTSlot {
+    int             fCount;         // number of contexts using fLibrary
+    FT_Library      fLibrary;
+    SkFaceRec*      fFaceRecHead;
+};
+
+static SK_DECLARE_MUTEX_ARRAY(gFTMutex, SK_FONTHOST_FREETYPE_SLOT_COUNT);
+static SkFTSlot     gFTSlots[SK_FONTHOST_FREETYPE_SLOT_COUNT];
+static int32_t      gFTNextSlot;
+
+// Hand out the slots round robin. Slot 0 is also used by the static
+// SkFontHost calls below.
+static int next_slot_index() {
+    if (SK_FONTHOST_FREETYPE_SLOT_COUNT == 1) {
+        return 0;
+    }
+    uint32_t n = (uint32_t)sk_atomic_inc(&gFTNextSlot);
+    return n % SK_FONTHOST_FREETYPE_SLOT_COUNT;
+}
+
 static bool         gLCDSupportValid;  // true iff |gLCDSupport| has been set.
 static bool         gLCDSupport;  // true iff LCD is supported by the runtime.
 static int          gLCDExtra;  // number of extra pixels for filtering.
@@ -97,21 +124,24 @@ static int          gLCDExtra;  // number of extra pixels for filtering.
 // Android >= Gingerbread (good)
 typedef FT_Error (*FT_Library_SetLcdFilterWeightsProc)(FT_Library, unsigned char*);
 
-// Caller must lock gFTMutex before calling this function.
-static bool InitFreetype() {
-    FT_Error err = FT_Init_FreeType(&gFTLibrary);
+// Creates a library and sets up its LCD filtering. If lcdSupport is not NULL,
+// it is set to whether that filtering is available.
+// Caller must lock the mutex of the slot that will own the library.
+static bool InitFreetype(FT_Library* library, bool* lcdSupport) {
+    FT_Error err = FT_Init_FreeType(library);
     if (err) {
         return false;
     }
+    FT_Library ftLibrary = *library;
+    bool supported = false;
 
     // Setup LCD filtering. This reduces color fringes for LCD smoothed glyphs.
 #ifdef FT_LCD_FILTER_H
     // Use default { 0x10, 0x40, 0x70, 0x40, 0x10 }, as it adds up to 0x110, simulating ink spread.
     // SetLcdFilter must be called before SetLcdFilterWeights.
-    err = FT_Library_SetLcdFilter(gFTLibrary, FT_LCD_FILTER_DEFAULT);
+    err = FT_Library_SetLcdFilter(ftLibrary, FT_LCD_FILTER_DEFAULT);
     if (0 == err) {
-        gLCDSupport = true;
-        gLCDExtra = 2; //Using a filter adds one full pixel to each side.
+        supported = true;
 
 #ifdef SK_FONTHOST_FREETYPE_USE_NORMAL_LCD_FILTER
         // This also adds to 0x110 simulating ink spread, but provides better results than default.
@@ -119,7 +149,7 @@ static bool InitFreetype() {
 
 #if defined(SK_FONTHOST_FREETYPE_RUNTIME_VERSION) && \
             SK_FONTHOST_FREETYPE_RUNTIME_VERSION > 0x020400
-        err = FT_Library_SetLcdFilterWeights(gFTLibrary, gGaussianLikeHeavyWeights);
+        err = FT_Library_SetLcdFilterWeights(ftLibrary, gGaussianLikeHeavyWeights);
 #elif defined(SK_CAN_USE_DLOPEN) && SK_CAN_USE_DLOPEN == 1
         //The FreeType library is already loaded, so symbols are available in process.
         void* self = dlopen(NULL, RTLD_LAZY);
@@ -130,16 +160,16 @@ static bool InitFreetype() {
             dlclose(self);
 
             if (NULL != setLcdFilterWeights) {
-                err = setLcdFilterWeights(gFTLibrary, gGaussianLikeHeavyWeights);
+                err = setLcdFilterWeights(ftLibrary, gGaussianLikeHeavyWeights);
             }
         }
 #endif
 #endif
     }
-#else
-    gLCDSupport = false;
 #endif
-    gLCDSupportValid = true;
+    if (lcdSupport) {
+        *lcdSupport = supported;
+    }
 
     return true;
 }
@@ -147,11 +177,17 @@ static bool InitFreetype() {
 // Lazy, once, wrapper to ask the FreeType Library if it can support LCD text
 static bool is_lcd_supported() {
     if (!gLCDSupportValid) {
-        SkAutoMutexAcquire  ac(gFTMutex);
+        SkAutoMutexAcquire  ac(gFTMutex[0]);
 
         if (!gLCDSupportValid) {
-            InitFreetype();
-            FT_Done_FreeType(gFTLibrary);
+            FT_Library library;
+            bool supported;
+            if (InitFreetype(&library, &supported)) {
+                FT_Done_FreeType(library);
+                gLCDSupport = supported;
+                gLCDExtra = supported ? 2 : 0; //Using a filter adds one full pixel to each side.
+            }
+            gLCDSupportValid = true;
         }
     }
     return gLCDSupport;
@@ -180,8 +216,10 @@ protected:
     virtual SkUnichar generateGlyphToChar(uint16_t glyph) SK_OVERRIDE;
 
 private:
+    SkFTSlot*   fSlot;
+    SkBaseMutex* fMutex;            // fSlot's mutex, also guards fFace
     SkFaceRec*  fFaceRec;
-    FT_Face     fFace;              // reference to shared face in gFaceRecHead
+    FT_Face     fFace;              // reference to shared face in fSlot
     FT_Size     fFTSize;            // our own copy
     SkFixed     fScaleX, fScaleY;
     FT_Matrix   fMatrix22;
@@ -192,7 +230,7 @@ private:
     FT_Error setupSize();
     void getBBoxForCurrentGlyph(SkGlyph* glyph, FT_BBox* bbox,
                                 bool snapToPixelBoundary = false);
-    // Caller must lock gFTMutex before calling this function.
+    // Caller must lock fMutex before calling this function.
     void updateGlyphIfLCD(SkGlyph* glyph);
 };
 
@@ -216,6 +254,11 @@ struct SkFaceRec {
     }
 };
 
+// The faces that different slots open for the same font may read from the
+// same SkStream (e.g. for a typeface created from a stream), so the reads,
+// which each rewind it, are serialized.
+SK_DECLARE_STATIC_MUTEX(gFTStreamMutex);
+
 extern "C" {
     static unsigned long sk_stream_read(FT_Stream       stream,
                                         unsigned long   offset,
@@ -224,6 +267,8 @@ extern "C" {
         SkStream* str = (SkStream*)stream->descriptor.pointer;
 
         if (count) {
+            SkAutoMutexAcquire  ac(gFTStreamMutex);
+
             if (!str->rewind()) {
                 return 0;
             } else {
@@ -259,9 +304,9 @@ SkFaceRec::SkFaceRec(SkStream* strm, uint32_t fontID)
 }
 
 // Will return 0 on failure
-// Caller must lock gFTMutex before calling this function.
-static SkFaceRec* ref_ft_face(uint32_t fontID) {
-    SkFaceRec* rec = gFaceRecHead;
+// Caller must lock the slot's mutex before calling this function.
+static SkFaceRec* ref_ft_face(SkFTSlot* slot, uint32_t fontID) {
+    SkFaceRec* rec = slot->fFaceRecHead;
     while (rec) {
         if (rec->fFontID == fontID) {
             SkASSERT(rec->fFace);
@@ -297,7 +342,7 @@ static SkFaceRec* ref_ft_face(uint32_t fontID) {
 
     int face_index;
     int length = SkFontHost::GetFileName(fontID, NULL, 0, &face_index);
-    FT_Error err = FT_Open_Face(gFTLibrary, &args, length ? face_index : 0,
+    FT_Error err = FT_Open_Face(slot->fLibrary, &args, length ? face_index : 0,
                                 &rec->fFace);
 
     if (err) {    // bad filename, try the default font
@@ -307,15 +352,15 @@ static SkFaceRec* ref_ft_face(uint32_t fontID) {
     } else {
         SkASSERT(rec->fFace);
         //fprintf(stderr, "Opened font '%s'\n", filename.c_str());
-        rec->fNext = gFaceRecHead;
-        gFaceRecHead = rec;
+        rec->fNext = slot->fFaceRecHead;
+        slot->fFaceRecHead = rec;
         return rec;
     }
 }
 
-// Caller must lock gFTMutex before calling this function.
-static void unref_ft_face(FT_Face face) {
-    SkFaceRec*  rec = gFaceRecHead;
+// Caller must lock the slot's mutex before calling this function.
+static void unref_ft_face(SkFTSlot* slot, FT_Face face) {
+    SkFaceRec*  rec = slot->fFaceRecHead;
     SkFaceRec*  prev = NULL;
     while (rec) {
         SkFaceRec* next = rec->fNext;
@@ -324,7 +369,7 @@ static void unref_ft_face(FT_Face face) {
                 if (prev) {
                     prev->fNext = next;
                 } else {
-                    gFaceRecHead = next;
+                    slot->fFaceRecHead = next;
                 }
                 FT_Done_Face(face);
                 SkDELETE(rec);
@@ -456,15 +501,16 @@ SkAdvancedTypefaceMetrics* SkFontHost::GetAdvancedTypefaceMetrics(
 #if defined(SK_BUILD_FOR_MAC)
     return NULL;
 #else
-    SkAutoMutexAcquire ac(gFTMutex);
+    SkAutoMutexAcquire ac(gFTMutex[0]);
+    SkFTSlot* slot = &gFTSlots[0];
     FT_Library libInit = NULL;
-    if (gFTCount == 0) {
-        if (!InitFreetype())
+    if (slot->fCount == 0) {
+        if (!InitFreetype(&slot->fLibrary, NULL))
             sk_throw();
-        libInit = gFTLibrary;
+        libInit = slot->fLibrary;
     }
     SkAutoTCallIProc<struct FT_LibraryRec_, FT_Done_FreeType> ftLib(libInit);
-    SkFaceRec* rec = ref_ft_face(fontID);
+    SkFaceRec* rec = ref_ft_face(slot, fontID);
     if (NULL == rec)
         return NULL;
     FT_Face face = rec->fFace;
@@ -632,7 +678,7 @@ SkAdvancedTypefaceMetrics* SkFontHost::GetAdvancedTypefaceMetrics(
     if (!canEmbed(face))
         info->fType = SkAdvancedTypefaceMetrics::kNotEmbeddable_Font;
 
-    unref_ft_face(face);
+    unref_ft_face(slot, face);
     return info;
 #endif
 }
@@ -693,13 +739,13 @@ void SkFontHost::FilterRec(SkScalerContext::Rec* rec, SkTypeface*) {
 
 #ifdef SK_BUILD_FOR_ANDROID
 uint32_t SkFontHost::GetUnitsPerEm(SkFontID fontID) {
-    SkAutoMutexAcquire ac(gFTMutex);
-    SkFaceRec *rec = ref_ft_face(fontID);
+    SkAutoMutexAcquire ac(gFTMutex[0]);
+    SkFaceRec *rec = ref_ft_face(&gFTSlots[0], fontID);
     uint16_t unitsPerEm = 0;
 
     if (rec != NULL && rec->fFace != NULL) {
         unitsPerEm = rec->fFace->units_per_EM;
-        unref_ft_face(rec->fFace);
+        unref_ft_face(&gFTSlots[0], rec->fFace);
     }
 
     return (uint32_t)unitsPerEm;
@@ -708,19 +754,25 @@ uint32_t SkFontHost::GetUnitsPerEm(SkFontID fontID) {
 
 SkScalerContext_FreeType::SkScalerContext_FreeType(const SkDescriptor* desc)
         : SkScalerContext_FreeType_Base(desc) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    // sets up gLCDExtra before any glyphs are measured
+    is_lcd_supported();
+
+    int index = next_slot_index();
+    fSlot = &gFTSlots[index];
+    fMutex = &gFTMutex[index];
+    SkAutoMutexAcquire  ac(*fMutex);
 
-    if (gFTCount == 0) {
-        if (!InitFreetype()) {
+    if (fSlot->fCount == 0) {
+        if (!InitFreetype(&fSlot->fLibrary, NULL)) {
             sk_throw();
         }
     }
-    ++gFTCount;
+    ++fSlot->fCount;
 
     // load the font file
     fFTSize = NULL;
     fFace = NULL;
-    fFaceRec = ref_ft_face(fRec.fFontID);
+    fFaceRec = ref_ft_face(fSlot, fRec.fFontID);
     if (NULL == fFaceRec) {
         return;
     }
@@ -886,19 +938,19 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(const SkDescriptor* desc)
 }
 
 SkScalerContext_FreeType::~SkScalerContext_FreeType() {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(*fMutex);
 
     if (fFTSize != NULL) {
         FT_Done_Size(fFTSize);
     }
 
     if (fFace != NULL) {
-        unref_ft_face(fFace);
+        unref_ft_face(fSlot, fFace);
     }
-    if (--gFTCount == 0) {
+    if (--fSlot->fCount == 0) {
 //        SkDEBUGF(("FT_Done_FreeType\n"));
-        FT_Done_FreeType(gFTLibrary);
-        SkDEBUGCODE(gFTLibrary = NULL;)
+        FT_Done_FreeType(fSlot->fLibrary);
+        SkDEBUGCODE(fSlot->fLibrary = NULL;)
     }
 }
 
@@ -949,7 +1001,7 @@ void SkScalerContext_FreeType::generateAdvance(SkGlyph* glyph) {
     * which are very cheap to compute with some font formats...
     */
     if (fDoLinearMetrics) {
-        SkAutoMutexAcquire  ac(gFTMutex);
+        SkAutoMutexAcquire  ac(*fMutex);
 
         if (this->setupSize()) {
             glyph->zeroMetrics();
@@ -1028,7 +1080,7 @@ void SkScalerContext_FreeType::updateGlyphIfLCD(SkGlyph* glyph) {
 }
 
 void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(*fMutex);
 
     glyph->fRsbDelta = 0;
     glyph->fLsbDelta = 0;
@@ -1081,7 +1133,7 @@ void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
       case FT_GLYPH_FORMAT_BITMAP:
         if (fRec.fFlags & kEmbolden_Flag) {
             FT_GlyphSlot_Own_Bitmap(fFace->glyph);
-            FT_Bitmap_Embolden(gFTLibrary, &fFace->glyph->bitmap, kBitmapEmboldenStrength, 0);
+            FT_Bitmap_Embolden(fSlot->fLibrary, &fFace->glyph->bitmap, kBitmapEmboldenStrength, 0);
         }
 
         if (fRec.fFlags & SkScalerContext::kVertical_Flag) {
@@ -1136,7 +1188,7 @@ void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
 
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(*fMutex);
 
     FT_Error    err;
 
@@ -1159,7 +1211,7 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
 
 void SkScalerContext_FreeType::generatePath(const SkGlyph& glyph,
                                             SkPath* path) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(*fMutex);
 
     SkASSERT(&glyph && path);
 
@@ -1200,7 +1252,7 @@ void SkScalerContext_FreeType::generateFontMetrics(SkPaint::FontMetrics* mx,
         return;
     }
 
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(*fMutex);
 
     if (this->setupSize()) {
         ERROR:
@@ -8,6 +8,7 @@
 
 
 #include "SkFontHost.h"
+#include "SkFontCatalog.h"
 #include "SkFontDescriptor.h"
 #include "SkDescriptor.h"
 #include "SkMMapStream.h"
@@ -24,6 +25,12 @@
 #ifndef SK_FONT_FILE_DIR_SEPERATOR
     #define SK_FONT_FILE_DIR_SEPERATOR "/"
 #endif
+/*  Define this to the path of a file in which to keep the name and style of
+    each system font between runs (see SkFontCatalog), e.g.
+    "/var/cache/skia/fonts.catalog". If it is undefined, every font file is
+    opened and parsed each time the fonts are loaded.
+ */
+//#define SK_FONT_CATALOG_FILE "/var/cache/skia/fonts.catalog"
 
 bool find_name_and_attributes(SkStream* stream, SkString* name,
                               SkTypeface::Style* style, bool* isFixedWidth);
@@ -374,12 +381,15 @@ static bool get_name_and_style(const char path[], SkString* name,
     return false;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
 // these globals are assigned (once) by load_system_fonts()
 static SkTypeface* gFallBackTypeface;
 static FamilyRec* gDefaultFamily;
 static SkTypeface* gDefaultNormal;
 
-static void load_directory_fonts(const SkString& directory, unsigned int* count) {
+static void load_directory_fonts(const SkString& directory, unsigned int* count,
+                                 SkFontCatalog* catalog) {
     SkOSFile::Iter  iter(directory.c_str(), ".ttf");
     SkString        name;
 
@@ -391,10 +401,20 @@ static void load_directory_fonts(const SkString& directory, unsigned int* count)
         SkString realname;
         SkTypeface::Style style = SkTypeface::kNormal; // avoid uninitialized warning
 
-        if (!get_name_and_style(filename.c_str(), &realname, &style, &isFixedWidth)) {
+        uint32_t fileSize, fileTime;
+        bool stamped = catalog->stamp(filename.c_str(), &fileSize, &fileTime);
+        bool found = stamped &&
+                     catalog->find(filename.c_str(), fileSize, fileTime,
+                                   &realname, &style, &isFixedWidth);
+        if (!found &&
+            !get_name_and_style(filename.c_str(), &realname, &style, &isFixedWidth)) {
             SkDebugf("------ can't load <%s> as a font\n", filename.c_str());
             continue;
         }
+        if (stamped) {
+            catalog->add(filename.c_str(), fileSize, fileTime, realname, style,
+                         isFixedWidth, found);
+        }
 
         FamilyRec* family = find_familyrec(realname.c_str());
         if (family && family->fFaces[style]) {
@@ -424,7 +444,7 @@ static void load_directory_fonts(const SkString& directory, unsigned int* count)
         SkString dirname(directory);
         dirname.append(name);
         dirname.append(SK_FONT_FILE_DIR_SEPERATOR);
-        load_directory_fonts(dirname, count);
+        load_directory_fonts(dirname, count, catalog);
     }
 }
 
@@ -434,9 +454,16 @@ static void load_system_fonts() {
         return;
     }
 
+#ifdef SK_FONT_CATALOG_FILE
+    SkFontCatalog catalog(SK_FONT_CATALOG_FILE);
+#else
+    SkFontCatalog catalog(NULL);
+#endif
+
     SkString baseDirectory(SK_FONT_FILE_PREFIX);
     unsigned int count = 0;
-    load_directory_fonts(baseDirectory, &count);
+    load_directory_fonts(baseDirectory, &count, &catalog);
+    catalog.save();
 
     if (0 == count) {
         SkNEW(EmptyTypeface);
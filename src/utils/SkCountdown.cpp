@@ -6,7 +6,6 @@
  */
 
 #include "SkCountdown.h"
-#include "SkThread.h"
 
 SkCountdown::SkCountdown(int32_t count)
 : fCount(count) {}
@@ -16,11 +15,13 @@ void SkCountdown::reset(int32_t count) {
 }
 
 void SkCountdown::run() {
-    if (sk_atomic_dec(&fCount) == 1) {
-        fReady.lock();
-        fReady.signal();
-        fReady.unlock();
+    // Count down while holding the lock: a waiter that sees zero may destroy
+    // us straight away, so we must not touch the lock once it is released.
+    fReady.lock();
+    if (--fCount == 0) {
+        fReady.broadcast();
     }
+    fReady.unlock();
 }
 
 void SkCountdown::wait() {
@@ -31,3 +32,11 @@ void SkCountdown::wait() {
     fReady.unlock();
 }
 
+bool SkCountdown::isDone() {
+    // Take the lock, so that the caller sees everything done before the last
+    // call to run().
+    fReady.lock();
+    bool done = fCount <= 0;
+    fReady.unlock();
+    return done;
+}
@@ -281,6 +281,10 @@ protected:
                                 const SkScalar pos[], SkScalar constY,
                                 int scalarsPerPos, const SkPaint& paint)
         {SkASSERT(0);}
+    virtual void drawPosTextRuns(const SkDraw&,
+                                 const SkCanvas::PosTextRun runs[],
+                                 int runCount, const SkPaint& paint)
+        {SkASSERT(0);}
     virtual void drawTextOnPath(const SkDraw&, const void* text,
                                 size_t len, const SkPath& path,
                                 const SkMatrix* matrix,
@@ -945,6 +949,13 @@ void SkDeferredCanvas::drawPosTextH(const void* text, size_t byteLength,
     this->recordedDrawCommand();
 }
 
+void SkDeferredCanvas::drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                       const SkPaint& paint) {
+    AutoImmediateDrawIfNeeded autoDraw(*this, &paint);
+    this->drawingCanvas()->drawPosTextRuns(runs, runCount, paint);
+    this->recordedDrawCommand();
+}
+
 void SkDeferredCanvas::drawTextOnPath(const void* text, size_t byteLength,
                                       const SkPath& path,
                                       const SkMatrix* matrix,
@@ -954,6 +965,17 @@ void SkDeferredCanvas::drawTextOnPath(const void* text, size_t byteLength,
     this->recordedDrawCommand();
 }
 
+void SkDeferredCanvas::drawTextOnMeasuredPath(const void* text,
+                                              size_t byteLength,
+                                              const SkMeasuredPath& path,
+                                              const SkMatrix* matrix,
+                                              const SkPaint& paint) {
+    AutoImmediateDrawIfNeeded autoDraw(*this, &paint);
+    this->drawingCanvas()->drawTextOnMeasuredPath(text, byteLength, path,
+                                                  matrix, paint);
+    this->recordedDrawCommand();
+}
+
 void SkDeferredCanvas::drawPicture(SkPicture& picture) {
     this->drawingCanvas()->drawPicture(picture);
     this->recordedDrawCommand();
@@ -407,6 +407,16 @@ void SkDumpCanvas::drawPosTextH(const void* text, size_t byteLength,
                SkScalarToFloat(constY));
 }
 
+void SkDumpCanvas::drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                   const SkPaint& paint) {
+    int glyphCount = 0;
+    for (int i = 0; i < runCount; ++i) {
+        glyphCount += runs[i].fCount;
+    }
+    this->dump(kDrawText_Verb, &paint, "drawPosTextRuns(%d runs, %d glyphs)",
+               runCount, glyphCount);
+}
+
 void SkDumpCanvas::drawTextOnPath(const void* text, size_t byteLength,
                                    const SkPath& path, const SkMatrix* matrix,
                                    const SkPaint& paint) {
@@ -416,6 +426,16 @@ void SkDumpCanvas::drawTextOnPath(const void* text, size_t byteLength,
                str.c_str(), byteLength);
 }
 
+void SkDumpCanvas::drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                          const SkMeasuredPath& path,
+                                          const SkMatrix* matrix,
+                                          const SkPaint& paint) {
+    SkString str;
+    toString(text, byteLength, paint.getTextEncoding(), &str);
+    this->dump(kDrawText_Verb, &paint, "drawTextOnMeasuredPath(%s [%d])",
+               str.c_str(), byteLength);
+}
+
 void SkDumpCanvas::drawPicture(SkPicture& picture) {
     this->dump(kDrawPicture_Verb, NULL, "drawPicture(%p) %d:%d", &picture,
                picture.width(), picture.height());
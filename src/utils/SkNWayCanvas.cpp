@@ -268,6 +268,14 @@ void SkNWayCanvas::drawPosTextH(const void* text, size_t byteLength,
     }
 }
 
+void SkNWayCanvas::drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                   const SkPaint& paint) {
+    Iter iter(fList);
+    while (iter.next()) {
+        iter->drawPosTextRuns(runs, runCount, paint);
+    }
+}
+
 void SkNWayCanvas::drawTextOnPath(const void* text, size_t byteLength,
                                   const SkPath& path, const SkMatrix* matrix,
                                   const SkPaint& paint) {
@@ -277,6 +285,16 @@ void SkNWayCanvas::drawTextOnPath(const void* text, size_t byteLength,
     }
 }
 
+void SkNWayCanvas::drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                          const SkMeasuredPath& path,
+                                          const SkMatrix* matrix,
+                                          const SkPaint& paint) {
+    Iter iter(fList);
+    while (iter.next()) {
+        iter->drawTextOnMeasuredPath(text, byteLength, path, matrix, paint);
+    }
+}
+
 void SkNWayCanvas::drawPicture(SkPicture& picture) {
     Iter iter(fList);
     while (iter.next()) {
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkParallelRaster.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkCountdown.h"
+#include "SkDevice.h"
+#include "SkPicture.h"
+#include "SkRunnable.h"
+#include "SkTDArray.h"
+#include "SkThread.h"
+#include "SkThreadPool.h"
+
+namespace {
+
+// The state shared by all of the workers. Everything here is read-only while
+// the workers run, except fNextTile which is only touched atomically.
+struct TileSet {
+    const SkBitmap* fDst;       // locked by the caller for the whole draw
+    int             fTileWidth;
+    int             fTileHeight;
+    int             fTilesAcross;
+    int             fTileCount;
+    int32_t         fNextTile;
+};
+
+// Draws tiles from its own picture until the set runs out.
+class TileWorker : public SkRunnable {
+public:
+    TileWorker(SkPicture* picture, TileSet* tiles, SkRunnable* done)
+        : fPicture(picture)
+        , fTiles(tiles)
+        , fDone(done) {}
+
+    virtual void run() SK_OVERRIDE {
+        int32_t index;
+        while ((index = sk_atomic_inc(&fTiles->fNextTile)) < fTiles->fTileCount) {
+            this->drawTile(index);
+        }
+        if (NULL != fDone) {
+            fDone->run();
+        }
+    }
+
+private:
+    void drawTile(int index) {
+        const SkBitmap& dst = *fTiles->fDst;
+        int x = (index % fTiles->fTilesAcross) * fTiles->fTileWidth;
+        int y = (index / fTiles->fTilesAcross) * fTiles->fTileHeight;
+        int w = SkMin32(fTiles->fTileWidth, dst.width() - x);
+        int h = SkMin32(fTiles->fTileHeight, dst.height() - y);
+
+        // Wrap the tile's pixels directly rather than going through a subset
+        // pixelref, so that the workers never touch a shared lock count.
+        SkBitmap tile;
+        tile.setConfig(dst.config(), w, h, dst.rowBytes());
+        tile.setPixels(dst.getAddr(x, y), dst.getColorTable());
+
+        SkDevice device(tile);
+        SkCanvas canvas(&device);
+        canvas.translate(-SkIntToScalar(x), -SkIntToScalar(y));
+        canvas.drawPicture(*fPicture);
+    }
+
+    SkPicture*  fPicture;
+    TileSet*    fTiles;
+    SkRunnable* fDone;
+};
+
+}
+
+bool SkParallelRaster::DrawPicture(SkPicture* picture, SkBitmap* dst,
+                                   int threadCount, int tileWidth,
+                                   int tileHeight) {
+    if (NULL == picture || NULL == dst || threadCount < 1 ||
+            tileWidth < 1 || tileHeight < 1) {
+        return false;
+    }
+
+    SkAutoLockPixels alp(*dst);
+    if (NULL == dst->getPixels() || dst->width() <= 0 || dst->height() <= 0) {
+        return false;
+    }
+
+    TileSet tiles;
+    tiles.fDst = dst;
+    tiles.fTileWidth = tileWidth;
+    tiles.fTileHeight = tileHeight;
+    tiles.fTilesAcross = (dst->width() + tileWidth - 1) / tileWidth;
+    tiles.fTileCount = tiles.fTilesAcross *
+                       ((dst->height() + tileHeight - 1) / tileHeight);
+    tiles.fNextTile = 0;
+
+    // no point in starting threads that would never get a tile
+    threadCount = SkMin32(threadCount, tiles.fTileCount);
+    if (1 == threadCount) {
+        TileWorker worker(picture, &tiles, NULL);
+        worker.run();
+        return true;
+    }
+
+    // The calling thread draws from the original picture; the others each
+    // get a clone, since playback is not thread-safe.
+    SkPicture* clones = SkNEW_ARRAY(SkPicture, threadCount - 1);
+    picture->clone(clones, threadCount - 1);
+
+    SkCountdown countdown(threadCount - 1);
+    SkTDArray<TileWorker*> workers;
+    for (int i = 0; i < threadCount - 1; ++i) {
+        *workers.append() = SkNEW_ARGS(TileWorker,
+                                       (&clones[i], &tiles, &countdown));
+    }
+
+    {
+        SkThreadPool pool(threadCount - 1);
+        for (int i = 0; i < workers.count(); ++i) {
+            pool.add(workers[i]);
+        }
+        TileWorker self(picture, &tiles, NULL);
+        self.run();
+        countdown.wait();
+    }
+
+    workers.deleteAll();
+    SkDELETE_ARRAY(clones);
+    return true;
+}
@@ -135,12 +135,24 @@ void SkProxyCanvas::drawPosTextH(const void* text, size_t byteLength,
     fProxy->drawPosTextH(text, byteLength, xpos, constY, paint);
 }
 
+void SkProxyCanvas::drawPosTextRuns(const PosTextRun runs[], int runCount,
+                                    const SkPaint& paint) {
+    fProxy->drawPosTextRuns(runs, runCount, paint);
+}
+
 void SkProxyCanvas::drawTextOnPath(const void* text, size_t byteLength,
                                    const SkPath& path, const SkMatrix* matrix,
                                    const SkPaint& paint) {
     fProxy->drawTextOnPath(text, byteLength, path, matrix, paint);
 }
 
+void SkProxyCanvas::drawTextOnMeasuredPath(const void* text, size_t byteLength,
+                                           const SkMeasuredPath& path,
+                                           const SkMatrix* matrix,
+                                           const SkPaint& paint) {
+    fProxy->drawTextOnMeasuredPath(text, byteLength, path, matrix, paint);
+}
+
 void SkProxyCanvas::drawPicture(SkPicture& picture) {
     fProxy->drawPicture(picture);
 }
@@ -6,83 +6,303 @@
  */
 
 #include "SkThreadPool.h"
+#include "SkCountdown.h"
 #include "SkRunnable.h"
+#include "SkTemplates.h"
+#include "SkThread.h"
 #include "SkThreadUtils.h"
+#include "SkTLS.h"
+
+/**
+ * One thread of the pool, and its queue. The thread pushes and pops at the
+ * back of the queue, which keeps it working on what it queued most recently
+ * (and whose data is most likely still in its cache), while other threads
+ * steal from the front. Each queue has its own lock, so threads only contend
+ * when one is stealing from another.
+ */
+class SkThreadPool::Worker {
+public:
+    Worker(SkThreadPool* pool, int index)
+        : fPool(pool)
+        , fIndex(index)
+        , fThread(NULL)
+        , fHead(0) {}
+
+    ~Worker() { SkDELETE(fThread); }
+
+    void push(const Task& task) {
+        SkAutoMutexAcquire ama(fLock);
+        *fTasks.append() = task;
+    }
+
+    bool popNewest(Task* task) {
+        SkAutoMutexAcquire ama(fLock);
+        if (fTasks.count() == fHead) {
+            return false;
+        }
+        fTasks.pop(task);
+        this->compact();
+        return true;
+    }
+
+    bool stealOldest(Task* task) {
+        SkAutoMutexAcquire ama(fLock);
+        if (fTasks.count() == fHead) {
+            return false;
+        }
+        *task = fTasks[fHead++];
+        this->compact();
+        return true;
+    }
+
+    SkThreadPool*   fPool;
+    int             fIndex;
+    SkThread*       fThread;
+
+private:
+    // Once the queue is empty, start over at the beginning of the array.
+    void compact() {
+        if (fTasks.count() == fHead) {
+            fTasks.rewind();
+            fHead = 0;
+        }
+    }
+
+    SkMutex         fLock;
+    SkTDArray<Task> fTasks;
+    int             fHead;  // The oldest task, fTasks[0..fHead) have been stolen.
+};
+
+namespace {
+
+// Each of the pool's threads records which pool and queue it belongs to, so
+// that tasks added from within a task go on that thread's queue.
+struct CurrentWorker {
+    const SkThreadPool* fPool;
+    int                 fIndex;
+};
+
+void* CreateCurrentWorker() {
+    CurrentWorker* current = SkNEW(CurrentWorker);
+    current->fPool = NULL;
+    current->fIndex = -1;
+    return current;
+}
+
+void DeleteCurrentWorker(void* current) {
+    SkDELETE(static_cast<CurrentWorker*>(current));
+}
+
+}
 
 SkThreadPool::SkThreadPool(const int count)
-: fDone(false) {
-    // Create count threads, all running SkThreadPool::Loop.
+: fPending(0)
+, fSleeping(0)
+, fNextWorker(0)
+, fDone(false) {
+    for (int i = 0; i < count; i++) {
+        *fWorkers.append() = SkNEW_ARGS(Worker, (this, i));
+    }
+    // Create the threads once all of the queues exist, since they steal from each other.
     for (int i = 0; i < count; i++) {
-        SkThread* thread = SkNEW_ARGS(SkThread, (&SkThreadPool::Loop, this));
-        *fThreads.append() = thread;
-        thread->start();
+        fWorkers[i]->fThread = SkNEW_ARGS(SkThread, (&SkThreadPool::Loop, fWorkers[i]));
+        fWorkers[i]->fThread->start();
     }
 }
 
 SkThreadPool::~SkThreadPool() {
-    fDone = true;
     fReady.lock();
+    fDone = true;
     fReady.broadcast();
     fReady.unlock();
 
     // Wait for all threads to stop.
-    for (int i = 0; i < fThreads.count(); i++) {
-        fThreads[i]->join();
-        SkDELETE(fThreads[i]);
+    for (int i = 0; i < fWorkers.count(); i++) {
+        fWorkers[i]->fThread->join();
+    }
+    fWorkers.deleteAll();
+}
+
+int SkThreadPool::currentWorker() const {
+    CurrentWorker* current = static_cast<CurrentWorker*>(SkTLS::Find(CreateCurrentWorker));
+    if (NULL != current && current->fPool == this) {
+        return current->fIndex;
+    }
+    return -1;
+}
+
+void SkThreadPool::push(const Task& task) {
+    int index = this->currentWorker();
+    if (index < 0) {
+        // Spread tasks from other threads over all of the queues.
+        index = (sk_atomic_inc(&fNextWorker) & 0x7FFFFFFF) % fWorkers.count();
+    }
+
+    // A thread going to sleep counts itself in fSleeping before it checks
+    // fPending, and we count the task in fPending before checking fSleeping,
+    // so (both atomics being full barriers) either it sees our task or we see
+    // that it needs waking. Counting it before it is queued means fPending
+    // never drops below zero.
+    sk_atomic_inc(&fPending);
+    fWorkers[index]->push(task);
+    if (fSleeping > 0) {
+        fReady.lock();
+        fReady.signal();
+        fReady.unlock();
+    }
+}
+
+bool SkThreadPool::claim(int self, Task* task) {
+    const int count = fWorkers.count();
+    bool found = self >= 0 && fWorkers[self]->popNewest(task);
+    // Look for something to steal, starting with our neighbour.
+    for (int i = 1; !found && i <= count; i++) {
+        int victim = (self + i) % count;
+        found = victim != self && fWorkers[victim]->stealOldest(task);
+    }
+    if (found) {
+        sk_atomic_dec(&fPending);
+    }
+    return found;
+}
+
+/*static*/ void SkThreadPool::RunTask(const Task& task) {
+    task.fRunnable->run();
+    if (NULL != task.fDone) {
+        task.fDone->run();
     }
 }
 
 /*static*/ void SkThreadPool::Loop(void* arg) {
-    // The SkThreadPool passes itself as arg to each thread as they're created.
-    SkThreadPool* pool = static_cast<SkThreadPool*>(arg);
+    // The SkThreadPool passes each thread its Worker as they're created.
+    Worker* self = static_cast<Worker*>(arg);
+    SkThreadPool* pool = self->fPool;
+    CurrentWorker* current = static_cast<CurrentWorker*>(
+            SkTLS::Get(CreateCurrentWorker, DeleteCurrentWorker));
+    current->fPool = pool;
+    current->fIndex = self->fIndex;
 
     while (true) {
-        // We have to be holding the lock to read the queue and to call wait.
+        Task task;
+        if (pool->claim(self->fIndex, &task)) {
+            RunTask(task);
+            continue;
+        }
+
+        // Nothing to run or steal. We have to be holding the lock to call wait.
         pool->fReady.lock();
-        while(pool->fQueue.isEmpty()) {
-            // Is it time to die?
-            if (pool->fDone) {
-                pool->fReady.unlock();
-                return;
-            }
+        sk_atomic_inc(&pool->fSleeping);
+        while (0 == pool->fPending && !pool->fDone) {
             // wait yields the lock while waiting, but will have it again when awoken.
             pool->fReady.wait();
         }
-        // We've got the lock back here, no matter if we ran wait or not.
-
-        // The queue is not empty, so we have something to run.  Claim it.
-        LinkedRunnable* r = pool->fQueue.tail();
-
-        pool->fQueue.remove(r);
-
-        // Having claimed our SkRunnable, we now give up the lock while we run it.
-        // Otherwise, we'd only ever do work on one thread at a time, which rather
-        // defeats the point of this code.
+        sk_atomic_dec(&pool->fSleeping);
+        // Is it time to die? Not until everything queued has been run.
+        bool done = pool->fDone && 0 == pool->fPending;
         pool->fReady.unlock();
-
-        // OK, now really do the work.
-        r->fRunnable->run();
-        SkDELETE(r);
+        if (done) {
+            return;
+        }
     }
-
-    SkASSERT(false); // Unreachable.  The only exit happens when pool->fDone.
 }
 
 void SkThreadPool::add(SkRunnable* r) {
+    this->add(r, NULL);
+}
+
+void SkThreadPool::add(SkRunnable* r, SkCountdown* done) {
     if (NULL == r) {
         return;
     }
 
+    Task task;
+    task.fRunnable = r;
+    task.fDone = done;
+
     // If we don't have any threads, obligingly just run the thing now.
-    if (fThreads.isEmpty()) {
-        return r->run();
+    if (fWorkers.isEmpty()) {
+        return RunTask(task);
     }
 
     // We have some threads.  Queue it up!
-    fReady.lock();
-    LinkedRunnable* linkedRunnable = SkNEW(LinkedRunnable);
-    linkedRunnable->fRunnable = r;
-    fQueue.addToHead(linkedRunnable);
-    fReady.signal();
-    fReady.unlock();
+    this->push(task);
+}
+
+void SkThreadPool::wait(SkCountdown* done) {
+    // Rather than sitting idle, help with whatever is queued. Once there is
+    // nothing left to claim, everything we are waiting for is already running
+    // on another thread.
+    const int self = this->currentWorker();
+    while (!done->isDone()) {
+        Task task;
+        if (fWorkers.isEmpty() || !this->claim(self, &task)) {
+            done->wait();
+            return;
+        }
+        RunTask(task);
+    }
+}
+
+namespace {
+
+// The range being split up by parallelFor(). Only fNextChunk changes while
+// the tasks run, and it is only touched atomically.
+struct ParallelRange {
+    SkRangeRunnable* fBody;
+    int              fBegin;
+    int              fEnd;
+    int              fGrain;
+    int32_t          fChunkCount;
+    int32_t          fNextChunk;
+};
+
+// Runs chunks of the range until there are none left.
+class RangeTask : public SkRunnable {
+public:
+    RangeTask() : fRange(NULL) {}
+
+    void setRange(ParallelRange* range) { fRange = range; }
+
+    virtual void run() SK_OVERRIDE {
+        int32_t chunk;
+        while ((chunk = sk_atomic_inc(&fRange->fNextChunk)) < fRange->fChunkCount) {
+            int start = fRange->fBegin + chunk * fRange->fGrain;
+            int stop = SkMin32(start + fRange->fGrain, fRange->fEnd);
+            fRange->fBody->run(start, stop);
+        }
+    }
+
+private:
+    ParallelRange* fRange;
+};
+
+}
+
+void SkThreadPool::parallelFor(int begin, int end, SkRangeRunnable* body, int grain) {
+    if (NULL == body || begin >= end) {
+        return;
+    }
+
+    ParallelRange range;
+    range.fBody = body;
+    range.fBegin = begin;
+    range.fEnd = end;
+    range.fGrain = SkMax32(grain, 1);
+    range.fChunkCount = (end - begin - 1) / range.fGrain + 1;
+    range.fNextChunk = 0;
+
+    // The calling thread takes chunks too, so only ask for help from as many
+    // threads as there are chunks left over.
+    const int helpers = SkMin32(fWorkers.count(), range.fChunkCount - 1);
+    SkAutoSTArray<8, RangeTask> tasks(helpers);
+    SkCountdown countdown(helpers);
+    for (int i = 0; i < helpers; i++) {
+        tasks[i].setRange(&range);
+        this->add(&tasks[i], &countdown);
+    }
+
+    RangeTask self;
+    self.setRange(&range);
+    self.run();
+    this->wait(&countdown);
 }
@@ -0,0 +1,270 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkThreadedPipeController.h"
+#include "SkCanvas.h"
+#include "SkDevice.h"
+#include "SkThread.h"
+#include "SkThreadUtils.h"
+
+// The ring's counters are each written by only one side, but read by the
+// other. A read goes through an atomic add of 0 followed by an acquire
+// barrier, so that everything written before the matching store is visible.
+static inline int32_t load_acquire(int32_t* addr) {
+    int32_t value = sk_atomic_add(addr, 0);
+    sk_membar_aquire__after_atomic_dec();
+    return value;
+}
+
+// Only valid for a counter that no other thread changes.
+static inline void store_release(int32_t* addr, int32_t value) {
+    sk_atomic_add(addr, value - load_acquire(addr));
+}
+
+/**
+ *  One slot of the ring. The writer fills in fSize, fData and resets the
+ *  counters while no reader is using it (fPending == 0), and then publishes
+ *  it by setting fSequence to the index of the block in the stream.
+ */
+struct SkThreadedPipeController::Block {
+    char*   fData;
+    int32_t fSize;
+    int32_t fSequence;
+    int32_t fWritten;   // bytes of whole atoms the readers may play back
+    int32_t fClosed;    // set once the writer has moved on to the next block
+    int32_t fPending;   // readers that have yet to finish with the block
+};
+
+class SkThreadedPipeController::Reader {
+public:
+    Reader(SkThreadedPipeController* controller, const SkBitmap& band, int top)
+        : fController(controller)
+        , fThread(Run, this) {
+        SkDevice* device = SkNEW_ARGS(SkDevice, (band));
+        fCanvas = SkNEW_ARGS(SkCanvas, (device));
+        device->unref();
+        fCanvas->translate(0, -SkIntToScalar(top));
+        fPipeReader.setCanvas(fCanvas);
+    }
+
+    ~Reader() {
+        fCanvas->unref();
+    }
+
+    bool start() { return fThread.start(); }
+    void join() { fThread.join(); }
+
+private:
+    static void Run(void* reader) {
+        static_cast<Reader*>(reader)->run();
+    }
+
+    void run() {
+        SkThreadedPipeController* controller = fController;
+        int32_t sequence = 0;
+        int32_t offset = 0;
+        // After an error there is no way to resync with the stream, but
+        // the reader keeps up with the writer so that it can reuse blocks.
+        bool drawing = true;
+
+        for (;;) {
+            // Read before looking for work, so that a wake() that comes after
+            // we looked is not missed.
+            int32_t wakeups = load_acquire(&controller->fWakeups);
+
+            Block* block = &controller->fBlocks[sequence %
+                                                controller->fBlocks.count()];
+            if (load_acquire(&block->fSequence) == sequence) {
+                // Check for closed first; everything it was closed with will
+                // have been written by then.
+                bool closed = 0 != load_acquire(&block->fClosed);
+                int32_t written = load_acquire(&block->fWritten);
+                if (written > offset) {
+                    if (drawing) {
+                        SkGPipeReader::Status status = fPipeReader.playback(
+                                block->fData + offset, written - offset);
+                        if (SkGPipeReader::kDone_Status == status) {
+                            return;
+                        }
+                        drawing = SkGPipeReader::kError_Status != status;
+                    }
+                    offset = written;
+                    continue;
+                }
+                if (closed) {
+                    if (1 == sk_atomic_dec(&block->fPending)) {
+                        controller->wake();
+                    }
+                    sequence += 1;
+                    offset = 0;
+                    continue;
+                }
+            }
+
+            if (load_acquire(&controller->fShutdown)) {
+                return;
+            }
+            controller->sleep(wakeups);
+        }
+    }
+
+    SkThreadedPipeController*   fController;
+    SkCanvas*                   fCanvas;
+    SkGPipeReader               fPipeReader;
+    SkThread                    fThread;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkThreadedPipeController::SkThreadedPipeController(const SkBitmap& target,
+                                                   int readerCount,
+                                                   int blockCount,
+                                                   size_t blockSize)
+    : fTarget(target)
+    , fCurrent(NULL)
+    , fWriteSequence(-1)
+    , fReaderCount(0)
+    , fJoined(false)
+    , fWakeups(0)
+    , fSleepers(0)
+    , fShutdown(0) {
+    // The writer fills one block while the readers finish the one before.
+    blockCount = SkMax32(blockCount, 2);
+    blockSize = SkAlign4(blockSize);
+    fBlocks.setCount(blockCount);
+    for (int i = 0; i < blockCount; ++i) {
+        Block& block = fBlocks[i];
+        block.fData = (char*)sk_malloc_throw(blockSize);
+        block.fSize = SkToS32(blockSize);
+        block.fSequence = -1;
+        block.fWritten = 0;
+        block.fClosed = 0;
+        block.fPending = 0;
+    }
+
+    fTarget.lockPixels();
+    if (NULL == fTarget.getPixels() || fTarget.height() <= 0) {
+        return;
+    }
+
+    // Wrap each band's pixels directly rather than going through a subset
+    // pixelref, so that the readers never touch a shared lock count.
+    readerCount = SkPin32(readerCount, 1, fTarget.height());
+    int top = 0;
+    for (int i = 0; i < readerCount; ++i) {
+        int bottom = (i + 1) * fTarget.height() / readerCount;
+        SkBitmap band;
+        band.setConfig(fTarget.config(), fTarget.width(), bottom - top,
+                       fTarget.rowBytes());
+        band.setPixels(fTarget.getAddr(0, top), fTarget.getColorTable());
+
+        Reader* reader = SkNEW_ARGS(Reader, (this, band, top));
+        // Only count the readers whose threads actually run, since the
+        // writer waits for all of those it counts to release each block.
+        if (reader->start()) {
+            *fReaders.append() = reader;
+        } else {
+            SkDELETE(reader);
+        }
+        top = bottom;
+    }
+    fReaderCount = fReaders.count();
+}
+
+SkThreadedPipeController::~SkThreadedPipeController() {
+    this->join();
+    for (int i = 0; i < fBlocks.count(); ++i) {
+        sk_free(fBlocks[i].fData);
+    }
+}
+
+void* SkThreadedPipeController::requestBlock(size_t minRequest,
+                                             size_t* actual) {
+    if (fJoined || 0 == fReaderCount) {
+        return NULL;
+    }
+
+    if (NULL != fCurrent) {
+        store_release(&fCurrent->fClosed, 1);
+        this->wake();
+    }
+
+    fWriteSequence += 1;
+    Block* block = &fBlocks[fWriteSequence % fBlocks.count()];
+    // If the ring is full, wait for the slowest reader to catch up.
+    for (;;) {
+        int32_t wakeups = load_acquire(&fWakeups);
+        if (0 == load_acquire(&block->fPending)) {
+            break;
+        }
+        this->sleep(wakeups);
+    }
+
+    // No reader looks at the block again until it is published below.
+    if (minRequest > (size_t)block->fSize) {
+        size_t size = SkAlign4(minRequest);
+        block->fData = (char*)sk_realloc_throw(block->fData, size);
+        block->fSize = SkToS32(size);
+    }
+    block->fWritten = 0;
+    block->fClosed = 0;
+    block->fPending = fReaderCount;
+    store_release(&block->fSequence, fWriteSequence);
+    this->wake();
+
+    fCurrent = block;
+    *actual = block->fSize;
+    return block->fData;
+}
+
+void SkThreadedPipeController::notifyWritten(size_t bytes) {
+    SkASSERT(NULL != fCurrent);
+    if (bytes > 0) {
+        sk_atomic_add(&fCurrent->fWritten, SkToS32(bytes));
+        this->wake();
+    }
+}
+
+int SkThreadedPipeController::numberOfReaders() const {
+    return fReaderCount;
+}
+
+void SkThreadedPipeController::join() {
+    if (fJoined) {
+        return;
+    }
+    store_release(&fShutdown, 1);
+    this->wake();
+    for (int i = 0; i < fReaders.count(); ++i) {
+        fReaders[i]->join();
+    }
+    fReaders.deleteAll();
+    fTarget.unlockPixels();
+    fJoined = true;
+}
+
+void SkThreadedPipeController::wake() {
+    sk_atomic_inc(&fWakeups);
+    // Only pay for the lock if someone is (about to be) asleep. Since both
+    // sides use full barriers, either the sleeper sees the new fWakeups, or
+    // we see it in fSleepers.
+    if (load_acquire(&fSleepers) > 0) {
+        fCondVar.lock();
+        fCondVar.broadcast();
+        fCondVar.unlock();
+    }
+}
+
+void SkThreadedPipeController::sleep(int32_t wakeups) {
+    sk_atomic_inc(&fSleepers);
+    fCondVar.lock();
+    while (load_acquire(&fWakeups) == wakeups) {
+        fCondVar.wait();
+    }
+    fCondVar.unlock();
+    sk_atomic_dec(&fSleepers);
+}
@@ -6,8 +6,10 @@
  */
 
 #include "Test.h"
+#include "TestUtils.h"
 #include "SkAAClip.h"
 #include "SkCanvas.h"
+#include "SkGraphics.h"
 #include "SkMask.h"
 #include "SkPath.h"
 #include "SkRandom.h"
@@ -394,6 +396,57 @@ static void test_regressions(skiatest::Reporter* reporter) {
     }
 }
 
+static void draw_clipped(SkBitmap* bm, const SkPath& clip, SkScalar dx) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, 40, 40);
+    bm->allocPixels();
+    bm->eraseColor(SK_ColorWHITE);
+
+    SkCanvas canvas(*bm);
+    canvas.translate(dx, 0);
+    canvas.save();
+    canvas.clipPath(clip, SkRegion::kIntersect_Op, true);
+    canvas.drawColor(SK_ColorBLUE);
+    canvas.restore();
+}
+
+static void test_clip_mask_cache(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.addCircle(SkFloatToScalar(20.3f), SkFloatToScalar(19.6f), 15);
+
+    SkBitmap expected, expectedShifted, actual;
+    size_t prevLimit = SkGraphics::SetClipMaskCacheLimit(0);
+    draw_clipped(&expected, path, 0);
+    draw_clipped(&expectedShifted, path, SK_Scalar1 / 2);
+
+    SkGraphics::SetClipMaskCacheLimit(1024 * 1024);
+    SkGraphics::PurgeClipMaskCache();
+    int32_t hits, misses;
+
+    // The first canvas builds the mask, and the second (drawing a copy of the
+    // path with the same matrix) reuses it.
+    draw_clipped(&actual, path, 0);
+    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+    SkPath copy(path);
+    draw_clipped(&actual, copy, 0);
+    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+    SkGraphics::GetClipMaskCacheStats(&hits, &misses);
+    REPORTER_ASSERT(reporter, 1 == hits && 1 == misses);
+    REPORTER_ASSERT(reporter, SkGraphics::GetClipMaskCacheUsed() > 0);
+
+    // A different matrix, or an edited path, needs a new mask.
+    draw_clipped(&actual, path, SK_Scalar1 / 2);
+    REPORTER_ASSERT(reporter, same_pixels(expectedShifted, actual));
+    copy.offset(SK_Scalar1 / 2, 0);
+    draw_clipped(&actual, copy, 0);
+    REPORTER_ASSERT(reporter, same_pixels(expectedShifted, actual));
+    SkGraphics::GetClipMaskCacheStats(&hits, &misses);
+    REPORTER_ASSERT(reporter, 1 == hits && 3 == misses);
+
+    SkGraphics::PurgeClipMaskCache();
+    REPORTER_ASSERT(reporter, 0 == SkGraphics::GetClipMaskCacheUsed());
+    SkGraphics::SetClipMaskCacheLimit(prevLimit);
+}
+
 static void TestAAClip(skiatest::Reporter* reporter) {
     test_empty(reporter);
     test_path_bounds(reporter);
@@ -402,6 +455,7 @@ static void TestAAClip(skiatest::Reporter* reporter) {
     test_path_with_hole(reporter);
     test_regressions(reporter);
     test_nearly_integral(reporter);
+    test_clip_mask_cache(reporter);
 }
 
 #include "TestClassDef.h"
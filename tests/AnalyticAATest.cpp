@@ -0,0 +1,203 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkAAClip.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkScan.h"
+
+static const int W = 64;
+static const int H = 64;
+
+static void draw(const SkPath& path, const SkIRect* clip, SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kA8_Config, W, H);
+    bm->allocPixels();
+    bm->eraseColor(0);
+
+    SkCanvas canvas(*bm);
+    if (clip) {
+        SkRect r;
+        r.set(*clip);
+        canvas.clipRect(r);
+    }
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    SkScan::SetUseAnalyticAA(true);
+    canvas.drawPath(path, paint);
+    SkScan::SetUseAnalyticAA(false);
+}
+
+/*  The reference: draw the path without antialiasing at 16x the size, then
+    average each 16x16 block of pixels down to one.
+ */
+static void draw_reference(const SkPath& path, const SkIRect* clip,
+                           SkBitmap* bm) {
+    static const int kScale = 16;
+
+    SkBitmap big;
+    big.setConfig(SkBitmap::kA8_Config, W * kScale, H * kScale);
+    big.allocPixels();
+    big.eraseColor(0);
+
+    SkCanvas canvas(big);
+    canvas.scale(SkIntToScalar(kScale), SkIntToScalar(kScale));
+    if (clip) {
+        SkRect r;
+        r.set(*clip);
+        canvas.clipRect(r);
+    }
+    canvas.drawPath(path, SkPaint());
+
+    bm->setConfig(SkBitmap::kA8_Config, W, H);
+    bm->allocPixels();
+    SkAutoLockPixels alp(big);
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            int sum = 0;
+            for (int dy = 0; dy < kScale; ++dy) {
+                const uint8_t* row = big.getAddr8(x * kScale, y * kScale + dy);
+                for (int dx = 0; dx < kScale; ++dx) {
+                    sum += row[dx];
+                }
+            }
+            *bm->getAddr8(x, y) = SkToU8(sum / (kScale * kScale));
+        }
+    }
+}
+
+static bool nearly_equal(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            int diff = *a.getAddr8(x, y) - *b.getAddr8(x, y);
+            if (SkAbs32(diff) > 16) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void check_path(skiatest::Reporter* reporter, const SkPath& path,
+                       const SkIRect* clip = NULL) {
+    SkBitmap reference, analytic;
+    draw_reference(path, clip, &reference);
+    draw(path, clip, &analytic);
+    REPORTER_ASSERT(reporter, nearly_equal(reference, analytic));
+}
+
+static void test_exact(skiatest::Reporter* reporter) {
+    // a rect covering half of each pixel along its edges
+    SkPath path;
+    path.addRect(SkFloatToScalar(10.5f), SkFloatToScalar(10.5f),
+                 SkFloatToScalar(20.5f), SkFloatToScalar(20.5f));
+
+    SkBitmap bm;
+    draw(path, NULL, &bm);
+    SkAutoLockPixels alp(bm);
+    REPORTER_ASSERT(reporter, 0 == *bm.getAddr8(9, 15));
+    REPORTER_ASSERT(reporter, 128 == *bm.getAddr8(10, 15));
+    REPORTER_ASSERT(reporter, 255 == *bm.getAddr8(15, 15));
+    REPORTER_ASSERT(reporter, 128 == *bm.getAddr8(20, 15));
+    REPORTER_ASSERT(reporter, 64 == *bm.getAddr8(10, 10));
+    REPORTER_ASSERT(reporter, 0 == *bm.getAddr8(21, 15));
+}
+
+static void test_aaclip(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.addCircle(SkIntToScalar(30), SkIntToScalar(30), SkIntToScalar(20));
+    SkIRect bounds = SkIRect::MakeWH(W, H);
+
+    SkScan::SetUseAnalyticAA(true);
+    SkAAClip analytic;
+    analytic.setPath(path, NULL, true);
+    SkScan::SetUseAnalyticAA(false);
+
+    REPORTER_ASSERT(reporter, !analytic.isEmpty());
+    SkIRect expected;
+    path.getBounds().roundOut(&expected);
+    REPORTER_ASSERT(reporter, bounds.contains(analytic.getBounds()));
+    REPORTER_ASSERT(reporter, expected.contains(analytic.getBounds()));
+}
+
+static void TestAnalyticAA(skiatest::Reporter* reporter) {
+    SkPath path;
+
+    path.addOval(SkRect::MakeXYWH(SkFloatToScalar(3.3f), SkFloatToScalar(5.7f),
+                                  SkIntToScalar(40), SkIntToScalar(27)));
+    check_path(reporter, path);
+
+    // partly outside of the device, on every side
+    path.reset();
+    path.addCircle(SkIntToScalar(W / 2), SkIntToScalar(H / 2),
+                   SkIntToScalar(40));
+    check_path(reporter, path);
+
+    SkIRect clip = SkIRect::MakeLTRB(7, 9, 50, 45);
+    check_path(reporter, path, &clip);
+
+    path.setFillType(SkPath::kInverseWinding_FillType);
+    check_path(reporter, path);
+    check_path(reporter, path, &clip);
+
+    // a ring, filled both ways
+    path.reset();
+    path.addCircle(SkIntToScalar(30), SkIntToScalar(31), SkIntToScalar(25));
+    path.addCircle(SkIntToScalar(33), SkIntToScalar(29), SkIntToScalar(12),
+                   SkPath::kCCW_Direction);
+    check_path(reporter, path);
+    path.reset();
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    path.addCircle(SkIntToScalar(30), SkIntToScalar(31), SkIntToScalar(25));
+    path.addCircle(SkIntToScalar(33), SkIntToScalar(29), SkIntToScalar(12));
+    check_path(reporter, path);
+
+    // Random curves. These must not cross themselves, since where they do
+    // analytic coverage is only approximate.
+    SkRandom rand;
+    for (int i = 0; i < 10; ++i) {
+        SkScalar cx = SkIntToScalar(W / 2) + rand.nextSScalar1() * 8;
+        SkScalar cy = SkIntToScalar(H / 2) + rand.nextSScalar1() * 8;
+        SkScalar radius = SkIntToScalar(10) + rand.nextUScalar1() * 20;
+
+        // a cubic with a convex control polygon, closed by a line
+        SkPoint pts[4];
+        SkScalar angle = 0;
+        for (int j = 0; j < 4; ++j) {
+            angle += SkScalarMul(SK_Scalar1 + rand.nextUScalar1(),
+                                 SK_ScalarPI / 4);
+            pts[j].set(cx + SkScalarMul(radius, SkScalarCos(angle)),
+                       cy + SkScalarMul(radius, SkScalarSin(angle)));
+        }
+        path.reset();
+        path.moveTo(pts[0]);
+        path.cubicTo(pts[1], pts[2], pts[3]);
+        path.close();
+        check_path(reporter, path);
+
+        path.reset();
+        path.addOval(SkRect::MakeXYWH(cx - radius, cy,
+                                      radius, radius + rand.nextUScalar1() * 9));
+        check_path(reporter, path);
+    }
+
+    test_exact(reporter);
+    test_aaclip(reporter);
+
+    SkGraphics::SetFlags("analytic-aa=1");
+    REPORTER_ASSERT(reporter, SkScan::GetUseAnalyticAA());
+    SkGraphics::SetFlags("analytic-aa=0");
+    REPORTER_ASSERT(reporter, !SkScan::GetUseAnalyticAA());
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("AnalyticAA", AnalyticAATestClass, TestAnalyticAA)
@@ -11,6 +11,7 @@
 #include "SkCanvas.h"
 #include "SkColor.h"
 #include "SkData.h"
+#include "SkImageCache.h"
 #include "SkImageEncoder.h"
 #include "SkPaint.h"
 #include "SkStream.h"
@@ -70,6 +71,21 @@ static void TestBitmapFactory(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, success);
     assert_bounds_equal(reporter, *bitmap.get(), boundedBitmap);
     REPORTER_ASSERT(reporter, boundedBitmap.pixelRef() == NULL);
+
+    // Decoding through a cache only decodes once, and shares the pixels.
+    SkImageCache cache;
+    const uint32_t sourceID = SkImageCache::NewSourceID();
+    SkBitmap cached1, cached2;
+    success = SkBitmapFactory::DecodeBitmap(&cached1, encodedBitmap, &cache, sourceID);
+    REPORTER_ASSERT(reporter, success);
+    assert_bounds_equal(reporter, *bitmap.get(), cached1);
+    REPORTER_ASSERT(reporter, cached1.getPixels() != NULL);
+    success = SkBitmapFactory::DecodeBitmap(&cached2, encodedBitmap, &cache, sourceID);
+    REPORTER_ASSERT(reporter, success);
+    REPORTER_ASSERT(reporter, cached1.pixelRef() == cached2.pixelRef());
+    REPORTER_ASSERT(reporter, cached2.getPixels() != NULL);
+    SkImageCache::Stats stats = cache.getStats();
+    REPORTER_ASSERT(reporter, 1 == stats.fHits && 1 == stats.fMisses && 1 == stats.fCount);
 }
 
 #include "TestClassDef.h"
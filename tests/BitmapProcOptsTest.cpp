@@ -0,0 +1,161 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Test.h"
+#include "SkBitmapProcState.h"
+#include "SkRandom.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+#include "SkBitmapProcState_opts_SSE2.h"
+
+static const int kMaxCount = 41;    // covers several 8 pixel blocks and tails
+
+static void fill_random(SkBitmap* bm, SkRandom& rand) {
+    SkAutoLockPixels alp(*bm);
+    uint8_t* row = (uint8_t*)bm->getPixels();
+    for (int y = 0; y < bm->height(); ++y) {
+        for (int i = 0; i < bm->rowBytes(); ++i) {
+            row[i] = rand.nextU() >> 24;
+        }
+        row += bm->rowBytes();
+    }
+}
+
+// A coordinate in [0, max) and the next one over, clamped, packed with a
+// random 4 bit sub-pixel the way the filter matrix procs do.
+static uint32_t pack_filter(SkRandom& rand, int max) {
+    unsigned i0 = rand.nextU() % max;
+    unsigned i1 = SkMin32(i0 + 1, max - 1);
+    unsigned sub = rand.nextU() & 0xF;
+    return (i0 << 18) | (sub << 14) | i1;
+}
+
+// The xy layouts that the sample procs read.
+enum XYKind {
+    kFilter_DX,
+    kFilter_DXDY,
+    kNoFilter_DX,
+};
+
+/**
+ *  Fill xy with random coordinates inside bm, in the layout the given kind of
+ *  sample proc reads.
+ */
+static void fill_xy(uint32_t xy[], XYKind kind, const SkBitmap& bm,
+                    int count, SkRandom& rand) {
+    const int w = bm.width();
+    const int h = bm.height();
+    switch (kind) {
+        case kFilter_DX:
+            *xy++ = pack_filter(rand, h);
+            for (int i = 0; i < count; ++i) {
+                *xy++ = pack_filter(rand, w);
+            }
+            break;
+        case kFilter_DXDY:
+            for (int i = 0; i < count; ++i) {
+                *xy++ = pack_filter(rand, h);
+                *xy++ = pack_filter(rand, w);
+            }
+            break;
+        case kNoFilter_DX: {
+            *xy++ = rand.nextU() % h;
+            uint16_t* xx = (uint16_t*)xy;
+            for (int i = 0; i < count; ++i) {
+                xx[i] = rand.nextU() % w;
+            }
+            break;
+        }
+    }
+}
+
+static const struct {
+    const char*                     fName;
+    SkBitmap::Config                fConfig;
+    bool                            fOpaque;    // fAlphaScale is 256
+    XYKind                          fKind;
+    SkBitmapProcState::SampleProc32 fPortable;
+    SkBitmapProcState::SampleProc32 fSSE2;
+} gProcs[] = {
+    { "S16_opaque_D32_filter_DX",       SkBitmap::kRGB_565_Config, true,
+      kFilter_DX, S16_opaque_D32_filter_DX, S16_opaque_D32_filter_DX_SSE2 },
+    { "S16_alpha_D32_filter_DX",        SkBitmap::kRGB_565_Config, false,
+      kFilter_DX, S16_alpha_D32_filter_DX, S16_alpha_D32_filter_DX_SSE2 },
+    { "S16_opaque_D32_filter_DXDY",     SkBitmap::kRGB_565_Config, true,
+      kFilter_DXDY, S16_opaque_D32_filter_DXDY,
+      S16_opaque_D32_filter_DXDY_SSE2 },
+    { "S16_alpha_D32_filter_DXDY",      SkBitmap::kRGB_565_Config, false,
+      kFilter_DXDY, S16_alpha_D32_filter_DXDY,
+      S16_alpha_D32_filter_DXDY_SSE2 },
+    { "S16_opaque_D32_nofilter_DX",     SkBitmap::kRGB_565_Config, true,
+      kNoFilter_DX, S16_opaque_D32_nofilter_DX,
+      S16_opaque_D32_nofilter_DX_SSE2 },
+    { "S16_alpha_D32_nofilter_DX",      SkBitmap::kRGB_565_Config, false,
+      kNoFilter_DX, S16_alpha_D32_nofilter_DX,
+      S16_alpha_D32_nofilter_DX_SSE2 },
+    { "SA8_alpha_D32_filter_DX",        SkBitmap::kA8_Config, false,
+      kFilter_DX, SA8_alpha_D32_filter_DX, SA8_alpha_D32_filter_DX_SSE2 },
+    { "SA8_alpha_D32_filter_DXDY",      SkBitmap::kA8_Config, false,
+      kFilter_DXDY, SA8_alpha_D32_filter_DXDY,
+      SA8_alpha_D32_filter_DXDY_SSE2 },
+    { "SA8_alpha_D32_nofilter_DX",      SkBitmap::kA8_Config, false,
+      kNoFilter_DX, SA8_alpha_D32_nofilter_DX,
+      SA8_alpha_D32_nofilter_DX_SSE2 },
+};
+
+// The SSE2 procs must produce exactly what the portable ones do, for any
+// source pixels, coordinates, alpha and (for A8) paint color.
+static void TestBitmapProcOpts(skiatest::Reporter* reporter) {
+    // Width 1 takes the memset path in the nofilter procs.
+    static const int gWidths[] = { 1, 2, 7, 33 };
+
+    SkRandom rand;
+    uint32_t xy[2 * kMaxCount + 1];
+    SkPMColor portable[kMaxCount];
+    SkPMColor sse2[kMaxCount];
+
+    for (size_t p = 0; p < SK_ARRAY_COUNT(gProcs); ++p) {
+        for (size_t w = 0; w < SK_ARRAY_COUNT(gWidths); ++w) {
+            SkBitmap bm;
+            bm.setConfig(gProcs[p].fConfig, gWidths[w], 5);
+            bm.allocPixels();
+            fill_random(&bm, rand);
+            SkAutoLockPixels alp(bm);
+
+            SkBitmapProcState state;
+            state.fBitmap = &bm;
+            state.fInvType = SkMatrix::kScale_Mask;
+            state.fDoFilter = kNoFilter_DX != gProcs[p].fKind;
+            for (int count = 1; count <= kMaxCount; ++count) {
+                state.fAlphaScale = gProcs[p].fOpaque ? 256 :
+                                    rand.nextU() % 256;
+                state.fPaintPMColor = SkPreMultiplyColor(rand.nextU());
+                fill_xy(xy, gProcs[p].fKind, bm, count, rand);
+
+                sk_bzero(portable, sizeof(portable));
+                sk_bzero(sse2, sizeof(sse2));
+                gProcs[p].fPortable(state, xy, count, portable);
+                gProcs[p].fSSE2(state, xy, count, sse2);
+                if (memcmp(portable, sse2, sizeof(portable))) {
+                    SkString str;
+                    str.printf("%s differs at width %d, count %d",
+                               gProcs[p].fName, bm.width(), count);
+                    reporter->reportFailed(str);
+                }
+            }
+        }
+    }
+}
+
+#else
+
+static void TestBitmapProcOpts(skiatest::Reporter*) {}
+
+#endif
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("BitmapProcOpts", BitmapProcOptsTestClass, TestBitmapProcOpts)
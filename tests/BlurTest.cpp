@@ -7,6 +7,7 @@
  */
 #include "Test.h"
 #include "SkBlurMaskFilter.h"
+#include "SkBoxBlurProcs.h"
 #include "SkCanvas.h"
 #include "SkMath.h"
 #include "SkPaint.h"
@@ -158,5 +159,150 @@ static void test_blur(skiatest::Reporter* reporter) {
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+/*  Straightforward versions of the box blur passes in SkBlurMask.cpp, which
+    the platform procs must match exactly. Output column k (after any left
+    padding) sums the source over [k - diameter, k].
+ */
+static void ref_box_blur(const uint8_t* src, int srcRB, uint8_t* dst,
+                         int leftRadius, int rightRadius, int width,
+                         int height, bool transpose) {
+    int diameter = leftRadius + rightRadius;
+    uint32_t scale = (1 << 24) / (diameter + 1);
+    int newWidth = width + SkMax32(leftRadius, rightRadius) * 2;
+    int pad = SkMax32(0, rightRadius - leftRadius);
+    for (int y = 0; y < height; ++y) {
+        for (int k = 0; k < newWidth; ++k) {
+            int j = k - pad;
+            uint8_t value = 0;
+            if (j >= 0 && j < width + diameter) {
+                int sum = 0;
+                for (int i = SkMax32(0, j - diameter);
+                     i <= SkMin32(width - 1, j); ++i) {
+                    sum += src[y * srcRB + i];
+                }
+                value = SkToU8((sum * scale) >> 24);
+            }
+            dst[transpose ? k * height + y : y * newWidth + k] = value;
+        }
+    }
+}
+
+static void ref_box_blur_interp(const uint8_t* src, int srcRB, uint8_t* dst,
+                                int radius, int width, int height,
+                                bool transpose, uint8_t outerWeight) {
+    int diameter = radius * 2;
+    int kernelSize = diameter + 1;
+    int innerWeight = 255 - outerWeight;
+    outerWeight += outerWeight >> 7;
+    innerWeight += innerWeight >> 7;
+    uint32_t outerScale = (outerWeight << 16) / kernelSize;
+    uint32_t innerScale = (innerWeight << 16) / (kernelSize - 2);
+    int newWidth = width + diameter;
+    for (int y = 0; y < height; ++y) {
+        for (int k = 0; k < newWidth; ++k) {
+            int outer = 0, inner = 0;
+            for (int i = SkMax32(0, k - diameter);
+                 i <= SkMin32(width - 1, k); ++i) {
+                int value = src[y * srcRB + i];
+                outer += value;
+                if (i > k - diameter && i < k) {
+                    inner += value;
+                }
+            }
+            if (k >= width && k < diameter) {
+                // when the kernel is wider than the row, the inner sum stops
+                // changing once the outer one has reached the end of the row
+                inner = outer - src[y * srcRB + width - 1];
+            }
+            dst[transpose ? k * height + y : y * newWidth + k] =
+                SkToU8((outer * outerScale + inner * innerScale) >> 24);
+        }
+    }
+}
+
+static void test_box_blur_procs(skiatest::Reporter* reporter) {
+    SkBoxBlurProc proc = SkBoxBlurGetPlatformProc();
+    SkBoxBlurInterpProc interpProc = SkBoxBlurInterpGetPlatformProc();
+    if (NULL == proc && NULL == interpProc) {
+        return;
+    }
+
+    static const int gWidths[] = { 1, 5, 16, 37 };
+    static const int gHeights[] = { 16, 17, 40 };
+    SkRandom rand;
+
+    for (size_t w = 0; w < SK_ARRAY_COUNT(gWidths); ++w) {
+        for (size_t h = 0; h < SK_ARRAY_COUNT(gHeights); ++h) {
+            const int width = gWidths[w];
+            const int height = gHeights[h];
+            const int srcRB = width + 3;
+            SkAutoTMalloc<uint8_t> src(srcRB * height);
+            for (int i = 0; i < srcRB * height; ++i) {
+                src[i] = SkToU8(rand.nextU() & 0xFF);
+            }
+
+            for (int radius = 1; radius <= 8; ++radius) {
+                const int dstSize = (width + 2 * (radius + 1)) * height;
+                SkAutoTMalloc<uint8_t> expected(dstSize);
+                SkAutoTMalloc<uint8_t> actual(dstSize);
+
+                for (int transpose = 0; transpose <= 1; ++transpose) {
+                    for (int lo = radius - 1; proc && lo <= radius + 1; ++lo) {
+                        int newWidth = width + 2 * SkMax32(lo, radius);
+                        int size = newWidth * height;
+                        sk_bzero(expected.get(), dstSize);
+                        sk_bzero(actual.get(), dstSize);
+                        ref_box_blur(src, srcRB, expected, lo, radius,
+                                     width, height, SkToBool(transpose));
+                        int rows = proc(src, srcRB, actual, lo, radius,
+                                        width, height, SkToBool(transpose));
+                        if (rows < height) {
+                            // let the reference stand in for the portable
+                            // code on the remaining rows
+                            for (int i = 0; i < size; ++i) {
+                                int y = transpose ? i % height : i / newWidth;
+                                if (y >= rows) {
+                                    actual[i] = expected[i];
+                                }
+                            }
+                        }
+                        REPORTER_ASSERT(reporter, rows <= height);
+                        REPORTER_ASSERT(reporter,
+                                !memcmp(expected.get(), actual.get(), size));
+                    }
+
+                    if (NULL == interpProc) {
+                        continue;
+                    }
+                    uint8_t outerWeight = SkToU8(rand.nextU() % 255);
+                    int newWidth = width + 2 * radius;
+                    int size = newWidth * height;
+                    ref_box_blur_interp(src, srcRB, expected, radius, width,
+                                        height, SkToBool(transpose),
+                                        outerWeight);
+                    int rows = interpProc(src, srcRB, actual, radius, width,
+                                          height, SkToBool(transpose),
+                                          outerWeight);
+                    for (int i = 0; i < size; ++i) {
+                        int y = transpose ? i % height : i / newWidth;
+                        if (y >= rows) {
+                            actual[i] = expected[i];
+                        }
+                    }
+                    REPORTER_ASSERT(reporter,
+                            !memcmp(expected.get(), actual.get(), size));
+                }
+            }
+        }
+    }
+}
+
+static void TestBlur(skiatest::Reporter* reporter) {
+    test_blur(reporter);
+    test_box_blur_procs(reporter);
+}
+
 #include "TestClassDef.h"
-DEFINE_TESTCLASS("BlurMaskFilter", BlurTestClass, test_blur)
+DEFINE_TESTCLASS("BlurMaskFilter", BlurTestClass, TestBlur)
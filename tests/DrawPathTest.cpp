@@ -9,6 +9,7 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkDashPathEffect.h"
+#include "SkRandom.h"
 
 static SkCanvas* create(SkBitmap::Config config, int w, int h, int rb,
                         void* addr = NULL) {
@@ -262,6 +263,84 @@ static void test_crbug_165432(skiatest::Reporter* reporter) {
     SkStrokeRec rec(paint);
     REPORTER_ASSERT(reporter, !dash.filterPath(&filteredPath, path, &rec));
     REPORTER_ASSERT(reporter, filteredPath.isEmpty());
+    // the path was not dashed, so it must still be drawn as a hairline
+    REPORTER_ASSERT(reporter, SkStrokeRec::kHairline_Style == rec.getStyle());
+}
+
+static void draw_dashed(const SkPath& path, const SkPaint& paint,
+                        SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kA8_Config, 100, 100);
+    bm->allocPixels();
+    bm->eraseColor(0);
+    SkCanvas canvas(*bm);
+    canvas.drawPath(path, paint);
+}
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    int maxDiff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            int diff = SkAbs32(*a.getAddr8(x, y) - *b.getAddr8(x, y));
+            maxDiff = SkMax32(maxDiff, diff);
+        }
+    }
+    return maxDiff;
+}
+
+// Polylines are dashed without the stroker; check that they look the same.
+static void test_polyline_dash(skiatest::Reporter* reporter) {
+    static const SkScalar gIntervals[] = {
+        SkIntToScalar(12), SkIntToScalar(5), SkIntToScalar(3), SkIntToScalar(4)
+    };
+    static const SkPaint::Cap gCaps[] = {
+        SkPaint::kButt_Cap, SkPaint::kSquare_Cap, SkPaint::kRound_Cap
+    };
+    static const SkPaint::Join gJoins[] = {
+        SkPaint::kMiter_Join, SkPaint::kBevel_Join, SkPaint::kRound_Join
+    };
+
+    SkRandom rand;
+    for (int i = 0; i < 12; ++i) {
+        SkPath path;
+        path.moveTo(SkIntToScalar(20), SkIntToScalar(20));
+        for (int j = 0; j < 6; ++j) {
+            path.lineTo(SkIntToScalar(10) + rand.nextUScalar1() * 80,
+                        SkIntToScalar(10) + rand.nextUScalar1() * 80);
+        }
+        if (i & 1) {
+            path.close();
+        }
+        if (i & 2) {
+            path.moveTo(SkIntToScalar(5), SkIntToScalar(95));
+            path.lineTo(SkIntToScalar(95), SkIntToScalar(60));
+        }
+        // a curve, off the canvas, makes the dasher take its general path
+        // (through SkPathMeasure and the stroker)
+        SkPath curvedPath(path);
+        curvedPath.moveTo(SkIntToScalar(200), SkIntToScalar(200));
+        curvedPath.quadTo(SkIntToScalar(300), SkIntToScalar(200),
+                          SkIntToScalar(300), SkIntToScalar(300));
+
+        SkDashPathEffect dash(gIntervals, SK_ARRAY_COUNT(gIntervals),
+                              SkIntToScalar(i * 3), i > 8);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setPathEffect(&dash);
+        paint.setStrokeWidth(SkIntToScalar(i % 4 * 2));
+        paint.setStrokeCap(gCaps[i % 3]);
+        paint.setStrokeJoin(gJoins[i / 3 % 3]);
+
+        SkBitmap fast, general;
+        draw_dashed(path, paint, &fast);
+        draw_dashed(curvedPath, paint, &general);
+        // The stroker pivots its inner joins and flattens its round caps
+        // differently, so edges may land on different supersamples, but a
+        // missing or misplaced piece would show up as a solid difference.
+        REPORTER_ASSERT(reporter, max_diff(fast, general) <= 128);
+    }
 }
 
 static void TestDrawPath(skiatest::Reporter* reporter) {
@@ -276,6 +355,7 @@ static void TestDrawPath(skiatest::Reporter* reporter) {
     if (false) test_crbug131181(reporter);
     test_infinite_dash(reporter);
     test_crbug_165432(reporter);
+    test_polyline_dash(reporter);
 }
 
 #include "TestClassDef.h"
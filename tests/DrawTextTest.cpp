@@ -11,6 +11,7 @@
 #include "SkCanvas.h"
 #include "SkColor.h"
 #include "SkPaint.h"
+#include "SkPicture.h"
 #include "SkPoint.h"
 #include "SkRect.h"
 
@@ -111,5 +112,103 @@ static void test_drawText(skiatest::Reporter* reporter) {
     }
 }
 
+static void draw_runs_as_pos_text(SkCanvas* canvas,
+                                  const SkCanvas::PosTextRun runs[],
+                                  int runCount, const SkPaint& paint) {
+    SkPaint runPaint(paint);
+    runPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    for (int i = 0; i < runCount; ++i) {
+        runPaint.setColor(runs[i].fColor);
+        canvas->drawPosText(runs[i].fGlyphs, runs[i].fCount * sizeof(uint16_t),
+                            runs[i].fPos, runPaint);
+    }
+}
+
+static void test_drawPosTextRuns(skiatest::Reporter* reporter) {
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(20));
+
+    uint16_t glyphs[8];
+    int glyphCount = paint.textToGlyphs("AbgWAbgW", 8, glyphs);
+    REPORTER_ASSERT(reporter, 8 == glyphCount);
+
+    // Overlapping runs, so that their order matters, some sharing a color.
+    SkPoint pos[8];
+    for (int i = 0; i < 8; ++i) {
+        pos[i].set(SkFloatToScalar(6.0f + 7.25f * i),
+                   SkFloatToScalar(24.0f + 0.5f * (i & 3)));
+    }
+    const SkCanvas::PosTextRun runs[] = {
+        { glyphs,     pos,     3, SK_ColorBLACK },
+        { glyphs + 3, pos + 2, 3, SK_ColorBLACK },
+        { glyphs,     pos + 1, 0, SK_ColorRED },
+        { glyphs + 4, pos + 4, 4, 0x8000FF00 },
+        { glyphs + 1, pos + 3, 2, SK_ColorBLUE },
+        { glyphs + 5, pos + 5, 1, SK_ColorBLACK },
+    };
+    const int runCount = SK_ARRAY_COUNT(runs);
+
+    SkIRect rect = SkIRect::MakeWH(80, 40);
+    SkBitmap expected, actual;
+    create(&expected, rect, SkBitmap::kARGB_8888_Config);
+    create(&actual, rect, SkBitmap::kARGB_8888_Config);
+    SkCanvas expectedCanvas(expected);
+    SkCanvas actualCanvas(actual);
+
+    for (int align = 0; align < SkPaint::kAlignCount; ++align) {
+        paint.setTextAlign(static_cast<SkPaint::Align>(align));
+
+        for (unsigned int flags = 0; flags < (1 << 3); ++flags) {
+            paint.setAntiAlias(SkToBool(flags & 1));
+            paint.setSubpixelText(SkToBool(flags & 2));
+            paint.setLCDRenderText(SkToBool(flags & 4));
+
+            drawBG(&expectedCanvas);
+            draw_runs_as_pos_text(&expectedCanvas, runs, runCount, paint);
+
+            // The text encoding of the paint is ignored.
+            paint.setTextEncoding(SkPaint::kUTF8_TextEncoding);
+
+            drawBG(&actualCanvas);
+            actualCanvas.drawPosTextRuns(runs, runCount, paint);
+            REPORTER_ASSERT(reporter,
+                            compare(expected, rect, actual, rect));
+
+            // Played back from a picture.
+            SkPicture picture;
+            picture.beginRecording(rect.width(), rect.height())->
+                drawPosTextRuns(runs, runCount, paint);
+            picture.endRecording();
+
+            drawBG(&actualCanvas);
+            actualCanvas.drawPicture(picture);
+            REPORTER_ASSERT(reporter,
+                            compare(expected, rect, actual, rect));
+
+            // Also with a clip and a transform.
+            expectedCanvas.save();
+            expectedCanvas.clipRect(SkRect::MakeLTRB(10, 5, 50, 35));
+            expectedCanvas.scale(SkFloatToScalar(1.5f), SK_Scalar1);
+            drawBG(&expectedCanvas);
+            draw_runs_as_pos_text(&expectedCanvas, runs, runCount, paint);
+            expectedCanvas.restore();
+
+            actualCanvas.save();
+            actualCanvas.clipRect(SkRect::MakeLTRB(10, 5, 50, 35));
+            actualCanvas.scale(SkFloatToScalar(1.5f), SK_Scalar1);
+            drawBG(&actualCanvas);
+            actualCanvas.drawPosTextRuns(runs, runCount, paint);
+            actualCanvas.restore();
+            REPORTER_ASSERT(reporter,
+                            compare(expected, rect, actual, rect));
+        }
+    }
+}
+
+static void TestDrawText(skiatest::Reporter* reporter) {
+    test_drawText(reporter);
+    test_drawPosTextRuns(reporter);
+}
+
 #include "TestClassDef.h"
-DEFINE_TESTCLASS("DrawText_DrawPosText", DrawTextTestClass, test_drawText)
+DEFINE_TESTCLASS("DrawText_DrawPosText", DrawTextTestClass, TestDrawText)
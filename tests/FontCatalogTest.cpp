@@ -0,0 +1,186 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Test.h"
+#include "SkFontCatalog.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+// The catalog's layout: a 3 word header, then 5 words per entry, the last of
+// which starts with the style byte.
+static const size_t kHeaderSize = 3 * sizeof(uint32_t);
+static const size_t kEntrySize = 5 * sizeof(uint32_t);
+
+static const struct {
+    const char*         fSuffix;
+    const char*         fName;
+    SkTypeface::Style   fStyle;
+    bool                fIsFixedWidth;
+} gFonts[] = {
+    { "a.ttf",  "Alpha",    SkTypeface::kBold,      true },
+    { "b.ttf",  "Beta",     SkTypeface::kItalic,    false },
+};
+
+static void write_file(const char path[], const void* data, size_t length) {
+    SkFILEWStream stream(path);
+    stream.write(data, length);
+}
+
+static size_t read_file(const char path[], SkAutoMalloc* storage) {
+    SkFILEStream stream(path);
+    size_t length = stream.getLength();
+    stream.read(storage->reset(length), length);
+    return length;
+}
+
+/**
+ *  Look up each of the fonts that exist in a catalog loaded from catalogPath
+ *  the way the font host does, add them, and save it. Returns the number of
+ *  fonts that were found intact.
+ */
+static int walk_fonts(skiatest::Reporter* reporter, const char catalogPath[],
+                      const SkString fontPaths[]) {
+    SkFontCatalog catalog(catalogPath);
+    int found = 0;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gFonts); ++i) {
+        uint32_t size, time;
+        if (!catalog.stamp(fontPaths[i].c_str(), &size, &time)) {
+            continue;   // removed
+        }
+        SkString name;
+        SkTypeface::Style style;
+        bool isFixedWidth;
+        bool hit = catalog.find(fontPaths[i].c_str(), size, time, &name,
+                                &style, &isFixedWidth);
+        if (hit) {
+            REPORTER_ASSERT(reporter, name.equals(gFonts[i].fName));
+            REPORTER_ASSERT(reporter, style == gFonts[i].fStyle);
+            REPORTER_ASSERT(reporter, isFixedWidth == gFonts[i].fIsFixedWidth);
+            found += 1;
+        }
+        catalog.add(fontPaths[i].c_str(), size, time,
+                    SkString(gFonts[i].fName), gFonts[i].fStyle,
+                    gFonts[i].fIsFixedWidth, hit);
+    }
+    catalog.save();
+    return found;
+}
+
+// The catalog must ignore the bad file, and the next walk must write a good
+// one in its place.
+static void test_rejected(skiatest::Reporter* reporter,
+                          const char catalogPath[], const SkString fontPaths[],
+                          const void* data, size_t length) {
+    write_file(catalogPath, data, length);
+    {
+        SkFontCatalog catalog(catalogPath);
+        REPORTER_ASSERT(reporter, 0 == catalog.count());
+    }
+    REPORTER_ASSERT(reporter,
+                    0 == walk_fonts(reporter, catalogPath, fontPaths));
+    REPORTER_ASSERT(reporter,
+                    2 == walk_fonts(reporter, catalogPath, fontPaths));
+}
+
+static void TestFontCatalog(skiatest::Reporter* reporter) {
+    SkString catalogPath;
+    catalogPath.printf("/tmp/skia_font_catalog_%d", (int)getpid());
+    SkString fontPaths[SK_ARRAY_COUNT(gFonts)];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gFonts); ++i) {
+        fontPaths[i].printf("%s_%s", catalogPath.c_str(), gFonts[i].fSuffix);
+        write_file(fontPaths[i].c_str(), gFonts[i].fName,
+                   strlen(gFonts[i].fName));
+    }
+
+    // Without a file nothing is found, and with one everything is.
+    remove(catalogPath.c_str());
+    REPORTER_ASSERT(reporter, 0 == walk_fonts(reporter, catalogPath.c_str(),
+                                              fontPaths));
+    REPORTER_ASSERT(reporter, 2 == walk_fonts(reporter, catalogPath.c_str(),
+                                              fontPaths));
+    // A catalog without a path finds nothing.
+    REPORTER_ASSERT(reporter, 0 == walk_fonts(reporter, NULL, fontPaths));
+
+    SkAutoMalloc storage;
+    const size_t length = read_file(catalogPath.c_str(), &storage);
+    REPORTER_ASSERT(reporter, length > kHeaderSize + 2 * kEntrySize);
+    SkAutoMalloc bad(length);
+    uint32_t* words = (uint32_t*)bad.get();
+    const size_t stringsSize = length - kHeaderSize - 2 * kEntrySize;
+
+    // Truncated in the header, the entries and the strings.
+    const size_t truncated[] = {
+        0, kHeaderSize - 1, kHeaderSize + kEntrySize, length - 1
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(truncated); ++i) {
+        test_rejected(reporter, catalogPath.c_str(), fontPaths, storage.get(),
+                      truncated[i]);
+    }
+
+    // A bad magic number, version or count.
+    for (int i = 0; i < 3; ++i) {
+        memcpy(words, storage.get(), length);
+        words[i] = 1000;
+        test_rejected(reporter, catalogPath.c_str(), fontPaths, words, length);
+    }
+
+    // The strings don't end in a NUL.
+    memcpy(words, storage.get(), length);
+    ((char*)words)[length - 1] = 'x';
+    test_rejected(reporter, catalogPath.c_str(), fontPaths, words, length);
+
+    // Path and name offsets past the strings.
+    for (int i = 0; i < 2; ++i) {
+        memcpy(words, storage.get(), length);
+        words[3 + 5 + i] = stringsSize;
+        test_rejected(reporter, catalogPath.c_str(), fontPaths, words, length);
+    }
+
+    // A style that doesn't exist.
+    memcpy(words, storage.get(), length);
+    ((uint8_t*)words)[kHeaderSize + 4 * sizeof(uint32_t)] = 0xFF;
+    test_rejected(reporter, catalogPath.c_str(), fontPaths, words, length);
+
+    // A font whose size changed, and then one whose time changed, is parsed
+    // again, and the catalog is rewritten to match.
+    write_file(fontPaths[1].c_str(), "Beta, bigger", 12);
+    REPORTER_ASSERT(reporter, 1 == walk_fonts(reporter, catalogPath.c_str(),
+                                              fontPaths));
+    REPORTER_ASSERT(reporter, 2 == walk_fonts(reporter, catalogPath.c_str(),
+                                              fontPaths));
+    struct stat st;
+    stat(fontPaths[0].c_str(), &st);
+    struct utimbuf times;
+    times.actime = st.st_atime;
+    times.modtime = st.st_mtime - 60;
+    utime(fontPaths[0].c_str(), &times);
+    REPORTER_ASSERT(reporter, 1 == walk_fonts(reporter, catalogPath.c_str(),
+                                              fontPaths));
+    REPORTER_ASSERT(reporter, 2 == walk_fonts(reporter, catalogPath.c_str(),
+                                              fontPaths));
+
+    // A font that was removed is dropped from the catalog.
+    remove(fontPaths[0].c_str());
+    REPORTER_ASSERT(reporter, 1 == walk_fonts(reporter, catalogPath.c_str(),
+                                              fontPaths));
+    {
+        SkFontCatalog catalog(catalogPath.c_str());
+        REPORTER_ASSERT(reporter, 1 == catalog.count());
+    }
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gFonts); ++i) {
+        remove(fontPaths[i].c_str());
+    }
+    remove(catalogPath.c_str());
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("FontCatalog", FontCatalogTestClass, TestFontCatalog)
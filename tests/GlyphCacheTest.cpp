@@ -0,0 +1,165 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkDescriptor.h"
+#include "SkGlyphCache.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkThreadUtils.h"
+
+static void measure_text(void*) {
+    const char text[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    size_t len = strlen(text);
+
+    SkPaint paint;
+
+    for (int j = 0; j < 4; ++j) {
+        for (int i = 9; i <= 24; ++i) {
+            paint.setTextSize(SkIntToScalar(i));
+            paint.setAntiAlias(false);
+            paint.measureText(text, len);
+            paint.setAntiAlias(true);
+            paint.measureText(text, len);
+        }
+    }
+}
+
+static void run_threads() {
+    SkThread* threads[8];
+    int N = SK_ARRAY_COUNT(threads);
+    int i;
+
+    for (i = 0; i < N; ++i) {
+        threads[i] = new SkThread(measure_text);
+    }
+
+    for (i = 0; i < N; ++i) {
+        threads[i]->start();
+    }
+
+    for (i = 0; i < N; ++i) {
+        threads[i]->join();
+    }
+
+    for (i = 0; i < N; ++i) {
+        delete threads[i];
+    }
+}
+
+// Sizes that no other test here uses, so their strikes are only made below.
+static const int gFrontSizes[] = { 31, 32, 33 };
+
+static void measure_front_sizes(void*) {
+    const char text[] = "Front";
+    SkPaint paint;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gFrontSizes); ++i) {
+        paint.setTextSize(SkIntToScalar(gFrontSizes[i]));
+        paint.measureText(text, strlen(text));
+    }
+}
+
+static bool copy_descriptor(SkGlyphCache* cache, void* context) {
+    SkTDArray<SkDescriptor*>* descs = (SkTDArray<SkDescriptor*>*)context;
+    *descs->append() = cache->getDescriptor().copy();
+    return false;   // keep visiting
+}
+
+// Returns the number of strikes in the shared cache, reporting any two that
+// have the same descriptor.
+static int count_shared_strikes(skiatest::Reporter* reporter) {
+    SkTDArray<SkDescriptor*> descs;
+    SkGlyphCache::VisitAllCaches(copy_descriptor, &descs);
+    for (int i = 0; i < descs.count(); ++i) {
+        for (int j = i + 1; j < descs.count(); ++j) {
+            REPORTER_ASSERT(reporter, !descs[i]->equals(*descs[j]));
+        }
+    }
+    for (int i = 0; i < descs.count(); ++i) {
+        SkDescriptor::Free(descs[i]);
+    }
+    return descs.count();
+}
+
+// Strikes parked in a front must go back to the shared cache when the count
+// drops to 0, and never leave two strikes for one descriptor there.
+static void test_front_flush(skiatest::Reporter* reporter) {
+    const int kSizeCount = SK_ARRAY_COUNT(gFrontSizes);
+
+    SkGraphics::PurgeFontCache();
+    SkGraphics::SetFontCachePerThreadStrikeCount(4);
+    measure_front_sizes(NULL);
+    const int shared = count_shared_strikes(reporter);
+
+    // Another thread makes its own strikes for the same sizes, which go to
+    // the shared cache when it exits, while this thread's stay parked.
+    SkThread thread(measure_front_sizes);
+    thread.start();
+    thread.join();
+    REPORTER_ASSERT(reporter,
+                    shared + kSizeCount == count_shared_strikes(reporter));
+
+    // Flushing this thread's strikes must not add copies of those.
+    SkGraphics::SetFontCachePerThreadStrikeCount(0);
+    REPORTER_ASSERT(reporter,
+                    shared + kSizeCount == count_shared_strikes(reporter));
+    measure_front_sizes(NULL);
+    REPORTER_ASSERT(reporter,
+                    shared + kSizeCount == count_shared_strikes(reporter));
+
+    // With only this thread involved, the flushed strikes are found again
+    // rather than built anew.
+    SkGraphics::PurgeFontCache();
+    SkGraphics::SetFontCachePerThreadStrikeCount(4);
+    measure_front_sizes(NULL);
+    REPORTER_ASSERT(reporter, shared == count_shared_strikes(reporter));
+    SkGraphics::SetFontCachePerThreadStrikeCount(0);
+    REPORTER_ASSERT(reporter,
+                    shared + kSizeCount == count_shared_strikes(reporter));
+    measure_front_sizes(NULL);
+    REPORTER_ASSERT(reporter,
+                    shared + kSizeCount == count_shared_strikes(reporter));
+
+    SkGraphics::PurgeFontCache();
+    REPORTER_ASSERT(reporter, 0 == SkGraphics::GetFontCacheUsed());
+}
+
+static void TestGlyphCache(skiatest::Reporter* reporter) {
+    size_t prevLimit = SkGraphics::GetFontCacheLimit();
+    int prevCount = SkGraphics::GetFontCachePerThreadStrikeCount();
+
+    int oldCount = SkGraphics::SetFontCachePerThreadStrikeCount(4);
+    REPORTER_ASSERT(reporter, prevCount == oldCount);
+    REPORTER_ASSERT(reporter, 4 == SkGraphics::GetFontCachePerThreadStrikeCount());
+
+    // out-of-range counts are pinned
+    SkGraphics::SetFontCachePerThreadStrikeCount(-1);
+    REPORTER_ASSERT(reporter, 0 == SkGraphics::GetFontCachePerThreadStrikeCount());
+
+    SkGraphics::SetFontCacheLimit(2 * 1024 * 1024);
+    test_front_flush(reporter);
+
+    for (int count = 0; count <= 4; count += 4) {
+        SkGraphics::SetFontCachePerThreadStrikeCount(count);
+
+        // a small budget forces the shards to purge while other threads
+        // attach and detach strikes
+        SkGraphics::SetFontCacheLimit(256 * 1024);
+        run_threads();
+
+        // the exiting threads hand their front strikes back to the shared
+        // cache, so a purge must now account for every byte
+        SkGraphics::PurgeFontCache();
+        REPORTER_ASSERT(reporter, 0 == SkGraphics::GetFontCacheUsed());
+    }
+
+    SkGraphics::SetFontCachePerThreadStrikeCount(prevCount);
+    SkGraphics::SetFontCacheLimit(prevLimit);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("GlyphCache", GlyphCacheTestClass, TestGlyphCache)
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkData.h"
+#include "SkImageCache.h"
+#include "SkImageEncoder.h"
+#include "SkImageRef_GlobalPool.h"
+#include "SkStream.h"
+#include "SkThreadUtils.h"
+
+static const int kSize = 16;
+static const size_t kBytes = kSize * kSize * 4;
+
+static SkImageCache::Key make_key(uint32_t sourceID) {
+    SkImageCache::Key key;
+    key.fSourceID = sourceID;
+    key.fSampleSize = 1;
+    key.fConfig = SkBitmap::kARGB_8888_Config;
+    return key;
+}
+
+static void make_bitmap(SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, kSize, kSize);
+    bm->allocPixels();
+    bm->eraseColor(SK_ColorBLUE);
+}
+
+static void add(SkImageCache* cache, uint32_t sourceID, bool pin = false) {
+    SkBitmap bm;
+    make_bitmap(&bm);
+    cache->add(make_key(sourceID), &bm, pin);
+}
+
+static bool contains(SkImageCache* cache, uint32_t sourceID) {
+    SkBitmap bm;
+    return cache->find(make_key(sourceID), &bm);
+}
+
+static void test_lru(skiatest::Reporter* reporter) {
+    SkImageCache cache(3 * kBytes);
+    add(&cache, 1);
+    add(&cache, 2);
+    add(&cache, 3);
+    REPORTER_ASSERT(reporter, 3 * kBytes == cache.getBytesUsed());
+
+    // 1 is now more recently used than 2, so 2 goes first
+    REPORTER_ASSERT(reporter, contains(&cache, 1));
+    add(&cache, 4);
+    REPORTER_ASSERT(reporter, !contains(&cache, 2));
+    REPORTER_ASSERT(reporter, contains(&cache, 1));
+    REPORTER_ASSERT(reporter, contains(&cache, 3));
+    REPORTER_ASSERT(reporter, contains(&cache, 4));
+
+    SkImageCache::Stats stats = cache.getStats();
+    REPORTER_ASSERT(reporter, 4 == stats.fHits);
+    REPORTER_ASSERT(reporter, 1 == stats.fMisses);
+    REPORTER_ASSERT(reporter, 1 == stats.fEvictions);
+    REPORTER_ASSERT(reporter, 3 == stats.fCount);
+    REPORTER_ASSERT(reporter, 3 * kBytes == stats.fBytesUsed);
+
+    // adding what is already there shares the pixels instead
+    SkBitmap first, second;
+    REPORTER_ASSERT(reporter, cache.find(make_key(1), &first));
+    make_bitmap(&second);
+    cache.add(make_key(1), &second);
+    REPORTER_ASSERT(reporter, first.pixelRef() == second.pixelRef());
+    REPORTER_ASSERT(reporter, 3 == cache.getStats().fCount);
+
+    cache.remove(make_key(3));
+    REPORTER_ASSERT(reporter, !contains(&cache, 3));
+    REPORTER_ASSERT(reporter, 2 * kBytes == cache.getBytesUsed());
+
+    cache.purgeTo(0);
+    REPORTER_ASSERT(reporter, 0 == cache.getBytesUsed());
+    REPORTER_ASSERT(reporter, 0 == cache.getStats().fCount);
+    // the bitmaps we still hold keep their pixels
+    REPORTER_ASSERT(reporter, 2 == first.pixelRef()->getRefCnt());
+}
+
+static void test_pin(skiatest::Reporter* reporter) {
+    SkImageCache cache;
+    add(&cache, 1, true);
+    add(&cache, 2);
+    SkBitmap bm;
+    REPORTER_ASSERT(reporter, cache.find(make_key(2), &bm, true));
+    REPORTER_ASSERT(reporter, cache.find(make_key(2), &bm, true));
+
+    // pinned entries are kept, even over budget
+    cache.setByteLimit(kBytes / 2);
+    REPORTER_ASSERT(reporter, 2 == cache.getStats().fCount);
+    REPORTER_ASSERT(reporter, !cache.removeIfUnpinned(make_key(1)));
+    REPORTER_ASSERT(reporter, 2 == cache.getStats().fCount);
+
+    cache.unpin(make_key(1));
+    REPORTER_ASSERT(reporter, !contains(&cache, 1));
+    cache.unpin(make_key(2));
+    REPORTER_ASSERT(reporter, contains(&cache, 2));
+    cache.unpin(make_key(2));
+    REPORTER_ASSERT(reporter, 0 == cache.getStats().fCount);
+    REPORTER_ASSERT(reporter, 0 == cache.getBytesUsed());
+}
+
+static SkImageCache* gThreadCache;
+
+static void hammer(void*) {
+    for (int i = 0; i < 1000; ++i) {
+        uint32_t sourceID = i % 37;
+        SkBitmap bm;
+        if (!gThreadCache->find(make_key(sourceID), &bm, true)) {
+            make_bitmap(&bm);
+            gThreadCache->add(make_key(sourceID), &bm, true);
+        }
+        gThreadCache->unpin(make_key(sourceID));
+    }
+}
+
+static void test_threads(skiatest::Reporter* reporter) {
+    SkImageCache cache(10 * kBytes);
+    gThreadCache = &cache;
+    SkThread* threads[4];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(threads); ++i) {
+        threads[i] = SkNEW_ARGS(SkThread, (hammer, NULL));
+        threads[i]->start();
+    }
+    for (size_t i = 0; i < SK_ARRAY_COUNT(threads); ++i) {
+        threads[i]->join();
+        SkDELETE(threads[i]);
+    }
+    gThreadCache = NULL;
+
+    SkImageCache::Stats stats = cache.getStats();
+    REPORTER_ASSERT(reporter, stats.fBytesUsed <= 10 * kBytes);
+    REPORTER_ASSERT(reporter, stats.fBytesUsed == stats.fCount * kBytes);
+    REPORTER_ASSERT(reporter, 4000 == stats.fHits + stats.fMisses);
+}
+
+static SkStream* encode_bitmap() {
+    SkBitmap bm;
+    make_bitmap(&bm);
+    SkDynamicMemoryWStream stream;
+    if (!SkImageEncoder::EncodeStream(&stream, bm, SkImageEncoder::kPNG_Type, 100)) {
+        return NULL;
+    }
+    SkAutoDataUnref data(stream.copyToData());
+    return SkNEW_ARGS(SkMemoryStream, (data));
+}
+
+static void test_global_pool(skiatest::Reporter* reporter) {
+    SkAutoTUnref<SkStream> stream(encode_bitmap());
+    if (NULL == stream.get()) {
+        return;
+    }
+
+    const size_t oldBudget = SkImageRef_GlobalPool::GetRAMBudget();
+    SkImageRef_GlobalPool::SetRAMUsed(0);
+    SkImageRef_GlobalPool::SetRAMBudget(kBytes);
+    {
+        SkAutoTUnref<SkImageRef_GlobalPool> ref1(
+            SkNEW_ARGS(SkImageRef_GlobalPool, (stream, SkBitmap::kARGB_8888_Config)));
+        SkAutoTUnref<SkImageRef_GlobalPool> ref2(
+            SkNEW_ARGS(SkImageRef_GlobalPool, (stream, SkBitmap::kARGB_8888_Config)));
+
+        // While locked, both images stay decoded, even over budget.
+        ref1->lockPixels();
+        ref2->lockPixels();
+        REPORTER_ASSERT(reporter, NULL != ref1->pixels() && NULL != ref2->pixels());
+        REPORTER_ASSERT(reporter, 2 * kBytes == SkImageRef_GlobalPool::GetRAMUsed());
+        ref1->unlockPixels();
+        ref2->unlockPixels();
+        REPORTER_ASSERT(reporter, kBytes == SkImageRef_GlobalPool::GetRAMUsed());
+
+        // Either may have been evicted, but locking decodes it again.
+        ref1->lockPixels();
+        REPORTER_ASSERT(reporter, NULL != ref1->pixels());
+        ref1->unlockPixels();
+    }
+    // Our pixels are dropped with us.
+    REPORTER_ASSERT(reporter, 0 == SkImageRef_GlobalPool::GetRAMUsed());
+    SkImageRef_GlobalPool::SetRAMBudget(oldBudget);
+}
+
+// Destroying an imageref must not take pixels away from another one that
+// shares its source ID and has them locked.
+static void test_shared_source(skiatest::Reporter* reporter) {
+    SkAutoTUnref<SkStream> stream(encode_bitmap());
+    if (NULL == stream.get()) {
+        return;
+    }
+
+    const size_t oldBudget = SkImageRef_GlobalPool::GetRAMBudget();
+    SkImageRef_GlobalPool::SetRAMUsed(0);
+    SkImageRef_GlobalPool::SetRAMBudget(kBytes);
+    SkImageCache* cache = SkImageCache::GetGlobal();
+    {
+        SkImageRef_GlobalPool* ref1 =
+            SkNEW_ARGS(SkImageRef_GlobalPool, (stream, SkBitmap::kARGB_8888_Config));
+        SkAutoTUnref<SkImageRef_GlobalPool> ref2(
+            SkNEW_ARGS(SkImageRef_GlobalPool, (stream, SkBitmap::kARGB_8888_Config)));
+        ref2->setSourceID(ref1->getSourceID());
+
+        ref1->lockPixels();
+        ref2->lockPixels();
+        REPORTER_ASSERT(reporter, ref1->pixels() == ref2->pixels());
+        ref1->unlockPixels();
+        ref1->unref();
+
+        // ref2's pixels are still cached, and still counted.
+        REPORTER_ASSERT(reporter, 1 == cache->getStats().fCount);
+        REPORTER_ASSERT(reporter, kBytes == SkImageRef_GlobalPool::GetRAMUsed());
+        ref2->unlockPixels();
+        REPORTER_ASSERT(reporter, kBytes == SkImageRef_GlobalPool::GetRAMUsed());
+
+        // so locking them again, or from a new imageref, does not decode.
+        const int32_t misses = cache->getStats().fMisses;
+        SkAutoTUnref<SkImageRef_GlobalPool> ref3(
+            SkNEW_ARGS(SkImageRef_GlobalPool, (stream, SkBitmap::kARGB_8888_Config)));
+        ref3->setSourceID(ref2->getSourceID());
+        ref2->lockPixels();
+        ref3->lockPixels();
+        REPORTER_ASSERT(reporter, ref2->pixels() == ref3->pixels());
+        REPORTER_ASSERT(reporter, misses == cache->getStats().fMisses);
+        ref2->unlockPixels();
+        ref3->unlockPixels();
+    }
+    // Once none of them is left, neither are the pixels.
+    REPORTER_ASSERT(reporter, 0 == SkImageRef_GlobalPool::GetRAMUsed());
+    SkImageRef_GlobalPool::SetRAMBudget(oldBudget);
+}
+
+static void TestImageCache(skiatest::Reporter* reporter) {
+    test_lru(reporter);
+    test_pin(reporter);
+    test_threads(reporter);
+    test_global_pool(reporter);
+    test_shared_source(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("ImageCache", ImageCacheTestClass, TestImageCache)
@@ -0,0 +1,240 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkFlate.h"
+#include "SkImageDecoder.h"
+#include "SkImageEncoder.h"
+#include "SkRect.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+static void make_bitmap(SkBitmap* bm, int w, int h) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, w, h);
+    bm->allocPixels();
+    bm->setIsOpaque(true);
+    SkAutoLockPixels alp(*bm);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            *bm->getAddr32(x, y) = SkPackARGB32(0xFF, x * 255 / w,
+                                                y * 255 / h, (x ^ y) & 0xFF);
+        }
+    }
+}
+
+static uint32_t png_crc(const uint8_t* data, size_t length, uint32_t crc) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return crc;
+}
+
+static void write_be32(SkWStream* stream, uint32_t value) {
+    uint8_t bytes[4] = {
+        (uint8_t)(value >> 24), (uint8_t)(value >> 16),
+        (uint8_t)(value >> 8), (uint8_t)value
+    };
+    stream->write(bytes, 4);
+}
+
+static void write_chunk(SkWStream* stream, const char tag[4],
+                        const void* data, size_t length) {
+    write_be32(stream, length);
+    stream->write(tag, 4);
+    stream->write(data, length);
+    uint32_t crc = png_crc((const uint8_t*)tag, 4, 0xFFFFFFFF);
+    crc = png_crc((const uint8_t*)data, length, crc);
+    write_be32(stream, ~crc);
+}
+
+// Our encoder never interlaces, so write an Adam7 interlaced RGB png by hand.
+static SkData* encode_interlaced_png(const SkBitmap& bm) {
+    if (!SkFlate::HaveFlate()) {
+        return NULL;
+    }
+    // The origin and spacing of each pass's pixels.
+    static const int gAdam7[7][4] = {
+        { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 },
+        { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 },
+    };
+    SkDynamicMemoryWStream scanlines;
+    SkAutoLockPixels alp(bm);
+    for (int pass = 0; pass < 7; pass++) {
+        const int x0 = gAdam7[pass][0];
+        const int y0 = gAdam7[pass][1];
+        if (x0 >= bm.width()) {
+            continue;   // the pass is empty
+        }
+        for (int y = y0; y < bm.height(); y += gAdam7[pass][3]) {
+            scanlines.write8(0);    // no filter
+            for (int x = x0; x < bm.width(); x += gAdam7[pass][2]) {
+                SkPMColor c = *bm.getAddr32(x, y);
+                uint8_t rgb[3] = {
+                    SkGetPackedR32(c), SkGetPackedG32(c), SkGetPackedB32(c)
+                };
+                scanlines.write(rgb, 3);
+            }
+        }
+    }
+    SkAutoDataUnref raw(scanlines.copyToData());
+    SkDynamicMemoryWStream idat;
+    if (!SkFlate::Deflate(raw.get(), &idat)) {
+        return NULL;
+    }
+    SkAutoDataUnref compressed(idat.copyToData());
+
+    SkDynamicMemoryWStream stream;
+    static const uint8_t gSignature[] = {
+        0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'
+    };
+    stream.write(gSignature, sizeof(gSignature));
+    uint8_t ihdr[13];
+    SkMemoryWStream ihdrStream(ihdr, sizeof(ihdr));
+    write_be32(&ihdrStream, bm.width());
+    write_be32(&ihdrStream, bm.height());
+    static const uint8_t gFormat[] = {
+        8,      // bit depth
+        2,      // RGB
+        0,      // deflate
+        0,      // adaptive filtering
+        1,      // Adam7 interlacing
+    };
+    ihdrStream.write(gFormat, sizeof(gFormat));
+    write_chunk(&stream, "IHDR", ihdr, sizeof(ihdr));
+    write_chunk(&stream, "IDAT", compressed->data(), compressed->size());
+    write_chunk(&stream, "IEND", NULL, 0);
+    return stream.copyToData();
+}
+
+static SkData* encode(const SkBitmap& bm, SkImageEncoder::Type type) {
+    SkDynamicMemoryWStream stream;
+    if (SkImageEncoder::EncodeStream(&stream, bm, type, 100)) {
+        return stream.copyToData();
+    }
+    return NULL;
+}
+
+// Check that region is the part of expected inside rect, sampled the way
+// SkScaledBitmapSampler does it.
+static void check_region(skiatest::Reporter* reporter, const SkBitmap& expected,
+                         const SkBitmap& region, SkIRect rect, int sampleSize) {
+    REPORTER_ASSERT(reporter, rect.intersect(0, 0, expected.width(),
+                                             expected.height()));
+    const int dx = SkMin32(sampleSize, rect.width());
+    const int dy = SkMin32(sampleSize, rect.height());
+    REPORTER_ASSERT(reporter, region.width() == rect.width() / dx);
+    REPORTER_ASSERT(reporter, region.height() == rect.height() / dy);
+    if (region.width() != rect.width() / dx ||
+        region.height() != rect.height() / dy) {
+        return;
+    }
+
+    SkAutoLockPixels alp0(expected);
+    SkAutoLockPixels alp1(region);
+    int mismatches = 0;
+    for (int y = 0; y < region.height(); y++) {
+        int srcY = rect.fTop + (dy >> 1) + y * dy;
+        for (int x = 0; x < region.width(); x++) {
+            int srcX = rect.fLeft + (dx >> 1) + x * dx;
+            if (*expected.getAddr32(srcX, srcY) != *region.getAddr32(x, y)) {
+                mismatches++;
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, 0 == mismatches);
+}
+
+static void test_regions(skiatest::Reporter* reporter, SkData* data,
+                         const SkBitmap& expected, int sampleSizeCount) {
+    SkMemoryStream stream(data);
+    SkAutoTDelete<SkImageDecoder> decoder(SkImageDecoder::Factory(&stream));
+    if (NULL == decoder.get()) {
+        return;
+    }
+
+    SkBitmap bm;
+    SkIRect rect = SkIRect::MakeWH(10, 10);
+    // no index yet
+    REPORTER_ASSERT(reporter, !decoder->decodeRegion(&bm, rect, 1));
+
+    int width, height;
+    REPORTER_ASSERT(reporter, stream.rewind());
+    REPORTER_ASSERT(reporter, decoder->buildTileIndex(&stream, &width, &height));
+    REPORTER_ASSERT(reporter, width == expected.width());
+    REPORTER_ASSERT(reporter, height == expected.height());
+
+    static const SkIRect gRects[] = {
+        { 0, 0, 100, 80 },      // the whole image
+        { 10, 20, 60, 50 },
+        { 33, 7, 34, 8 },       // a single pixel
+        { 70, 60, 200, 200 },   // clipped by the image
+    };
+    static const int gSampleSizes[] = { 1, 3 };
+    SkASSERT(sampleSizeCount <= (int)SK_ARRAY_COUNT(gSampleSizes));
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gRects); i++) {
+        for (int j = 0; j < sampleSizeCount; j++) {
+            // decode the same regions repeatedly from the one index
+            for (int repeat = 0; repeat < 2; repeat++) {
+                SkBitmap region;
+                bool success = decoder->decodeRegion(&region, gRects[i],
+                                                     gSampleSizes[j],
+                                                     SkBitmap::kARGB_8888_Config);
+                REPORTER_ASSERT(reporter, success);
+                if (success) {
+                    check_region(reporter, expected, region, gRects[i],
+                                 gSampleSizes[j]);
+                }
+            }
+        }
+    }
+
+    // entirely outside the image
+    rect.setXYWH(200, 200, 10, 10);
+    REPORTER_ASSERT(reporter, !decoder->decodeRegion(&bm, rect, 1));
+    REPORTER_ASSERT(reporter, bm.isNull());
+}
+
+static void TestImageDecodeRegion(skiatest::Reporter* reporter) {
+    SkBitmap bm;
+    make_bitmap(&bm, 100, 80);
+
+    // png is lossless, so regions must match the original
+    SkAutoDataUnref png(encode(bm, SkImageEncoder::kPNG_Type));
+    if (png.get()) {
+        test_regions(reporter, png, bm, 2);
+    }
+
+    // as are interlaced pngs, which are decoded a pass at a time
+    SkAutoDataUnref interlaced(encode_interlaced_png(bm));
+    if (interlaced.get()) {
+        test_regions(reporter, interlaced, bm, 2);
+    }
+
+    // jpeg is not, so regions must match the whole image decoded normally.
+    // It also samples in the DCT, so we only compare unsampled regions.
+    SkAutoDataUnref jpeg(encode(bm, SkImageEncoder::kJPEG_Type));
+    if (jpeg.get()) {
+        SkBitmap decoded;
+        if (SkImageDecoder::DecodeMemory(jpeg->data(), jpeg->size(), &decoded,
+                                         SkBitmap::kARGB_8888_Config,
+                                         SkImageDecoder::kDecodePixels_Mode)) {
+            test_regions(reporter, jpeg, decoded, 1);
+        }
+    }
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("ImageDecodeRegion", ImageDecodeRegionTestClass,
+                 TestImageDecodeRegion)
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkBlendImageFilter.h"
+#include "SkBlurImageFilter.h"
+#include "SkCanvas.h"
+#include "SkColorFilterImageFilter.h"
+#include "SkColorMatrixFilter.h"
+#include "SkDevice.h"
+#include "SkDeviceImageFilterProxy.h"
+#include "SkMergeImageFilter.h"
+#include "SkMorphologyImageFilter.h"
+#include "SkOffsetImageFilter.h"
+#include "SkRandom.h"
+#include "SkSingleInputImageFilter.h"
+#include "SkTestImageFilters.h"
+
+static const int kSize = 64;
+
+namespace {
+
+// Passes its input through, and remembers how big it was.
+class RecordingImageFilter : public SkSingleInputImageFilter {
+public:
+    RecordingImageFilter(SkImageFilter* input = NULL)
+        : INHERITED(input), fInputWidth(0), fInputHeight(0) {}
+
+    int fInputWidth, fInputHeight;
+
+    SK_DECLARE_UNFLATTENABLE_OBJECT()
+
+protected:
+    virtual bool onFilterImage(Proxy* proxy, const SkBitmap& src,
+                               const Context& ctx, SkBitmap* result,
+                               SkIPoint* offset) SK_OVERRIDE {
+        *result = this->getInputResult(proxy, src, ctx, offset);
+        fInputWidth = result->width();
+        fInputHeight = result->height();
+        return true;
+    }
+
+    virtual bool onSourceBounds(const SkIRect& dst, const SkMatrix&,
+                                SkIRect* src) SK_OVERRIDE {
+        *src = dst;
+        return true;
+    }
+
+private:
+    typedef SkSingleInputImageFilter INHERITED;
+};
+
+}
+
+static void make_source(SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, kSize, kSize);
+    bm->allocPixels();
+    SkRandom rand;
+    SkAutoLockPixels alp(*bm);
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            // mostly clear, with some opaque spots, so the filters have edges
+            // to move around
+            uint32_t r = rand.nextU();
+            *bm->getAddr32(x, y) = (r & 7) ? 0 : SkPreMultiplyColor(r | 0xFF000000);
+        }
+    }
+}
+
+static void draw_filtered(const SkBitmap& src, SkImageFilter* filter,
+                          const SkIRect* clip, SkBitmap* dst) {
+    dst->setConfig(SkBitmap::kARGB_8888_Config, kSize, kSize);
+    dst->allocPixels();
+    dst->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*dst);
+    if (clip) {
+        SkRect r;
+        r.set(*clip);
+        canvas.clipRect(r);
+    }
+    SkPaint paint;
+    paint.setImageFilter(filter);
+    canvas.drawSprite(src, 0, 0, &paint);
+}
+
+static bool equal_in_rect(const SkBitmap& a, const SkBitmap& b,
+                          const SkIRect& r) {
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    for (int y = r.fTop; y < r.fBottom; ++y) {
+        for (int x = r.fLeft; x < r.fRight; ++x) {
+            if (*a.getAddr32(x, y) != *b.getAddr32(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void test_clipped_results(skiatest::Reporter* reporter) {
+    SkBitmap src;
+    make_source(&src);
+
+    SkScalar matrix[20];
+    memset(matrix, 0, sizeof(matrix));
+    matrix[2] = matrix[5] = matrix[13] = matrix[18] = SK_Scalar1;
+    SkAutoTUnref<SkColorFilter> cf(SkNEW_ARGS(SkColorMatrixFilter, (matrix)));
+
+    SkAutoTUnref<SkImageFilter> blur(SkNEW_ARGS(SkBlurImageFilter, (3, 2)));
+    SkAutoTUnref<SkImageFilter> erode(SkNEW_ARGS(SkErodeImageFilter, (2, 3)));
+    SkAutoTUnref<SkImageFilter> dilate(SkNEW_ARGS(SkDilateImageFilter, (4, 1)));
+    SkAutoTUnref<SkImageFilter> offset(SkNEW_ARGS(SkOffsetImageFilter,
+                                                  (SkIntToScalar(7),
+                                                   SkIntToScalar(-5))));
+    SkAutoTUnref<SkImageFilter> blurOffset(SkNEW_ARGS(SkBlurImageFilter,
+                                                      (2, 2, offset)));
+    SkAutoTUnref<SkImageFilter> colorDilate(
+            SkColorFilterImageFilter::Create(cf, dilate));
+    SkAutoTUnref<SkImageFilter> merge(SkNEW_ARGS(SkMergeImageFilter,
+                                                 (blurOffset, erode)));
+    SkAutoTUnref<SkImageFilter> blend(SkNEW_ARGS(SkBlendImageFilter,
+            (SkBlendImageFilter::kMultiply_Mode, blurOffset, dilate)));
+    SkAutoTUnref<SkImageFilter> compose(SkNEW_ARGS(SkComposeImageFilter,
+                                                   (erode, blurOffset)));
+
+    SkImageFilter* filters[] = {
+        blur, erode, dilate, offset, blurOffset, colorDilate, merge, blend,
+        compose
+    };
+    const SkIRect clips[] = {
+        SkIRect::MakeXYWH(0, 0, 16, 16),
+        SkIRect::MakeXYWH(20, 9, 13, 31),
+        SkIRect::MakeXYWH(48, 48, 16, 16),
+        SkIRect::MakeXYWH(1, 30, 62, 3),
+    };
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(filters); ++i) {
+        SkBitmap expected;
+        draw_filtered(src, filters[i], NULL, &expected);
+        for (size_t j = 0; j < SK_ARRAY_COUNT(clips); ++j) {
+            SkBitmap actual;
+            draw_filtered(src, filters[i], &clips[j], &actual);
+            REPORTER_ASSERT(reporter,
+                            equal_in_rect(expected, actual, clips[j]));
+        }
+    }
+}
+
+static void test_source_bounds(skiatest::Reporter* reporter) {
+    const SkMatrix& identity = SkMatrix::I();
+    const SkIRect dst = SkIRect::MakeXYWH(10, 20, 30, 40);
+    SkIRect src;
+
+    SkAutoTUnref<SkImageFilter> erode(SkNEW_ARGS(SkErodeImageFilter, (2, 3)));
+    REPORTER_ASSERT(reporter, erode->sourceBounds(dst, identity, &src));
+    REPORTER_ASSERT(reporter, SkIRect::MakeLTRB(8, 17, 42, 63) == src);
+
+    SkAutoTUnref<SkImageFilter> offset(SkNEW_ARGS(SkOffsetImageFilter,
+                                                  (SkIntToScalar(5),
+                                                   SkIntToScalar(-4),
+                                                   erode)));
+    REPORTER_ASSERT(reporter, offset->sourceBounds(dst, identity, &src));
+    REPORTER_ASSERT(reporter, SkIRect::MakeLTRB(3, 21, 37, 67) == src);
+
+    SkAutoTUnref<SkImageFilter> merge(SkNEW_ARGS(SkMergeImageFilter,
+                                                 (offset, NULL)));
+    REPORTER_ASSERT(reporter, merge->sourceBounds(dst, identity, &src));
+    REPORTER_ASSERT(reporter, SkIRect::MakeLTRB(3, 20, 40, 67) == src);
+
+    // a filter that cannot say what it needs makes its parents need it all
+    SkAutoTUnref<SkImageFilter> downSample(SkNEW_ARGS(SkDownSampleImageFilter,
+                                                      (SK_Scalar1 / 2)));
+    SkAutoTUnref<SkImageFilter> blur(SkNEW_ARGS(SkBlurImageFilter,
+                                                (1, 1, downSample)));
+    REPORTER_ASSERT(reporter, !blur->sourceBounds(dst, identity, &src));
+}
+
+static void test_input_is_cropped(skiatest::Reporter* reporter) {
+    SkBitmap src;
+    make_source(&src);
+
+    SkAutoTUnref<RecordingImageFilter> recorder(
+            SkNEW(RecordingImageFilter));
+    SkAutoTUnref<SkImageFilter> dilate(SkNEW_ARGS(SkDilateImageFilter,
+                                                  (3, 2, recorder)));
+    const SkIRect clip = SkIRect::MakeXYWH(20, 20, 10, 10);
+    SkBitmap dst;
+    draw_filtered(src, dilate, &clip, &dst);
+    REPORTER_ASSERT(reporter, 16 == recorder->fInputWidth);
+    REPORTER_ASSERT(reporter, 14 == recorder->fInputHeight);
+}
+
+static void test_proxy_reuses_devices(skiatest::Reporter* reporter) {
+    SkDevice device(SkBitmap::kARGB_8888_Config, 8, 8);
+    SkDeviceImageFilterProxy proxy(&device);
+
+    SkDevice* first = proxy.createDevice(10, 10);
+    SkCanvas(first).drawColor(SK_ColorRED);
+    SkBitmap held = first->accessBitmap(false);
+    first->unref();
+
+    // its pixels are still in use, so it cannot be handed out again
+    SkDevice* second = proxy.createDevice(10, 10);
+    REPORTER_ASSERT(reporter, second != first);
+    second->unref();
+
+    held.reset();
+    SkDevice* third = proxy.createDevice(10, 10);
+    REPORTER_ASSERT(reporter, third == first);
+    {
+        SkAutoLockPixels alp(third->accessBitmap(false));
+        REPORTER_ASSERT(reporter,
+                        0 == *third->accessBitmap(false).getAddr32(5, 5));
+    }
+
+    SkDevice* other = proxy.createDevice(10, 12);
+    REPORTER_ASSERT(reporter, other != first && other != second);
+    other->unref();
+    third->unref();
+}
+
+static void TestImageFilter(skiatest::Reporter* reporter) {
+    test_clipped_results(reporter);
+    test_source_bounds(reporter);
+    test_input_is_cropped(reporter);
+    test_proxy_reuses_devices(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("ImageFilter", ImageFilterTestClass, TestImageFilter)
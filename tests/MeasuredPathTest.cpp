@@ -0,0 +1,166 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Test.h"
+#include "TestUtils.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkMeasuredPath.h"
+#include "SkPathMeasure.h"
+#include "SkPicture.h"
+#include "SkStream.h"
+
+static const int W = 256;
+static const int H = 128;
+
+static void make_path(SkPath* path) {
+    path->moveTo(SkIntToScalar(10), SkIntToScalar(100));
+    path->cubicTo(SkIntToScalar(60), SkIntToScalar(0),
+                  SkIntToScalar(140), SkIntToScalar(140),
+                  SkIntToScalar(240), SkIntToScalar(40));
+}
+
+static void make_paint(SkPaint* paint) {
+    paint->setAntiAlias(true);
+    paint->setTextSize(SkIntToScalar(18));
+}
+
+static void make_bitmap(SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, W, H);
+    bm->allocPixels();
+    bm->eraseColor(SK_ColorWHITE);
+}
+
+static void test_measure(skiatest::Reporter* reporter, const SkPath& path) {
+    SkMeasuredPath measured(path);
+    SkPathMeasure meas(path, false);
+
+    REPORTER_ASSERT(reporter, measured.getLength() == meas.getLength());
+    for (int i = -1; i <= 11; ++i) {
+        SkScalar distance = meas.getLength() * i / 10;
+        SkPoint pos0, pos1;
+        SkVector tan0, tan1;
+        REPORTER_ASSERT(reporter, meas.getPosTan(distance, &pos0, &tan0));
+        REPORTER_ASSERT(reporter, measured.getPosTan(distance, &pos1, &tan1));
+        REPORTER_ASSERT(reporter, pos0 == pos1 && tan0 == tan1);
+    }
+}
+
+static const char* gLabels[] = { "Main Street", "Main St", "M" };
+
+static void test_draw(skiatest::Reporter* reporter, const SkPath& path) {
+    SkMeasuredPath measured(path);
+    SkPaint paint;
+    make_paint(&paint);
+
+    static const SkPaint::Align gAligns[] = {
+        SkPaint::kLeft_Align, SkPaint::kCenter_Align, SkPaint::kRight_Align
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gAligns); ++i) {
+        paint.setTextAlign(gAligns[i]);
+
+        SkBitmap expected, actual;
+        make_bitmap(&expected);
+        make_bitmap(&actual);
+        SkCanvas expectedCanvas(expected);
+        SkCanvas actualCanvas(actual);
+        expectedCanvas.drawTextOnPathHV(gLabels[0], strlen(gLabels[0]), path,
+                                        SkIntToScalar(12), SkIntToScalar(-4),
+                                        paint);
+        actualCanvas.drawTextOnMeasuredPathHV(gLabels[0], strlen(gLabels[0]),
+                                              measured, SkIntToScalar(12),
+                                              SkIntToScalar(-4), paint);
+        REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+    }
+}
+
+static void draw_labels(SkCanvas* canvas, const SkMeasuredPath& measured) {
+    const void* texts[SK_ARRAY_COUNT(gLabels)];
+    size_t lengths[SK_ARRAY_COUNT(gLabels)];
+    SkPoint offsets[SK_ARRAY_COUNT(gLabels)];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gLabels); ++i) {
+        texts[i] = gLabels[i];
+        lengths[i] = strlen(gLabels[i]);
+        offsets[i].set(SkIntToScalar(100 * i), SkIntToScalar(6 * i));
+    }
+    SkPaint paint;
+    make_paint(&paint);
+    canvas->drawTextsOnMeasuredPath(SK_ARRAY_COUNT(gLabels), texts, lengths,
+                                    offsets, measured, paint);
+}
+
+static void test_batch(skiatest::Reporter* reporter, const SkPath& path) {
+    SkMeasuredPath measured(path);
+    SkPaint paint;
+    make_paint(&paint);
+
+    SkBitmap expected, actual;
+    make_bitmap(&expected);
+    make_bitmap(&actual);
+    SkCanvas expectedCanvas(expected);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gLabels); ++i) {
+        expectedCanvas.drawTextOnPathHV(gLabels[i], strlen(gLabels[i]), path,
+                                        SkIntToScalar(100 * i),
+                                        SkIntToScalar(6 * i), paint);
+    }
+    SkCanvas actualCanvas(actual);
+    draw_labels(&actualCanvas, measured);
+    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+}
+
+static void test_picture(skiatest::Reporter* reporter, const SkPath& path) {
+    SkMeasuredPath* measured = SkNEW_ARGS(SkMeasuredPath, (path));
+
+    SkBitmap expected;
+    make_bitmap(&expected);
+    SkCanvas expectedCanvas(expected);
+    draw_labels(&expectedCanvas, *measured);
+    draw_labels(&expectedCanvas, *measured);
+
+    SkPicture* picture = SkNEW(SkPicture);
+    SkCanvas* recordingCanvas = picture->beginRecording(W, H);
+    draw_labels(recordingCanvas, *measured);
+    draw_labels(recordingCanvas, *measured);
+    // the recording holds one reference, however often the path is used
+    REPORTER_ASSERT(reporter, 2 == measured->getRefCnt());
+    picture->endRecording();
+    REPORTER_ASSERT(reporter, measured->getRefCnt() > 1);
+
+    SkBitmap actual;
+    make_bitmap(&actual);
+    SkCanvas actualCanvas(actual);
+    actualCanvas.drawPicture(*picture);
+    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+
+    // once serialized, the path is measured again on playback
+    SkDynamicMemoryWStream stream;
+    picture->serialize(&stream);
+    SkAutoDataUnref data(stream.copyToData());
+    SkMemoryStream readStream(data);
+    SkAutoTUnref<SkPicture> readPicture(SkNEW_ARGS(SkPicture, (&readStream)));
+    make_bitmap(&actual);
+    SkCanvas readCanvas(actual);
+    readCanvas.drawPicture(*readPicture);
+    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+
+    picture->unref();
+    REPORTER_ASSERT(reporter, 1 == measured->getRefCnt());
+    measured->unref();
+}
+
+static void TestMeasuredPath(skiatest::Reporter* reporter) {
+    SkPath path;
+    make_path(&path);
+
+    test_measure(reporter, path);
+    test_draw(reporter, path);
+    test_batch(reporter, path);
+    test_picture(reporter, path);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("MeasuredPath", MeasuredPathTestClass, TestMeasuredPath)
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkMatrix.h"
+#include "SkMorphologyImageFilter.h"
+#include "SkMorphologyProcs.h"
+#include "SkRandom.h"
+#include "SkTemplates.h"
+
+static SkPMColor morph_color(SkPMColor a, SkPMColor b, bool isMax) {
+    SkPMColor result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        unsigned ca = (a >> shift) & 0xFF;
+        unsigned cb = (b >> shift) & 0xFF;
+        unsigned c = isMax ? SkMax32(ca, cb) : SkMin32(ca, cb);
+        result |= c << shift;
+    }
+    return result;
+}
+
+// The straightforward version, which looks at every pixel in the window.
+static void ref_morph(const SkPMColor* src, int srcRowPixels,
+                      SkPMColor* dst, int dstRowPixels,
+                      int radius, int width, int height,
+                      bool isMax, bool isY) {
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int center = isY ? y : x;
+            int length = isY ? height : width;
+            SkPMColor value = src[y * srcRowPixels + x];
+            for (int i = SkMax32(0, center - radius);
+                 i <= SkMin32(length - 1, center + radius); ++i) {
+                int index = isY ? i * srcRowPixels + x : y * srcRowPixels + i;
+                value = morph_color(value, src[index], isMax);
+            }
+            dst[y * dstRowPixels + x] = value;
+        }
+    }
+}
+
+static void fill_random(SkBitmap* bm, SkRandom& rand) {
+    bm->lockPixels();
+    for (int y = 0; y < bm->height(); ++y) {
+        for (int x = 0; x < bm->width(); ++x) {
+            *bm->getAddr32(x, y) = rand.nextU();
+        }
+    }
+    bm->unlockPixels();
+}
+
+static bool bitmaps_equal(const SkBitmap& a, const SkBitmap& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y),
+                   a.width() * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const int gSizes[] = { 1, 3, 4, 7, 16, 37 };
+
+static void test_filters(skiatest::Reporter* reporter) {
+    static const int gRadii[] = { 0, 1, 2, 5, 40 };
+    SkRandom rand;
+
+    for (size_t w = 0; w < SK_ARRAY_COUNT(gSizes); ++w) {
+        for (size_t h = 0; h < SK_ARRAY_COUNT(gSizes); ++h) {
+            const int width = gSizes[w];
+            const int height = gSizes[h];
+            // pad the rows, so that strides that are not the width get tested
+            SkBitmap src;
+            src.setConfig(SkBitmap::kARGB_8888_Config, width, height,
+                          (width + 3) * sizeof(SkPMColor));
+            src.allocPixels();
+            fill_random(&src, rand);
+
+            SkBitmap temp, expected;
+            temp.setConfig(SkBitmap::kARGB_8888_Config, width, height);
+            temp.allocPixels();
+            expected.setConfig(SkBitmap::kARGB_8888_Config, width, height);
+            expected.allocPixels();
+
+            for (size_t rx = 0; rx < SK_ARRAY_COUNT(gRadii); ++rx) {
+                for (size_t ry = 0; ry < SK_ARRAY_COUNT(gRadii); ++ry) {
+                    const int radiusX = gRadii[rx];
+                    const int radiusY = gRadii[ry];
+                    for (int isMax = 0; isMax <= 1; ++isMax) {
+                        {
+                            SkAutoLockPixels alps(src);
+                            SkAutoLockPixels alpt(temp);
+                            SkAutoLockPixels alpe(expected);
+                            ref_morph(src.getAddr32(0, 0),
+                                      src.rowBytesAsPixels(),
+                                      temp.getAddr32(0, 0),
+                                      temp.rowBytesAsPixels(),
+                                      radiusX, width, height,
+                                      SkToBool(isMax), false);
+                            ref_morph(temp.getAddr32(0, 0),
+                                      temp.rowBytesAsPixels(),
+                                      expected.getAddr32(0, 0),
+                                      expected.rowBytesAsPixels(),
+                                      radiusY, width, height,
+                                      SkToBool(isMax), true);
+                        }
+
+                        SkAutoTUnref<SkImageFilter> filter;
+                        if (isMax) {
+                            filter.reset(SkNEW_ARGS(SkDilateImageFilter,
+                                                    (radiusX, radiusY)));
+                        } else {
+                            filter.reset(SkNEW_ARGS(SkErodeImageFilter,
+                                                    (radiusX, radiusY)));
+                        }
+                        SkBitmap actual;
+                        SkIPoint offset = SkIPoint::Make(0, 0);
+                        REPORTER_ASSERT(reporter,
+                                filter->filterImage(NULL, src, SkMatrix::I(),
+                                                    &actual, &offset));
+                        REPORTER_ASSERT(reporter,
+                                        bitmaps_equal(expected, actual));
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void test_platform_procs(skiatest::Reporter* reporter) {
+    static const SkMorphologyProcType gTypes[] = {
+        kErodeX_SkMorphologyProcType,
+        kErodeY_SkMorphologyProcType,
+        kDilateX_SkMorphologyProcType,
+        kDilateY_SkMorphologyProcType
+    };
+    SkRandom rand;
+
+    for (size_t t = 0; t < SK_ARRAY_COUNT(gTypes); ++t) {
+        SkMorphologyProc proc = SkMorphologyGetPlatformProc(gTypes[t]);
+        if (NULL == proc) {
+            continue;
+        }
+        bool isMax = kDilateX_SkMorphologyProcType == gTypes[t] ||
+                     kDilateY_SkMorphologyProcType == gTypes[t];
+        bool isY = kErodeY_SkMorphologyProcType == gTypes[t] ||
+                   kDilateY_SkMorphologyProcType == gTypes[t];
+
+        for (size_t w = 0; w < SK_ARRAY_COUNT(gSizes); ++w) {
+            for (size_t h = 0; h < SK_ARRAY_COUNT(gSizes); ++h) {
+                const int width = gSizes[w];
+                const int height = gSizes[h];
+                const int srcRowPixels = width + 1;
+                const int dstRowPixels = width + 2;
+                SkAutoTMalloc<SkPMColor> src(srcRowPixels * height);
+                for (int i = 0; i < srcRowPixels * height; ++i) {
+                    src[i] = rand.nextU();
+                }
+                SkAutoTMalloc<SkPMColor> expected(dstRowPixels * height);
+                SkAutoTMalloc<SkPMColor> actual(dstRowPixels * height);
+
+                const int length = isY ? height : width;
+                for (int radius = 1; radius < length; ++radius) {
+                    ref_morph(src, srcRowPixels, expected, dstRowPixels,
+                              radius, width, height, isMax, isY);
+                    sk_bzero(actual.get(),
+                             dstRowPixels * height * sizeof(SkPMColor));
+                    int done = proc(src, srcRowPixels, actual, dstRowPixels,
+                                    radius, width, height);
+                    REPORTER_ASSERT(reporter, done >= 0);
+                    REPORTER_ASSERT(reporter, done <= (isY ? width : height));
+                    // only compare the rows or columns the proc says it did
+                    bool equal = true;
+                    for (int y = 0; y < height; ++y) {
+                        for (int x = 0; x < width; ++x) {
+                            if ((isY ? x : y) >= done) {
+                                continue;
+                            }
+                            int index = y * dstRowPixels + x;
+                            equal &= expected[index] == actual[index];
+                        }
+                    }
+                    REPORTER_ASSERT(reporter, equal);
+                }
+            }
+        }
+    }
+}
+
+static void TestMorphology(skiatest::Reporter* reporter) {
+    test_filters(reporter);
+    test_platform_procs(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("Morphology", MorphologyTestClass, TestMorphology)
@@ -8,13 +8,18 @@
 
 
 #include "Test.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
 #include "SkData.h"
 #include "SkFlate.h"
 #include "SkPDFCatalog.h"
+#include "SkPDFDevice.h"
+#include "SkPDFDocument.h"
 #include "SkPDFStream.h"
 #include "SkPDFTypes.h"
 #include "SkScalar.h"
 #include "SkStream.h"
+#include "SkString.h"
 #include "SkTypes.h"
 
 class SkPDFTestDict : public SkPDFDict {
@@ -217,6 +222,114 @@ static void TestSubstitute(skiatest::Reporter* reporter) {
                                             buffer.getOffset()));
 }
 
+static void draw_streamed_page(SkPDFDocument* doc, int pageNumber) {
+    SkISize size = SkISize::Make(612, 792);
+    SkAutoTUnref<SkPDFDevice> device(new SkPDFDevice(size, size,
+                                                     SkMatrix::I()));
+    SkCanvas canvas(device.get());
+
+    SkBitmap bitmap;
+    bitmap.setConfig(SkBitmap::kARGB_8888_Config, 32, 32);
+    bitmap.allocPixels();
+    bitmap.eraseARGB(0x80, 0xFF, pageNumber * 40, 0);
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    paint.setAlpha(0x80);
+    canvas.drawRectCoords(SkIntToScalar(10 * pageNumber), SkIntToScalar(10),
+                          SkIntToScalar(300), SkIntToScalar(400), paint);
+    canvas.drawBitmap(bitmap, SkIntToScalar(100), SkIntToScalar(100));
+    // Each page uses different glyphs of the same font, which is only
+    // written (subset to all of them) at the end.
+    SkString text;
+    text.printf("Page %d", pageNumber);
+    paint.setAlpha(0xFF);
+    canvas.drawText(text.c_str(), text.size(), SkIntToScalar(72),
+                    SkIntToScalar(500), paint);
+    doc->appendPage(device.get());
+}
+
+static int read_dec(const char* text, size_t* offset) {
+    int value = 0;
+    while (text[*offset] >= '0' && text[*offset] <= '9') {
+        value = value * 10 + text[*offset] - '0';
+        (*offset)++;
+    }
+    return value;
+}
+
+static void TestStreamedDocument(skiatest::Reporter* reporter) {
+    static const int kPageCount = 5;
+
+    SkDynamicMemoryWStream stream;
+    {
+        SkPDFDocument doc;
+        REPORTER_ASSERT(reporter, doc.beginStream(&stream, 2));
+        REPORTER_ASSERT(reporter, !doc.finishStream());
+        for (int i = 0; i < kPageCount; i++) {
+            draw_streamed_page(&doc, i);
+            // The earlier pages are already out.
+            REPORTER_ASSERT(reporter, i == 0 || stream.getOffset() > 0);
+        }
+        REPORTER_ASSERT(reporter, !doc.emitPDF(&stream));
+        REPORTER_ASSERT(reporter, doc.finishStream());
+        REPORTER_ASSERT(reporter, !doc.finishStream());
+    }
+
+    // Copied into an SkString for its terminating zero. The compressed
+    // streams may contain zeros too, so search the trailer from the end.
+    SkAutoDataUnref data(stream.copyToData());
+    SkString pdf((const char*)data->data(), data->size());
+    const char* text = pdf.c_str();
+    size_t size = pdf.size();
+    REPORTER_ASSERT(reporter, 0 == strncmp(text, "%PDF-1.4\n", 9));
+    REPORTER_ASSERT(reporter, 0 == strcmp(text + size - 5, "%%EOF"));
+
+    // Every object in the cross reference table has to be where it says.
+    static const char kStartXRef[] = "startxref\n";
+    size_t offset = size - strlen(kStartXRef);
+    while (offset > 0 && 0 != strncmp(text + offset, kStartXRef,
+                                      strlen(kStartXRef))) {
+        offset--;
+    }
+    REPORTER_ASSERT(reporter, offset > 0);
+    if (0 == offset) {
+        return;
+    }
+    offset += strlen(kStartXRef);
+    size_t xrefOffset = read_dec(text, &offset);
+    offset = xrefOffset;
+    REPORTER_ASSERT(reporter, 0 == strncmp(text + offset, "xref\n0 ", 7));
+    offset += 7;
+    int objCount = read_dec(text, &offset);
+    // The catalog, the page tree, a page, content stream, image and graphic
+    // state for each page, and the font.
+    REPORTER_ASSERT(reporter, objCount > 3 + kPageCount * 4);
+    REPORTER_ASSERT(reporter, 0 == strncmp(text + offset,
+                                           "\n0000000000 65535 f \n", 21));
+    offset += 21;
+    for (int objNum = 1; objNum < objCount; objNum++) {
+        // Each entry is a 10 digit offset, and then " 00000 n \n".
+        size_t entryOffset = offset;
+        size_t objOffset = read_dec(text, &offset);
+        REPORTER_ASSERT(reporter, entryOffset + 10 == offset);
+        REPORTER_ASSERT(reporter, 0 == strncmp(text + offset, " 00000 n \n",
+                                               10));
+        offset += 10;
+        // The offset has to be that of the start of a line that starts
+        // "objNum 0 obj".
+        REPORTER_ASSERT(reporter, objOffset > 0 && objOffset < xrefOffset);
+        if (0 == objOffset || objOffset >= xrefOffset) {
+            continue;
+        }
+        REPORTER_ASSERT(reporter, '\n' == text[objOffset - 1]);
+        size_t numberOffset = objOffset;
+        REPORTER_ASSERT(reporter, objNum == read_dec(text, &numberOffset));
+        REPORTER_ASSERT(reporter,
+                        0 == strncmp(text + numberOffset, " 0 obj\n", 7));
+    }
+    REPORTER_ASSERT(reporter, 0 == strncmp(text + offset, "trailer\n", 8));
+}
+
 static void TestPDFPrimitives(skiatest::Reporter* reporter) {
     SkAutoTUnref<SkPDFInt> int42(new SkPDFInt(42));
     SimpleCheckObjectOutput(reporter, int42.get(), "42");
@@ -298,6 +411,8 @@ static void TestPDFPrimitives(skiatest::Reporter* reporter) {
     TestObjectRef(reporter);
 
     TestSubstitute(reporter);
+
+    TestStreamedDocument(reporter);
 }
 
 #include "TestClassDef.h"
@@ -0,0 +1,157 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkColorTable.h"
+#include "SkData.h"
+#include "SkImageDecoder.h"
+#include "SkImageEncoder.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+#include "SkThreadPool.h"
+#include "Test.h"
+
+// copyTo() can't make an Index8 bitmap, so index a fixed palette: 4 levels of
+// red and green, 8 of blue, and 2 of alpha.
+static void make_index8_bitmap(SkBitmap* bm, int w, int h, bool opaque) {
+    SkPMColor colors[256];
+    for (int i = 0; i < 256; i++) {
+        unsigned a = (opaque || !(i & 0x80)) ? 0xFF : 0x80;
+        colors[i] = SkPreMultiplyARGB(a, (i & 3) * 85, ((i >> 2) & 3) * 85,
+                                      ((i >> 4) & 7) * 36);
+    }
+    SkColorTable* ctable = SkNEW_ARGS(SkColorTable, (colors, 256));
+    ctable->setIsOpaque(opaque);
+    bm->setConfig(SkBitmap::kIndex8_Config, w, h);
+    bm->allocPixels(ctable);
+    ctable->unref();
+    bm->setIsOpaque(opaque);
+    SkAutoLockPixels alp(*bm);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            *bm->getAddr8(x, y) = ((x / 16) & 3) | (((y / 8) & 3) << 2) |
+                                  ((((x * 7) ^ (y * 13)) & 0xF) << 4);
+        }
+    }
+}
+
+static void make_bitmap(SkBitmap* bm, SkBitmap::Config config, bool opaque) {
+    const int w = 123;
+    const int h = 97;
+    if (SkBitmap::kIndex8_Config == config) {
+        make_index8_bitmap(bm, w, h, opaque);
+        return;
+    }
+    SkBitmap src;
+    src.setConfig(SkBitmap::kARGB_8888_Config, w, h);
+    src.allocPixels();
+    src.setIsOpaque(opaque);
+    SkAutoLockPixels alp(src);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            // Runs of flat color, like map tiles, along with some noise.
+            unsigned a = opaque ? 0xFF : ((x * y) & 0xFF);
+            unsigned r = (x / 16) * 32 & 0xFF;
+            unsigned g = (y / 8) * 24 & 0xFF;
+            unsigned b = ((x * 7) ^ (y * 13)) & 0xFF;
+            *src.getAddr32(x, y) = SkPreMultiplyARGB(a, r, g, b);
+        }
+    }
+    if (SkBitmap::kARGB_8888_Config == config) {
+        src.swap(*bm);
+    } else {
+        src.copyTo(bm, config);
+        bm->setIsOpaque(opaque);
+    }
+}
+
+static SkData* encode(SkImageEncoder* encoder, const SkBitmap& bm) {
+    SkDynamicMemoryWStream stream;
+    if (encoder->encodeStream(&stream, bm, 100)) {
+        return stream.copyToData();
+    }
+    return NULL;
+}
+
+static bool decode(SkData* data, SkBitmap* bm) {
+    return SkImageDecoder::DecodeMemory(data->data(), data->size(), bm,
+                                        SkBitmap::kARGB_8888_Config,
+                                        SkImageDecoder::kDecodePixels_Mode);
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    for (int y = 0; y < a.height(); y++) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * 4)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_config(skiatest::Reporter* reporter, SkThreadPool* pool,
+                        SkBitmap::Config config, bool opaque) {
+    SkBitmap bm;
+    make_bitmap(&bm, config, opaque);
+
+    // The parallel encoder has to produce an image that decodes to exactly
+    // what the one libpng writes does.
+    SkAutoTDelete<SkImageEncoder> serial(CreatePNGImageEncoder());
+    SkAutoDataUnref expectedData(encode(serial.get(), bm));
+    if (NULL == expectedData.get()) {
+        return;
+    }
+    SkBitmap expected;
+    REPORTER_ASSERT(reporter, decode(expectedData, &expected));
+
+    static const int gStripHeights[] = { 0, 1, 5, 96, 97, 1000 };
+    static const int gLevels[] = { -1, 0, 1, 9 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gStripHeights); i++) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(gLevels); j++) {
+            SkAutoTDelete<SkImageEncoder> encoder(
+                    CreateParallelPNGImageEncoder(pool, gLevels[j],
+                                                  gStripHeights[i]));
+            SkAutoDataUnref data(encode(encoder.get(), bm));
+            REPORTER_ASSERT(reporter, NULL != data.get());
+            if (NULL == data.get()) {
+                continue;
+            }
+            SkBitmap actual;
+            REPORTER_ASSERT(reporter, decode(data, &actual));
+            REPORTER_ASSERT(reporter, equal_pixels(expected, actual));
+        }
+    }
+}
+
+static void TestPNGEncode(skiatest::Reporter* reporter) {
+    static const struct {
+        SkBitmap::Config    fConfig;
+        bool                fOpaque;
+    } gRec[] = {
+        { SkBitmap::kARGB_8888_Config,  true },
+        { SkBitmap::kARGB_8888_Config,  false },
+        { SkBitmap::kRGB_565_Config,    true },
+        { SkBitmap::kARGB_4444_Config,  false },
+        { SkBitmap::kIndex8_Config,     true },
+        { SkBitmap::kIndex8_Config,     false },
+    };
+
+    SkThreadPool pool(3);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gRec); i++) {
+        test_config(reporter, NULL, gRec[i].fConfig, gRec[i].fOpaque);
+        test_config(reporter, &pool, gRec[i].fConfig, gRec[i].fOpaque);
+    }
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("PNGEncode", PNGEncodeTestClass, TestPNGEncode)
@@ -0,0 +1,312 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Test.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRandom.h"
+#include "SkTemplates.h"
+
+static const int kSize = 32;
+
+static const SkPathOp gOps[] = {
+    kDifference_PathOp,
+    kIntersect_PathOp,
+    kUnion_PathOp,
+    kXOR_PathOp
+};
+
+static const SkPath::FillType gFillTypes[] = {
+    SkPath::kWinding_FillType,
+    SkPath::kEvenOdd_FillType,
+    SkPath::kInverseWinding_FillType,
+    SkPath::kInverseEvenOdd_FillType
+};
+
+static bool apply_op(bool one, bool two, SkPathOp op) {
+    switch (op) {
+        case kDifference_PathOp:
+            return one && !two;
+        case kIntersect_PathOp:
+            return one && two;
+        case kUnion_PathOp:
+            return one || two;
+        case kXOR_PathOp:
+            return one != two;
+    }
+    SkASSERT(0);
+    return false;
+}
+
+static const SkScalar kNear = SK_Scalar1 / 64;
+
+// Returns false if path's edges pass within about kNear of (x, y), and
+// otherwise sets inside to whether path contains (x, y).
+static bool sample(const SkPath& path, SkScalar x, SkScalar y, bool* inside) {
+    *inside = path.contains(x, y);
+    return *inside == path.contains(x - kNear, y) &&
+           *inside == path.contains(x + kNear, y) &&
+           *inside == path.contains(x, y - kNear) &&
+           *inside == path.contains(x, y + kNear);
+}
+
+// Compare the result against the inputs, combined one pixel at a time at the
+// center of each pixel. The scan converter is not used as the reference,
+// since it can move the edges of self-intersecting paths by a fraction of a
+// pixel. The result's vertices are intersections rounded to floats, so a
+// pixel whose center is on (or very near) an edge of the inputs is skipped.
+static int count_mismatches(const SkPath& one, const SkPath& two, SkPathOp op,
+                            const SkPath& result, int size = kSize) {
+    int mismatches = 0;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            SkScalar cx = SkIntToScalar(x) + SK_ScalarHalf;
+            SkScalar cy = SkIntToScalar(y) + SK_ScalarHalf;
+            bool inOne, inTwo;
+            if (!sample(one, cx, cy, &inOne) || !sample(two, cx, cy, &inTwo)) {
+                continue;
+            }
+            if (apply_op(inOne, inTwo, op) != result.contains(cx, cy)) {
+                ++mismatches;
+            }
+        }
+    }
+    return mismatches;
+}
+
+// The edge walker may give up on some coincident edges or shared end points,
+// so the random paths keep their points in general position: none are on a
+// grid. The paths may intersect themselves. test_grid_rects covers the rest.
+static void make_random_path(SkRandom& rand, SkPath* path) {
+    const SkScalar lo = SkIntToScalar(4);
+    const SkScalar hi = SkIntToScalar(kSize - 4);
+    path->reset();
+    int contours = rand.nextRangeU(1, 3);
+    for (int c = 0; c < contours; ++c) {
+        int points = rand.nextRangeU(3, 8);
+        path->moveTo(rand.nextRangeScalar(lo, hi),
+                     rand.nextRangeScalar(lo, hi));
+        for (int i = 1; i < points; ++i) {
+            path->lineTo(rand.nextRangeScalar(lo, hi),
+                         rand.nextRangeScalar(lo, hi));
+        }
+        path->close();
+    }
+    int fill = rand.nextULessThan(SK_ARRAY_COUNT(gFillTypes));
+    path->setFillType(gFillTypes[fill]);
+}
+
+static void test_random_ops(skiatest::Reporter* reporter) {
+    static const int kTrials = 200;
+    SkRandom rand;
+    for (int i = 0; i < kTrials; ++i) {
+        SkPath one, two, result;
+        make_random_path(rand, &one);
+        make_random_path(rand, &two);
+        for (size_t op = 0; op < SK_ARRAY_COUNT(gOps); ++op) {
+            REPORTER_ASSERT(reporter, Op(one, two, gOps[op], &result));
+            int mismatches = count_mismatches(one, two, gOps[op], result);
+            REPORTER_ASSERT(reporter, 0 == mismatches);
+        }
+        // simplifying a path is the same as a union with an empty path
+        SkPath empty;
+        REPORTER_ASSERT(reporter, Simplify(one, &result));
+        int mismatches = count_mismatches(one, empty, kUnion_PathOp, result);
+        REPORTER_ASSERT(reporter, 0 == mismatches);
+    }
+}
+
+// Random rectangles on a coarse grid, so that edges and corners are shared
+// within and between the operands.
+static void test_grid_rects(skiatest::Reporter* reporter) {
+    static const int kTrials = 200;
+    SkRandom rand;
+    for (int i = 0; i < kTrials; ++i) {
+        SkPath paths[2];
+        for (int p = 0; p < 2; ++p) {
+            int rects = rand.nextRangeU(1, 3);
+            for (int r = 0; r < rects; ++r) {
+                int left = rand.nextRangeU(1, 5) * 4;
+                int top = rand.nextRangeU(1, 5) * 4;
+                int right = left + rand.nextRangeU(1, 3) * 4;
+                int bottom = top + rand.nextRangeU(1, 3) * 4;
+                paths[p].addRect(SkIntToScalar(left), SkIntToScalar(top),
+                                 SkIntToScalar(right), SkIntToScalar(bottom),
+                                 rand.nextBool() ? SkPath::kCW_Direction
+                                                 : SkPath::kCCW_Direction);
+            }
+            int fill = rand.nextULessThan(SK_ARRAY_COUNT(gFillTypes));
+            paths[p].setFillType(gFillTypes[fill]);
+        }
+        for (size_t op = 0; op < SK_ARRAY_COUNT(gOps); ++op) {
+            SkPath result;
+            REPORTER_ASSERT(reporter, Op(paths[0], paths[1], gOps[op], &result));
+            int mismatches = count_mismatches(paths[0], paths[1], gOps[op],
+                                              result);
+            REPORTER_ASSERT(reporter, 0 == mismatches);
+        }
+    }
+}
+
+static void test_adjacent_rects(skiatest::Reporter* reporter) {
+    static const SkIRect gSecond[] = {
+        { 10,  0, 20, 10 },     // shares the whole right edge
+        {  0, 10, 10, 20 },     // shares the whole bottom edge
+        { 10,  4, 20, 14 },     // shares part of the right edge
+        {  4, 10, 20, 20 },     // shares part of the bottom edge
+        { 10, 10, 20, 20 },     // shares only a corner
+    };
+    SkPath one;
+    one.addRect(0, 0, SkIntToScalar(10), SkIntToScalar(10));
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gSecond); ++i) {
+        SkPath two;
+        SkRect second;
+        second.set(gSecond[i]);
+        two.addRect(second);
+        for (size_t op = 0; op < SK_ARRAY_COUNT(gOps); ++op) {
+            SkPath result;
+            REPORTER_ASSERT(reporter, Op(one, two, gOps[op], &result));
+            int mismatches = count_mismatches(one, two, gOps[op], result);
+            REPORTER_ASSERT(reporter, 0 == mismatches);
+        }
+    }
+
+    SkPath two, result;
+    two.addRect(SkIntToScalar(10), 0, SkIntToScalar(20), SkIntToScalar(10));
+    REPORTER_ASSERT(reporter, Op(one, two, kUnion_PathOp, &result));
+    SkRect bounds;
+    bounds.iset(0, 0, 20, 10);
+    REPORTER_ASSERT(reporter, bounds == result.getBounds());
+    REPORTER_ASSERT(reporter, Op(one, two, kIntersect_PathOp, &result));
+    REPORTER_ASSERT(reporter, result.isEmpty());
+}
+
+// A checkerboard of quads whose inner corners are moved by up to jitter.
+// Neighboring quads share edges, and each shared edge is in both paths.
+static void make_parcels(SkRandom& rand, int count, SkScalar jitter,
+                         SkPath* even, SkPath* odd) {
+    const int stride = count + 1;
+    SkAutoTMalloc<SkPoint> corners(stride * stride);
+    for (int y = 0; y <= count; ++y) {
+        for (int x = 0; x <= count; ++x) {
+            SkScalar dx = 0, dy = 0;
+            if (x > 0 && x < count) {
+                dx = rand.nextRangeScalar(-jitter, jitter);
+            }
+            if (y > 0 && y < count) {
+                dy = rand.nextRangeScalar(-jitter, jitter);
+            }
+            corners[y * stride + x].set(SkIntToScalar(x * 10) + dx,
+                                        SkIntToScalar(y * 10) + dy);
+        }
+    }
+    for (int y = 0; y < count; ++y) {
+        for (int x = 0; x < count; ++x) {
+            SkPath* path = (x + y) & 1 ? odd : even;
+            const SkPoint* corner = &corners[y * stride + x];
+            path->moveTo(corner[0]);
+            path->lineTo(corner[1]);
+            path->lineTo(corner[stride + 1]);
+            path->lineTo(corner[stride]);
+            path->close();
+        }
+    }
+}
+
+static void test_parcels(skiatest::Reporter* reporter) {
+    static const SkScalar gJitters[] = { 0, SkIntToScalar(2) };
+    SkRandom rand;
+    for (size_t j = 0; j < SK_ARRAY_COUNT(gJitters); ++j) {
+        for (int count = 2; count <= 3; ++count) {
+            SkPath even, odd;
+            make_parcels(rand, count, gJitters[j], &even, &odd);
+            for (size_t op = 0; op < SK_ARRAY_COUNT(gOps); ++op) {
+                SkPath result;
+                REPORTER_ASSERT(reporter, Op(even, odd, gOps[op], &result));
+                int mismatches = count_mismatches(even, odd, gOps[op], result);
+                REPORTER_ASSERT(reporter, 0 == mismatches);
+            }
+        }
+        SkPath even, odd, result;
+        make_parcels(rand, 8, gJitters[j], &even, &odd);
+        REPORTER_ASSERT(reporter, Op(even, odd, kUnion_PathOp, &result));
+        int mismatches = count_mismatches(even, odd, kUnion_PathOp, result, 80);
+        REPORTER_ASSERT(reporter, 0 == mismatches);
+        // the grid measured by ParcelsUnionBench; its corners do not move, so
+        // the union is the square that they bound
+        static const int kCount = 16;
+        even.reset();
+        odd.reset();
+        make_parcels(rand, kCount, gJitters[j], &even, &odd);
+        REPORTER_ASSERT(reporter, Op(even, odd, kUnion_PathOp, &result));
+        SkPath square, empty;
+        square.addRect(0, 0, SkIntToScalar(kCount * 10),
+                       SkIntToScalar(kCount * 10));
+        mismatches = count_mismatches(square, empty, kUnion_PathOp, result,
+                                      kCount * 10);
+        REPORTER_ASSERT(reporter, 0 == mismatches);
+    }
+}
+
+static void test_overlapping_squares(skiatest::Reporter* reporter) {
+    SkPath one, two, result;
+    one.addRect(SkIntToScalar(4), SkIntToScalar(4),
+                SkIntToScalar(20), SkIntToScalar(20));
+    two.addRect(SkIntToScalar(12), SkIntToScalar(12),
+                SkIntToScalar(28), SkIntToScalar(28));
+
+    SkRect bounds;
+
+    REPORTER_ASSERT(reporter, Op(one, two, kIntersect_PathOp, &result));
+    bounds.iset(12, 12, 20, 20);
+    REPORTER_ASSERT(reporter, bounds == result.getBounds());
+    REPORTER_ASSERT(reporter,
+                    SkPath::kEvenOdd_FillType == result.getFillType());
+
+    REPORTER_ASSERT(reporter, Op(one, two, kUnion_PathOp, &result));
+    bounds.iset(4, 4, 28, 28);
+    REPORTER_ASSERT(reporter, bounds == result.getBounds());
+
+    // the result may be one of the operands
+    SkPath copy(one);
+    REPORTER_ASSERT(reporter, Op(copy, two, kDifference_PathOp, &copy));
+    REPORTER_ASSERT(reporter, 0 == count_mismatches(one, two,
+                                                    kDifference_PathOp, copy));
+
+    // the part of two outside of one is inverted, and so covers the rest
+    one.setFillType(SkPath::kInverseWinding_FillType);
+    REPORTER_ASSERT(reporter, Op(one, two, kUnion_PathOp, &result));
+    REPORTER_ASSERT(reporter, result.isInverseFillType());
+    REPORTER_ASSERT(reporter, 0 == count_mismatches(one, two, kUnion_PathOp,
+                                                    result));
+}
+
+static void test_non_finite(skiatest::Reporter* reporter) {
+    SkPath one, bad, result;
+    one.addRect(0, 0, SkIntToScalar(10), SkIntToScalar(10));
+    bad.moveTo(0, 0);
+    bad.lineTo(SK_ScalarNaN, 0);
+    bad.lineTo(0, SkIntToScalar(10));
+    result.addCircle(0, 0, SK_Scalar1);
+    const SkPath before(result);
+
+    REPORTER_ASSERT(reporter, !Op(one, bad, kUnion_PathOp, &result));
+    REPORTER_ASSERT(reporter, !Op(bad, one, kUnion_PathOp, &result));
+    REPORTER_ASSERT(reporter, !Simplify(bad, &result));
+    REPORTER_ASSERT(reporter, before == result);
+}
+
+static void TestPathOps(skiatest::Reporter* reporter) {
+    test_random_ops(reporter);
+    test_grid_rects(reporter);
+    test_adjacent_rects(reporter);
+    test_parcels(reporter);
+    test_overlapping_squares(reporter);
+    test_non_finite(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("PathOps", PathOpsTestClass, TestPathOps)
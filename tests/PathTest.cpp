@@ -2254,6 +2254,36 @@ static void test_oval(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, path.isOval(NULL));
 }
 
+static void test_contains(skiatest::Reporter* reporter) {
+    SkPath p;
+    p.addRect(0, 0, SkIntToScalar(10), SkIntToScalar(10));
+    p.addRect(SkIntToScalar(2), SkIntToScalar(2),
+              SkIntToScalar(8), SkIntToScalar(8));
+    const SkScalar inside = SkIntToScalar(1);
+    const SkScalar hole = SkIntToScalar(5);
+    const SkScalar outside = SkIntToScalar(20);
+
+    REPORTER_ASSERT(reporter, p.contains(inside, inside));
+    REPORTER_ASSERT(reporter, p.contains(hole, hole));
+    REPORTER_ASSERT(reporter, !p.contains(outside, outside));
+
+    p.setFillType(SkPath::kEvenOdd_FillType);
+    REPORTER_ASSERT(reporter, p.contains(inside, inside));
+    REPORTER_ASSERT(reporter, !p.contains(hole, hole));
+
+    // the inverse fill types contain what the others do not, including
+    // points within the path's bounds
+    p.setFillType(SkPath::kInverseEvenOdd_FillType);
+    REPORTER_ASSERT(reporter, !p.contains(inside, inside));
+    REPORTER_ASSERT(reporter, p.contains(hole, hole));
+    REPORTER_ASSERT(reporter, p.contains(outside, outside));
+
+    p.setFillType(SkPath::kInverseWinding_FillType);
+    REPORTER_ASSERT(reporter, !p.contains(inside, inside));
+    REPORTER_ASSERT(reporter, !p.contains(hole, hole));
+    REPORTER_ASSERT(reporter, p.contains(outside, outside));
+}
+
 static void TestPath(skiatest::Reporter* reporter) {
     SkTSize<SkScalar>::Make(3,4);
 
@@ -2338,6 +2368,7 @@ static void TestPath(skiatest::Reporter* reporter) {
     test_convexity(reporter);
     test_convexity2(reporter);
     test_conservativelyContains(reporter);
+    test_contains(reporter);
     test_close(reporter);
     test_segment_masks(reporter);
     test_flattening(reporter);
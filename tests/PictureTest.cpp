@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 #include "Test.h"
+#include "TestUtils.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkData.h"
@@ -390,6 +391,252 @@ static void test_bitmap_with_encoded_data(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, picture1->equals(picture2));
 }
 
+#include "SkParallelRaster.h"
+
+// Only rects, since clipping curved edges to a tile can move them slightly.
+static void draw_random_rects(SkCanvas* canvas, SkRandom& rand, int W, int H) {
+    SkPaint paint;
+    for (int i = 0; i < 200; ++i) {
+        SkRect r;
+        rand_rect(&r, rand, SkIntToScalar(W), SkIntToScalar(H));
+        paint.setColor(rand.nextU() | 0xFF000000);
+        paint.setAntiAlias(rand.nextBool());
+        paint.setAlpha(rand.nextBool() ? 0xFF : 0x80);
+        canvas->drawRect(r, paint);
+    }
+}
+
+static void test_parallel_raster(skiatest::Reporter* reporter) {
+    static const int W = 300;
+    static const int H = 200;
+    static const uint32_t gFlags[] = {
+        0,
+        SkPicture::kOptimizeForClippedPlayback_RecordingFlag
+    };
+
+    for (size_t f = 0; f < SK_ARRAY_COUNT(gFlags); ++f) {
+        SkRandom rand;
+        SkPicture picture;
+        draw_random_rects(picture.beginRecording(W, H, gFlags[f]), rand, W, H);
+        picture.endRecording();
+
+        SkBitmap expected;
+        expected.setConfig(SkBitmap::kARGB_8888_Config, W, H);
+        expected.allocPixels();
+        expected.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(expected);
+        canvas.drawPicture(picture);
+
+        // odd tile sizes, so that tiles don't line up with the edges
+        for (int threads = 1; threads <= 4; threads += 3) {
+            SkBitmap actual;
+            actual.setConfig(SkBitmap::kARGB_8888_Config, W, H);
+            actual.allocPixels();
+            actual.eraseColor(SK_ColorTRANSPARENT);
+            REPORTER_ASSERT(reporter,
+                SkParallelRaster::DrawPicture(&picture, &actual, threads, 37, 23));
+
+            SkAutoLockPixels alpe(expected);
+            SkAutoLockPixels alpa(actual);
+            bool same = true;
+            for (int y = 0; y < H && same; ++y) {
+                same = 0 == memcmp(expected.getAddr32(0, y),
+                                   actual.getAddr32(0, y), W * sizeof(SkPMColor));
+            }
+            REPORTER_ASSERT(reporter, same);
+        }
+    }
+
+    SkPicture picture;
+    picture.beginRecording(10, 10);
+    picture.endRecording();
+    SkBitmap noPixels;
+    noPixels.setConfig(SkBitmap::kARGB_8888_Config, 10, 10);
+    REPORTER_ASSERT(reporter,
+                    !SkParallelRaster::DrawPicture(&picture, &noPixels, 2));
+}
+
+static void draw_to_bitmap(SkPicture* picture, SkBitmap* bm) {
+    make_bm(bm, picture->width(), picture->height(), SK_ColorTRANSPARENT, false);
+    SkCanvas canvas(*bm);
+    canvas.drawPicture(*picture);
+}
+
+static void test_load_in_place(skiatest::Reporter* reporter) {
+    static const int W = 100;
+    static const int H = 100;
+
+    SkBitmap bm;
+    make_bm(&bm, 20, 20, SK_ColorGREEN, true);
+
+    SkPicture child;
+    SkPaint childPaint;
+    childPaint.setColor(SK_ColorMAGENTA);
+    child.beginRecording(10, 10)->drawCircle(5, 5, 5, childPaint);
+    child.endRecording();
+
+    SkPicture picture;
+    SkCanvas* canvas = picture.beginRecording(W, H);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorRED);
+    SkPath path;
+    path.moveTo(10, 10);
+    path.quadTo(90, 10, 50, 90);
+    path.close();
+    canvas->drawPath(path, paint);
+    paint.setColor(SK_ColorBLUE);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    canvas->drawPath(path, paint);
+    canvas->drawBitmap(bm, 60, 60);
+    canvas->translate(5, 70);
+    canvas->drawPicture(child);
+    picture.endRecording();
+
+    SkDynamicMemoryWStream wStream;
+    picture.serialize(&wStream);
+    SkAutoDataUnref data(wStream.copyToData());
+
+    SkMemoryStream stream(data);
+    SkPicture copied(&stream);
+    bool success = false;
+    SkPicture inPlace(data, &success);
+    REPORTER_ASSERT(reporter, success);
+    REPORTER_ASSERT(reporter, inPlace.width() == W && inPlace.height() == H);
+
+    SkBitmap expected, actual;
+    draw_to_bitmap(&copied, &expected);
+    draw_to_bitmap(&inPlace, &actual);
+    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+
+    // clones read their own paints and paths, but share the bitmaps
+    SkAutoTUnref<SkPicture> clone(inPlace.clone());
+    draw_to_bitmap(clone, &actual);
+    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+
+    // it serializes back to what it was loaded from
+    SkDynamicMemoryWStream reStream;
+    inPlace.serialize(&reStream);
+    SkAutoDataUnref reData(reStream.copyToData());
+    REPORTER_ASSERT(reporter, data->equals(reData));
+
+    // truncated data fails to load
+    SkAutoDataUnref truncated(SkData::NewSubset(data, 0, data->size() - 8));
+    SkPicture bad(truncated, &success);
+    REPORTER_ASSERT(reporter, !success);
+}
+
+static void draw_rect(SkCanvas* canvas, SkScalar l, SkScalar t, SkScalar r,
+                      SkScalar b, SkColor color) {
+    SkPaint paint;
+    paint.setColor(color);
+    canvas->drawRect(SkRect::MakeLTRB(l, t, r, b), paint);
+}
+
+static SkColor color_at(SkPicture* picture, int x, int y) {
+    SkBitmap bm;
+    draw_to_bitmap(picture, &bm);
+    return bm.getColor(x, y);
+}
+
+static void test_segments(skiatest::Reporter* reporter) {
+    static const uint32_t gFlags[] = {
+        0,
+        SkPicture::kOptimizeForClippedPlayback_RecordingFlag
+    };
+
+    for (size_t f = 0; f < SK_ARRAY_COUNT(gFlags); ++f) {
+        SkPicture picture;
+        SkCanvas* canvas = picture.beginRecording(100, 100, gFlags[f]);
+        draw_rect(canvas, 0, 0, 100, 100, SK_ColorWHITE);
+        canvas->translate(10, 20);
+        SkCanvas* segment = picture.beginRecordingSegment(7);
+        REPORTER_ASSERT(reporter, NULL != segment);
+        draw_rect(segment, 0, 0, 10, 10, SK_ColorRED);
+        picture.endRecordingSegment();
+        // drawn after the segment, so it stays on top of it
+        draw_rect(canvas, 50, 50, 60, 60, SK_ColorBLUE);
+        picture.endRecording();
+
+        REPORTER_ASSERT(reporter, !picture.getDirtyBounds(NULL));
+        REPORTER_ASSERT(reporter, NULL == picture.beginRecordingSegment(8));
+        REPORTER_ASSERT(reporter, SK_ColorRED == color_at(&picture, 15, 25));
+
+        SkPicture copy(picture);
+
+        // move the red rect so that it is partly under the blue one
+        segment = picture.beginRecordingSegment(7);
+        REPORTER_ASSERT(reporter, NULL != segment);
+        draw_rect(segment, 45, 45, 55, 55, SK_ColorRED);
+        picture.endRecordingSegment();
+
+        REPORTER_ASSERT(reporter, SK_ColorWHITE == color_at(&picture, 15, 25));
+        REPORTER_ASSERT(reporter, SK_ColorRED == color_at(&picture, 57, 67));
+        REPORTER_ASSERT(reporter, SK_ColorBLUE == color_at(&picture, 62, 72));
+        REPORTER_ASSERT(reporter, SK_ColorRED == color_at(&copy, 15, 25));
+        REPORTER_ASSERT(reporter, SK_ColorWHITE == color_at(&copy, 57, 67));
+
+        // the old and new red rects, and not much else
+        SkRect dirty;
+        REPORTER_ASSERT(reporter, picture.getDirtyBounds(&dirty));
+        REPORTER_ASSERT(reporter, dirty.contains(SkRect::MakeLTRB(10, 20, 65, 75)));
+        REPORTER_ASSERT(reporter, SkRect::MakeLTRB(9, 19, 66, 76).contains(dirty));
+        picture.clearDirtyBounds();
+        REPORTER_ASSERT(reporter, !picture.getDirtyBounds(NULL));
+    }
+
+    // Segments can be re-recorded before the picture is done, and are
+    // limited to the clip they were inserted with.
+    SkPicture picture;
+    SkCanvas* canvas = picture.beginRecording(100, 100);
+    canvas->clipRect(SkRect::MakeWH(50, 50));
+    draw_rect(picture.beginRecordingSegment(1), 0, 0, 20, 20, SK_ColorRED);
+    picture.endRecordingSegment();
+    draw_rect(picture.beginRecordingSegment(1), 40, 40, 80, 80, SK_ColorGREEN);
+    picture.endRecordingSegment();
+    picture.endRecording();
+
+    REPORTER_ASSERT(reporter, SK_ColorTRANSPARENT == color_at(&picture, 10, 10));
+    REPORTER_ASSERT(reporter, SK_ColorGREEN == color_at(&picture, 45, 45));
+    REPORTER_ASSERT(reporter, SK_ColorTRANSPARENT == color_at(&picture, 55, 55));
+    SkRect dirty;
+    REPORTER_ASSERT(reporter, picture.getDirtyBounds(&dirty));
+    REPORTER_ASSERT(reporter, dirty == SkRect::MakeWH(50, 50));
+
+    // A segment draws in the coordinates it was inserted with, which need not
+    // map its width and height onto where it draws. Playback culled by an
+    // R-tree must still find it anywhere in its clip.
+    for (size_t f = 0; f < SK_ARRAY_COUNT(gFlags); ++f) {
+        SkPicture picture;
+        SkCanvas* canvas = picture.beginRecording(100, 100, gFlags[f]);
+        canvas->scale(SK_ScalarHalf, SK_ScalarHalf);
+        draw_rect(picture.beginRecordingSegment(1), 150, 150, 190, 190,
+                  SK_ColorRED);
+        picture.endRecordingSegment();
+        picture.endRecording();
+
+        SkBitmap bm;
+        bm.setConfig(SkBitmap::kARGB_8888_Config, 100, 100);
+        bm.allocPixels();
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas clipped(bm);
+        clipped.clipRect(SkRect::MakeLTRB(60, 60, 100, 100));
+        picture.draw(&clipped);
+        REPORTER_ASSERT(reporter, SK_ColorRED == bm.getColor(80, 80));
+
+        // and wherever it is re-recorded to draw
+        draw_rect(picture.beginRecordingSegment(1), 10, 10, 30, 30,
+                  SK_ColorGREEN);
+        picture.endRecordingSegment();
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas clipped2(bm);
+        clipped2.clipRect(SkRect::MakeLTRB(0, 0, 20, 20));
+        picture.draw(&clipped2);
+        REPORTER_ASSERT(reporter, SK_ColorGREEN == bm.getColor(10, 10));
+    }
+}
+
 static void TestPicture(skiatest::Reporter* reporter) {
 #ifdef SK_DEBUG
     test_deleting_empty_playback();
@@ -400,6 +647,9 @@ static void TestPicture(skiatest::Reporter* reporter) {
     test_peephole(reporter);
     test_gatherpixelrefs(reporter);
     test_bitmap_with_encoded_data(reporter);
+    test_parallel_raster(reporter);
+    test_load_in_place(reporter);
+    test_segments(reporter);
 }
 
 #include "TestClassDef.h"
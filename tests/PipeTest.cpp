@@ -11,7 +11,9 @@
 #include "SkCanvas.h"
 #include "SkGPipe.h"
 #include "SkPaint.h"
+#include "SkRandom.h"
 #include "SkShader.h"
+#include "SkThreadedPipeController.h"
 #include "Test.h"
 
 // Ensures that the pipe gracefully handles drawing an invalid bitmap.
@@ -43,7 +45,58 @@ static void testDrawingAfterEndRecording(SkCanvas* canvas) {
     pipeCanvas->drawBitmap(bm, 0, 0);
 }
 
-static void test_pipeTests(skiatest::Reporter*) {
+static void drawManyRects(SkCanvas* canvas, const SkBitmap& bm) {
+    SkRandom rand;
+    SkPaint paint;
+    for (int i = 0; i < 2000; ++i) {
+        SkRect r;
+        r.setXYWH(SkIntToScalar(rand.nextU() % 64), SkIntToScalar(rand.nextU() % 64),
+                  SkIntToScalar(rand.nextU() % 32), SkIntToScalar(rand.nextU() % 32));
+        paint.setColor(rand.nextU() | 0xFF000000);
+        canvas->drawRect(r, paint);
+        if (0 == i % 100) {
+            canvas->drawBitmap(bm, r.fLeft, r.fTop);
+        }
+    }
+}
+
+// Ensures that the threaded pipe draws the same thing as drawing directly, with a ring small
+// enough that the writer has to wait for the readers.
+static void testThreadedPipe(skiatest::Reporter* reporter) {
+    SkBitmap bm;
+    bm.setConfig(SkBitmap::kARGB_8888_Config, 8, 8);
+    bm.allocPixels();
+    bm.eraseColor(SK_ColorBLUE);
+
+    SkBitmap expected;
+    expected.setConfig(SkBitmap::kARGB_8888_Config, 64, 64);
+    expected.allocPixels();
+    expected.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(expected);
+    drawManyRects(&canvas, bm);
+
+    SkBitmap actual;
+    actual.setConfig(SkBitmap::kARGB_8888_Config, 64, 64);
+    actual.allocPixels();
+    actual.eraseColor(SK_ColorWHITE);
+    {
+        SkThreadedPipeController controller(actual, 3, 2);
+        REPORTER_ASSERT(reporter, 3 == controller.numberOfReaders());
+        SkGPipeWriter writer;
+        SkCanvas* pipeCanvas = writer.startRecording(&controller,
+                                                     SkThreadedPipeController::kWriterFlags);
+        drawManyRects(pipeCanvas, bm);
+        writer.endRecording();
+        controller.join();
+    }
+
+    SkAutoLockPixels alpExpected(expected);
+    SkAutoLockPixels alpActual(actual);
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.getSize()));
+}
+
+static void test_pipeTests(skiatest::Reporter* reporter) {
     SkBitmap bitmap;
     bitmap.setConfig(SkBitmap::kARGB_8888_Config, 64, 64);
     SkCanvas canvas(bitmap);
@@ -55,6 +108,7 @@ static void test_pipeTests(skiatest::Reporter*) {
     writer.endRecording();
 
     testDrawingAfterEndRecording(&canvas);
+    testThreadedPipe(reporter);
 }
 
 #include "TestClassDef.h"
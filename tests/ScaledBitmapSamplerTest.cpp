@@ -0,0 +1,150 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkImageDecoder.h"
+#include "SkImageEncoder.h"
+#include "SkRandom.h"
+#include "SkScaledBitmapSampler.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// Sample random rows of src pixels into dst, and compare each pixel to what
+// the portable pack would give, so that the platform row procs (which only
+// kick in for some widths and samplings) agree with it.
+static void test_rows(skiatest::Reporter* reporter, SkBitmap::Config config,
+                      SkScaledBitmapSampler::SrcConfig sc, int srcBytes,
+                      int width, int sampleSize) {
+    const int height = 3;
+    SkScaledBitmapSampler sampler(width, height, sampleSize);
+
+    SkBitmap dst;
+    dst.setConfig(config, sampler.scaledWidth(), sampler.scaledHeight());
+    dst.allocPixels();
+    SkAutoLockPixels alp(dst);
+    REPORTER_ASSERT(reporter, sampler.begin(&dst, sc, false));
+
+    SkRandom rand(width);
+    SkAutoTMalloc<uint8_t> storage(width * height * srcBytes);
+    uint8_t* src = storage.get();
+    for (int i = 0; i < width * height * srcBytes; i++) {
+        src[i] = rand.nextU() >> 24;
+    }
+
+    for (int y = 0; y < sampler.scaledHeight(); y++) {
+        int srcY = sampler.srcY0() + y * sampler.srcDY();
+        sampler.next(src + srcY * width * srcBytes);
+    }
+
+    const int dx = SkMin32(sampleSize, width);
+    int mismatches = 0;
+    for (int y = 0; y < dst.height(); y++) {
+        int srcY = sampler.srcY0() + y * sampler.srcDY();
+        for (int x = 0; x < dst.width(); x++) {
+            int srcX = (sampleSize > 1 ? dx >> 1 : 0) + x * dx;
+            const uint8_t* p = src + (srcY * width + srcX) * srcBytes;
+            if (SkBitmap::kARGB_8888_Config == config) {
+                if (*dst.getAddr32(x, y) != SkPackARGB32(0xFF, p[0], p[1], p[2])) {
+                    mismatches++;
+                }
+            } else {
+                if (*dst.getAddr16(x, y) != SkPack888ToRGB16(p[0], p[1], p[2])) {
+                    mismatches++;
+                }
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, 0 == mismatches);
+}
+
+static void test_sample_rows(skiatest::Reporter* reporter) {
+    static const int gWidths[] = { 1, 5, 15, 16, 17, 31, 32, 33, 67, 100 };
+    static const int gSampleSizes[] = { 1, 2, 3 };
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gWidths); i++) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(gSampleSizes); j++) {
+            int w = gWidths[i];
+            int s = gSampleSizes[j];
+            test_rows(reporter, SkBitmap::kARGB_8888_Config,
+                      SkScaledBitmapSampler::kRGB, 3, w, s);
+            test_rows(reporter, SkBitmap::kARGB_8888_Config,
+                      SkScaledBitmapSampler::kRGBX, 4, w, s);
+            test_rows(reporter, SkBitmap::kRGB_565_Config,
+                      SkScaledBitmapSampler::kRGB, 3, w, s);
+            test_rows(reporter, SkBitmap::kRGB_565_Config,
+                      SkScaledBitmapSampler::kRGBX, 4, w, s);
+        }
+    }
+}
+
+// The jpeg decoder has libjpeg do the power of two part of the sampling, and
+// samples the rest itself, so every sample size should come back (close to)
+// the size asked for.
+static void test_jpeg_sample_size(skiatest::Reporter* reporter) {
+    const int w = 100;
+    const int h = 75;
+    SkBitmap bm;
+    bm.setConfig(SkBitmap::kARGB_8888_Config, w, h);
+    bm.allocPixels();
+    bm.setIsOpaque(true);
+    bm.eraseColor(SK_ColorBLUE);
+
+    SkDynamicMemoryWStream stream;
+    if (!SkImageEncoder::EncodeStream(&stream, bm, SkImageEncoder::kJPEG_Type,
+                                      90)) {
+        return;
+    }
+    SkAutoDataUnref data(stream.copyToData());
+
+    for (int sampleSize = 1; sampleSize <= 12; sampleSize++) {
+        SkMemoryStream memStream(data);
+        SkAutoTDelete<SkImageDecoder> decoder(
+                SkImageDecoder::Factory(&memStream));
+        if (NULL == decoder.get()) {
+            return;
+        }
+        REPORTER_ASSERT(reporter, memStream.rewind());
+        decoder->setSampleSize(sampleSize);
+
+        SkBitmap decoded;
+        bool success = decoder->decode(&memStream, &decoded,
+                                       SkBitmap::kARGB_8888_Config,
+                                       SkImageDecoder::kDecodePixels_Mode);
+        REPORTER_ASSERT(reporter, success);
+        if (!success) {
+            continue;
+        }
+
+        // libjpeg rounds its scaled size up.
+        REPORTER_ASSERT(reporter, decoded.width() >= w / sampleSize);
+        REPORTER_ASSERT(reporter,
+                        decoded.width() <= (w + sampleSize - 1) / sampleSize);
+        REPORTER_ASSERT(reporter, decoded.height() >= h / sampleSize);
+        REPORTER_ASSERT(reporter,
+                        decoded.height() <= (h + sampleSize - 1) / sampleSize);
+
+        SkAutoLockPixels alp(decoded);
+        SkPMColor c = *decoded.getAddr32(decoded.width() / 2,
+                                         decoded.height() / 2);
+        REPORTER_ASSERT(reporter, SkGetPackedB32(c) > 0xF0 &&
+                                  SkGetPackedR32(c) < 0x10 &&
+                                  SkGetPackedG32(c) < 0x10);
+    }
+}
+
+static void TestScaledBitmapSampler(skiatest::Reporter* reporter) {
+    test_sample_rows(reporter);
+    test_jpeg_sample_size(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("ScaledBitmapSampler", ScaledBitmapSamplerTestClass,
+                 TestScaledBitmapSampler)
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkDashPathEffect.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "Test.h"
+#include "TestUtils.h"
+
+static void make_bitmap(SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, 64, 64);
+    bm->allocPixels();
+}
+
+static void draw(SkBitmap* bm, const SkPath& path, const SkPaint& paint,
+                 SkScalar scale) {
+    bm->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bm);
+    canvas.scale(scale, scale);
+    canvas.drawPath(path, paint);
+}
+
+static void TestStrokeCache(skiatest::Reporter* reporter) {
+    size_t prevLimit = SkGraphics::SetStrokeCacheLimit(0);
+    SkGraphics::PurgeStrokeCache();
+
+    SkPath path;
+    path.moveTo(5, 5);
+    path.quadTo(40, 10, 30, 40);
+    path.lineTo(58, 58);
+
+    SkScalar intervals[] = { 6, 3 };
+    SkDashPathEffect* dash = SkNEW_ARGS(SkDashPathEffect, (intervals, 2, 0));
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(4);
+    paint.setStrokeJoin(SkPaint::kRound_Join);
+    paint.setPathEffect(dash)->unref();
+
+    SkBitmap expected, actual;
+    make_bitmap(&expected);
+    make_bitmap(&actual);
+
+    // With the cache off, nothing is counted.
+    draw(&expected, path, paint, 1);
+    int32_t hits, misses;
+    SkGraphics::GetStrokeCacheStats(&hits, &misses);
+    REPORTER_ASSERT(reporter, 0 == hits && 0 == misses);
+
+    SkGraphics::SetStrokeCacheLimit(1024 * 1024);
+    draw(&actual, path, paint, 1);
+    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+    SkGraphics::GetStrokeCacheStats(&hits, &misses);
+    REPORTER_ASSERT(reporter, 0 == hits && 1 == misses);
+    REPORTER_ASSERT(reporter, SkGraphics::GetStrokeCacheUsed() > 0);
+
+    // A copy of the path shares its outline, whatever the scale.
+    SkPath copy(path);
+    draw(&actual, copy, paint, 1);
+    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+    draw(&actual, copy, paint, SK_Scalar1 / 2);
+    SkGraphics::GetStrokeCacheStats(&hits, &misses);
+    REPORTER_ASSERT(reporter, 2 == hits && 1 == misses);
+
+    // Changing the stroke, or the path, misses.
+    paint.setStrokeWidth(5);
+    draw(&actual, path, paint, 1);
+    REPORTER_ASSERT(reporter, !same_pixels(expected, actual));
+    paint.setStrokeWidth(4);
+    copy.lineTo(5, 58);
+    draw(&actual, copy, paint, 1);
+    REPORTER_ASSERT(reporter, !same_pixels(expected, actual));
+    SkGraphics::GetStrokeCacheStats(&hits, &misses);
+    REPORTER_ASSERT(reporter, 2 == hits && 3 == misses);
+
+    // The original path still hits.
+    draw(&actual, path, paint, 1);
+    REPORTER_ASSERT(reporter, same_pixels(expected, actual));
+    SkGraphics::GetStrokeCacheStats(&hits, &misses);
+    REPORTER_ASSERT(reporter, 3 == hits && 3 == misses);
+
+    // Fills are never cached.
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setPathEffect(NULL);
+    draw(&actual, path, paint, 1);
+    SkGraphics::GetStrokeCacheStats(&hits, &misses);
+    REPORTER_ASSERT(reporter, 3 == hits && 3 == misses);
+
+    // Turning the cache off empties it.
+    SkGraphics::SetStrokeCacheLimit(0);
+    REPORTER_ASSERT(reporter, 0 == SkGraphics::GetStrokeCacheUsed());
+
+    SkGraphics::PurgeStrokeCache();
+    SkGraphics::SetStrokeCacheLimit(prevLimit);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("StrokeCache", StrokeCacheTestClass, TestStrokeCache)
@@ -0,0 +1,23 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef skiatest_TestUtils_DEFINED
+#define skiatest_TestUtils_DEFINED
+
+#include "SkBitmap.h"
+
+/**
+ *  Return true if the two bitmaps have the same number of bytes of pixels,
+ *  and those bytes are identical.
+ */
+static inline bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    return a.getSize() == b.getSize() &&
+           0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkCountdown.h"
+#include "SkRunnable.h"
+#include "SkTDArray.h"
+#include "SkThread.h"
+#include "SkThreadPool.h"
+
+static const int kThreadCounts[] = { 0, 1, 4 };
+
+class CountRunnable : public SkRunnable {
+public:
+    CountRunnable(int32_t* count) : fCount(count) {}
+
+    virtual void run() SK_OVERRIDE {
+        sk_atomic_inc(fCount);
+    }
+
+private:
+    int32_t* fCount;
+};
+
+// Counts how many times each index is visited.
+class VisitRange : public SkRangeRunnable {
+public:
+    VisitRange(int count, int grain) : fGrain(grain), fTooLong(false) {
+        fVisits.setCount(count);
+        sk_bzero(fVisits.begin(), fVisits.bytes());
+    }
+
+    virtual void run(int start, int stop) SK_OVERRIDE {
+        fTooLong = fTooLong || stop - start > fGrain;
+        for (int i = start; i < stop; ++i) {
+            sk_atomic_inc(&fVisits[i]);
+        }
+    }
+
+    bool visitedOnce() const {
+        for (int i = 0; i < fVisits.count(); ++i) {
+            if (1 != fVisits[i]) {
+                return false;
+            }
+        }
+        return !fTooLong;
+    }
+
+private:
+    SkTDArray<int32_t> fVisits;
+    int                fGrain;
+    bool               fTooLong;
+};
+
+// A task that splits its own work up over the pool that runs it.
+class NestedRunnable : public SkRunnable {
+public:
+    NestedRunnable() : fPool(NULL), fRange(100, 3) {}
+
+    void init(SkThreadPool* pool) { fPool = pool; }
+
+    virtual void run() SK_OVERRIDE {
+        fPool->parallelFor(0, 100, &fRange, 3);
+    }
+
+    bool visitedOnce() const { return fRange.visitedOnce(); }
+
+private:
+    SkThreadPool* fPool;
+    VisitRange    fRange;
+};
+
+static void test_add(skiatest::Reporter* reporter, int threadCount) {
+    static const int kTasks = 100;
+    int32_t count = 0;
+    CountRunnable counter(&count);
+
+    SkThreadPool pool(threadCount);
+    SkCountdown done(kTasks);
+    for (int i = 0; i < kTasks; ++i) {
+        pool.add(&counter, &done);
+    }
+    pool.wait(&done);
+    REPORTER_ASSERT(reporter, kTasks == count);
+
+    // Tasks added without a countdown still run before the pool goes away.
+    int32_t count2 = 0;
+    CountRunnable counter2(&count2);
+    {
+        SkThreadPool pool2(threadCount);
+        for (int i = 0; i < kTasks; ++i) {
+            pool2.add(&counter2);
+        }
+        pool2.add(NULL);
+    }
+    REPORTER_ASSERT(reporter, kTasks == count2);
+}
+
+static void test_parallel_for(skiatest::Reporter* reporter, int threadCount) {
+    SkThreadPool pool(threadCount);
+
+    static const int kGrains[] = { 1, 7, 1000 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kGrains); ++i) {
+        VisitRange range(500, kGrains[i]);
+        pool.parallelFor(0, 500, &range, kGrains[i]);
+        REPORTER_ASSERT(reporter, range.visitedOnce());
+    }
+
+    // An empty range never calls the body.
+    VisitRange empty(0, 1);
+    pool.parallelFor(10, 10, &empty);
+    REPORTER_ASSERT(reporter, empty.visitedOnce());
+
+    // Tasks that wait on work of their own must not deadlock the pool.
+    static const int kNested = 8;
+    NestedRunnable nested[kNested];
+    SkCountdown done(kNested);
+    for (int i = 0; i < kNested; ++i) {
+        nested[i].init(&pool);
+        pool.add(&nested[i], &done);
+    }
+    pool.wait(&done);
+    for (int i = 0; i < kNested; ++i) {
+        REPORTER_ASSERT(reporter, nested[i].visitedOnce());
+    }
+}
+
+static void TestThreadPool(skiatest::Reporter* reporter) {
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kThreadCounts); ++i) {
+        test_add(reporter, kThreadCounts[i]);
+        test_parallel_for(reporter, kThreadCounts[i]);
+    }
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("ThreadPool", ThreadPoolTestClass, TestThreadPool)